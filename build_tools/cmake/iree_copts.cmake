@@ -347,6 +347,7 @@ if(${IREE_SIZE_OPTIMIZED})
       "/DIREE_HAL_MODULE_STRING_UTIL_ENABLE=0"
       "/DIREE_VM_EXT_I64_ENABLE=0"
       "/DIREE_VM_EXT_F32_ENABLE=0"
+      "/DIREE_VM_EXT_F64_ENABLE=0"
       "/Os"
       "/Oy"
       "/Zi"
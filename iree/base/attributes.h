@@ -162,6 +162,26 @@
 #define IREE_UNLIKELY(x) (x)
 #endif  // IREE_HAVE_ATTRIBUTE(likely)
 
+//===----------------------------------------------------------------------===//
+// IREE_THREAD_LOCAL
+//===----------------------------------------------------------------------===//
+
+// Storage class specifier for variables with one instance per thread.
+// Only use with trivially-initialized POD types; there is no guarantee of
+// destructors running on thread exit.
+//
+// Example:
+//   static IREE_THREAD_LOCAL uint32_t thread_slot = 0;
+#if defined(__cplusplus)
+#define IREE_THREAD_LOCAL thread_local
+#elif defined(_MSC_VER)
+#define IREE_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define IREE_THREAD_LOCAL _Thread_local
+#else
+#define IREE_THREAD_LOCAL __thread
+#endif  // __cplusplus
+
 //===----------------------------------------------------------------------===//
 // IREE_ATTRIBUTE_PACKED
 //===----------------------------------------------------------------------===//
@@ -21,12 +21,19 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#if defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#endif  // IREE_PLATFORM_LINUX
+
 struct iree_dynamic_library_s {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
 
   // dlopen shared object handle.
   void* handle;
+
+  // memfd the library was loaded from or -1 if loaded from a file.
+  int memfd;
 };
 
 // Allocate a new string from |allocator| returned in |out_file_path| containing
@@ -137,6 +144,7 @@ static iree_status_t iree_dynamic_library_create(
   iree_atomic_ref_count_init(&library->ref_count);
   library->allocator = allocator;
   library->handle = handle;
+  library->memfd = -1;
 
   *out_library = library;
   return iree_ok_status();
@@ -183,10 +191,85 @@ iree_status_t iree_dynamic_library_load_from_files(
   return status;
 }
 
-// TODO(#3845): use dlopen on an fd with either dlopen(/proc/self/fd/NN),
-// fdlopen, or android_dlopen_ext to avoid needing to write the file to disk.
-// Can fallback to memfd_create + dlopen where available, and fallback from
-// that to disk (maybe just windows/mac).
+#if defined(IREE_PLATFORM_LINUX) && defined(SYS_memfd_create)
+
+// Loads the library from an anonymous in-memory file via memfd_create and
+// dlopen on its /proc/self/fd/ path. This avoids touching the filesystem
+// entirely, which on systems with slow or read-only temp directories can be
+// significantly faster than writing a temp file.
+//
+// The fd is kept open for the lifetime of the library: the loader identifies
+// libraries by path and a reused fd number would otherwise return the library
+// previously loaded through it.
+//
+// Returns IREE_STATUS_UNAVAILABLE if memfd_create is not supported by the
+// kernel (pre-3.17) or the fd cannot be opened through /proc (such as in
+// some sandboxes), in which case callers should fall back to a temp file.
+static iree_status_t iree_dynamic_library_load_from_memfd(
+    iree_string_view_t identifier, iree_const_byte_span_t buffer,
+    iree_dynamic_library_flags_t flags, iree_allocator_t allocator,
+    iree_dynamic_library_t** out_library) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The name is only used for debugging and shows up in /proc/self/maps as
+  // `/memfd:<name> (deleted)`. The kernel limits it to 249 characters.
+  char name[128];
+  snprintf(name, sizeof(name), "iree_dylib_%.*s", (int)identifier.size,
+           identifier.data);
+
+  // NOTE: we use the raw syscall as memfd_create was only added to glibc in
+  // 2.27 and many toolchains still target older versions.
+  int fd = (int)syscall(SYS_memfd_create, name, /*MFD_CLOEXEC=*/1u);
+  if (fd < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "memfd_create unavailable (errno %d)", errno);
+  }
+
+  // Write all file bytes; large writes may be split.
+  iree_status_t status = iree_ok_status();
+  const uint8_t* data = buffer.data;
+  iree_host_size_t remaining = buffer.data_length;
+  while (remaining > 0) {
+    ssize_t written = write(fd, data, remaining);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "unable to write %zu bytes to memfd",
+                                buffer.data_length);
+      break;
+    }
+    data += written;
+    remaining -= (iree_host_size_t)written;
+  }
+
+  if (iree_status_is_ok(status)) {
+    char fd_path[64];
+    snprintf(fd_path, sizeof(fd_path), "/proc/self/fd/%d", fd);
+    void* handle = dlopen(fd_path, RTLD_LAZY | RTLD_LOCAL);
+    if (handle) {
+      status = iree_dynamic_library_create(handle, allocator, out_library);
+      if (iree_status_is_ok(status)) {
+        (*out_library)->memfd = fd;
+      } else {
+        dlclose(handle);
+      }
+    } else {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "dlopen of memfd failed: %s", dlerror());
+    }
+  }
+
+  if (!iree_status_is_ok(status)) close(fd);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#endif  // IREE_PLATFORM_LINUX && SYS_memfd_create
+
+// TODO(#3845): use fdlopen or android_dlopen_ext where available to avoid
+// needing to write the file to disk on other platforms.
 iree_status_t iree_dynamic_library_load_from_memory(
     iree_string_view_t identifier, iree_const_byte_span_t buffer,
     iree_dynamic_library_flags_t flags, iree_allocator_t allocator,
@@ -195,6 +278,18 @@ iree_status_t iree_dynamic_library_load_from_memory(
   IREE_ASSERT_ARGUMENT(out_library);
   *out_library = NULL;
 
+#if defined(IREE_PLATFORM_LINUX) && defined(SYS_memfd_create)
+  // Try first to load entirely from memory and fall back to the temp file if
+  // the system does not support it.
+  iree_status_t memfd_status = iree_dynamic_library_load_from_memfd(
+      identifier, buffer, flags, allocator, out_library);
+  if (!iree_status_is_unavailable(memfd_status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return memfd_status;
+  }
+  iree_status_ignore(memfd_status);
+#endif  // IREE_PLATFORM_LINUX && SYS_memfd_create
+
   // Extract the library to a temp file.
   char* temp_path = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -231,6 +326,10 @@ static void iree_dynamic_library_delete(iree_dynamic_library_t* library) {
   if (library->handle != NULL) {
     dlclose(library->handle);
   }
+  // Only once unloaded can the fd (and its path) be reused.
+  if (library->memfd != -1) {
+    close(library->memfd);
+  }
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
   iree_allocator_free(allocator, library);
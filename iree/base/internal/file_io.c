@@ -14,6 +14,14 @@
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_FILE_IO_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_*
+
 iree_status_t iree_file_exists(const char* path) {
   IREE_ASSERT_ARGUMENT(path);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -51,8 +59,8 @@ static iree_status_t iree_file_read_contents_impl(
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(allocator, file_size + 1, (void**)&contents));
 
-  // Attempt to read the file into memory.
-  if (fread(contents, file_size, 1, file) != 1) {
+  // Attempt to read the file into memory (empty files have nothing to read).
+  if (file_size > 0 && fread(contents, file_size, 1, file) != 1) {
     iree_allocator_free(allocator, contents);
     return iree_make_status(iree_status_code_from_errno(errno),
                             "unable to read entire %zu file bytes", file_size);
@@ -92,6 +100,120 @@ iree_status_t iree_file_read_contents(const char* path,
   return status;
 }
 
+#if defined(IREE_FILE_IO_HAVE_MMAP)
+
+// Deallocator state for a mapped file; freeing the contents unmaps them.
+typedef struct {
+  iree_allocator_t allocator;
+  iree_host_size_t length;
+} iree_file_mapping_t;
+
+static iree_status_t iree_file_mapping_alloc(void* self,
+                                             iree_allocation_mode_t mode,
+                                             iree_host_size_t byte_length,
+                                             void** out_ptr) {
+  return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                          "file mappings cannot allocate");
+}
+
+static void iree_file_mapping_free(void* self, void* ptr) {
+  iree_file_mapping_t* mapping = (iree_file_mapping_t*)self;
+  munmap(ptr, mapping->length);
+  iree_allocator_free(mapping->allocator, mapping);
+}
+
+// Maps |fd| with |file_size| bytes. Returns with |out_contents| empty if the
+// file cannot be mapped and should be read instead.
+static iree_status_t iree_file_map_contents_impl(
+    int fd, iree_host_size_t file_size, iree_allocator_t allocator,
+    iree_const_byte_span_t* out_contents, iree_allocator_t* out_deallocator) {
+  iree_file_mapping_t* mapping = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*mapping), (void**)&mapping));
+  mapping->allocator = allocator;
+  mapping->length = file_size;
+
+  void* base_address = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (base_address == MAP_FAILED) {
+    iree_allocator_free(allocator, mapping);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "mmap of %zu bytes failed", file_size);
+  }
+
+  *out_contents = iree_make_const_byte_span(base_address, file_size);
+  out_deallocator->self = mapping;
+  out_deallocator->alloc = iree_file_mapping_alloc;
+  out_deallocator->free = iree_file_mapping_free;
+  return iree_ok_status();
+}
+
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_const_byte_span_t* out_contents,
+                                     iree_allocator_t* out_deallocator) {
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(out_contents);
+  IREE_ASSERT_ARGUMENT(out_deallocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  *out_contents = iree_make_const_byte_span(NULL, 0);
+  *out_deallocator = iree_allocator_null();
+
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open file '%s'", path);
+  }
+
+  iree_status_t status = iree_ok_status();
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) == -1) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "size query of file '%s'", path);
+  } else if (stat_buf.st_size > 0) {
+    status = iree_file_map_contents_impl(fd, (iree_host_size_t)stat_buf.st_size,
+                                         allocator, out_contents,
+                                         out_deallocator);
+    if (!iree_status_is_ok(status)) {
+      status = iree_status_annotate_f(status, "mapping file '%s'", path);
+    }
+  }
+
+  // The mapping keeps its own reference to the file.
+  close(fd);
+
+  // Empty files cannot be mapped; read them so callers still get a valid
+  // (NUL-terminated) allocation.
+  if (iree_status_is_ok(status) && !out_contents->data) {
+    iree_byte_span_t contents = iree_make_byte_span(NULL, 0);
+    status = iree_file_read_contents(path, allocator, &contents);
+    *out_contents = iree_make_const_byte_span(contents.data,
+                                              contents.data_length);
+    *out_deallocator = allocator;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+#else
+
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_const_byte_span_t* out_contents,
+                                     iree_allocator_t* out_deallocator) {
+  IREE_ASSERT_ARGUMENT(out_contents);
+  IREE_ASSERT_ARGUMENT(out_deallocator);
+  iree_byte_span_t contents = iree_make_byte_span(NULL, 0);
+  iree_status_t status = iree_file_read_contents(path, allocator, &contents);
+  *out_contents =
+      iree_make_const_byte_span(contents.data, contents.data_length);
+  *out_deallocator = allocator;
+  return status;
+}
+
+#endif  // IREE_FILE_IO_HAVE_MMAP
+
 iree_status_t iree_file_write_contents(const char* path,
                                        iree_const_byte_span_t content) {
   IREE_ASSERT_ARGUMENT(path);
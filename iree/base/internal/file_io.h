@@ -29,6 +29,22 @@ iree_status_t iree_file_read_contents(const char* path,
                                       iree_allocator_t allocator,
                                       iree_byte_span_t* out_contents);
 
+// Maps a file's contents into memory read-only.
+//
+// Returns the contents of the file in |out_contents| and an allocator in
+// |out_deallocator| that must be used to release them with
+// iree_allocator_free(*out_deallocator, out_contents->data). Pages are only
+// read from disk as they are touched so large files that are only partially
+// accessed do not pay to load the unused portions.
+//
+// On platforms without memory mapping support (or for empty files) the
+// contents are read into memory allocated from |allocator| as with
+// iree_file_read_contents and |out_deallocator| is |allocator|.
+iree_status_t iree_file_map_contents(const char* path,
+                                     iree_allocator_t allocator,
+                                     iree_const_byte_span_t* out_contents,
+                                     iree_allocator_t* out_deallocator);
+
 // Synchronously writes a byte buffer into a file.
 // Existing contents are overwritten.
 iree_status_t iree_file_write_contents(const char* path,
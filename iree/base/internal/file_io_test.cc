@@ -61,6 +61,36 @@ TEST(FileIO, ReadWriteContents) {
   iree_allocator_free(iree_allocator_system(), read_contents.data);
 }
 
+TEST(FileIO, MapContents) {
+  constexpr const char* kUniqueName = "MapContents";
+  auto path = GetUniquePath(kUniqueName);
+
+  auto write_contents = GetUniqueContents(kUniqueName);
+  IREE_ASSERT_OK(iree_file_write_contents(
+      path.c_str(),
+      iree_make_const_byte_span(write_contents.data(), write_contents.size())));
+
+  // Map the contents and expect they match what was written.
+  iree_const_byte_span_t mapped_contents;
+  iree_allocator_t deallocator;
+  IREE_ASSERT_OK(iree_file_map_contents(path.c_str(), iree_allocator_system(),
+                                        &mapped_contents, &deallocator));
+  EXPECT_EQ(write_contents.size(), mapped_contents.data_length);
+  EXPECT_EQ(memcmp(write_contents.data(), mapped_contents.data,
+                   mapped_contents.data_length),
+            0);
+  iree_allocator_free(deallocator, (void*)mapped_contents.data);
+
+  // Empty files are returned as empty (but valid) contents.
+  FILE* file = fopen(path.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  fclose(file);
+  IREE_ASSERT_OK(iree_file_map_contents(path.c_str(), iree_allocator_system(),
+                                        &mapped_contents, &deallocator));
+  EXPECT_EQ(0, mapped_contents.data_length);
+  iree_allocator_free(deallocator, (void*)mapped_contents.data);
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
@@ -0,0 +1,248 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/lz4_block.h"
+
+#include <string.h>
+
+// Minimum length of a match; shorter repeats are emitted as literals.
+#define IREE_LZ4_MIN_MATCH 4
+// The last 5 bytes of a block are always literals.
+#define IREE_LZ4_LAST_LITERALS 5
+// The last match must start at least 12 bytes before the end of the block.
+#define IREE_LZ4_MF_LIMIT 12
+// Matches are encoded with a 16-bit offset.
+#define IREE_LZ4_MAX_OFFSET 65535
+// Length nibbles saturate at 15 and continue in additional bytes.
+#define IREE_LZ4_RUN_MASK 15
+
+// log2 of the number of entries in the compressor match hash table.
+#define IREE_LZ4_HASH_LOG 12
+
+//===----------------------------------------------------------------------===//
+// Compression
+//===----------------------------------------------------------------------===//
+
+iree_host_size_t iree_lz4_block_compress_bound(iree_host_size_t source_length) {
+  return source_length + source_length / 255 + 16;
+}
+
+static inline uint32_t iree_lz4_read32(const uint8_t* ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static inline uint32_t iree_lz4_hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IREE_LZ4_HASH_LOG);
+}
+
+// Returns the number of bytes needed to encode a |length| in the additional
+// length bytes following a token nibble.
+static inline iree_host_size_t iree_lz4_length_size(iree_host_size_t length) {
+  return length >= IREE_LZ4_RUN_MASK ? (length - IREE_LZ4_RUN_MASK) / 255 + 1
+                                     : 0;
+}
+
+static inline uint8_t* iree_lz4_write_length(uint8_t* op,
+                                             iree_host_size_t length) {
+  if (length < IREE_LZ4_RUN_MASK) return op;
+  length -= IREE_LZ4_RUN_MASK;
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// Writes a sequence of |literal_length| literals from |literals| followed by a
+// match of |match_length| bytes at |offset| (if |match_length| is nonzero).
+// Returns NULL if the sequence does not fit before |op_end|.
+static uint8_t* iree_lz4_write_sequence(uint8_t* op, uint8_t* op_end,
+                                        const uint8_t* literals,
+                                        iree_host_size_t literal_length,
+                                        iree_host_size_t offset,
+                                        iree_host_size_t match_length) {
+  iree_host_size_t required_size =
+      1 + iree_lz4_length_size(literal_length) + literal_length;
+  iree_host_size_t match_code = 0;
+  if (match_length) {
+    match_code = match_length - IREE_LZ4_MIN_MATCH;
+    required_size += 2 + iree_lz4_length_size(match_code);
+  }
+  if (required_size > (iree_host_size_t)(op_end - op)) return NULL;
+
+  uint8_t literal_nibble = literal_length < IREE_LZ4_RUN_MASK
+                               ? (uint8_t)literal_length
+                               : IREE_LZ4_RUN_MASK;
+  uint8_t match_nibble =
+      match_code < IREE_LZ4_RUN_MASK ? (uint8_t)match_code : IREE_LZ4_RUN_MASK;
+  *op++ = (uint8_t)(literal_nibble << 4) | match_nibble;
+  op = iree_lz4_write_length(op, literal_length);
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (match_length) {
+    *op++ = (uint8_t)(offset & 0xFF);
+    *op++ = (uint8_t)(offset >> 8);
+    op = iree_lz4_write_length(op, match_code);
+  }
+  return op;
+}
+
+iree_host_size_t iree_lz4_block_compress(iree_const_byte_span_t source,
+                                         iree_byte_span_t target) {
+  if (source.data_length > UINT32_MAX) return 0;
+  const uint8_t* const base = source.data;
+  const uint8_t* const ip_end = base + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* const op_end = target.data + target.data_length;
+
+  const uint8_t* ip = base;
+  const uint8_t* anchor = base;
+  if (source.data_length > IREE_LZ4_MF_LIMIT) {
+    // Positions (relative to |base|) of the last occurrence of each hashed
+    // 4-byte sequence. Candidates are always verified so stale or zeroed
+    // entries only cost a missed match.
+    uint32_t hash_table[1 << IREE_LZ4_HASH_LOG];
+    memset(hash_table, 0, sizeof(hash_table));
+    const uint8_t* const match_start_limit = ip_end - IREE_LZ4_MF_LIMIT;
+    const uint8_t* const match_end_limit = ip_end - IREE_LZ4_LAST_LITERALS;
+    while (ip < match_start_limit) {
+      uint32_t sequence = iree_lz4_read32(ip);
+      uint32_t hash = iree_lz4_hash(sequence);
+      const uint8_t* ref = base + hash_table[hash];
+      hash_table[hash] = (uint32_t)(ip - base);
+      if (ref >= ip || ip - ref > IREE_LZ4_MAX_OFFSET ||
+          iree_lz4_read32(ref) != sequence) {
+        ++ip;
+        continue;
+      }
+
+      // Extend the match backward into pending literals and then forward.
+      while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+        --ip;
+        --ref;
+      }
+      const uint8_t* match_end = ip + IREE_LZ4_MIN_MATCH;
+      const uint8_t* ref_end = ref + IREE_LZ4_MIN_MATCH;
+      while (match_end < match_end_limit && *match_end == *ref_end) {
+        ++match_end;
+        ++ref_end;
+      }
+
+      op = iree_lz4_write_sequence(op, op_end, anchor, ip - anchor, ip - ref,
+                                   match_end - ip);
+      if (!op) return 0;
+      ip = anchor = match_end;
+    }
+  }
+
+  // Emit the remaining bytes as the final literal-only sequence.
+  op = iree_lz4_write_sequence(op, op_end, anchor, ip_end - anchor, 0, 0);
+  if (!op) return 0;
+  return op - target.data;
+}
+
+//===----------------------------------------------------------------------===//
+// Decompression
+//===----------------------------------------------------------------------===//
+
+// Reads the additional length bytes following a saturated token nibble.
+// Returns false if the input ends before the length is complete.
+static bool iree_lz4_read_length(const uint8_t** ip_ptr, const uint8_t* ip_end,
+                                 iree_host_size_t* length) {
+  const uint8_t* ip = *ip_ptr;
+  uint8_t value = 0;
+  do {
+    if (ip >= ip_end) return false;
+    value = *ip++;
+    *length += value;
+  } while (value == 255);
+  *ip_ptr = ip;
+  return true;
+}
+
+iree_status_t iree_lz4_block_decompress(iree_const_byte_span_t source,
+                                        iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* const ip_end = source.data + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* const op_end = target.data + target.data_length;
+
+  while (true) {
+    if (ip >= ip_end) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 block truncated before token");
+    }
+    uint8_t token = *ip++;
+
+    // Literals.
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == IREE_LZ4_RUN_MASK &&
+        !iree_lz4_read_length(&ip, ip_end, &literal_length)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 block truncated in literal length");
+    }
+    if (literal_length > (iree_host_size_t)(ip_end - ip) ||
+        literal_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 literal run of %zu bytes out of bounds",
+                              literal_length);
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // The last sequence has no match.
+    if (ip == ip_end) break;
+
+    // Match.
+    if (ip_end - ip < 2) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 block truncated in match offset");
+    }
+    iree_host_size_t offset =
+        (iree_host_size_t)ip[0] | ((iree_host_size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (iree_host_size_t)(op - target.data)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 match offset %zu out of bounds", offset);
+    }
+    iree_host_size_t match_length = token & IREE_LZ4_RUN_MASK;
+    if (match_length == IREE_LZ4_RUN_MASK &&
+        !iree_lz4_read_length(&ip, ip_end, &match_length)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 block truncated in match length");
+    }
+    match_length += IREE_LZ4_MIN_MATCH;
+    if (match_length > (iree_host_size_t)(op_end - op)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "lz4 match of %zu bytes out of bounds",
+                              match_length);
+    }
+
+    // Matches may overlap the bytes they produce (such as runs with an offset
+    // of 1). Everything from |ref| to |op| repeats with a period of |offset| so
+    // each copy can take as many bytes as have been produced since |ref|.
+    const uint8_t* ref = op - offset;
+    while (match_length > 0) {
+      iree_host_size_t chunk_length = op - ref;
+      if (chunk_length > match_length) chunk_length = match_length;
+      memcpy(op, ref, chunk_length);
+      op += chunk_length;
+      match_length -= chunk_length;
+    }
+  }
+
+  if (op != op_end) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "lz4 block decompressed to %zu bytes but %zu were expected",
+        (iree_host_size_t)(op - target.data), target.data_length);
+  }
+  return iree_ok_status();
+}
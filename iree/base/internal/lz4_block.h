@@ -0,0 +1,53 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//==============================================================================
+//
+// LZ4 block format compression
+//
+// A small self-contained implementation of the LZ4 block format:
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//
+// Blocks produced here can be decoded by any conforming LZ4 block decoder and
+// any conforming block can be decoded here. The compressor is a simple greedy
+// single-pass matcher intended for offline use (such as by the compiler) and
+// does not aim to match the ratio of the reference implementation. The
+// decompressor is bounds checked and safe to use on untrusted inputs.
+//
+//==============================================================================
+
+#ifndef IREE_BASE_INTERNAL_LZ4_BLOCK_H_
+#define IREE_BASE_INTERNAL_LZ4_BLOCK_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Returns the maximum compressed size in bytes of a |source_length| byte input.
+iree_host_size_t iree_lz4_block_compress_bound(iree_host_size_t source_length);
+
+// Compresses |source| into |target| as a single LZ4 block.
+// Returns the compressed size in bytes or 0 if the compressed data would not
+// fit in |target|. Compression always succeeds if |target| has at least
+// iree_lz4_block_compress_bound bytes. Inputs larger than 4GB are not
+// supported and return 0.
+iree_host_size_t iree_lz4_block_compress(iree_const_byte_span_t source,
+                                         iree_byte_span_t target);
+
+// Decompresses the LZ4 block in |source| into |target|.
+// |target| must be exactly the size of the decompressed data. Fails with
+// IREE_STATUS_INVALID_ARGUMENT if the block is malformed or does not
+// decompress to exactly |target|.data_length bytes.
+iree_status_t iree_lz4_block_decompress(iree_const_byte_span_t source,
+                                        iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_LZ4_BLOCK_H_
@@ -0,0 +1,130 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/lz4_block.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+std::vector<uint8_t> Compress(const std::vector<uint8_t>& source) {
+  std::vector<uint8_t> compressed(iree_lz4_block_compress_bound(source.size()));
+  iree_host_size_t compressed_length = iree_lz4_block_compress(
+      iree_make_const_byte_span(source.data(), source.size()),
+      iree_make_byte_span(compressed.data(), compressed.size()));
+  EXPECT_GT(compressed_length, 0);
+  compressed.resize(compressed_length);
+  return compressed;
+}
+
+void ExpectRoundTrip(const std::vector<uint8_t>& source) {
+  auto compressed = Compress(source);
+  std::vector<uint8_t> decompressed(source.size());
+  IREE_ASSERT_OK(iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed.data(), compressed.size()),
+      iree_make_byte_span(decompressed.data(), decompressed.size())));
+  EXPECT_EQ(source, decompressed);
+}
+
+TEST(LZ4BlockTest, Empty) { ExpectRoundTrip({}); }
+
+TEST(LZ4BlockTest, ShorterThanMinimumMatch) {
+  ExpectRoundTrip({1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+}
+
+// Long runs are encoded as overlapping matches with extended lengths.
+TEST(LZ4BlockTest, Runs) {
+  std::vector<uint8_t> source(100000, 0);
+  auto compressed = Compress(source);
+  EXPECT_LT(compressed.size(), 1024);
+  ExpectRoundTrip(source);
+}
+
+TEST(LZ4BlockTest, RepeatedPattern) {
+  std::vector<uint8_t> source;
+  for (int i = 0; i < 4096; ++i) {
+    source.push_back(static_cast<uint8_t>(i % 7));
+    source.push_back(static_cast<uint8_t>(i % 13));
+  }
+  ExpectRoundTrip(source);
+}
+
+// Returns |length| bytes of pseudo-random incompressible data.
+std::vector<uint8_t> MakeNoise(size_t length) {
+  std::vector<uint8_t> source(length);
+  uint32_t state = 1;
+  for (auto& value : source) {
+    state = state * 1103515245u + 12345u;
+    value = static_cast<uint8_t>(state >> 24);
+  }
+  return source;
+}
+
+// Incompressible data is stored as literals with extended literal lengths.
+TEST(LZ4BlockTest, Incompressible) {
+  auto source = MakeNoise(70000);
+  auto compressed = Compress(source);
+  EXPECT_LE(compressed.size(), iree_lz4_block_compress_bound(source.size()));
+  ExpectRoundTrip(source);
+}
+
+TEST(LZ4BlockTest, TargetTooSmall) {
+  auto source = MakeNoise(1000);
+  std::vector<uint8_t> compressed(source.size() / 2);
+  EXPECT_EQ(0, iree_lz4_block_compress(
+                   iree_make_const_byte_span(source.data(), source.size()),
+                   iree_make_byte_span(compressed.data(), compressed.size())));
+}
+
+// Decodes a block assembled by hand from the format specification.
+TEST(LZ4BlockTest, HandAssembledBlock) {
+  // 3 literals with an 18 byte match at offset 3 followed by 5 literals.
+  std::vector<uint8_t> compressed = {0x3E, 'a', 'b', 'c', 0x03, 0x00,
+                                     0x50, 'x', 'y', 'z', 'w', 'v'};
+  std::vector<uint8_t> decompressed(3 + 18 + 5);
+  IREE_ASSERT_OK(iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed.data(), compressed.size()),
+      iree_make_byte_span(decompressed.data(), decompressed.size())));
+  std::string expected = "abcabcabcabcabcabcabcxyzwv";
+  EXPECT_EQ(expected, std::string(decompressed.begin(), decompressed.end()));
+}
+
+TEST(LZ4BlockTest, MalformedBlocks) {
+  std::vector<uint8_t> decompressed(64);
+  auto decompress = [&](std::vector<uint8_t> compressed, size_t length) {
+    return iree::Status(iree_lz4_block_decompress(
+        iree_make_const_byte_span(compressed.data(), compressed.size()),
+        iree_make_byte_span(decompressed.data(), length)));
+  };
+  // Literal run longer than the input.
+  EXPECT_THAT(decompress({0x40, 'a', 'b'}, 4),
+              StatusIs(StatusCode::kInvalidArgument));
+  // Match offset before the start of the output.
+  EXPECT_THAT(decompress({0x10, 'a', 0x02, 0x00, 0x00}, 5),
+              StatusIs(StatusCode::kInvalidArgument));
+  // Zero match offset.
+  EXPECT_THAT(decompress({0x10, 'a', 0x00, 0x00, 0x00}, 5),
+              StatusIs(StatusCode::kInvalidArgument));
+  // Output larger than the target.
+  EXPECT_THAT(decompress({0x10, 'a', 0x01, 0x00, 0x00}, 4),
+              StatusIs(StatusCode::kInvalidArgument));
+  // Output smaller than the target.
+  EXPECT_THAT(decompress({0x30, 'a', 'b', 'c'}, 4),
+              StatusIs(StatusCode::kInvalidArgument));
+  // Truncated extended length.
+  EXPECT_THAT(decompress({0xF0, 0xFF}, 64),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+}  // namespace
@@ -0,0 +1,150 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/numa.h"
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/target_platform.h"
+#include "iree/base/tracing.h"
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// From <linux/mempolicy.h>; we issue the syscall directly to avoid taking a
+// dependency on libnuma.
+#define IREE_MPOL_PREFERRED 1
+#define IREE_MPOL_MF_MOVE (1 << 1)
+
+// Maximum node ID we can place memory on. Linux defaults to a maximum of 1024.
+#define IREE_NUMA_MAX_NODE_COUNT 1024
+
+static iree_once_flag iree_numa_node_count_flag_ = IREE_ONCE_FLAG_INIT;
+static iree_host_size_t iree_numa_node_count_ = 1;
+
+// Parses a Linux cpulist/nodelist (such as "0-3,8,10-11") and returns the
+// highest value in the list or -1 if the list is empty or malformed.
+static int iree_numa_parse_list_max(const char* list) {
+  int max_value = -1;
+  const char* p = list;
+  while (*p >= '0' && *p <= '9') {
+    char* end = NULL;
+    long value = strtol(p, &end, 10);
+    if (*end == '-') value = strtol(end + 1, &end, 10);
+    if (value > max_value) max_value = (int)value;
+    if (*end != ',') break;
+    p = end + 1;
+  }
+  return max_value;
+}
+
+static void iree_numa_query_node_count(void) {
+  FILE* file = fopen("/sys/devices/system/node/possible", "r");
+  if (!file) return;
+  char buffer[256];
+  if (fgets(buffer, sizeof(buffer), file)) {
+    int max_node = iree_numa_parse_list_max(buffer);
+    if (max_node >= 0 && max_node < IREE_NUMA_MAX_NODE_COUNT) {
+      iree_numa_node_count_ = (iree_host_size_t)max_node + 1;
+    }
+  }
+  fclose(file);
+}
+
+iree_host_size_t iree_numa_node_count(void) {
+  iree_call_once(&iree_numa_node_count_flag_, iree_numa_query_node_count);
+  return iree_numa_node_count_;
+}
+
+iree_numa_node_id_t iree_numa_node_for_processor(uint32_t processor_id) {
+  if (iree_numa_node_count() <= 1) return 0;
+
+  // Each cpuN directory has a nodeM link to the node it belongs to.
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", processor_id);
+  DIR* dir = opendir(path);
+  if (!dir) return 0;
+  iree_numa_node_id_t node_id = 0;
+  struct dirent* entry = NULL;
+  while ((entry = readdir(dir)) != NULL) {
+    unsigned int value = 0;
+    if (strncmp(entry->d_name, "node", 4) == 0 &&
+        sscanf(entry->d_name + 4, "%u", &value) == 1) {
+      node_id = value;
+      break;
+    }
+  }
+  closedir(dir);
+  return node_id;
+}
+
+void iree_numa_bind_memory(void* ptr, iree_host_size_t length,
+                           iree_numa_node_id_t node_id) {
+  if (node_id == IREE_NUMA_NODE_ID_ANY || node_id >= IREE_NUMA_MAX_NODE_COUNT) {
+    return;
+  }
+  if (iree_numa_node_count() <= 1) return;
+
+  // mbind operates on whole pages and we must not change the policy of pages
+  // shared with other allocations.
+  uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t start = ((uintptr_t)ptr + page_size - 1) & ~(page_size - 1);
+  uintptr_t end = ((uintptr_t)ptr + length) & ~(page_size - 1);
+  if (start >= end) return;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, (int64_t)node_id);
+
+  // MPOL_PREFERRED (vs. MPOL_BIND) allows falling back to other nodes if the
+  // preferred node is out of memory instead of failing allocations.
+  enum { kBitsPerLong = 8 * sizeof(unsigned long) };
+  unsigned long node_mask[IREE_NUMA_MAX_NODE_COUNT / kBitsPerLong] = {0};
+  node_mask[node_id / kBitsPerLong] = 1ul << (node_id % kBitsPerLong);
+  // Hints only; failures (old kernels, seccomp, etc) are ignored.
+  syscall(SYS_mbind, (void*)start, (unsigned long)(end - start),
+          IREE_MPOL_PREFERRED, node_mask,
+          (unsigned long)IREE_NUMA_MAX_NODE_COUNT + 1, IREE_MPOL_MF_MOVE);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+#else
+
+iree_host_size_t iree_numa_node_count(void) { return 1; }
+
+iree_numa_node_id_t iree_numa_node_for_processor(uint32_t processor_id) {
+  return 0;
+}
+
+void iree_numa_bind_memory(void* ptr, iree_host_size_t length,
+                           iree_numa_node_id_t node_id) {}
+
+#endif  // IREE_PLATFORM_*
+
+static iree_status_t iree_numa_allocator_system_allocate(
+    void* self, iree_allocation_mode_t mode, iree_host_size_t byte_length,
+    void** out_ptr) {
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_system_allocate(NULL, mode, byte_length, out_ptr));
+  iree_numa_bind_memory(*out_ptr, byte_length,
+                        (iree_numa_node_id_t)(uintptr_t)self);
+  return iree_ok_status();
+}
+
+iree_allocator_t iree_numa_allocator_system(iree_numa_node_id_t node_id) {
+  // The node is stored in the self pointer so that the allocator is stateless.
+  iree_allocator_t allocator = {
+      (void*)(uintptr_t)node_id,
+      iree_numa_allocator_system_allocate,
+      iree_allocator_system_free,
+  };
+  return allocator;
+}
@@ -0,0 +1,69 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BASE_INTERNAL_NUMA_H_
+#define IREE_BASE_INTERNAL_NUMA_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//==============================================================================
+// iree_numa_*
+//==============================================================================
+// Non-Uniform Memory Access (NUMA) node queries and memory placement.
+//
+// On multi-socket machines each socket has its own memory controller and
+// accessing memory attached to another socket is significantly slower (and
+// consumes interconnect bandwidth shared by all cores). Processors and memory
+// are grouped into nodes and these utilities allow for querying which node
+// a processor belongs to and hinting that memory should be placed on a
+// particular node.
+//
+// Only Linux/Android currently report node information; other platforms (and
+// Linux machines with a single node) report one node that all processors
+// belong to and memory binding is a no-op. All queries are best-effort hints:
+// the system may have nodes without processors or memory, or may ignore
+// placement requests when a node is out of memory.
+
+// Identifies a NUMA node. Node IDs are dense starting at 0 and match the IDs
+// used by the OS (such as /sys/devices/system/node/nodeN on Linux).
+typedef uint32_t iree_numa_node_id_t;
+
+// Indicates that no particular node is required or that the node is unknown.
+#define IREE_NUMA_NODE_ID_ANY UINT32_MAX
+
+// Returns the total number of NUMA nodes in the system (always >= 1).
+// All node IDs are < the returned count.
+iree_host_size_t iree_numa_node_count(void);
+
+// Returns the node that the processor with the given OS |processor_id| (such as
+// the Linux CPU number in /sys/devices/system/cpu/cpuN) belongs to.
+// Returns 0 if the node cannot be determined.
+iree_numa_node_id_t iree_numa_node_for_processor(uint32_t processor_id);
+
+// Hints that the pages of the given memory range should be placed on |node_id|.
+// Only pages wholly contained within the range are affected and pages that
+// have already been touched are migrated if possible. This is a no-op if
+// |node_id| is IREE_NUMA_NODE_ID_ANY or the system only has a single node.
+void iree_numa_bind_memory(void* ptr, iree_host_size_t length,
+                           iree_numa_node_id_t node_id);
+
+// Returns an allocator that uses the system allocator and binds all
+// allocations to |node_id| with iree_numa_bind_memory. Allocations may be freed
+// with either this allocator or iree_allocator_system() and the allocator has
+// no state such that it may outlive any object that creates it.
+iree_allocator_t iree_numa_allocator_system(iree_numa_node_id_t node_id);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_INTERNAL_NUMA_H_
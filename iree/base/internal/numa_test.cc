@@ -0,0 +1,51 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/numa.h"
+
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+// NOTE: we can't verify placement without making the tests machine-dependent;
+// these only check that the queries are consistent and binding is harmless.
+
+TEST(NumaTest, NodeCount) { EXPECT_GE(iree_numa_node_count(), 1); }
+
+TEST(NumaTest, NodeForProcessor) {
+  EXPECT_LT(iree_numa_node_for_processor(0), iree_numa_node_count());
+  // Processors that don't exist are reported as node 0.
+  EXPECT_EQ(0, iree_numa_node_for_processor(UINT32_MAX / 2));
+}
+
+TEST(NumaTest, BindMemory) {
+  static constexpr iree_host_size_t kLength = 64 * 1024;
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(iree_allocator_system(), kLength, &ptr));
+  // Unaligned ranges, empty ranges, and ANY are all valid.
+  iree_numa_bind_memory((uint8_t*)ptr + 1, kLength - 1, 0);
+  iree_numa_bind_memory(ptr, 0, 0);
+  iree_numa_bind_memory(ptr, kLength, IREE_NUMA_NODE_ID_ANY);
+  memset(ptr, 0xCD, kLength);
+  EXPECT_EQ(0xCD, ((uint8_t*)ptr)[kLength - 1]);
+  iree_allocator_free(iree_allocator_system(), ptr);
+}
+
+TEST(NumaTest, Allocator) {
+  iree_allocator_t allocator = iree_numa_allocator_system(0);
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 64 * 1024, &ptr));
+  EXPECT_EQ(0, ((uint8_t*)ptr)[0]);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 128 * 1024, &ptr));
+  memset(ptr, 0xCD, 128 * 1024);
+  // Allocations are interchangeable with the system allocator.
+  iree_allocator_free(iree_allocator_system(), ptr);
+}
+
+}  // namespace
@@ -0,0 +1,190 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/wait_handle.h"
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <poll.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
+// Measures the cost of polling a wait set of 1, 16, and 63 (the Windows
+// WaitForMultipleObjects limit) events where only the last inserted event is
+// signaled, which is the worst case for backends that scan the handle list.
+// The BM_WaitSet* benchmarks use whichever backend was selected for the
+// platform (epoll on Linux/Android) and BM_Poll/BM_PPoll issue the raw
+// syscalls over an equivalent pollfd list the way the poll/ppoll backends do
+// to allow comparing them in the same run. Building with -DIREE_WAIT_API=N
+// (see wait_handle_impl.h) runs the BM_WaitSet* benchmarks on another backend.
+
+namespace {
+
+// A set of |count| events with only the last one signaled.
+class EventList {
+ public:
+  explicit EventList(int count) : events_(count) {
+    for (auto& event : events_) {
+      IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &event));
+    }
+    iree_event_set(&events_.back());
+  }
+
+  ~EventList() {
+    for (auto& event : events_) {
+      iree_event_deinitialize(&event);
+    }
+  }
+
+  std::vector<iree_event_t>& events() { return events_; }
+
+  iree_wait_set_t* CreateWaitSet() {
+    iree_wait_set_t* wait_set = NULL;
+    IREE_CHECK_OK(iree_wait_set_allocate(events_.size(),
+                                         iree_allocator_system(), &wait_set));
+    for (auto& event : events_) {
+      IREE_CHECK_OK(iree_wait_set_insert(wait_set, event));
+    }
+    return wait_set;
+  }
+
+ private:
+  std::vector<iree_event_t> events_;
+};
+
+void HandleCountArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"handles"});
+  for (int64_t handle_count : {1, 16, 63}) {
+    benchmark->Args({handle_count});
+  }
+}
+
+// Polls for any signaled handle; the last one is always signaled.
+void BM_WaitSetAny(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  iree_wait_set_t* wait_set = event_list.CreateWaitSet();
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    IREE_CHECK_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    benchmark::DoNotOptimize(wake_handle);
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitSetAny)->Apply(HandleCountArgs);
+
+// Polls a set with nothing signaled (such as a worker checking for new work).
+void BM_WaitSetAnyTimeout(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  iree_event_reset(&event_list.events().back());
+  iree_wait_set_t* wait_set = event_list.CreateWaitSet();
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    iree_status_t status =
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle);
+    if (!iree_status_is_deadline_exceeded(status)) {
+      IREE_CHECK_OK(status);
+    }
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitSetAnyTimeout)->Apply(HandleCountArgs);
+
+// The common wait-wake-erase-insert pattern used when multiplexing waits.
+void BM_WaitSetAnyEraseInsert(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  iree_wait_set_t* wait_set = event_list.CreateWaitSet();
+  for (auto _ : state) {
+    iree_wait_handle_t wake_handle;
+    IREE_CHECK_OK(
+        iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+    iree_wait_set_erase(wait_set, wake_handle);
+    IREE_CHECK_OK(iree_wait_set_insert(wait_set, event_list.events().back()));
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitSetAnyEraseInsert)->Apply(HandleCountArgs);
+
+// Waits for all handles with all of them signaled.
+void BM_WaitSetAll(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  for (auto& event : event_list.events()) iree_event_set(&event);
+  iree_wait_set_t* wait_set = event_list.CreateWaitSet();
+  for (auto _ : state) {
+    IREE_CHECK_OK(iree_wait_all(wait_set, IREE_TIME_INFINITE_PAST));
+  }
+  iree_wait_set_free(wait_set);
+}
+BENCHMARK(BM_WaitSetAll)->Apply(HandleCountArgs);
+
+#if !defined(IREE_PLATFORM_WINDOWS)
+
+int GetReadFd(const iree_wait_handle_t& handle) {
+  switch (handle.type) {
+#if defined(IREE_HAVE_WAIT_TYPE_EVENTFD)
+    case IREE_WAIT_PRIMITIVE_TYPE_EVENT_FD:
+      return handle.value.event.fd;
+#endif  // IREE_HAVE_WAIT_TYPE_EVENTFD
+#if defined(IREE_HAVE_WAIT_TYPE_PIPE)
+    case IREE_WAIT_PRIMITIVE_TYPE_PIPE:
+      return handle.value.pipe.read_fd;
+#endif  // IREE_HAVE_WAIT_TYPE_PIPE
+    default:
+      return -1;
+  }
+}
+
+std::vector<struct pollfd> MakePollFds(EventList& event_list) {
+  std::vector<struct pollfd> poll_fds;
+  for (auto& event : event_list.events()) {
+    struct pollfd poll_fd;
+    poll_fd.fd = GetReadFd(event);
+    poll_fd.events = POLLIN | POLLPRI;
+    poll_fd.revents = 0;
+    poll_fds.push_back(poll_fd);
+  }
+  return poll_fds;
+}
+
+// Returns the index of the first signaled pollfd, as the poll backends scan.
+int FindSignaled(const std::vector<struct pollfd>& poll_fds) {
+  for (size_t i = 0; i < poll_fds.size(); ++i) {
+    if (poll_fds[i].revents & POLLIN) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void BM_Poll(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  std::vector<struct pollfd> poll_fds = MakePollFds(event_list);
+  for (auto _ : state) {
+    int rv = poll(poll_fds.data(), poll_fds.size(), /*timeout=*/0);
+    benchmark::DoNotOptimize(rv);
+    benchmark::DoNotOptimize(FindSignaled(poll_fds));
+  }
+}
+BENCHMARK(BM_Poll)->Apply(HandleCountArgs);
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+void BM_PPoll(benchmark::State& state) {
+  EventList event_list(static_cast<int>(state.range(0)));
+  std::vector<struct pollfd> poll_fds = MakePollFds(event_list);
+  for (auto _ : state) {
+    struct timespec timeout_ts = {0, 0};
+    int rv = ppoll(poll_fds.data(), poll_fds.size(), &timeout_ts, NULL);
+    benchmark::DoNotOptimize(rv);
+    benchmark::DoNotOptimize(FindSignaled(poll_fds));
+  }
+}
+BENCHMARK(BM_PPoll)->Apply(HandleCountArgs);
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
+#endif  // !IREE_PLATFORM_WINDOWS
+
+}  // namespace
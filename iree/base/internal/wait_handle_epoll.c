@@ -9,58 +9,440 @@
 
 #if IREE_WAIT_API == IREE_WAIT_API_EPOLL
 
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <time.h>
+#include <unistd.h>
+
 #include "iree/base/internal/wait_handle_posix.h"
 #include "iree/base/tracing.h"
 
+//===----------------------------------------------------------------------===//
+// Platform utilities
+//===----------------------------------------------------------------------===//
+
+// epoll_wait only takes a millisecond timeout. To avoid waking before the
+// deadline and spinning we round partial milliseconds up; waits that need
+// precise deadlines should prefer a single handle and iree_wait_one.
+//
+// epoll_wait may spuriously wake with an EINTR. We don't do anything with that
+// opportunity (no fancy signal stuff), but we do need to retry the wait and
+// ensure that we do so with an updated timeout based on the deadline.
+//
+// Documentation: https://man7.org/linux/man-pages/man2/epoll_wait.2.html
+static int iree_epoll_timeout_ms(iree_time_t deadline_ns) {
+  if (deadline_ns == IREE_TIME_INFINITE_PAST) {
+    return 0;  // block never
+  } else if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+    return -1;  // block forever
+  }
+  iree_duration_t timeout_ns = deadline_ns - iree_time_now();
+  if (timeout_ns <= 0) return 0;
+  iree_duration_t timeout_ms = (timeout_ns + 1000000 - 1) / 1000000;
+  return timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms;
+}
+
+static iree_status_t iree_syscall_epoll_wait(int epoll_fd,
+                                             struct epoll_event* events,
+                                             int max_events,
+                                             iree_time_t deadline_ns,
+                                             int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    rv = epoll_wait(epoll_fd, events, max_events,
+                    iree_epoll_timeout_ms(deadline_ns));
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (IREE_UNLIKELY(rv < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_wait failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Maps an epoll event bitfield result to a status (on failure) and an
+// indicator of whether the event was signaled.
+static iree_status_t iree_wait_set_resolve_epoll_events(uint32_t events,
+                                                        bool* out_signaled) {
+  if (events & EPOLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "EPOLLERR on fd");
+  } else if (events & EPOLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "EPOLLHUP on fd");
+  }
+  *out_signaled = (events & EPOLLIN) != 0;
+  return iree_ok_status();
+}
+
+// ppoll is used for the single handle and wait-all cases where it avoids
+// changing the epoll registration. Loops on EINTR with an updated timeout.
+//
+// Documentation: http://man7.org/linux/man-pages/man2/poll.2.html
+static iree_status_t iree_syscall_ppoll(struct pollfd* fds, nfds_t nfds,
+                                        iree_time_t deadline_ns,
+                                        int* out_signaled_count) {
+  *out_signaled_count = 0;
+  int rv = -1;
+  do {
+    // Convert the deadline into a tmo_p struct for ppoll; this must be done
+    // every iteration as a previous ppoll may have taken some of the time.
+    struct timespec timeout_ts;
+    struct timespec* tmo_p = &timeout_ts;
+    if (deadline_ns == IREE_TIME_INFINITE_FUTURE) {
+      tmo_p = NULL;  // block forever
+    } else {
+      iree_duration_t timeout_ns = deadline_ns == IREE_TIME_INFINITE_PAST
+                                       ? 0
+                                       : deadline_ns - iree_time_now();
+      if (timeout_ns < 0) timeout_ns = 0;
+      timeout_ts.tv_sec = (time_t)(timeout_ns / 1000000000ull);
+      timeout_ts.tv_nsec = (long)(timeout_ns % 1000000000ull);
+    }
+    rv = ppoll(fds, nfds, tmo_p, NULL);
+  } while (rv < 0 && errno == EINTR);
+  if (rv > 0) {
+    // One or more events set.
+    *out_signaled_count = rv;
+    return iree_ok_status();
+  } else if (IREE_UNLIKELY(rv < 0)) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "ppoll failure %d", errno);
+  }
+  // rv == 0
+  // Timeout; no events set.
+  return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+}
+
+// Maps a poll revent bitfield result to a status (on failure) and an indicator
+// of whether the event was signaled.
+static iree_status_t iree_wait_set_resolve_poll_events(short revents,
+                                                       bool* out_signaled) {
+  if (revents & POLLERR) {
+    return iree_make_status(IREE_STATUS_INTERNAL, "POLLERR on fd");
+  } else if (revents & POLLHUP) {
+    return iree_make_status(IREE_STATUS_CANCELLED, "POLLHUP on fd");
+  } else if (revents & POLLNVAL) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "POLLNVAL on fd");
+  }
+  *out_signaled = (revents & POLLIN) != 0;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_wait_set_t
 //===----------------------------------------------------------------------===//
 
-// TODO(benvanik): iree_wait_set_s using an epoll fd.
-// epoll lets us route the wait set operations right to kernel and not need our
-// own duplicate data structure. epoll is great, just not available on mac/ios
-// so we still need poll for that. linux/android/bsd all have epoll, though.
+// A registered handle within the set.
+// Slots never move once assigned so that the slot index can be stored as the
+// epoll user data and handles resolved in O(1) when woken.
+typedef struct {
+  // User-provided handle. |handle.set_internal.dupe_count| tracks how many
+  // additional times the handle has been inserted. The slot is free if the
+  // handle type is 0.
+  iree_wait_handle_t handle;
+  // Native fd registered with epoll.
+  int fd;
+} iree_wait_set_slot_t;
+
+// epoll lets us route the wait set operations right to the kernel: handles are
+// registered once on insert and only the signaled ones are returned from each
+// wait instead of the entire list being passed in and scanned each time as
+// with poll. epoll is great, just not available on mac/ios so we still need
+// poll for that.
 struct iree_wait_set_s {
-  // NOTE: we could in theory use the epoll handle directly (iree_wait_set_s
-  // then is just a pointer). Then allocate/free just go straight to the system.
-  int reserved;
+  iree_allocator_t allocator;
+
+  // epoll instance holding all registered fds.
+  int epoll_fd;
+
+  // Total capacity of the slot list.
+  iree_host_size_t handle_capacity;
+
+  // Total number of slots in use (unique handles in the set).
+  iree_host_size_t handle_count;
+
+  // Slots for each unique handle in the set.
+  iree_wait_set_slot_t* slots;
+
+  // Stack of free slot indices; the top |free_count| entries are valid.
+  uint16_t* free_slots;
+  iree_host_size_t free_count;
+
+  // Scratch storage receiving events from epoll_wait.
+  struct epoll_event* events;
+
+  // Scratch storage for the fds polled by iree_wait_all.
+  struct pollfd* poll_fds;
 };
 
 iree_status_t iree_wait_set_allocate(iree_host_size_t capacity,
                                      iree_allocator_t allocator,
                                      iree_wait_set_t** out_set) {
-  // TODO(benvanik): epoll_create()
+  // Be reasonable; 64K objects is too high (and our slot indices are 16-bit).
+  if (capacity >= UINT16_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "wait set capacity of %zu is unreasonably large",
+                            capacity);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t slot_list_size = capacity * sizeof(iree_wait_set_slot_t);
+  iree_host_size_t event_list_size = capacity * sizeof(struct epoll_event);
+  iree_host_size_t poll_fd_list_size = capacity * sizeof(struct pollfd);
+  iree_host_size_t free_list_size = capacity * sizeof(uint16_t);
+  iree_host_size_t total_size = sizeof(iree_wait_set_t) + slot_list_size +
+                                event_list_size + poll_fd_list_size +
+                                free_list_size;
+
+  iree_wait_set_t* set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&set));
+  set->allocator = allocator;
+  set->handle_capacity = capacity;
+  set->slots = (iree_wait_set_slot_t*)((uint8_t*)set + sizeof(iree_wait_set_t));
+  set->events = (struct epoll_event*)((uint8_t*)set->slots + slot_list_size);
+  set->poll_fds = (struct pollfd*)((uint8_t*)set->events + event_list_size);
+  set->free_slots =
+      (uint16_t*)((uint8_t*)set->poll_fds + poll_fd_list_size);
+
+  set->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (IREE_UNLIKELY(set->epoll_fd < 0)) {
+    iree_status_t status = iree_make_status(
+        iree_status_code_from_errno(errno), "epoll_create1 failure %d", errno);
+    iree_allocator_free(allocator, set);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Reset slot tracking; nothing is registered with the new epoll fd yet.
+  set->handle_count = 0;
+  set->free_count = capacity;
+  for (iree_host_size_t i = 0; i < capacity; ++i) {
+    set->slots[i].handle.type = 0;
+    set->free_slots[i] = (uint16_t)(capacity - i - 1);
+  }
+
+  *out_set = set;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 void iree_wait_set_free(iree_wait_set_t* set) {
-  // TODO(benvanik): close()
+  close(set->epoll_fd);
+  iree_allocator_free(set->allocator, set);
+}
+
+// Finds the slot holding |handle| using |hint_index| if valid.
+// Returns -1 if not found.
+static int iree_wait_set_find_slot(iree_wait_set_t* set,
+                                   const iree_wait_handle_t* handle,
+                                   iree_host_size_t hint_index) {
+  if (hint_index < set->handle_capacity &&
+      set->slots[hint_index].handle.type != 0 &&
+      iree_wait_primitive_compare_identical(&set->slots[hint_index].handle,
+                                            handle)) {
+    return (int)hint_index;
+  }
+  // Fallback to a linear scan; this is only needed for erasing handles that
+  // didn't come from a wake and when inserting duplicates.
+  for (iree_host_size_t i = 0; i < set->handle_capacity; ++i) {
+    if (set->slots[i].handle.type != 0 &&
+        iree_wait_primitive_compare_identical(&set->slots[i].handle, handle)) {
+      return (int)i;
+    }
+  }
+  return -1;
 }
 
 iree_status_t iree_wait_set_insert(iree_wait_set_t* set,
                                    iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_ADD)
+  if (set->free_count == 0) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "wait set capacity reached");
+  }
+  int fd = iree_wait_primitive_get_read_fd(&handle);
+  if (fd == -1) {
+    // Handles without an fd (such as immediately resolved ones) never need to
+    // be waited on. poll ignores negative fds but epoll_ctl rejects them.
+    return iree_ok_status();
+  }
+
+  // Register the fd with the slot index as the event user data. If the fd is
+  // already registered then this is a duplicate insertion of an existing
+  // handle and we track the count instead (epoll only allows one registration
+  // per fd).
+  uint16_t slot_index = set->free_slots[set->free_count - 1];
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN | EPOLLPRI;  // implicit EPOLLERR | EPOLLHUP
+  event.data.u32 = slot_index;
+  if (epoll_ctl(set->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+    if (errno == EEXIST) {
+      int existing_index = iree_wait_set_find_slot(set, &handle, UINT16_MAX);
+      if (existing_index >= 0) {
+        ++set->slots[existing_index].handle.set_internal.dupe_count;
+        return iree_ok_status();
+      }
+    }
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "epoll_ctl add failure %d", errno);
+  }
+
+  --set->free_count;
+  ++set->handle_count;
+  iree_wait_set_slot_t* slot = &set->slots[slot_index];
+  memcpy(&slot->handle, &handle, sizeof(slot->handle));
+  slot->handle.set_internal.dupe_count = 0;
+  slot->fd = fd;
+  return iree_ok_status();
+}
+
+// Unregisters the handle in |slot_index| and returns the slot to the free list.
+static void iree_wait_set_release_slot(iree_wait_set_t* set,
+                                       iree_host_size_t slot_index) {
+  iree_wait_set_slot_t* slot = &set->slots[slot_index];
+  epoll_ctl(set->epoll_fd, EPOLL_CTL_DEL, slot->fd, NULL);
+  slot->handle.type = 0;
+  set->free_slots[set->free_count++] = (uint16_t)slot_index;
+  --set->handle_count;
 }
 
 void iree_wait_set_erase(iree_wait_set_t* set, iree_wait_handle_t handle) {
-  // TODO(benvanik): epoll_ctl(EPOLL_CTL_DEL)
+  // Wake handles returned from iree_wait_any carry their slot index so that
+  // the common wait-wake-erase pattern needs no scan.
+  int slot_index =
+      iree_wait_set_find_slot(set, &handle, handle.set_internal.index);
+  if (IREE_UNLIKELY(slot_index < 0)) return;
+  iree_wait_set_slot_t* slot = &set->slots[slot_index];
+  if (slot->handle.set_internal.dupe_count > 0) {
+    --slot->handle.set_internal.dupe_count;
+    return;
+  }
+  iree_wait_set_release_slot(set, slot_index);
 }
 
 void iree_wait_set_clear(iree_wait_set_t* set) {
-  // TODO(benvanik): close and reopen?
+  for (iree_host_size_t i = 0;
+       i < set->handle_capacity && set->handle_count > 0; ++i) {
+    if (set->slots[i].handle.type != 0) {
+      iree_wait_set_release_slot(set, i);
+    }
+  }
 }
 
 iree_status_t iree_wait_all(iree_wait_set_t* set, iree_time_t deadline_ns) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Wait-all requires that we repeatedly wait until all handles have been
+  // signaled. epoll is level-triggered and would keep returning handles that
+  // have already signaled unless we modified their registration (twice per
+  // handle per wait) so instead we ppoll a scratch list of the fds and drop
+  // each one from the list as it signals. wait-any is the common case and
+  // keeps the epoll registration untouched.
+  nfds_t poll_fd_count = 0;
+  for (iree_host_size_t i = 0; i < set->handle_capacity; ++i) {
+    if (set->slots[i].handle.type == 0) continue;
+    struct pollfd* poll_fd = &set->poll_fds[poll_fd_count++];
+    poll_fd->fd = set->slots[i].fd;
+    poll_fd->events = POLLIN | POLLPRI;
+    poll_fd->revents = 0;
+  }
+
+  iree_status_t status = iree_ok_status();
+  while (poll_fd_count > 0) {
+    int signaled_count = 0;
+    status = iree_syscall_ppoll(set->poll_fds, poll_fd_count, deadline_ns,
+                                &signaled_count);
+    if (!iree_status_is_ok(status)) break;
+
+    // Swap-remove any that have resolved.
+    for (nfds_t i = 0; i < poll_fd_count;) {
+      bool signaled = false;
+      status = iree_wait_set_resolve_poll_events(set->poll_fds[i].revents,
+                                                 &signaled);
+      if (!iree_status_is_ok(status)) break;
+      if (signaled) {
+        set->poll_fds[i] = set->poll_fds[--poll_fd_count];
+      } else {
+        set->poll_fds[i++].revents = 0;
+      }
+    }
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 iree_status_t iree_wait_any(iree_wait_set_t* set, iree_time_t deadline_ns,
                             iree_wait_handle_t* out_wake_handle) {
-  // TODO(benvanik): epoll_wait
+  // Make the syscall only when we have at least one valid fd.
+  // Don't use this as a sleep.
+  if (set->handle_count <= 0) {
+    memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // We only need one signaled handle and the kernel hands us exactly that; no
+  // scanning required.
+  int signaled_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_syscall_epoll_wait(set->epoll_fd, set->events, /*max_events=*/1,
+                                  deadline_ns, &signaled_count));
+
+  memset(out_wake_handle, 0, sizeof(*out_wake_handle));
+  if (signaled_count > 0) {
+    bool signaled = false;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0,
+        iree_wait_set_resolve_epoll_events(set->events[0].events, &signaled));
+    if (signaled) {
+      uint32_t slot_index = set->events[0].data.u32;
+      memcpy(out_wake_handle, &set->slots[slot_index].handle,
+             sizeof(*out_wake_handle));
+      out_wake_handle->set_internal.index = slot_index;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_wait_one(iree_wait_handle_t* handle,
                             iree_time_t deadline_ns) {
-  // TODO(benvanik): just use poll?
+  // A single handle doesn't benefit from an epoll set (and creating one would
+  // need additional syscalls) so we just ppoll it directly.
+  struct pollfd poll_fd;
+  poll_fd.fd = iree_wait_primitive_get_read_fd(handle);
+  if (poll_fd.fd == -1) return iree_ok_status();
+  poll_fd.events = POLLIN;
+  poll_fd.revents = 0;
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int signaled_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_syscall_ppoll(&poll_fd, 1, deadline_ns, &signaled_count));
+
+  IREE_TRACE_ZONE_END(z0);
+  return signaled_count ? iree_ok_status()
+                        : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
 }
 
 #endif  // IREE_WAIT_API == IREE_WAIT_API_EPOLL
@@ -37,15 +37,23 @@
 #define IREE_WAIT_API_KQUEUE 4
 
 // NOTE: we could be tighter here, but we today only have win32 or not-win32.
-#if defined(IREE_PLATFORM_WINDOWS)
+// Builds may define IREE_WAIT_API to one of the above to override the
+// selection (such as to compare backends on the same platform).
+#if defined(IREE_WAIT_API)
+// Explicitly selected by the build.
+#elif defined(IREE_PLATFORM_WINDOWS)
 #define IREE_WAIT_API 0  // WFMO used in wait_handle_win32.c
 #else
 
-// TODO(benvanik): EPOLL on android/linux/bsd/etc.
+// TODO(benvanik): EPOLL on bsd/etc.
 // TODO(benvanik): KQUEUE on mac/ios.
 // KQUEUE is not implemented yet. Use POLL for mac/ios
-// Android ppoll requires API version >= 21
-#if !defined(IREE_PLATFORM_APPLE) && !defined(__EMSCRIPTEN__) && \
+// Android ppoll and epoll_create1 require API version >= 21
+#if (defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)) && \
+    !defined(__EMSCRIPTEN__) &&                                          \
+    (!defined(__ANDROID_API__) || __ANDROID_API__ >= 21)
+#define IREE_WAIT_API IREE_WAIT_API_EPOLL
+#elif !defined(IREE_PLATFORM_APPLE) && !defined(__EMSCRIPTEN__) && \
     (!defined(__ANDROID_API__) || __ANDROID_API__ >= 21)
 #define IREE_WAIT_API IREE_WAIT_API_PPOLL
 #else
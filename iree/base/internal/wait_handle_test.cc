@@ -750,6 +750,31 @@ TEST(WaitSet, WaitAnyEraseSplit) {
   iree_event_deinitialize(&ev_set);
 }
 
+// Tests that handles without a native fd are treated as already resolved.
+TEST(WaitSet, ImmediateHandles) {
+  iree_wait_handle_t immediate;
+  memset(&immediate, 0, sizeof(immediate));
+  IREE_ASSERT_OK(iree_wait_one(&immediate, IREE_TIME_INFINITE_PAST));
+
+  iree_event_t ev_set;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/true, &ev_set));
+  iree_wait_set_t* wait_set = NULL;
+  IREE_ASSERT_OK(
+      iree_wait_set_allocate(128, iree_allocator_system(), &wait_set));
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, immediate));
+  IREE_ASSERT_OK(iree_wait_set_insert(wait_set, ev_set));
+
+  IREE_ASSERT_OK(iree_wait_all(wait_set, IREE_TIME_INFINITE_PAST));
+  iree_wait_handle_t wake_handle;
+  IREE_ASSERT_OK(
+      iree_wait_any(wait_set, IREE_TIME_INFINITE_PAST, &wake_handle));
+  EXPECT_EQ(0, memcmp(&ev_set.value, &wake_handle.value, sizeof(ev_set.value)));
+
+  iree_wait_set_erase(wait_set, immediate);
+  iree_wait_set_free(wait_set);
+  iree_event_deinitialize(&ev_set);
+}
+
 // Tests iree_wait_one when polling (deadline_ns = IREE_TIME_INFINITE_PAST).
 TEST(WaitSet, WaitOnePolling) {
   iree_event_t ev_unset, ev_set;
@@ -0,0 +1,67 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/dynamic_library.h"
+#include "iree/base/internal/file_io.h"
+#include "iree/base/testing/dynamic_library_test_library_embed.h"
+
+// Measures the time to load (and unload) a small shared object from memory.
+// iree_dynamic_library_load_from_memory loads through an anonymous memfd where
+// supported and falls back to extracting a temp file otherwise;
+// BM_LoadFromTempFile performs the temp file path explicitly for comparison.
+// Point TMPDIR at slow storage to see the effect on the fallback.
+
+namespace {
+
+iree_const_byte_span_t GetLibraryData() {
+  const struct iree_file_toc_t* file_toc =
+      dynamic_library_test_library_create();
+  return iree_make_const_byte_span(file_toc->data, file_toc->size);
+}
+
+void BM_LoadFromMemory(benchmark::State& state) {
+  iree_const_byte_span_t library_data = GetLibraryData();
+  for (auto _ : state) {
+    iree_dynamic_library_t* library = NULL;
+    IREE_CHECK_OK(iree_dynamic_library_load_from_memory(
+        iree_make_cstring_view("benchmark"), library_data,
+        IREE_DYNAMIC_LIBRARY_FLAG_NONE, iree_allocator_system(), &library));
+    iree_dynamic_library_release(library);
+  }
+  state.SetBytesProcessed(state.iterations() * library_data.data_length);
+}
+BENCHMARK(BM_LoadFromMemory)->UseRealTime();
+
+void BM_LoadFromTempFile(benchmark::State& state) {
+  iree_const_byte_span_t library_data = GetLibraryData();
+  const char* tmpdir = getenv("TEST_TMPDIR");
+  if (!tmpdir) tmpdir = getenv("TMPDIR");
+  if (!tmpdir) tmpdir = "/tmp";
+  int unique_id = 0;
+  for (auto _ : state) {
+    // Each iteration uses a new path so that the loader cannot reuse a
+    // previously loaded library, matching what the memory path does.
+    std::string path = std::string(tmpdir) + "/iree_dylib_benchmark_" +
+                       std::to_string(unique_id++) + ".so";
+    IREE_CHECK_OK(iree_file_write_contents(path.c_str(), library_data));
+    iree_dynamic_library_t* library = NULL;
+    IREE_CHECK_OK(iree_dynamic_library_load_from_file(
+        path.c_str(), IREE_DYNAMIC_LIBRARY_FLAG_NONE, iree_allocator_system(),
+        &library));
+    remove(path.c_str());
+    iree_dynamic_library_release(library);
+  }
+  state.SetBytesProcessed(state.iterations() * library_data.data_length);
+}
+BENCHMARK(BM_LoadFromTempFile)->UseRealTime();
+
+}  // namespace
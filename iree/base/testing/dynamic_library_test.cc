@@ -11,6 +11,7 @@
 #include "iree/base/internal/file_io.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/testing/dynamic_library_test_library_embed.h"
+#include "iree/base/testing/dynamic_library_test_other_library_embed.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -97,6 +98,63 @@ TEST_F(DynamicLibraryTest, LoadLibraryTwice) {
   iree_dynamic_library_release(library2);
 }
 
+TEST_F(DynamicLibraryTest, LoadLibraryFromMemory) {
+  const struct iree_file_toc_t* file_toc =
+      dynamic_library_test_library_create();
+  iree_dynamic_library_t* library = NULL;
+  IREE_ASSERT_OK(iree_dynamic_library_load_from_memory(
+      iree_make_cstring_view("test"),
+      iree_make_const_byte_span(file_toc->data, file_toc->size),
+      IREE_DYNAMIC_LIBRARY_FLAG_NONE, iree_allocator_system(), &library));
+
+  int (*fn_ptr)(int);
+  IREE_ASSERT_OK(iree_dynamic_library_lookup_symbol(library, "times_two",
+                                                    (void**)&fn_ptr));
+  ASSERT_NE(nullptr, fn_ptr);
+  EXPECT_EQ(246, fn_ptr(123));
+
+  iree_dynamic_library_release(library);
+}
+
+// Distinct libraries loaded from memory at the same time must not alias.
+TEST_F(DynamicLibraryTest, LoadDistinctLibrariesFromMemory) {
+  const struct iree_file_toc_t* file_toc =
+      dynamic_library_test_library_create();
+  iree_dynamic_library_t* library = NULL;
+  IREE_ASSERT_OK(iree_dynamic_library_load_from_memory(
+      iree_make_cstring_view("test"),
+      iree_make_const_byte_span(file_toc->data, file_toc->size),
+      IREE_DYNAMIC_LIBRARY_FLAG_NONE, iree_allocator_system(), &library));
+  const struct iree_file_toc_t* other_file_toc =
+      dynamic_library_test_other_library_create();
+  iree_dynamic_library_t* other_library = NULL;
+  IREE_ASSERT_OK(iree_dynamic_library_load_from_memory(
+      iree_make_cstring_view("other"),
+      iree_make_const_byte_span(other_file_toc->data, other_file_toc->size),
+      IREE_DYNAMIC_LIBRARY_FLAG_NONE, iree_allocator_system(), &other_library));
+
+  int (*times_two)(int) = NULL;
+  IREE_ASSERT_OK(iree_dynamic_library_lookup_symbol(library, "times_two",
+                                                    (void**)&times_two));
+  EXPECT_EQ(246, times_two(123));
+  int (*times_three)(int) = NULL;
+  IREE_ASSERT_OK(iree_dynamic_library_lookup_symbol(
+      other_library, "times_three", (void**)&times_three));
+  EXPECT_EQ(369, times_three(123));
+
+  iree_status_t status = iree_dynamic_library_lookup_symbol(
+      library, "times_three", (void**)&times_three);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND, status);
+  iree_status_free(status);
+  status = iree_dynamic_library_lookup_symbol(other_library, "times_two",
+                                              (void**)&times_two);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_NOT_FOUND, status);
+  iree_status_free(status);
+
+  iree_dynamic_library_release(other_library);
+  iree_dynamic_library_release(library);
+}
+
 TEST_F(DynamicLibraryTest, GetSymbolSuccess) {
   iree_dynamic_library_t* library = NULL;
   IREE_ASSERT_OK(iree_dynamic_library_load_from_file(
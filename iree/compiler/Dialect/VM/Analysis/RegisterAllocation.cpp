@@ -15,6 +15,7 @@
 #include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -533,8 +534,12 @@ RegisterAllocation::remapSuccessorRegisters(Operation *op, int successorIndex) {
       scratchReg =
           Register::getWithSameType(feedbackEdge.first, ++scratchRefReg);
     } else {
-      scratchReg =
-          Register::getWithSameType(feedbackEdge.first, ++scratchI32Reg);
+      // 64-bit values need an aligned span of two i32 registers.
+      int ordinalCount = feedbackEdge.first.byteWidth() == 8 ? 2 : 1;
+      int ordinal =
+          static_cast<int>(llvm::alignTo(scratchI32Reg + 1, ordinalCount));
+      scratchReg = Register::getWithSameType(feedbackEdge.first, ordinal);
+      scratchI32Reg = ordinal + ordinalCount - 1;
     }
     feedbackArcSet.acyclicEdges.insert(feedbackArcSet.acyclicEdges.begin(),
                                        {feedbackEdge.first, scratchReg});
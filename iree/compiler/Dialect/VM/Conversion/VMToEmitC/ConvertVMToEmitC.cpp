@@ -67,6 +67,23 @@ GlobalOpTy lookupGlobalOp(AccessOpTy accessOp) {
   return globalOp;
 }
 
+// Returns the ordinal of the ref register allocated to |value|. Refs are held
+// in the local_refs array of the generated function instead of individual
+// variables, which makes releasing them on every exit path easier.
+FailureOr<int32_t> getRefRegisterOrdinal(Operation *op, Value value) {
+  // TODO(simon-camp): This is expensive as we recalculate the
+  // RegisterAllocation for every ref producing op in a function. We could make
+  // it compatible with the analysis framework in MLIR which would cache it
+  // automatically IIUC. See here for reference
+  // https://mlir.llvm.org/docs/PassManagement/#analysis-management
+  auto funcOp = op->getParentOfType<IREE::VM::FuncOp>();
+  RegisterAllocation registerAllocation;
+  if (failed(registerAllocation.recalculate(funcOp))) {
+    return op->emitOpError() << "unable to perform register allocation";
+  }
+  return registerAllocation.mapToRegister(value).ordinal();
+}
+
 // Convert vm operations to emitc calls. The resultiong call has the ops
 // operands as arguments followed by an argument for every attribute.
 template <typename SrcOpTy>
@@ -249,6 +266,125 @@ class GlobalStoreOpConversion : public OpConversionPattern<StoreOpTy> {
   StringRef funcName;
 };
 
+// Returns the address of the global ref with the given |globalOp| ordinal in
+// the module state.
+template <typename GlobalOpTy>
+emitc::CallOp globalRefAddress(ConversionPatternRewriter &rewriter,
+                               Location loc, GlobalOpTy globalOp) {
+  auto ctx = rewriter.getContext();
+  // TODO(simon-camp): We can't represent structs in emitc (yet maybe), so
+  // the array where global refs live after code generation as well as the
+  // state struct argument name are hardcoded here.
+  return rewriter.create<emitc::CallOp>(
+      /*location=*/loc,
+      /*type=*/emitc::OpaqueType::get(ctx, "iree_vm_ref_t*"),
+      /*callee=*/rewriter.getStringAttr("VM_ARRAY_ELEMENT_ADDRESS"),
+      /*args=*/
+      ArrayAttr::get(ctx,
+                     {emitc::OpaqueAttr::get(ctx, "state->refs"),
+                      rewriter.getI32IntegerAttr(static_cast<int32_t>(
+                          globalOp.ordinal().getValue().getZExtValue()))}),
+      /*templateArgs=*/ArrayAttr{},
+      /*operands=*/ArrayRef<Value>{});
+}
+
+// Convert vm.global.load.ref to a retain of the global into the ref register of
+// the result.
+class GlobalLoadRefOpConversion
+    : public OpConversionPattern<IREE::VM::GlobalLoadRefOp> {
+  using OpConversionPattern<IREE::VM::GlobalLoadRefOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::VM::GlobalLoadRefOp loadOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = loadOp.getContext();
+    auto loc = loadOp.getLoc();
+
+    auto globalOp =
+        lookupGlobalOp<IREE::VM::GlobalLoadRefOp, IREE::VM::GlobalRefOp>(
+            loadOp);
+    if (!globalOp) {
+      return loadOp.emitError() << "Unable to find GlobalOp";
+    }
+
+    auto ordinal = getRefRegisterOrdinal(loadOp, loadOp.value());
+    if (failed(ordinal)) {
+      return failure();
+    }
+
+    auto refPtrOp = rewriter.replaceOpWithNewOp<emitc::CallOp>(
+        /*op=*/loadOp,
+        /*type=*/emitc::OpaqueType::get(ctx, "iree_vm_ref_t*"),
+        /*callee=*/rewriter.getStringAttr("VM_ARRAY_ELEMENT_ADDRESS"),
+        /*args=*/
+        ArrayAttr::get(ctx, {emitc::OpaqueAttr::get(ctx, "local_refs"),
+                             rewriter.getI32IntegerAttr(*ordinal)}),
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/ArrayRef<Value>{});
+
+    auto globalRefPtrOp = globalRefAddress(rewriter, loc, globalOp);
+
+    rewriter.create<emitc::CallOp>(
+        /*location=*/loc,
+        /*type=*/TypeRange{},
+        /*callee=*/rewriter.getStringAttr("iree_vm_ref_retain"),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/
+        ArrayRef<Value>{globalRefPtrOp.getResult(0), refPtrOp.getResult(0)});
+
+    return success();
+  }
+};
+
+// Convert vm.global.store.ref to a retain of the value into the global. The
+// previous value of the global is released.
+class GlobalStoreRefOpConversion
+    : public OpConversionPattern<IREE::VM::GlobalStoreRefOp> {
+  using OpConversionPattern<IREE::VM::GlobalStoreRefOp>::OpConversionPattern;
+
+ private:
+  LogicalResult matchAndRewrite(
+      IREE::VM::GlobalStoreRefOp storeOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto ctx = storeOp.getContext();
+    auto loc = storeOp.getLoc();
+
+    auto globalOp =
+        lookupGlobalOp<IREE::VM::GlobalStoreRefOp, IREE::VM::GlobalRefOp>(
+            storeOp);
+    if (!globalOp) {
+      return storeOp.emitError() << "Unable to find GlobalOp";
+    }
+
+    // Null refs are materialized as values instead of register addresses.
+    Value valuePtr = operands[0];
+    auto valueType = valuePtr.getType().dyn_cast<emitc::OpaqueType>();
+    if (valueType && valueType.getValue() == "iree_vm_ref_t") {
+      auto applyOp = rewriter.create<emitc::ApplyOp>(
+          /*location=*/loc,
+          /*result=*/emitc::OpaqueType::get(ctx, "iree_vm_ref_t*"),
+          /*applicableOperator=*/rewriter.getStringAttr("&"),
+          /*operand=*/valuePtr);
+      valuePtr = applyOp.getResult();
+    }
+
+    auto globalRefPtrOp = globalRefAddress(rewriter, loc, globalOp);
+
+    rewriter.replaceOpWithNewOp<emitc::CallOp>(
+        /*op=*/storeOp,
+        /*type=*/TypeRange{},
+        /*callee=*/rewriter.getStringAttr("iree_vm_ref_retain"),
+        /*args=*/ArrayAttr{},
+        /*templateArgs=*/ArrayAttr{},
+        /*operands=*/
+        ArrayRef<Value>{valuePtr, globalRefPtrOp.getResult(0)});
+
+    return success();
+  }
+};
+
 // Convert vm list operations to two emitc calls. The wrapping ref pointer is
 // first dereferenced and the result is used as the argument of the specified
 // function name.
@@ -382,6 +518,11 @@ class ListAllocOpConversion
       elementTypeStr =
           std::string("IREE_VM_VALUE_TYPE_I") + std::to_string(bitWidth);
       elementTypeConstructor = "iree_vm_type_def_make_value_type";
+    } else if (elementType.isa<FloatType>()) {
+      unsigned int bitWidth = elementType.getIntOrFloatBitWidth();
+      elementTypeStr =
+          std::string("IREE_VM_VALUE_TYPE_F") + std::to_string(bitWidth);
+      elementTypeConstructor = "iree_vm_type_def_make_value_type";
     } else {
       return allocOp.emitError() << "Unhandeled element type " << elementType;
     }
@@ -425,27 +566,18 @@ class ListAllocOpConversion
         ArrayRef<Value>{elementTypePtrOp.getResult(), operands[0],
                         listPtrOp.getResult()});
 
-    // TODO(simon-camp): This is expensive as we recalculate the
-    // RegisterAllocation for every alloc in a function. We could make it
-    // compatible with the analysis framework in MLIR which would cache it
-    // automatically IIUC. See here for reference
-    // https://mlir.llvm.org/docs/PassManagement/#analysis-management
-    auto funcOp = allocOp.getOperation()->getParentOfType<IREE::VM::FuncOp>();
-    RegisterAllocation registerAllocation;
-    if (failed(registerAllocation.recalculate(funcOp))) {
-      return allocOp.emitOpError() << "unable to perform register allocation";
+    auto ordinal = getRefRegisterOrdinal(allocOp, allocOp.getResult());
+    if (failed(ordinal)) {
+      return failure();
     }
 
-    int32_t ordinal =
-        registerAllocation.mapToRegister(allocOp.getResult()).ordinal();
-
     auto refPtrOp = rewriter.replaceOpWithNewOp<emitc::CallOp>(
         /*op=*/allocOp,
         /*type=*/emitc::OpaqueType::get(ctx, "iree_vm_ref_t*"),
         /*callee=*/rewriter.getStringAttr("VM_ARRAY_ELEMENT_ADDRESS"),
         /*args=*/
         ArrayAttr::get(ctx, {emitc::OpaqueAttr::get(ctx, "local_refs"),
-                             rewriter.getI32IntegerAttr(ordinal)}),
+                             rewriter.getI32IntegerAttr(*ordinal)}),
         /*templateArgs=*/ArrayAttr{},
         /*operands=*/ArrayRef<Value>{});
 
@@ -497,6 +629,14 @@ class ListGetOpConversion : public OpConversionPattern<GetOpTy> {
               return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_I64"),
                                     StringRef("iree_vm_value_get_i64"));
             })
+            .template Case<IREE::VM::ListGetF32Op>([&](auto op) {
+              return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_F32"),
+                                    StringRef("iree_vm_value_get_f32"));
+            })
+            .template Case<IREE::VM::ListGetF64Op>([&](auto op) {
+              return std::make_pair(StringRef("IREE_VM_VALUE_TYPE_F64"),
+                                    StringRef("iree_vm_value_get_f64"));
+            })
             .Default([](Operation *) { return std::make_pair(None, None); });
 
     if (!valueTypeEnum.hasValue() || !valueExtractor.hasValue()) {
@@ -581,6 +721,10 @@ class ListSetOpConversion : public OpConversionPattern<SetOpTy> {
                 [&](auto op) { return StringRef("iree_vm_value_make_i32"); })
             .template Case<IREE::VM::ListSetI64Op>(
                 [&](auto op) { return StringRef("iree_vm_value_make_i64"); })
+            .template Case<IREE::VM::ListSetF32Op>(
+                [&](auto op) { return StringRef("iree_vm_value_make_f32"); })
+            .template Case<IREE::VM::ListSetF64Op>(
+                [&](auto op) { return StringRef("iree_vm_value_make_f64"); })
             .Default([](Operation *) { return None; });
 
     if (!valueConstructor.hasValue()) {
@@ -651,6 +795,8 @@ void populateVMToCPatterns(MLIRContext *context,
   patterns.insert<GlobalStoreOpConversion<IREE::VM::GlobalStoreI32Op,
                                           IREE::VM::GlobalI32Op>>(
       context, "vm_global_store_i32");
+  patterns.insert<GlobalLoadRefOpConversion>(context);
+  patterns.insert<GlobalStoreRefOpConversion>(context);
 
   // Constants
   patterns.insert<ConstOpConversion<IREE::VM::ConstI32Op>>(context);
@@ -723,10 +869,26 @@ void populateVMToCPatterns(MLIRContext *context,
   patterns.insert<CallOpConversion<IREE::VM::CmpNZI32Op>>(context,
                                                           "vm_cmp_nz_i32");
 
+  // ExtF32: Globals
+  patterns.insert<
+      GlobalLoadOpConversion<IREE::VM::GlobalLoadF32Op, IREE::VM::GlobalF32Op>>(
+      context, "vm_global_load_f32");
+  patterns.insert<GlobalStoreOpConversion<IREE::VM::GlobalStoreF32Op,
+                                          IREE::VM::GlobalF32Op>>(
+      context, "vm_global_store_f32");
+
   // ExtF32: Native floating-point constants
   patterns.insert<ConstOpConversion<IREE::VM::ConstF32Op>>(context);
   patterns.insert<ConstZeroOpConversion<IREE::VM::ConstF32ZeroOp>>(context);
 
+  // ExtF32: List ops
+  patterns.insert<ListGetOpConversion<IREE::VM::ListGetF32Op>>(context);
+  patterns.insert<ListSetOpConversion<IREE::VM::ListSetF32Op>>(context);
+
+  // ExtF32: Conditional assignment ops
+  patterns.insert<CallOpConversion<IREE::VM::SelectF32Op>>(context,
+                                                           "vm_select_f32");
+
   // ExtF32: Native floating-point arithmetic
   patterns.insert<CallOpConversion<IREE::VM::AddF32Op>>(context, "vm_add_f32");
   patterns.insert<CallOpConversion<IREE::VM::SubF32Op>>(context, "vm_sub_f32");
@@ -767,6 +929,16 @@ void populateVMToCPatterns(MLIRContext *context,
   patterns.insert<CallOpConversion<IREE::VM::TanhF32Op>>(context,
                                                          "vm_tanh_f32");
 
+  // ExtF32: Casting and type conversion/emulation ops
+  patterns.insert<CallOpConversion<IREE::VM::CastSI32F32Op>>(context,
+                                                             "vm_cast_si32f32");
+  patterns.insert<CallOpConversion<IREE::VM::CastUI32F32Op>>(context,
+                                                             "vm_cast_ui32f32");
+  patterns.insert<CallOpConversion<IREE::VM::CastF32SI32Op>>(context,
+                                                             "vm_cast_f32si32");
+  patterns.insert<CallOpConversion<IREE::VM::CastF32UI32Op>>(context,
+                                                             "vm_cast_f32ui32");
+
   // ExtF32: Comparison ops
   patterns.insert<CallOpConversion<IREE::VM::CmpEQF32OOp>>(context,
                                                            "vm_cmp_eq_f32o");
@@ -787,6 +959,14 @@ void populateVMToCPatterns(MLIRContext *context,
   patterns.insert<CallOpConversion<IREE::VM::CmpNaNF32Op>>(context,
                                                            "vm_cmp_nan_f32");
 
+  // ExtI64: Globals
+  patterns.insert<
+      GlobalLoadOpConversion<IREE::VM::GlobalLoadI64Op, IREE::VM::GlobalI64Op>>(
+      context, "vm_global_load_i64");
+  patterns.insert<GlobalStoreOpConversion<IREE::VM::GlobalStoreI64Op,
+                                          IREE::VM::GlobalI64Op>>(
+      context, "vm_global_store_i64");
+
   // ExtI64: Constants
   patterns.insert<ConstOpConversion<IREE::VM::ConstI64Op>>(context);
   patterns.insert<ConstZeroOpConversion<IREE::VM::ConstI64ZeroOp>>(context);
@@ -842,6 +1022,92 @@ void populateVMToCPatterns(MLIRContext *context,
                                                            "vm_cmp_lt_i64u");
   patterns.insert<CallOpConversion<IREE::VM::CmpNZI64Op>>(context,
                                                           "vm_cmp_nz_i64");
+
+  // ExtF64: Globals
+  patterns.insert<
+      GlobalLoadOpConversion<IREE::VM::GlobalLoadF64Op, IREE::VM::GlobalF64Op>>(
+      context, "vm_global_load_f64");
+  patterns.insert<GlobalStoreOpConversion<IREE::VM::GlobalStoreF64Op,
+                                          IREE::VM::GlobalF64Op>>(
+      context, "vm_global_store_f64");
+
+  // ExtF64: Native floating-point constants
+  patterns.insert<ConstOpConversion<IREE::VM::ConstF64Op>>(context);
+  patterns.insert<ConstZeroOpConversion<IREE::VM::ConstF64ZeroOp>>(context);
+
+  // ExtF64: List ops
+  patterns.insert<ListGetOpConversion<IREE::VM::ListGetF64Op>>(context);
+  patterns.insert<ListSetOpConversion<IREE::VM::ListSetF64Op>>(context);
+
+  // ExtF64: Conditional assignment ops
+  patterns.insert<CallOpConversion<IREE::VM::SelectF64Op>>(context,
+                                                           "vm_select_f64");
+
+  // ExtF64: Native floating-point arithmetic
+  patterns.insert<CallOpConversion<IREE::VM::AddF64Op>>(context, "vm_add_f64");
+  patterns.insert<CallOpConversion<IREE::VM::SubF64Op>>(context, "vm_sub_f64");
+  patterns.insert<CallOpConversion<IREE::VM::MulF64Op>>(context, "vm_mul_f64");
+  patterns.insert<CallOpConversion<IREE::VM::DivF64Op>>(context, "vm_div_f64");
+  patterns.insert<CallOpConversion<IREE::VM::RemF64Op>>(context, "vm_rem_f64");
+  patterns.insert<CallOpConversion<IREE::VM::FMAF64Op>>(context, "vm_fma_f64");
+  patterns.insert<CallOpConversion<IREE::VM::AbsF64Op>>(context, "vm_abs_f64");
+  patterns.insert<CallOpConversion<IREE::VM::NegF64Op>>(context, "vm_neg_f64");
+  patterns.insert<CallOpConversion<IREE::VM::CeilF64Op>>(context,
+                                                         "vm_ceil_f64");
+  patterns.insert<CallOpConversion<IREE::VM::FloorF64Op>>(context,
+                                                          "vm_floor_f64");
+
+  patterns.insert<CallOpConversion<IREE::VM::AtanF64Op>>(context,
+                                                         "vm_atan_f64");
+  patterns.insert<CallOpConversion<IREE::VM::Atan2F64Op>>(context,
+                                                          "vm_atan2_f64");
+  patterns.insert<CallOpConversion<IREE::VM::CosF64Op>>(context, "vm_cos_f64");
+  patterns.insert<CallOpConversion<IREE::VM::SinF64Op>>(context, "vm_sin_f64");
+  patterns.insert<CallOpConversion<IREE::VM::ExpF64Op>>(context, "vm_exp_f64");
+  patterns.insert<CallOpConversion<IREE::VM::Exp2F64Op>>(context,
+                                                         "vm_exp2_f64");
+  patterns.insert<CallOpConversion<IREE::VM::ExpM1F64Op>>(context,
+                                                          "vm_expm1_f64");
+  patterns.insert<CallOpConversion<IREE::VM::LogF64Op>>(context, "vm_log_f64");
+  patterns.insert<CallOpConversion<IREE::VM::Log10F64Op>>(context,
+                                                          "vm_log10_f64");
+  patterns.insert<CallOpConversion<IREE::VM::Log1pF64Op>>(context,
+                                                          "vm_log1p_f64");
+  patterns.insert<CallOpConversion<IREE::VM::Log2F64Op>>(context,
+                                                         "vm_log2_f64");
+  patterns.insert<CallOpConversion<IREE::VM::PowF64Op>>(context, "vm_pow_f64");
+  patterns.insert<CallOpConversion<IREE::VM::RsqrtF64Op>>(context,
+                                                          "vm_rsqrt_f64");
+  patterns.insert<CallOpConversion<IREE::VM::SqrtF64Op>>(context,
+                                                         "vm_sqrt_f64");
+  patterns.insert<CallOpConversion<IREE::VM::TanhF64Op>>(context,
+                                                         "vm_tanh_f64");
+
+  // ExtF64: Casting and type conversion/emulation ops
+  patterns.insert<CallOpConversion<IREE::VM::TruncF64F32Op>>(context,
+                                                             "vm_trunc_f64f32");
+  patterns.insert<CallOpConversion<IREE::VM::ExtF32F64Op>>(context,
+                                                           "vm_ext_f32f64");
+
+  // ExtF64: Comparison ops
+  patterns.insert<CallOpConversion<IREE::VM::CmpEQF64OOp>>(context,
+                                                           "vm_cmp_eq_f64o");
+  patterns.insert<CallOpConversion<IREE::VM::CmpEQF64UOp>>(context,
+                                                           "vm_cmp_eq_f64u");
+  patterns.insert<CallOpConversion<IREE::VM::CmpNEF64OOp>>(context,
+                                                           "vm_cmp_ne_f64o");
+  patterns.insert<CallOpConversion<IREE::VM::CmpNEF64UOp>>(context,
+                                                           "vm_cmp_ne_f64u");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTF64OOp>>(context,
+                                                           "vm_cmp_lt_f64o");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTF64UOp>>(context,
+                                                           "vm_cmp_lt_f64u");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTEF64OOp>>(context,
+                                                            "vm_cmp_lte_f64o");
+  patterns.insert<CallOpConversion<IREE::VM::CmpLTEF64UOp>>(context,
+                                                            "vm_cmp_lte_f64u");
+  patterns.insert<CallOpConversion<IREE::VM::CmpNaNF64Op>>(context,
+                                                           "vm_cmp_nan_f64");
 }
 
 namespace IREE {
@@ -872,7 +1138,12 @@ class ConvertVMToEmitCPass
     target.addLegalOp<IREE::VM::ModuleTerminatorOp>();
     target.addLegalOp<IREE::VM::FuncOp>();
     target.addLegalOp<IREE::VM::GlobalI32Op>();
+    target.addLegalOp<IREE::VM::GlobalI64Op>();
+    target.addLegalOp<IREE::VM::GlobalF32Op>();
+    target.addLegalOp<IREE::VM::GlobalF64Op>();
+    target.addLegalOp<IREE::VM::GlobalRefOp>();
     target.addLegalOp<IREE::VM::ExportOp>();
+    target.addLegalOp<IREE::VM::ImportOp>();
 
     // Control flow ops
     target.addLegalOp<IREE::VM::BranchOp>();
@@ -0,0 +1,274 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+// CHECK-LABEL: @add_f64
+vm.module @my_module {
+  vm.func @add_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_add_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.add.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @sub_f64
+vm.module @my_module {
+  vm.func @sub_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_sub_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.sub.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @mul_f64
+vm.module @my_module {
+  vm.func @mul_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_mul_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.mul.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @div_f64
+vm.module @my_module {
+  vm.func @div_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_div_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.div.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @rem_f64
+vm.module @my_module {
+  vm.func @rem_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_rem_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.rem.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @atan2_f64
+vm.module @my_module {
+  vm.func @atan2_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_atan2_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.atan2.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @pow_f64
+vm.module @my_module {
+  vm.func @pow_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_pow_f64"(%arg0, %arg1) : (f64, f64) -> f64
+    %0 = vm.pow.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @fma_f64
+vm.module @my_module {
+  vm.func @fma_f64(%arg0 : f64, %arg1 : f64, %arg2 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_fma_f64"(%arg0, %arg1, %arg2) : (f64, f64, f64) -> f64
+    %0 = vm.fma.f64 %arg0, %arg1, %arg2 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @abs_f64
+vm.module @my_module {
+  vm.func @abs_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_abs_f64"(%arg0) : (f64) -> f64
+    %0 = vm.abs.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @neg_f64
+vm.module @my_module {
+  vm.func @neg_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_neg_f64"(%arg0) : (f64) -> f64
+    %0 = vm.neg.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @ceil_f64
+vm.module @my_module {
+  vm.func @ceil_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_ceil_f64"(%arg0) : (f64) -> f64
+    %0 = vm.ceil.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @floor_f64
+vm.module @my_module {
+  vm.func @floor_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_floor_f64"(%arg0) : (f64) -> f64
+    %0 = vm.floor.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @atan_f64
+vm.module @my_module {
+  vm.func @atan_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_atan_f64"(%arg0) : (f64) -> f64
+    %0 = vm.atan.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @cos_f64
+vm.module @my_module {
+  vm.func @cos_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cos_f64"(%arg0) : (f64) -> f64
+    %0 = vm.cos.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @sin_f64
+vm.module @my_module {
+  vm.func @sin_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_sin_f64"(%arg0) : (f64) -> f64
+    %0 = vm.sin.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @exp_f64
+vm.module @my_module {
+  vm.func @exp_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_exp_f64"(%arg0) : (f64) -> f64
+    %0 = vm.exp.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @exp2_f64
+vm.module @my_module {
+  vm.func @exp2_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_exp2_f64"(%arg0) : (f64) -> f64
+    %0 = vm.exp2.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @expm1_f64
+vm.module @my_module {
+  vm.func @expm1_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_expm1_f64"(%arg0) : (f64) -> f64
+    %0 = vm.expm1.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @log_f64
+vm.module @my_module {
+  vm.func @log_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_log_f64"(%arg0) : (f64) -> f64
+    %0 = vm.log.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @log10_f64
+vm.module @my_module {
+  vm.func @log10_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_log10_f64"(%arg0) : (f64) -> f64
+    %0 = vm.log10.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @log1p_f64
+vm.module @my_module {
+  vm.func @log1p_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_log1p_f64"(%arg0) : (f64) -> f64
+    %0 = vm.log1p.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @log2_f64
+vm.module @my_module {
+  vm.func @log2_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_log2_f64"(%arg0) : (f64) -> f64
+    %0 = vm.log2.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @rsqrt_f64
+vm.module @my_module {
+  vm.func @rsqrt_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_rsqrt_f64"(%arg0) : (f64) -> f64
+    %0 = vm.rsqrt.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @sqrt_f64
+vm.module @my_module {
+  vm.func @sqrt_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_sqrt_f64"(%arg0) : (f64) -> f64
+    %0 = vm.sqrt.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @tanh_f64
+vm.module @my_module {
+  vm.func @tanh_f64(%arg0 : f64) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_tanh_f64"(%arg0) : (f64) -> f64
+    %0 = vm.tanh.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
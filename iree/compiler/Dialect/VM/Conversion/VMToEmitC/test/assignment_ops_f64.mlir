@@ -0,0 +1,10 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+// CHECK-LABEL: vm.func @select_f64
+vm.module @my_module {
+  vm.func @select_f64(%arg0 : i32, %arg1 : f64, %arg2 : f64) -> f64 {
+    // CHECK: %0 = emitc.call "vm_select_f64"(%arg0, %arg1, %arg2) : (i32, f64, f64) -> f64
+    %0 = vm.select.f64 %arg0, %arg1, %arg2 : f64
+    vm.return %0 : f64
+  }
+}
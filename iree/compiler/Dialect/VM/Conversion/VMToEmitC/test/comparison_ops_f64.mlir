@@ -0,0 +1,100 @@
+// Tests printing and parsing of comparison ops.
+
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_eq_f64o
+  vm.func @cmp_eq_f64o(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_eq_f64o"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.eq.f64.o %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_eq_f64u
+  vm.func @cmp_eq_f64u(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_eq_f64u"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.eq.f64.u %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_ne_f64o
+  vm.func @cmp_ne_f64o(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_ne_f64o"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.ne.f64.o %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_ne_f64u
+  vm.func @cmp_ne_f64u(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_ne_f64u"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.ne.f64.u %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_lt_f64o
+  vm.func @cmp_lt_f64o(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lt_f64o"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.lt.f64.o %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_lt_f64u
+  vm.func @cmp_lt_f64u(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lt_f64u"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.lt.f64.u %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_lte_f64o
+  vm.func @cmp_lte_f64o(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lte_f64o"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.lte.f64.o %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_lte_f64u
+  vm.func @cmp_lte_f64u(%arg0 : f64, %arg1 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_lte_f64u"(%arg0, %arg1) : (f64, f64) -> i32
+    %0 = vm.cmp.lte.f64.u %arg0, %arg1 : f64
+    vm.return
+  }
+}
+
+// -----
+
+vm.module @module {
+  // CHECK-LABEL: vm.func @cmp_nan_f64
+  vm.func @cmp_nan_f64(%arg0 : f64) -> i32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_cmp_nan_f64"(%arg0) : (f64) -> i32
+    %0 = vm.cmp.nan.f64 %arg0 : f64
+    vm.return
+  }
+}
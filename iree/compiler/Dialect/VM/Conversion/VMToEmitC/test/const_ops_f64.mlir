@@ -0,0 +1,25 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+vm.module @my_module {
+  // CHECK-LABEL: vm.func @const_f64_zero
+  vm.func @const_f64_zero() -> f64 {
+    // CHECK: %[[ZERO:.+]] = "emitc.const"() {value = 0.000000e+00 : f64} : () -> f64
+    %zero = vm.const.f64.zero : f64
+    vm.return %zero : f64
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: vm.func @const_f64
+  vm.func @const_f64() {
+    // CHECK-NEXT: %0 = "emitc.const"() {value = 5.000000e-01 : f64} : () -> f64
+    %0 = vm.const.f64 0.5 : f64
+    // CHECK-NEXT: %1 = "emitc.const"() {value = 2.500000e+00 : f64} : () -> f64
+    %1 = vm.const.f64 2.5 : f64
+    // CHECK-NEXT: %2 = "emitc.const"() {value = -2.500000e+00 : f64} : () -> f64
+    %2 = vm.const.f64 -2.5 : f64
+    vm.return
+  }
+}
@@ -0,0 +1,21 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='vm.module(iree-convert-vm-to-emitc)' %s | IreeFileCheck %s
+
+// CHECK-LABEL: vm.func @trunc
+vm.module @my_module {
+  vm.func @trunc(%arg0 : f64) -> f32 {
+    // CHECK-NEXT: %0 = emitc.call "vm_trunc_f64f32"(%arg0) : (f64) -> f32
+    %0 = vm.trunc.f64.f32 %arg0 : f64 -> f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @ext
+vm.module @my_module {
+  vm.func @ext(%arg0 : f32) -> f64 {
+    // CHECK-NEXT: %0 = emitc.call "vm_ext_f32f64"(%arg0) : (f32) -> f64
+    %0 = vm.ext.f32.f64 %arg0 : f32 -> f64
+    vm.return %0 : f64
+  }
+}
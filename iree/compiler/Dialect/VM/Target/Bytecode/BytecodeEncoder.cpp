@@ -9,6 +9,7 @@
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/VM/Analysis/RegisterAllocation.h"
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "llvm/ADT/STLExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
@@ -187,10 +188,33 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     // this list is small :)
     auto srcDstRegs = registerAllocation_->remapSuccessorRegisters(
         currentOp_, successorIndex);
-    (void)writeUint16(srcDstRegs.size());
+    // The i32 and ref register remappings are written as two separate runs
+    // so that the runtime does not need to check each register type. The
+    // relative order within each run is preserved and the banks are disjoint
+    // so this does not change the result of the remapping. The runtime remaps
+    // i32 registers individually so 64-bit values are split into their low
+    // and high halves.
+    SmallVector<std::pair<uint16_t, uint16_t>, 8> i32Regs;
+    SmallVector<std::pair<uint16_t, uint16_t>, 8> refRegs;
     for (auto srcDstReg : srcDstRegs) {
-      if (failed(writeUint16(srcDstReg.first.encode())) ||
-          failed(writeUint16(srcDstReg.second.encode()))) {
+      uint16_t srcReg = srcDstReg.first.encode();
+      uint16_t dstReg = srcDstReg.second.encode();
+      if (srcDstReg.first.isRef()) {
+        refRegs.push_back({srcReg, dstReg});
+        continue;
+      }
+      i32Regs.push_back({srcReg, dstReg});
+      if (srcDstReg.first.byteWidth() == 8) {
+        i32Regs.push_back({static_cast<uint16_t>(srcReg + 1),
+                           static_cast<uint16_t>(dstReg + 1)});
+      }
+    }
+    (void)writeUint16(i32Regs.size());
+    (void)writeUint16(refRegs.size());
+    for (auto encodedReg : llvm::concat<std::pair<uint16_t, uint16_t>>(
+             i32Regs, refRegs)) {
+      if (failed(writeUint16(encodedReg.first)) ||
+          failed(writeUint16(encodedReg.second))) {
         return failure();
       }
     }
@@ -305,6 +329,89 @@ class V0BytecodeEncoder : public BytecodeEncoder {
   std::vector<std::pair<Block *, size_t>> blockOffsetFixups_;
 };
 
+// Returns the superinstruction opcode fusing a cmp.*.i32 op with a cond_br on
+// its result, if the comparison has one.
+static Optional<Opcode> getCmpI32CondBranchOpcode(Operation *cmpOp) {
+  if (isa<CmpEQI32Op>(cmpOp)) return Opcode::CmpEQI32CondBranch;
+  if (isa<CmpNEI32Op>(cmpOp)) return Opcode::CmpNEI32CondBranch;
+  if (isa<CmpLTI32SOp>(cmpOp)) return Opcode::CmpLTI32SCondBranch;
+  if (isa<CmpLTI32UOp>(cmpOp)) return Opcode::CmpLTI32UCondBranch;
+  return llvm::None;
+}
+
+// Attempts to encode |op| and the |nextOp| immediately following it in the
+// same block as a single fused superinstruction. Ops are only fused when the
+// value passed between them has no other uses as the fused form never writes
+// it to a register. Returns true if both ops were encoded.
+static FailureOr<bool> encodeSuperinstruction(Operation *op, Operation *nextOp,
+                                              BytecodeEncoder &e) {
+  if (op->getNumResults() != 1 || !op->getResult(0).hasOneUse() ||
+      *op->getResult(0).user_begin() != nextOp) {
+    return false;
+  }
+
+  // cmp.*.i32 + cond_br:
+  //   opcode, lhs, rhs, true branch, false branch
+  if (auto condBranchOp = dyn_cast<CondBranchOp>(nextOp)) {
+    auto opcode = getCmpI32CondBranchOpcode(op);
+    if (!opcode || condBranchOp.condition() != op->getResult(0)) return false;
+    if (failed(e.beginOp(op)) ||
+        failed(e.encodeOpcode(stringifyEnum(*opcode),
+                              static_cast<int>(*opcode))) ||
+        failed(e.encodeOperand(op->getOperand(0), 0)) ||
+        failed(e.encodeOperand(op->getOperand(1), 1)) || failed(e.endOp(op)) ||
+        failed(e.beginOp(nextOp)) ||
+        failed(e.encodeBranch(condBranchOp.getTrueDest(),
+                              condBranchOp.getTrueOperands(), 0)) ||
+        failed(e.encodeBranch(condBranchOp.getFalseDest(),
+                              condBranchOp.getFalseOperands(), 1)) ||
+        failed(e.endOp(nextOp))) {
+      return failure();
+    }
+    return true;
+  }
+
+  // buffer.load.i32 + add.i32:
+  //   opcode, source_buffer, source_offset, addend, result
+  if (auto loadOp = dyn_cast<BufferLoadI32Op>(op)) {
+    auto addOp = dyn_cast<AddI32Op>(nextOp);
+    if (!addOp) return false;
+    int addendOrdinal = addOp.lhs() == loadOp.result() ? 1 : 0;
+    if (failed(e.beginOp(op)) ||
+        failed(e.encodeOpcode("BufferLoadI32AddI32",
+                              static_cast<int>(Opcode::BufferLoadI32AddI32))) ||
+        failed(e.encodeOperand(loadOp.source_buffer(), 0)) ||
+        failed(e.encodeOperand(loadOp.source_offset(), 1)) ||
+        failed(e.endOp(op)) || failed(e.beginOp(nextOp)) ||
+        failed(e.encodeOperand(nextOp->getOperand(addendOrdinal),
+                               addendOrdinal)) ||
+        failed(e.encodeResult(addOp.result())) || failed(e.endOp(nextOp))) {
+      return failure();
+    }
+    return true;
+  }
+
+  // list.get.i32 + list.set.i32:
+  //   opcode, src_list, src_index, dst_list, dst_index
+  if (auto getOp = dyn_cast<ListGetI32Op>(op)) {
+    auto setOp = dyn_cast<ListSetI32Op>(nextOp);
+    if (!setOp || setOp.value() != getOp.result()) return false;
+    if (failed(e.beginOp(op)) ||
+        failed(e.encodeOpcode("ListGetI32SetI32",
+                              static_cast<int>(Opcode::ListGetI32SetI32))) ||
+        failed(e.encodeOperand(getOp.list(), 0)) ||
+        failed(e.encodeOperand(getOp.index(), 1)) || failed(e.endOp(op)) ||
+        failed(e.beginOp(nextOp)) ||
+        failed(e.encodeOperand(setOp.list(), 0)) ||
+        failed(e.encodeOperand(setOp.index(), 1)) || failed(e.endOp(nextOp))) {
+      return failure();
+    }
+    return true;
+  }
+
+  return false;
+}
+
 }  // namespace
 
 // static
@@ -328,7 +435,19 @@ Optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
       return llvm::None;
     }
 
-    for (auto &op : block.getOperations()) {
+    for (auto it = block.begin(), end = block.end(); it != end; ++it) {
+      auto &op = *it;
+      auto nextIt = std::next(it);
+      if (nextIt != end) {
+        auto fused = encodeSuperinstruction(&op, &*nextIt, encoder);
+        if (failed(fused)) {
+          op.emitOpError() << "failed to encode fused with " << *nextIt;
+          return llvm::None;
+        } else if (*fused) {
+          it = nextIt;
+          continue;
+        }
+      }
       auto serializableOp = dyn_cast<IREE::VM::VMSerializableOp>(op);
       if (!serializableOp) {
         op.emitOpError() << "is not serializable";
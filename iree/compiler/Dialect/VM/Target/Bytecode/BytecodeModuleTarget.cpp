@@ -528,7 +528,7 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // were to serialize all rodata we'd have it in the opposite order as we do
   // in the IR. Though this it isn't required for correctness, enabling file
   // layout planning by preserving the order in the IR is useful.
-  SmallVector<flatbuffers_uint8_vec_ref_t, 8> rodataContentRefs;
+  SmallVector<SerializedConstantRef, 8> rodataContentRefs;
   rodataContentRefs.reserve(rodataOps.size());
 
   // All constants are defaulted to 16-byte aligned as that is the maximum
@@ -536,6 +536,11 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // overridden by creators of the rodata with the `alignment` attribute.
   static constexpr int kDefaultRodataAlignment = 16;
 
+  // Compressed rodata is decompressed by the runtime into allocations aligned
+  // to IREE_VM_BYTECODE_RODATA_ALIGNMENT; rodata requiring a larger alignment
+  // is always stored uncompressed.
+  static constexpr size_t kMaxCompressedRodataAlignment = 64;
+
   for (auto rodataOp : llvm::reverse(rodataOps)) {
     // Only include rodata entries in the ZIP if they are file-like. This
     // prevents all of our string tables from getting included.
@@ -548,13 +553,20 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
             ? static_cast<size_t>(rodataOp.alignment().getValue())
             : 0;
     if (alignment == 0) alignment = kDefaultRodataAlignment;
+
+    // Rodata included in the ZIP must be stored as-is so that it can be
+    // extracted by standard tools.
+    bool compress = targetOptions.rodataCompression ==
+                        BytecodeRodataCompression::kLZ4 &&
+                    !includeInZIP && alignment <= kMaxCompressedRodataAlignment;
+
     auto constantRef =
         serializeConstant(rodataOp.getLoc(), rodataOp.value(), alignment,
-                          /*calculateCRC32=*/includeInZIP, fbb);
+                          /*calculateCRC32=*/includeInZIP, compress, fbb);
     if (!constantRef.ref) {
       return rodataOp.emitOpError() << "failed to encode";
     }
-    rodataContentRefs.push_back(constantRef.ref);
+    rodataContentRefs.push_back(constantRef);
 
     // Add the ZIP per-file header.
     if (includeInZIP) {
@@ -622,8 +634,18 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   // Serialize metadata that should be near the front of the file.
   auto rodataSegmentRefs = llvm::to_vector<8>(
       llvm::map_range(rodataContentRefs, [&](auto rodataContentRef) {
+        iree_vm_LZ4BlockDataDef_ref_t lz4BlockDataRef = 0;
+        if (rodataContentRef.isCompressed) {
+          lz4BlockDataRef =
+              iree_vm_LZ4BlockDataDef_create(fbb, rodataContentRef.totalSize);
+        }
         iree_vm_RodataSegmentDef_start(fbb);
-        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef);
+        iree_vm_RodataSegmentDef_data_add(fbb, rodataContentRef.ref);
+        if (lz4BlockDataRef) {
+          iree_vm_RodataSegmentDef_compression_type_add(
+              fbb, iree_vm_CompressionTypeDef_as_LZ4BlockDataDef(
+                       lz4BlockDataRef));
+        }
         return iree_vm_RodataSegmentDef_end(fbb);
       }));
   SmallVector<iree_vm_RwdataSegmentDef_ref_t, 8> rwdataSegmentRefs;
@@ -711,6 +733,8 @@ static LogicalResult buildFlatBufferModule(BytecodeTargetOptions targetOptions,
   iree_vm_BytecodeModuleDef_function_descriptors_add(fbb,
                                                      functionDescriptorsRef);
   iree_vm_BytecodeModuleDef_bytecode_data_add(fbb, bytecodeDataRef);
+  iree_vm_BytecodeModuleDef_bytecode_version_add(fbb,
+                                                 iree_vm_BytecodeVersionDef_V1);
   iree_vm_BytecodeModuleDef_end_as_root(fbb);
 
   return success();
@@ -31,6 +31,15 @@ enum class BytecodeOutputFormat {
   kAnnotatedMlirText,
 };
 
+// Defines how large read-only data segments are compressed in the module.
+enum class BytecodeRodataCompression {
+  // Rodata is stored uncompressed and referenced in-place by the runtime.
+  kNone,
+  // Rodata is stored as LZ4 blocks and decompressed by the runtime on first
+  // use. Segments that do not compress well are stored uncompressed.
+  kLZ4,
+};
+
 // Options that can be provided to bytecode translation.
 struct BytecodeTargetOptions {
   // Format of the module written to the output stream.
@@ -46,6 +55,10 @@ struct BytecodeTargetOptions {
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
 
+  // Compression applied to rodata segments.
+  BytecodeRodataCompression rodataCompression =
+      BytecodeRodataCompression::kNone;
+
   // Enables the output .vmfb to be inspected as a ZIP file.
   // This is only useful for debugging and should be disabled otherwise.
   bool emitPolyglotZip = false;
@@ -6,6 +6,10 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ConstantEncoder.h"
 
+#include <cstring>
+#include <vector>
+
+#include "iree/base/internal/lz4_block.h"
 #include "llvm/Support/CRC.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinTypes.h"
@@ -104,9 +108,31 @@ static void serializeConstantF64Array(DenseFPElementsAttr attr,
   }
 }
 
+// Values smaller than this are never compressed as the savings would not be
+// worth a separate runtime allocation.
+static constexpr size_t kMinCompressedSize = 256;
+
+// Replaces the |totalSize| bytes at |dataPtr| of the vector being built with
+// their LZ4 block compressed form. Returns false and leaves the vector
+// unchanged if compression would save less than 1/8th of the size.
+static bool compressVectorContents(uint8_t *dataPtr, size_t totalSize,
+                                   FlatbufferBuilder &fbb) {
+  std::vector<uint8_t> compressedData(iree_lz4_block_compress_bound(totalSize));
+  size_t compressedSize = iree_lz4_block_compress(
+      iree_make_const_byte_span(dataPtr, totalSize),
+      iree_make_byte_span(compressedData.data(), compressedData.size()));
+  if (!compressedSize || compressedSize > totalSize - totalSize / 8) {
+    return false;
+  }
+  flatcc_builder_truncate_vector(fbb, totalSize - compressedSize);
+  std::memcpy(flatcc_builder_vector_edit(fbb), compressedData.data(),
+              compressedSize);
+  return true;
+}
+
 SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
                                         size_t alignment, bool calculateCRC32,
-                                        FlatbufferBuilder &fbb) {
+                                        bool compress, FlatbufferBuilder &fbb) {
   flatcc_builder_start_vector(fbb, 1, alignment, FLATBUFFERS_COUNT_MAX(1));
   if (auto attr = elementsAttr.dyn_cast<DenseIntElementsAttr>()) {
     switch (attr.getType().getElementTypeBitWidth()) {
@@ -156,10 +182,13 @@ SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
   if (calculateCRC32) {
     crc32Value = llvm::crc32(0u, ArrayRef<uint8_t>(dataPtr, totalSize));
   }
+  bool isCompressed = compress && totalSize >= kMinCompressedSize &&
+                      compressVectorContents(dataPtr, totalSize, fbb);
   return SerializedConstantRef{
       flatbuffers_uint8_vec_end(fbb),
       static_cast<int64_t>(totalSize),
       crc32Value,
+      isCompressed,
   };
 }
 
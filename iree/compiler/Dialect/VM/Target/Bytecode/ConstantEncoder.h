@@ -21,15 +21,20 @@ struct SerializedConstantRef {
   flatbuffers_uint8_vec_ref_t ref = 0;
   int64_t totalSize = 0;
   uint32_t crc32 = 0;
+  // True if the uint8 vec contains the value as an LZ4 block that decompresses
+  // to |totalSize| bytes.
+  bool isCompressed = false;
 };
 
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
 // Returns the size in bytes of the serialized value and the flatbuffers offset
 // to the uint8 vec containing the data. If |calculateCRC32| is provided then a
-// CRC32 of the data will be computed and returned as well.
+// CRC32 of the data will be computed and returned as well. If |compress| is
+// provided then large values that compress well will be stored as an LZ4
+// block; the size and CRC32 are always those of the uncompressed value.
 SerializedConstantRef serializeConstant(Location loc, ElementsAttr elementsAttr,
                                         size_t alignment, bool calculateCRC32,
-                                        FlatbufferBuilder &fbb);
+                                        bool compress, FlatbufferBuilder &fbb);
 
 }  // namespace VM
 }  // namespace IREE
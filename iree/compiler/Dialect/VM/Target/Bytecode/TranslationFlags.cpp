@@ -58,6 +58,17 @@ static llvm::cl::opt<bool> stripDebugOpsFlag{
     llvm::cl::init(false),
 };
 
+static llvm::cl::opt<BytecodeRodataCompression> rodataCompressionFlag{
+    "iree-vm-bytecode-module-rodata-compression",
+    llvm::cl::desc("Compression applied to large rodata segments"),
+    llvm::cl::init(BytecodeRodataCompression::kNone),
+    llvm::cl::values(
+        clEnumValN(BytecodeRodataCompression::kNone, "none",
+                   "Rodata is stored uncompressed"),
+        clEnumValN(BytecodeRodataCompression::kLZ4, "lz4",
+                   "Rodata is LZ4 compressed and decompressed on first use")),
+};
+
 static llvm::cl::opt<bool> emitPolyglotZipFlag{
     "iree-vm-emit-polyglot-zip",
     llvm::cl::desc(
@@ -72,6 +83,7 @@ BytecodeTargetOptions getBytecodeTargetOptionsFromFlags() {
   targetOptions.stripSymbols = stripSymbolsFlag;
   targetOptions.stripSourceMap = stripSourceMapFlag;
   targetOptions.stripDebugOps = stripDebugOpsFlag;
+  targetOptions.rodataCompression = rodataCompressionFlag;
   targetOptions.emitPolyglotZip = emitPolyglotZipFlag;
   if (outputFormatFlag != BytecodeOutputFormat::kFlatBufferBinary) {
     // Only allow binary output formats to also be .zip files.
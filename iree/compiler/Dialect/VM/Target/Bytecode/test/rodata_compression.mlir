@@ -0,0 +1,47 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text -iree-vm-bytecode-module-rodata-compression=lz4 %s | IreeFileCheck %s
+
+// Large rodata that compresses well is stored as an LZ4 block.
+
+// CHECK-LABEL: "name": "compressed"
+vm.module @compressed {
+  // CHECK: "rodata_segments": [{
+  // CHECK-NEXT: "compression_type_type": "LZ4BlockDataDef",
+  // CHECK-NEXT: "compression_type": {
+  // CHECK-NEXT:   "uncompressed_size": 4096
+  // CHECK-NEXT: },
+  // CHECK-NEXT: "data": [
+  vm.rodata @splat_i32s dense<7> : tensor<1024xi32>
+}
+
+// -----
+
+// Small rodata is stored uncompressed.
+
+// CHECK-LABEL: "name": "small"
+vm.module @small {
+  // CHECK: "rodata_segments": [{
+  // CHECK-NOT: "compression_type"
+  // CHECK: "data": [
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   2,
+  // CHECK-NEXT:   3
+  // CHECK-NEXT: ]
+  vm.rodata @dense_i8s dense<[1, 2, 3]> : tensor<3xi8>
+}
+
+// -----
+
+// Rodata requiring more alignment than the runtime provides for decompressed
+// data is stored uncompressed.
+
+// CHECK-LABEL: "name": "overaligned"
+vm.module @overaligned {
+  // CHECK: "rodata_segments": [{
+  // CHECK-NOT: "compression_type"
+  // CHECK: "data": [
+  "vm.rodata"() {
+    sym_name = "splat_i32s",
+    value = dense<7> : tensor<1024xi32>,
+    alignment = 128 : i64
+  } : () -> ()
+}
@@ -0,0 +1,45 @@
+// RUN: iree-translate -split-input-file -iree-vm-ir-to-bytecode-module -iree-vm-bytecode-module-output-format=flatbuffer-text %s | IreeFileCheck %s
+
+// CHECK: "name": "cmp_cond_br"
+vm.module @cmp_cond_br {
+  vm.export @fused
+  vm.func @fused(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    vm.return %arg0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+
+  // The comparison and branch are encoded as CmpLTI32SCondBranch (0x82)
+  // followed by lhs, rhs and the two branch targets.
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   130,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   1,
+  // CHECK-NEXT:   0,
+  // CHECK-NEXT:   21,
+  // CHECK: "bytecode_version": "V1"
+}
+
+// -----
+
+// CHECK: "name": "cmp_multiple_uses"
+vm.module @cmp_multiple_uses {
+  vm.export @unfused
+  vm.func @unfused(%arg0 : i32, %arg1 : i32) -> i32 {
+    %0 = vm.cmp.lt.i32.s %arg0, %arg1 : i32
+    vm.cond_br %0, ^bb1, ^bb2
+  ^bb1:
+    vm.return %0 : i32
+  ^bb2:
+    vm.return %arg1 : i32
+  }
+
+  // The comparison result is used after the branch and must be materialized
+  // with a standalone CmpLTI32S (0x42).
+  //      CHECK: "bytecode_data": [
+  // CHECK-NEXT:   66,
+}
@@ -62,6 +62,11 @@ static LogicalResult printStructDefinitions(IREE::VM::ModuleOp &moduleOp,
          << moduleOp.ordinal_counts().getValue().global_bytes() << "];\n";
   output << "iree_vm_ref_t refs["
          << moduleOp.ordinal_counts().getValue().global_refs() << "];\n";
+  // Resolved imports indexed by import ordinal.
+  if (moduleOp.ordinal_counts().getValue().import_funcs() > 0) {
+    output << "iree_vm_function_t imports["
+           << moduleOp.ordinal_counts().getValue().import_funcs() << "];\n";
+  }
   output << "};\n";
 
   output << "typedef struct " << moduleName << "_s " << moduleName << "_t;\n";
@@ -113,17 +118,60 @@ static LogicalResult printFuncOpResults(
       });
 }
 
-static LogicalResult initializeGlobals(IREE::VM::ModuleOp moduleOp,
-                                       mlir::emitc::CppEmitter &emitter) {
+static SmallVector<std::string, 4> buildResultNames(IREE::VM::FuncOp &funcOp) {
+  SmallVector<std::string, 4> resultNames;
+  for (unsigned int idx = 0; idx < funcOp.getNumResults(); idx++) {
+    resultNames.push_back("out" + std::to_string(idx));
+  }
+  return resultNames;
+}
+
+// Prints the signature of the function implementing |funcOp|. The calling
+// stack is passed through so that calls to imports can be made from within.
+static LogicalResult printImplFunctionSignature(
+    IREE::VM::ModuleOp &moduleOp, IREE::VM::FuncOp &funcOp,
+    SmallVector<std::string, 4> &resultNames,
+    mlir::emitc::CppEmitter &emitter) {
   llvm::raw_ostream &output = emitter.ostream();
 
-  for (auto globalOp : moduleOp.getOps<IREE::VM::GlobalI32Op>()) {
+  output << "iree_status_t "
+         << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true)
+         << "(iree_vm_stack_t* stack, ";
+
+  if (failed(printFuncOpArguments(funcOp, emitter))) {
+    return failure();
+  }
+
+  if (funcOp.getNumArguments() > 0) {
+    output << ", ";
+  }
+
+  if (failed(printFuncOpResults(funcOp, emitter, resultNames))) {
+    return failure();
+  }
+
+  if (funcOp.getNumResults() > 0) {
+    output << ", ";
+  }
+
+  // TODO(simon-camp): We can't represent structs in emitc (yet maybe), so the
+  // struct argument name here must not be changed.
+  output << moduleOp.getName() << "_state_t* state)";
+
+  return success();
+}
+
+template <typename GlobalOpTy>
+static LogicalResult initializeGlobalsOfType(IREE::VM::ModuleOp moduleOp,
+                                             mlir::emitc::CppEmitter &emitter,
+                                             StringRef storeFunctionName) {
+  for (auto globalOp : moduleOp.getOps<GlobalOpTy>()) {
     Optional<Attribute> initialValue = globalOp.initial_value();
     Optional<StringRef> initializer = globalOp.initializer();
     if (initialValue.hasValue()) {
       // TODO(simon-camp): We can't represent structs in emitc (yet maybe), so
       // the struct argument name here must not be changed.
-      emitter.ostream() << "vm_global_store_i32(state->rwdata, "
+      emitter.ostream() << storeFunctionName << "(state->rwdata, "
                         << globalOp.ordinal() << ", ";
       if (failed(emitter.emitAttribute(*globalOp.getOperation(),
                                        initialValue.getValue()))) {
@@ -135,8 +183,30 @@ static LogicalResult initializeGlobals(IREE::VM::ModuleOp moduleOp,
              << "Initializers for globals not supported yet";
     }
   }
+  return success();
+}
+
+static LogicalResult initializeGlobals(IREE::VM::ModuleOp moduleOp,
+                                       mlir::emitc::CppEmitter &emitter) {
+  if (failed(initializeGlobalsOfType<IREE::VM::GlobalI32Op>(
+          moduleOp, emitter, "vm_global_store_i32")) ||
+      failed(initializeGlobalsOfType<IREE::VM::GlobalI64Op>(
+          moduleOp, emitter, "vm_global_store_i64")) ||
+      failed(initializeGlobalsOfType<IREE::VM::GlobalF32Op>(
+          moduleOp, emitter, "vm_global_store_f32")) ||
+      failed(initializeGlobalsOfType<IREE::VM::GlobalF64Op>(
+          moduleOp, emitter, "vm_global_store_f64"))) {
+    return failure();
+  }
 
-  // TODO(simon-camp): Support vm.global.i64 and vm.global.ref
+  // Ref globals start out as null refs through the zeroed state and have no
+  // initial values.
+  for (auto globalOp : moduleOp.getOps<IREE::VM::GlobalRefOp>()) {
+    if (globalOp.initializer().hasValue()) {
+      return globalOp.emitError()
+             << "Initializers for globals not supported yet";
+    }
+  }
 
   return success();
 }
@@ -162,8 +232,139 @@ static LogicalResult translateBranchOp(IREE::VM::BranchOp branchOp,
   return success();
 }
 
+// Returns the size in bytes of |type| in the packed argument and result
+// buffers of the calling convention or 0 if the type is not supported.
+static size_t getPackedTypeSize(Type type) {
+  if (auto integerType = type.dyn_cast<IntegerType>()) {
+    return integerType.getWidth() <= 32 ? sizeof(int32_t) : sizeof(int64_t);
+  } else if (auto floatType = type.dyn_cast<FloatType>()) {
+    return floatType.getWidth() <= 32 ? sizeof(float) : sizeof(double);
+  }
+  return 0;
+}
+
+// Emits a call to the import |importOp| by packing the operands into a byte
+// buffer laid out as the import calling convention expects and unpacking the
+// results after the call returns.
+static LogicalResult translateImportCallOpToC(IREE::VM::CallOp callOp,
+                                              IREE::VM::ImportOp importOp,
+                                              mlir::emitc::CppEmitter &emitter,
+                                              bool hasRefs) {
+  llvm::raw_ostream &output = emitter.ostream();
+
+  if (importOp.isVariadic()) {
+    return callOp.emitOpError() << "variadic imports not supported yet";
+  }
+  if (!importOp.ordinal().hasValue()) {
+    return callOp.emitOpError() << "import has no ordinal assigned";
+  }
+
+  size_t argumentsSize = 0;
+  for (Value operand : callOp.getOperands()) {
+    argumentsSize += getPackedTypeSize(operand.getType());
+  }
+  size_t resultsSize = 0;
+  for (Value result : callOp.getResults()) {
+    resultsSize += getPackedTypeSize(result.getType());
+  }
+
+  auto printByteSpan = [&](StringRef bufferName, size_t size) {
+    if (size == 0) {
+      output << "iree_make_byte_span(NULL, 0)";
+    } else {
+      output << "iree_make_byte_span(" << bufferName << ", sizeof("
+             << bufferName << "))";
+    }
+  };
+
+  output << "{\n";
+  if (argumentsSize > 0) {
+    output << "uint8_t call_arguments[" << argumentsSize << "];\n";
+    size_t offset = 0;
+    for (Value operand : callOp.getOperands()) {
+      output << "memcpy(call_arguments + " << offset << ", &"
+             << emitter.getOrCreateName(operand) << ", "
+             << getPackedTypeSize(operand.getType()) << ");\n";
+      offset += getPackedTypeSize(operand.getType());
+    }
+  }
+  if (resultsSize > 0) {
+    output << "uint8_t call_results[" << resultsSize << "];\n";
+  }
+
+  output << "iree_status_t call_status = call_import_shim(stack, "
+         << "&state->imports["
+         << importOp.ordinal().getValue().getLimitedValue() << "], ";
+  printByteSpan("call_arguments", argumentsSize);
+  output << ", ";
+  printByteSpan("call_results", resultsSize);
+  output << ");\n";
+
+  if (hasRefs) {
+    output << "VM_RETURN_IF_ERROR(call_status, local_refs);\n";
+  } else {
+    output << "IREE_RETURN_IF_ERROR(call_status);\n";
+  }
+
+  size_t offset = 0;
+  for (Value result : callOp.getResults()) {
+    output << "memcpy(&" << emitter.getOrCreateName(result)
+           << ", call_results + " << offset << ", "
+           << getPackedTypeSize(result.getType()) << ");\n";
+    offset += getPackedTypeSize(result.getType());
+  }
+  output << "}\n";
+
+  return success();
+}
+
 static LogicalResult translateCallOpToC(IREE::VM::CallOp callOp,
-                                        mlir::emitc::CppEmitter &emitter) {
+                                        IREE::VM::ModuleOp &moduleOp,
+                                        mlir::emitc::CppEmitter &emitter,
+                                        bool hasRefs) {
+  llvm::raw_ostream &output = emitter.ostream();
+
+  // TODO(simon-camp): Support passing refs across calls.
+  auto isPrimitive = [](Value value) {
+    return getPackedTypeSize(value.getType()) != 0;
+  };
+  if (!llvm::all_of(callOp.getOperands(), isPrimitive) ||
+      !llvm::all_of(callOp.getResults(), isPrimitive)) {
+    return callOp.emitOpError()
+           << "only primitive arguments and results supported yet";
+  }
+
+  Operation *calleeOp =
+      SymbolTable::lookupSymbolIn(moduleOp.getOperation(), callOp.callee());
+  if (auto importOp = dyn_cast_or_null<IREE::VM::ImportOp>(calleeOp)) {
+    return translateImportCallOpToC(callOp, importOp, emitter, hasRefs);
+  }
+  auto funcOp = dyn_cast_or_null<IREE::VM::FuncOp>(calleeOp);
+  if (!funcOp) {
+    return callOp.emitOpError() << "unable to find callee";
+  }
+
+  // Internal calls go directly to the implementation of the callee and share
+  // the module state.
+  output << "{\n"
+         << "iree_status_t call_status = "
+         << buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true)
+         << "(stack, ";
+  for (Value operand : callOp.getOperands()) {
+    output << emitter.getOrCreateName(operand) << ", ";
+  }
+  for (Value result : callOp.getResults()) {
+    output << "&" << emitter.getOrCreateName(result) << ", ";
+  }
+  output << "state);\n";
+
+  if (hasRefs) {
+    output << "VM_RETURN_IF_ERROR(call_status, local_refs);\n";
+  } else {
+    output << "IREE_RETURN_IF_ERROR(call_status);\n";
+  }
+  output << "}\n";
+
   return success();
 }
 
@@ -251,13 +452,14 @@ static LogicalResult translateReturnOpToC(
 }
 
 static LogicalResult translateOpToC(Operation &op,
+                                    IREE::VM::ModuleOp &moduleOp,
                                     mlir::emitc::CppEmitter &emitter,
                                     SmallVector<std::string, 4> resultNames,
                                     bool hasRefs) {
   if (auto branchOp = dyn_cast<IREE::VM::BranchOp>(op))
     return translateBranchOp(branchOp, emitter);
   if (auto callOp = dyn_cast<IREE::VM::CallOp>(op))
-    return translateCallOpToC(callOp, emitter);
+    return translateCallOpToC(callOp, moduleOp, emitter, hasRefs);
   if (auto condBranchOp = dyn_cast<IREE::VM::CondBranchOp>(op))
     return translateCondBranchOp(condBranchOp, emitter);
   if (auto failOp = dyn_cast<IREE::VM::FailOp>(op))
@@ -275,41 +477,16 @@ static LogicalResult translateOpToC(Operation &op,
 static LogicalResult translateFunctionToC(IREE::VM::ModuleOp &moduleOp,
                                           IREE::VM::FuncOp &funcOp,
                                           mlir::emitc::CppEmitter &emitter) {
-  std::string moduleName = moduleOp.getName().str();
   emitc::CppEmitter::Scope scope(emitter);
   llvm::raw_ostream &output = emitter.ostream();
 
   // this function later gets wrapped with argument marshalling code
-  std::string functionName =
-      buildFunctionName(moduleOp, funcOp, /*implSuffix=*/true);
-
-  output << "iree_status_t " << functionName << "(";
-
-  if (failed(printFuncOpArguments(funcOp, emitter))) {
+  SmallVector<std::string, 4> resultNames = buildResultNames(funcOp);
+  if (failed(
+          printImplFunctionSignature(moduleOp, funcOp, resultNames, emitter))) {
     return failure();
   }
-
-  if (funcOp.getNumResults() > 0 && funcOp.getNumArguments() > 0) {
-    output << ", ";
-  }
-
-  SmallVector<std::string, 4> resultNames;
-  for (unsigned int idx = 0; idx < funcOp.getNumResults(); idx++) {
-    std::string resultName = "out" + std::to_string(idx);
-    resultNames.push_back(resultName);
-  }
-
-  if (failed(printFuncOpResults(funcOp, emitter, resultNames))) {
-    return failure();
-  }
-
-  if (funcOp.getNumArguments() + funcOp.getNumResults() > 0) {
-    output << ", ";
-  }
-
-  // TODO(simon-camp): We can't represent structs in emitc (yet maybe), so the
-  // struct argument name here must not be changed.
-  output << moduleName << "_state_t* state) {\n";
+  output << " {\n";
 
   // We forward declare all result variables except for the ones with RefType.
   output << "// VARIABLE DECLARATIONS\n";
@@ -375,8 +552,8 @@ static LogicalResult translateFunctionToC(IREE::VM::ModuleOp &moduleOp,
       }
     }
     for (Operation &op : block.getOperations()) {
-      if (failed(
-              translateOpToC(op, emitter, resultNames, /*hasRefs=*/hasRefs))) {
+      if (failed(translateOpToC(op, moduleOp, emitter, resultNames,
+                                /*hasRefs=*/hasRefs))) {
         return failure();
       }
     }
@@ -414,12 +591,7 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
       output << ", ";
     }
 
-    SmallVector<std::string, 4> resultNames;
-    for (unsigned int idx = 0; idx < funcOp.getNumResults(); idx++) {
-      std::string resultName = "out" + std::to_string(idx);
-      resultNames.push_back(resultName);
-    }
-
+    SmallVector<std::string, 4> resultNames = buildResultNames(funcOp);
     if (failed(printFuncOpResults(funcOp, emitter, resultNames))) {
       return failure();
     }
@@ -427,7 +599,7 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
            << "return "
            << buildFunctionName(moduleOp, funcOp,
                                 /*implSufffix=*/true)
-           << "(";
+           << "(stack, ";
 
     SmallVector<std::string, 4> argNames;
     for (Value &argument : funcOp.getArguments()) {
@@ -488,11 +660,12 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
   output << "static const iree_vm_native_import_descriptor_t " << importName
          << "[] = {\n";
 
-  // sort import ops
+  // sort import ops by ordinal as the ordinals index the resolved imports in
+  // the module state
   SmallVector<IREE::VM::ImportOp, 4> importOps(
       moduleOp.getOps<IREE::VM::ImportOp>());
   llvm::sort(importOps, [](auto &lhs, auto &rhs) {
-    return lhs.getName().compare(rhs.getName()) < 0;
+    return lhs.ordinal().getValue().ult(rhs.ordinal().getValue());
   });
 
   for (auto importOp : importOps) {
@@ -506,16 +679,11 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
   output << "static const iree_vm_native_function_ptr_t " << functionName
          << "[] = {\n";
 
-  // sort func ops
-  SmallVector<IREE::VM::FuncOp, 4> funcOps(moduleOp.getOps<IREE::VM::FuncOp>());
-  llvm::sort(funcOps, [&moduleOp](auto &lhs, auto &rhs) {
-    std::string lhsStr =
-        buildFunctionName(moduleOp, lhs, /*implSufffix=*/false);
-    std::string rhsStr =
-        buildFunctionName(moduleOp, rhs, /*implSufffix=*/false);
-    return lhsStr.compare(rhsStr) < 0;
-  });
-  for (auto funcOp : funcOps) {
+  // The native module calls through this table by export ordinal so it must
+  // be 1:1 with the sorted exports; internal functions are only reachable
+  // through direct calls.
+  for (auto exportOp : exportOps) {
+    auto funcOp = symbolTable.lookup<IREE::VM::FuncOp>(exportOp.function_ref());
     output << "{"
            << "(iree_vm_native_function_shim_t)";
 
@@ -573,12 +741,31 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
          << "_free_state(void* self, iree_vm_module_state_t* "
             "module_state) {\n"
          << moduleName << "_state_t* state = (" << moduleName
-         << "_state_t*)module_state;\n"
-         << "iree_allocator_free(state->allocator, state);\n"
+         << "_state_t*)module_state;\n";
+  if (moduleOp.ordinal_counts().getValue().global_refs() > 0) {
+    output << "VM_REF_ARRAY_RELEASE(state->refs);\n";
+  }
+  output << "iree_allocator_free(state->allocator, state);\n"
          << "}\n";
 
-  // resolve_imports
-  // TODO(simon-camp):
+  // resolve_import
+  const bool hasImports = !importOps.empty();
+  if (hasImports) {
+    output << "static iree_status_t " << moduleName
+           << "_resolve_import(void* self, iree_vm_module_state_t* "
+              "module_state, iree_host_size_t ordinal, const "
+              "iree_vm_function_t* function, const "
+              "iree_vm_function_signature_t* signature) {\n"
+           << moduleName << "_state_t* state = (" << moduleName
+           << "_state_t*)module_state;\n"
+           << "if (ordinal >= IREE_ARRAYSIZE(state->imports)) {\n"
+           << "return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "
+              "\"import ordinal out of range\");\n"
+           << "}\n"
+           << "state->imports[ordinal] = *function;\n"
+           << "return iree_ok_status();\n"
+           << "}\n";
+  }
 
   // create
   output << "static iree_status_t " << moduleName << "_create("
@@ -590,7 +777,8 @@ static LogicalResult buildModuleDescriptors(IREE::VM::ModuleOp &moduleOp,
          << "interface.destroy = NULL;\n"
          << "interface.alloc_state = " << moduleName << "_alloc_state;\n"
          << "interface.free_state = " << moduleName << "_free_state;\n"
-         << "interface.resolve_import = NULL;\n"
+         << "interface.resolve_import = "
+         << (hasImports ? moduleName + "_resolve_import" : "NULL") << ";\n"
          << "return iree_vm_native_module_create(&interface, "
             "&"
          << descriptorName << ", allocator, out_module);\n"
@@ -706,6 +894,18 @@ LogicalResult translateModuleToC(IREE::VM::ModuleOp moduleOp,
     return failure();
   }
 
+  // forward declare functions so that calls can precede the callee definition
+  for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
+    mlir::emitc::CppEmitter::Scope scope(emitter);
+    SmallVector<std::string, 4> resultNames = buildResultNames(funcOp);
+    if (failed(printImplFunctionSignature(moduleOp, funcOp, resultNames,
+                                          emitter))) {
+      return failure();
+    }
+    output << ";\n";
+  }
+  output << "\n";
+
   // translate functions
   for (auto funcOp : moduleOp.getOps<IREE::VM::FuncOp>()) {
     if (failed(translateFunctionToC(moduleOp, funcOp, emitter))) {
@@ -0,0 +1,49 @@
+// RUN: iree-translate -iree-vm-ir-to-c-module -iree-vm-c-module-optimize=false %s | IreeFileCheck %s
+
+vm.module @call_ops {
+  // CHECK-LABEL: struct call_ops_state_s {
+  // CHECK: iree_vm_function_t imports[1];
+  // CHECK-NEXT: };
+
+  // CHECK: iree_status_t call_ops_callee_impl(iree_vm_stack_t* stack, int32_t v1, int32_t *out0, call_ops_state_t* state);
+  // CHECK-NEXT: iree_status_t call_ops_call_internal_impl(iree_vm_stack_t* stack, int32_t v1, int32_t *out0, call_ops_state_t* state);
+
+  vm.import @other.mul(%a : i32, %b : i64) -> f32
+
+  vm.func @callee(%arg0 : i32) -> i32 {
+    vm.return %arg0 : i32
+  }
+
+  vm.export @call_internal
+  // CHECK-LABEL: iree_status_t call_ops_call_internal_impl(iree_vm_stack_t* stack, int32_t v1, int32_t *out0, call_ops_state_t* state) {
+  vm.func @call_internal(%arg0 : i32) -> i32 {
+    // CHECK: iree_status_t call_status = call_ops_callee_impl(stack, v1, &[[RESULT:[^ ]*]], state);
+    // CHECK-NEXT: IREE_RETURN_IF_ERROR(call_status);
+    %0 = vm.call @callee(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+
+  vm.export @call_import
+  // CHECK-LABEL: iree_status_t call_ops_call_import_impl(
+  vm.func @call_import(%arg0 : i32, %arg1 : i64) -> f32 {
+    // CHECK: uint8_t call_arguments[12];
+    // CHECK-NEXT: memcpy(call_arguments + 0, &v1, 4);
+    // CHECK-NEXT: memcpy(call_arguments + 4, &v2, 8);
+    // CHECK-NEXT: uint8_t call_results[4];
+    // CHECK-NEXT: iree_status_t call_status = call_import_shim(stack, &state->imports[0], iree_make_byte_span(call_arguments, sizeof(call_arguments)), iree_make_byte_span(call_results, sizeof(call_results)));
+    // CHECK-NEXT: IREE_RETURN_IF_ERROR(call_status);
+    // CHECK-NEXT: memcpy(&[[RESULT:[^ ]*]], call_results + 0, 4);
+    %0 = vm.call @other.mul(%arg0, %arg1) : (i32, i64) -> f32
+    vm.return %0 : f32
+  }
+
+  // CHECK: static const iree_vm_native_import_descriptor_t call_ops_imports_[] = {
+  // CHECK-NEXT: {iree_make_cstring_view("other.mul")},
+  // CHECK-NEXT: };
+
+  // CHECK-LABEL: static iree_status_t call_ops_resolve_import(
+  // CHECK: state->imports[ordinal] = *function;
+
+  // CHECK-LABEL: static iree_status_t call_ops_create(
+  // CHECK: interface.resolve_import = call_ops_resolve_import;
+}
@@ -2,7 +2,7 @@
 
 // CHECK: #include "iree/vm/ops.h"
 vm.module @calling_convention_test {
-  // CHECK: iree_status_t calling_convention_test_no_in_no_return_impl(calling_convention_test_state_t* state) {
+  // CHECK: iree_status_t calling_convention_test_no_in_no_return_impl(iree_vm_stack_t* stack, calling_convention_test_state_t* state) {
   vm.func @no_in_no_return() -> () {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -12,7 +12,7 @@ vm.module @calling_convention_test {
     vm.return
   }
 
-  // CHECK: iree_status_t calling_convention_test_i32_in_no_return_impl(int32_t v1, calling_convention_test_state_t* state) {
+  // CHECK: iree_status_t calling_convention_test_i32_in_no_return_impl(iree_vm_stack_t* stack, int32_t v1, calling_convention_test_state_t* state) {
   vm.func @i32_in_no_return(%arg0 : i32) -> () {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -22,7 +22,7 @@ vm.module @calling_convention_test {
     vm.return
   }
 
-  // CHECK: iree_status_t calling_convention_test_no_in_i32_return_impl(int32_t *out0, calling_convention_test_state_t* state) {
+  // CHECK: iree_status_t calling_convention_test_no_in_i32_return_impl(iree_vm_stack_t* stack, int32_t *out0, calling_convention_test_state_t* state) {
   vm.func @no_in_i32_return() -> (i32) {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -36,7 +36,7 @@ vm.module @calling_convention_test {
     vm.return %0 : i32
   }
 
-  // CHECK: iree_status_t calling_convention_test_i32_in_i32_return_impl(int32_t v1, int32_t *out0, calling_convention_test_state_t* state) {
+  // CHECK: iree_status_t calling_convention_test_i32_in_i32_return_impl(iree_vm_stack_t* stack, int32_t v1, int32_t *out0, calling_convention_test_state_t* state) {
   vm.func @i32_in_i32_return(%arg0 : i32) -> (i32) {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -4,15 +4,19 @@ vm.module @global_ops {
   // check the generated state struct
   // CHECK-LABEL: struct global_ops_state_s {
   // CHECK-NEXT: iree_allocator_t allocator;
-  // CHECK-NEXT: uint8_t rwdata[8];
-  // CHECK-NEXT: iree_vm_ref_t refs[0];
+  // CHECK-NEXT: uint8_t rwdata[32];
+  // CHECK-NEXT: iree_vm_ref_t refs[1];
   // CHECK-NEXT: };
 
   vm.global.i32 @c42 42 : i32
   vm.global.i32 @c107_mut mutable 107 : i32
+  vm.global.i64 @c42_i64 42 : i64
+  vm.global.f32 @c42_f32 42.5 : f32
+  vm.global.f64 @c42_f64 42.5 : f64
+  vm.global.ref @g0_mut mutable : !vm.list<i32>
 
   vm.export @test_global_load_i32
-  // CHECK-LABEL: iree_status_t global_ops_test_global_load_i32_impl(
+  // CHECK-LABEL: iree_status_t global_ops_test_global_load_i32_impl(iree_vm_stack_t* stack, int32_t *out0, global_ops_state_t* state) {
   vm.func @test_global_load_i32() -> i32 {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -25,7 +29,7 @@ vm.module @global_ops {
   }
 
   vm.export @test_global_store_i32
-  // CHECK-LABEL: iree_status_t global_ops_test_global_store_i32_impl(
+  // CHECK-LABEL: iree_status_t global_ops_test_global_store_i32_impl(iree_vm_stack_t* stack, int32_t *out0, global_ops_state_t* state) {
   vm.func @test_global_store_i32() -> i32 {
     // CHECK-NEXT: VARIABLE DECLARATIONS
     // CHECK-NEXT: RESULTS
@@ -42,8 +46,31 @@ vm.module @global_ops {
     vm.return %value : i32
   }
 
+  vm.export @test_global_ref
+  // CHECK-LABEL: iree_status_t global_ops_test_global_ref_impl(
+  vm.func @test_global_ref() -> i32 {
+    // CHECK: [[GLOBAL:[^ ]*]] = VM_ARRAY_ELEMENT_ADDRESS(state->refs, 0);
+    // CHECK-NEXT: iree_vm_ref_retain({{.*}}, [[GLOBAL]]);
+    %null = vm.const.ref.zero : !vm.list<i32>
+    vm.global.store.ref %null, @g0_mut : !vm.list<i32>
+    // CHECK: [[REF:[^ ]*]] = VM_ARRAY_ELEMENT_ADDRESS(local_refs, {{[0-9]+}});
+    // CHECK-NEXT: [[GLOBAL2:[^ ]*]] = VM_ARRAY_ELEMENT_ADDRESS(state->refs, 0);
+    // CHECK-NEXT: iree_vm_ref_retain([[GLOBAL2]], [[REF]]);
+    %list = vm.global.load.ref @g0_mut : !vm.list<i32>
+    %size = vm.list.size %list : (!vm.list<i32>) -> i32
+    vm.return %size : i32
+  }
+
   // check state initialization inside the alloc_state function
   // CHECK-LABEL: static iree_status_t global_ops_alloc_state(
   // CHECK: vm_global_store_i32(state->rwdata, 0, 42);
   // CHECK-NEXT: vm_global_store_i32(state->rwdata, 4, 107);
+  // CHECK-NEXT: vm_global_store_i64(state->rwdata, 16, 42);
+  // CHECK-NEXT: vm_global_store_f32(state->rwdata, 8, {{.*}});
+  // CHECK-NEXT: vm_global_store_f64(state->rwdata, 24, {{.*}});
+
+  // check that global refs are released with the state
+  // CHECK-LABEL: static void global_ops_free_state(
+  // CHECK: VM_REF_ARRAY_RELEASE(state->refs);
+  // CHECK-NEXT: iree_allocator_free(state->allocator, state);
 }
@@ -139,6 +139,67 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
     iree_hal_allocator_t** out_allocator);
 
+// Parameters controlling the block cache of a heap allocator.
+//
+// Released buffer storage is binned by size class (4 classes per power of two)
+// and kept for reuse instead of being returned to the host allocator. This
+// keeps transient buffers of repeated invocations from round-tripping through
+// the system malloc and keeps their pages resident. Each thread first uses its
+// own small magazine of blocks per size class and then falls back to a shared
+// depot so that steady-state allocation does not contend.
+typedef struct {
+  // Maximum total size in bytes of unused blocks retained by the cache.
+  // Blocks released while the cache is full go back to the host allocator.
+  // 0 disables caching and all storage comes directly from the host allocator.
+  iree_host_size_t max_retained_size;
+
+  // Largest allocation size in bytes that is served from the cache. Larger
+  // allocations always go directly to the host allocator.
+  iree_host_size_t max_block_size;
+
+  // Number of blocks of each size class a thread keeps in its own magazine
+  // before releasing additional blocks to the shared depot.
+  iree_host_size_t magazine_capacity;
+} iree_hal_heap_allocator_cache_params_t;
+
+// Initializes |out_params| to default values with caching enabled.
+IREE_API_EXPORT void iree_hal_heap_allocator_cache_params_initialize(
+    iree_hal_heap_allocator_cache_params_t* out_params);
+
+// Statistics of a heap allocator block cache.
+typedef struct {
+  // Total size in bytes of unused blocks currently retained.
+  iree_host_size_t retained_size;
+  // Highest |retained_size| observed since creation or the last trim.
+  iree_host_size_t high_water_retained_size;
+  // Number of allocations served from retained blocks.
+  uint64_t hit_count;
+  // Number of cacheable allocations that had to go to the host allocator.
+  uint64_t miss_count;
+} iree_hal_heap_allocator_cache_statistics_t;
+
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// that caches buffer storage as configured by |cache_params|. Buffer storage
+// is aligned to at least 64 bytes when caching is enabled.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_cache(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_cache_params_t* cache_params,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+
+// Returns retained blocks of a heap allocator cache to the host allocator
+// until at most |max_retained_size| bytes remain; 0 releases all blocks.
+// Larger blocks are released first. The high-water mark is reset to the
+// remaining retained size. No-op if |allocator| is not a caching heap
+// allocator.
+IREE_API_EXPORT void iree_hal_heap_allocator_trim(
+    iree_hal_allocator_t* allocator, iree_host_size_t max_retained_size);
+
+// Queries the cache statistics of a heap allocator. All values are zero if
+// |allocator| is not a caching heap allocator.
+IREE_API_EXPORT void iree_hal_heap_allocator_query_cache_statistics(
+    iree_hal_allocator_t* allocator,
+    iree_hal_heap_allocator_cache_statistics_t* out_statistics);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
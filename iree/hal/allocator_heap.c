@@ -4,23 +4,477 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer_heap_impl.h"
 #include "iree/hal/detail.h"
 
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_cache_t
+//===----------------------------------------------------------------------===//
+
+// Size classes are spaced 2^IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2 per
+// power of two, bounding the unused tail of a cached block to 25%.
+#define IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2 2
+
+// Smallest size class; smaller allocations are rounded up to it.
+#define IREE_HAL_HEAP_CACHE_MIN_BLOCK_SIZE_LOG2 8
+
+// Alignment of all blocks returned by the cache. Matches the heap buffer
+// header alignment so that buffer contents are also aligned to it.
+#define IREE_HAL_HEAP_CACHE_BLOCK_ALIGNMENT IREE_HAL_HEAP_BUFFER_ALIGNMENT
+
+// Number of magazines threads are distributed across. Threads are assigned
+// magazines round-robin on first use and so are only contended when more
+// threads than this allocate concurrently from the same allocator.
+#define IREE_HAL_HEAP_CACHE_MAGAZINE_COUNT 16
+
+// Size class of blocks that are larger than the cache maximum and always
+// return to the host allocator.
+#define IREE_HAL_HEAP_CACHE_UNCACHED_CLASS UINT32_MAX
+
+// Stored immediately prior to each block returned from the cache.
+typedef struct {
+  // Pointer returned by the host allocator that must be used to free it.
+  void* base_ptr;
+  // Usable size of the block in bytes.
+  iree_host_size_t block_size;
+  // Size class of the block or IREE_HAL_HEAP_CACHE_UNCACHED_CLASS.
+  uint32_t size_class;
+} iree_hal_heap_cache_block_header_t;
+
+// Overlaid on the contents of blocks while they are retained in the cache.
+typedef struct iree_hal_heap_cache_free_block_s {
+  struct iree_hal_heap_cache_free_block_s* next;
+} iree_hal_heap_cache_free_block_t;
+
+// Singly-linked LIFO list of retained blocks of a single size class.
+typedef struct {
+  iree_hal_heap_cache_free_block_t* head;
+  iree_host_size_t count;
+} iree_hal_heap_cache_list_t;
+
+typedef struct {
+  iree_slim_mutex_t mutex;
+  // One list per size class.
+  iree_hal_heap_cache_list_t* lists IREE_GUARDED_BY(mutex);
+} iree_hal_heap_cache_magazine_t;
+
+// Caches are referenced by their owning allocator and by every block that is
+// currently allocated from them as heap buffers may outlive the device (and
+// its allocator) they were allocated from. Once the owning allocator is
+// destroyed the cache is closed and outstanding blocks return directly to the
+// host allocator as they are released.
+typedef struct {
+  iree_atomic_ref_count_t ref_count;
+  // Set when the owning allocator has been destroyed.
+  iree_atomic_int32_t is_closed;
+
+  iree_allocator_t host_allocator;
+  iree_host_size_t max_retained_size;
+  iree_host_size_t magazine_capacity;
+  uint32_t size_class_count;
+
+  // Total size of all blocks in magazines and the depot.
+  iree_atomic_int64_t retained_size;
+  iree_atomic_int64_t high_water_retained_size;
+  iree_atomic_int64_t hit_count;
+  iree_atomic_int64_t miss_count;
+
+  // Per-thread magazines that service most requests without contention.
+  iree_hal_heap_cache_magazine_t magazines[IREE_HAL_HEAP_CACHE_MAGAZINE_COUNT];
+
+  // Shared depot that magazines overflow into and refill from.
+  iree_slim_mutex_t depot_mutex;
+  iree_hal_heap_cache_list_t* depot_lists IREE_GUARDED_BY(depot_mutex);
+} iree_hal_heap_cache_t;
+
+// Next magazine slot handed out to a thread. Shared by all caches so that
+// threads are spread evenly regardless of which allocator they first use.
+static iree_atomic_int32_t iree_hal_heap_cache_next_thread_slot =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// 1-based magazine slot of the current thread or 0 if not yet assigned.
+static IREE_THREAD_LOCAL uint32_t iree_hal_heap_cache_thread_slot = 0;
+
+// Returns the size class that can hold |size| bytes.
+static uint32_t iree_hal_heap_cache_size_class(iree_host_size_t size) {
+  if (size <= (1ull << IREE_HAL_HEAP_CACHE_MIN_BLOCK_SIZE_LOG2)) return 0;
+  // Classes are (2^S + m) << (e - S) for m in [0, 2^S) where S is the
+  // subdivision; find the smallest one that is >= size.
+  uint64_t n = (uint64_t)size - 1;
+  int e = 63 - iree_math_count_leading_zeros_u64(n);
+  int shift = e - IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2;
+  uint32_t m = (uint32_t)(n >> shift) + 1 -
+               (1u << IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2);
+  return ((uint32_t)(e - IREE_HAL_HEAP_CACHE_MIN_BLOCK_SIZE_LOG2)
+          << IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2) +
+         m;
+}
+
+// Returns the usable size in bytes of blocks in |size_class|.
+static iree_host_size_t iree_hal_heap_cache_class_size(uint32_t size_class) {
+  uint32_t e = IREE_HAL_HEAP_CACHE_MIN_BLOCK_SIZE_LOG2 +
+               (size_class >> IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2);
+  uint64_t m = size_class &
+               ((1u << IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2) - 1);
+  return (iree_host_size_t)(
+      ((1ull << IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2) + m)
+      << (e - IREE_HAL_HEAP_CACHE_CLASS_SUBDIVISION_LOG2));
+}
+
+static iree_hal_heap_cache_block_header_t* iree_hal_heap_cache_block_header(
+    void* ptr) {
+  return (iree_hal_heap_cache_block_header_t*)ptr - 1;
+}
+
+static iree_hal_heap_cache_magazine_t* iree_hal_heap_cache_select_magazine(
+    iree_hal_heap_cache_t* cache) {
+  uint32_t slot = iree_hal_heap_cache_thread_slot;
+  if (IREE_UNLIKELY(slot == 0)) {
+    slot = (uint32_t)iree_atomic_fetch_add_int32(
+               &iree_hal_heap_cache_next_thread_slot, 1,
+               iree_memory_order_relaxed) +
+           1;
+    iree_hal_heap_cache_thread_slot = slot;
+  }
+  return &cache->magazines[(slot - 1) % IREE_HAL_HEAP_CACHE_MAGAZINE_COUNT];
+}
+
+static void iree_hal_heap_cache_list_push(iree_hal_heap_cache_list_t* list,
+                                          void* ptr) {
+  iree_hal_heap_cache_free_block_t* block =
+      (iree_hal_heap_cache_free_block_t*)ptr;
+  block->next = list->head;
+  list->head = block;
+  ++list->count;
+}
+
+static void* iree_hal_heap_cache_list_pop(iree_hal_heap_cache_list_t* list) {
+  iree_hal_heap_cache_free_block_t* block = list->head;
+  if (!block) return NULL;
+  list->head = block->next;
+  --list->count;
+  return block;
+}
+
+// Allocates a new block of |block_size| usable bytes from the host allocator.
+// Contents are zeroed by the host allocator.
+static iree_status_t iree_hal_heap_cache_allocate_block(
+    iree_hal_heap_cache_t* cache, uint32_t size_class,
+    iree_host_size_t block_size, void** out_ptr) {
+  iree_host_size_t header_size = sizeof(iree_hal_heap_cache_block_header_t);
+  uint8_t* base_ptr = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      cache->host_allocator,
+      header_size + IREE_HAL_HEAP_CACHE_BLOCK_ALIGNMENT - 1 + block_size,
+      (void**)&base_ptr));
+  uint8_t* ptr = (uint8_t*)iree_host_align((uintptr_t)base_ptr + header_size,
+                                           IREE_HAL_HEAP_CACHE_BLOCK_ALIGNMENT);
+  iree_hal_heap_cache_block_header_t* header =
+      iree_hal_heap_cache_block_header(ptr);
+  header->base_ptr = base_ptr;
+  header->block_size = block_size;
+  header->size_class = size_class;
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+static void iree_hal_heap_cache_free_block(iree_hal_heap_cache_t* cache,
+                                           void* ptr) {
+  iree_allocator_free(cache->host_allocator,
+                      iree_hal_heap_cache_block_header(ptr)->base_ptr);
+}
+
+static void iree_hal_heap_cache_note_retained(iree_hal_heap_cache_t* cache,
+                                              int64_t delta) {
+  int64_t retained_size = iree_atomic_fetch_add_int64(
+                              &cache->retained_size, delta,
+                              iree_memory_order_relaxed) +
+                          delta;
+  if (delta <= 0) return;
+  int64_t high_water = iree_atomic_load_int64(&cache->high_water_retained_size,
+                                              iree_memory_order_relaxed);
+  while (retained_size > high_water &&
+         !iree_atomic_compare_exchange_weak_int64(
+             &cache->high_water_retained_size, &high_water, retained_size,
+             iree_memory_order_relaxed, iree_memory_order_relaxed)) {
+  }
+}
+
+// Takes a retained block of |size_class| from the calling thread's magazine or
+// the depot. Returns NULL if none is available.
+static void* iree_hal_heap_cache_acquire(iree_hal_heap_cache_t* cache,
+                                         uint32_t size_class) {
+  iree_hal_heap_cache_magazine_t* magazine =
+      iree_hal_heap_cache_select_magazine(cache);
+  iree_slim_mutex_lock(&magazine->mutex);
+  void* ptr = iree_hal_heap_cache_list_pop(&magazine->lists[size_class]);
+  iree_slim_mutex_unlock(&magazine->mutex);
+  if (!ptr) {
+    iree_slim_mutex_lock(&cache->depot_mutex);
+    ptr = iree_hal_heap_cache_list_pop(&cache->depot_lists[size_class]);
+    iree_slim_mutex_unlock(&cache->depot_mutex);
+  }
+  return ptr;
+}
+
+// Retains |ptr| for reuse if it is cacheable and the cache has room and
+// otherwise returns it to the host allocator.
+static void iree_hal_heap_cache_release(iree_hal_heap_cache_t* cache,
+                                        void* ptr) {
+  iree_hal_heap_cache_block_header_t* header =
+      iree_hal_heap_cache_block_header(ptr);
+  // The limit check races with other threads releasing blocks and may
+  // overshoot by at most one block per concurrent releaser.
+  if (header->size_class == IREE_HAL_HEAP_CACHE_UNCACHED_CLASS ||
+      iree_atomic_load_int32(&cache->is_closed, iree_memory_order_acquire) ||
+      iree_atomic_load_int64(&cache->retained_size,
+                             iree_memory_order_relaxed) +
+              header->block_size >
+          cache->max_retained_size) {
+    iree_hal_heap_cache_free_block(cache, ptr);
+    return;
+  }
+  iree_hal_heap_cache_note_retained(cache, (int64_t)header->block_size);
+
+  iree_hal_heap_cache_magazine_t* magazine =
+      iree_hal_heap_cache_select_magazine(cache);
+  iree_slim_mutex_lock(&magazine->mutex);
+  iree_hal_heap_cache_list_t* list = &magazine->lists[header->size_class];
+  bool retained = list->count < cache->magazine_capacity;
+  if (retained) iree_hal_heap_cache_list_push(list, ptr);
+  iree_slim_mutex_unlock(&magazine->mutex);
+  if (!retained) {
+    iree_slim_mutex_lock(&cache->depot_mutex);
+    iree_hal_heap_cache_list_push(&cache->depot_lists[header->size_class], ptr);
+    iree_slim_mutex_unlock(&cache->depot_mutex);
+  }
+}
+
+static void iree_hal_heap_cache_trim_list(iree_hal_heap_cache_t* cache,
+                                          iree_hal_heap_cache_list_t* list,
+                                          iree_host_size_t block_size,
+                                          iree_host_size_t max_retained_size) {
+  while (list->head && (iree_host_size_t)iree_atomic_load_int64(
+                           &cache->retained_size, iree_memory_order_relaxed) >
+                           max_retained_size) {
+    void* ptr = iree_hal_heap_cache_list_pop(list);
+    iree_hal_heap_cache_note_retained(cache, -(int64_t)block_size);
+    iree_hal_heap_cache_free_block(cache, ptr);
+  }
+}
+
+static void iree_hal_heap_cache_trim(iree_hal_heap_cache_t* cache,
+                                     iree_host_size_t max_retained_size) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // Release the largest blocks first: they are the most expensive to keep and
+  // the cheapest to reacquire relative to the work done on them.
+  for (int32_t i = (int32_t)cache->size_class_count - 1; i >= 0; --i) {
+    iree_host_size_t block_size = iree_hal_heap_cache_class_size(i);
+    iree_slim_mutex_lock(&cache->depot_mutex);
+    iree_hal_heap_cache_trim_list(cache, &cache->depot_lists[i], block_size,
+                                  max_retained_size);
+    iree_slim_mutex_unlock(&cache->depot_mutex);
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(cache->magazines); ++j) {
+      iree_hal_heap_cache_magazine_t* magazine = &cache->magazines[j];
+      iree_slim_mutex_lock(&magazine->mutex);
+      iree_hal_heap_cache_trim_list(cache, &magazine->lists[i], block_size,
+                                    max_retained_size);
+      iree_slim_mutex_unlock(&magazine->mutex);
+    }
+  }
+  iree_atomic_store_int64(
+      &cache->high_water_retained_size,
+      iree_atomic_load_int64(&cache->retained_size, iree_memory_order_relaxed),
+      iree_memory_order_relaxed);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_heap_cache_create(
+    const iree_hal_heap_allocator_cache_params_t* params,
+    iree_allocator_t host_allocator, iree_hal_heap_cache_t** out_cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t max_block_size =
+      iree_max(params->max_block_size,
+               (iree_host_size_t)1 << IREE_HAL_HEAP_CACHE_MIN_BLOCK_SIZE_LOG2);
+  uint32_t size_class_count = iree_hal_heap_cache_size_class(max_block_size);
+  if (iree_hal_heap_cache_class_size(size_class_count) > max_block_size &&
+      size_class_count > 0) {
+    // Only cache classes that fit entirely within the maximum block size.
+    --size_class_count;
+  }
+  ++size_class_count;
+
+  iree_hal_heap_cache_t* cache = NULL;
+  iree_host_size_t list_count =
+      (IREE_HAL_HEAP_CACHE_MAGAZINE_COUNT + 1) * size_class_count;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator,
+      sizeof(*cache) + list_count * sizeof(iree_hal_heap_cache_list_t),
+      (void**)&cache);
+  if (iree_status_is_ok(status)) {
+    iree_atomic_ref_count_init(&cache->ref_count);
+    cache->host_allocator = host_allocator;
+    cache->max_retained_size = params->max_retained_size;
+    cache->magazine_capacity = params->magazine_capacity;
+    cache->size_class_count = size_class_count;
+    iree_hal_heap_cache_list_t* lists =
+        (iree_hal_heap_cache_list_t*)((uint8_t*)cache + sizeof(*cache));
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(cache->magazines); ++i) {
+      iree_slim_mutex_initialize(&cache->magazines[i].mutex);
+      cache->magazines[i].lists = lists + i * size_class_count;
+    }
+    iree_slim_mutex_initialize(&cache->depot_mutex);
+    cache->depot_lists =
+        lists + IREE_HAL_HEAP_CACHE_MAGAZINE_COUNT * size_class_count;
+    *out_cache = cache;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_heap_cache_destroy(iree_hal_heap_cache_t* cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_heap_cache_trim(cache, 0);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(cache->magazines); ++i) {
+    iree_slim_mutex_deinitialize(&cache->magazines[i].mutex);
+  }
+  iree_slim_mutex_deinitialize(&cache->depot_mutex);
+  iree_allocator_free(cache->host_allocator, cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static void iree_hal_heap_cache_release_ref(iree_hal_heap_cache_t* cache) {
+  if (iree_atomic_ref_count_dec(&cache->ref_count) == 1) {
+    iree_hal_heap_cache_destroy(cache);
+  }
+}
+
+// Closes the cache on behalf of its owning allocator. Retained blocks are
+// released immediately and the cache is freed once all outstanding blocks are.
+static void iree_hal_heap_cache_close(iree_hal_heap_cache_t* cache) {
+  iree_atomic_store_int32(&cache->is_closed, 1, iree_memory_order_release);
+  iree_hal_heap_cache_trim(cache, 0);
+  iree_hal_heap_cache_release_ref(cache);
+}
+
+static void iree_hal_heap_cache_free(void* self, void* ptr) {
+  iree_hal_heap_cache_t* cache = (iree_hal_heap_cache_t*)self;
+  iree_hal_heap_cache_release(cache, ptr);
+  iree_hal_heap_cache_release_ref(cache);
+}
+
+static iree_status_t iree_hal_heap_cache_allocate(void* self,
+                                                  iree_allocation_mode_t mode,
+                                                  iree_host_size_t byte_length,
+                                                  void** out_ptr) {
+  iree_hal_heap_cache_t* cache = (iree_hal_heap_cache_t*)self;
+  IREE_ASSERT_ARGUMENT(out_ptr);
+  if (byte_length == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocations must be >0 bytes");
+  }
+
+  void* existing_ptr =
+      iree_all_bits_set(mode, IREE_ALLOCATION_MODE_TRY_REUSE_EXISTING)
+          ? *out_ptr
+          : NULL;
+  if (existing_ptr &&
+      iree_hal_heap_cache_block_header(existing_ptr)->block_size >=
+          byte_length) {
+    // Existing block has enough slack to hold the new size.
+    if (iree_all_bits_set(mode, IREE_ALLOCATION_MODE_ZERO_CONTENTS)) {
+      memset(existing_ptr, 0, byte_length);
+    }
+    return iree_ok_status();
+  }
+
+  void* ptr = NULL;
+  if (byte_length > iree_hal_heap_cache_class_size(cache->size_class_count -
+                                                   1)) {
+    IREE_RETURN_IF_ERROR(iree_hal_heap_cache_allocate_block(
+        cache, IREE_HAL_HEAP_CACHE_UNCACHED_CLASS, byte_length, &ptr));
+  } else {
+    uint32_t size_class = iree_hal_heap_cache_size_class(byte_length);
+    iree_host_size_t block_size = iree_hal_heap_cache_class_size(size_class);
+    ptr = iree_hal_heap_cache_acquire(cache, size_class);
+    if (ptr) {
+      iree_hal_heap_cache_note_retained(cache, -(int64_t)block_size);
+      iree_atomic_fetch_add_int64(&cache->hit_count, 1,
+                                  iree_memory_order_relaxed);
+      if (iree_all_bits_set(mode, IREE_ALLOCATION_MODE_ZERO_CONTENTS)) {
+        memset(ptr, 0, byte_length);
+      }
+    } else {
+      iree_atomic_fetch_add_int64(&cache->miss_count, 1,
+                                  iree_memory_order_relaxed);
+      IREE_RETURN_IF_ERROR(iree_hal_heap_cache_allocate_block(
+          cache, size_class, block_size, &ptr));
+    }
+  }
+
+  iree_atomic_ref_count_inc(&cache->ref_count);
+  if (existing_ptr) {
+    memcpy(ptr, existing_ptr,
+           iree_hal_heap_cache_block_header(existing_ptr)->block_size);
+    iree_hal_heap_cache_free(cache, existing_ptr);
+  }
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+static iree_allocator_t iree_hal_heap_cache_allocator(
+    iree_hal_heap_cache_t* cache) {
+  iree_allocator_t v = {cache, iree_hal_heap_cache_allocate,
+                        iree_hal_heap_cache_free};
+  return v;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_allocator_t
+//===----------------------------------------------------------------------===//
+
 typedef struct iree_hal_heap_allocator_s {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
+
+  // Optional cache that buffer storage is allocated from; NULL if disabled.
+  iree_hal_heap_cache_t* cache;
 } iree_hal_heap_allocator_t;
 
 static const iree_hal_allocator_vtable_t iree_hal_heap_allocator_vtable;
 
+IREE_API_EXPORT void iree_hal_heap_allocator_cache_params_initialize(
+    iree_hal_heap_allocator_cache_params_t* out_params) {
+  memset(out_params, 0, sizeof(*out_params));
+  out_params->max_retained_size = 256 * 1024 * 1024;
+  out_params->max_block_size = 64 * 1024 * 1024;
+  out_params->magazine_capacity = 4;
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
     iree_hal_allocator_t** out_allocator) {
+  return iree_hal_allocator_create_heap_with_cache(identifier, NULL,
+                                                   host_allocator,
+                                                   out_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_with_cache(
+    iree_string_view_t identifier,
+    const iree_hal_heap_allocator_cache_params_t* cache_params,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(out_allocator);
+  *out_allocator = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_heap_allocator_t* allocator = NULL;
@@ -34,11 +488,21 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_append_to_buffer(
         identifier, &allocator->identifier,
         (char*)allocator + total_size - identifier.size);
-    *out_allocator = (iree_hal_allocator_t*)allocator;
   }
 
+  if (iree_status_is_ok(status) && cache_params &&
+      cache_params->max_retained_size > 0) {
+    status = iree_hal_heap_cache_create(cache_params, host_allocator,
+                                        &allocator->cache);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_allocator = (iree_hal_allocator_t*)allocator;
+  } else if (allocator) {
+    iree_allocator_free(host_allocator, allocator);
+  }
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_heap_allocator_destroy(
@@ -48,11 +512,48 @@ static void iree_hal_heap_allocator_destroy(
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (allocator->cache) {
+    iree_hal_heap_cache_close(allocator->cache);
+  }
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Returns the cache of |base_allocator| if it is a caching heap allocator.
+static iree_hal_heap_cache_t* iree_hal_heap_allocator_cache(
+    iree_hal_allocator_t* base_allocator) {
+  if (!base_allocator ||
+      !iree_hal_resource_is(base_allocator, &iree_hal_heap_allocator_vtable)) {
+    return NULL;
+  }
+  return ((iree_hal_heap_allocator_t*)base_allocator)->cache;
+}
+
+IREE_API_EXPORT void iree_hal_heap_allocator_trim(
+    iree_hal_allocator_t* base_allocator, iree_host_size_t max_retained_size) {
+  iree_hal_heap_cache_t* cache = iree_hal_heap_allocator_cache(base_allocator);
+  if (cache) iree_hal_heap_cache_trim(cache, max_retained_size);
+}
+
+IREE_API_EXPORT void iree_hal_heap_allocator_query_cache_statistics(
+    iree_hal_allocator_t* base_allocator,
+    iree_hal_heap_allocator_cache_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  iree_hal_heap_cache_t* cache = iree_hal_heap_allocator_cache(base_allocator);
+  if (!cache) return;
+  out_statistics->retained_size = (iree_host_size_t)iree_atomic_load_int64(
+      &cache->retained_size, iree_memory_order_relaxed);
+  out_statistics->high_water_retained_size =
+      (iree_host_size_t)iree_atomic_load_int64(
+          &cache->high_water_retained_size, iree_memory_order_relaxed);
+  out_statistics->hit_count = (uint64_t)iree_atomic_load_int64(
+      &cache->hit_count, iree_memory_order_relaxed);
+  out_statistics->miss_count = (uint64_t)iree_atomic_load_int64(
+      &cache->miss_count, iree_memory_order_relaxed);
+}
+
 static iree_allocator_t iree_hal_heap_allocator_host_allocator(
     const iree_hal_allocator_t* base_allocator) {
   iree_hal_heap_allocator_t* allocator =
@@ -123,10 +624,14 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   IREE_RETURN_IF_ERROR(iree_hal_heap_allocator_make_compatible(
       &memory_type, &allowed_access, &allowed_usage));
 
-  // Allocate and return the buffer.
+  // Allocate and return the buffer. Storage comes from the cache when enabled
+  // so that transient buffers are recycled instead of hitting the system heap.
   return iree_hal_heap_buffer_create(
       base_allocator, memory_type, allowed_access, allowed_usage,
-      allocation_size, allocator->host_allocator, out_buffer);
+      allocation_size,
+      allocator->cache ? iree_hal_heap_cache_allocator(allocator->cache)
+                       : allocator->host_allocator,
+      out_buffer);
 }
 
 static iree_status_t iree_hal_heap_allocator_wrap_buffer(
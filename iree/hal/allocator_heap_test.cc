@@ -0,0 +1,159 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class HeapAllocatorCacheTest : public ::testing::Test {
+ protected:
+  void CreateAllocator(iree_host_size_t max_retained_size,
+                       iree_host_size_t max_block_size = 64 * 1024) {
+    iree_hal_heap_allocator_cache_params_t params;
+    iree_hal_heap_allocator_cache_params_initialize(&params);
+    params.max_retained_size = max_retained_size;
+    params.max_block_size = max_block_size;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap_with_cache(
+        iree_make_cstring_view("cached"), &params, iree_allocator_system(),
+        &allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(allocator_); }
+
+  iree_hal_buffer_t* Allocate(iree_host_size_t size) {
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        allocator_, IREE_HAL_MEMORY_TYPE_HOST_LOCAL, IREE_HAL_BUFFER_USAGE_ALL,
+        size, &buffer));
+    return buffer;
+  }
+
+  // Returns the base pointer of |buffer| contents and whether they are zero.
+  static uint8_t* MapContents(iree_hal_buffer_t* buffer, bool* out_is_zero) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+        IREE_WHOLE_BUFFER, &mapping));
+    *out_is_zero = true;
+    for (iree_host_size_t i = 0; i < mapping.contents.data_length; ++i) {
+      if (mapping.contents.data[i]) *out_is_zero = false;
+    }
+    uint8_t* data = mapping.contents.data;
+    memset(data, 0xAB, mapping.contents.data_length);
+    iree_hal_buffer_unmap_range(&mapping);
+    return data;
+  }
+
+  iree_hal_heap_allocator_cache_statistics_t QueryStatistics() {
+    iree_hal_heap_allocator_cache_statistics_t statistics;
+    iree_hal_heap_allocator_query_cache_statistics(allocator_, &statistics);
+    return statistics;
+  }
+
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+// Without cache params the heap allocator behaves as before and reports no
+// cache activity.
+TEST_F(HeapAllocatorCacheTest, Disabled) {
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+      iree_make_cstring_view("uncached"), iree_allocator_system(),
+      &allocator_));
+  iree_hal_buffer_release(Allocate(1024));
+  iree_hal_heap_allocator_trim(allocator_, 0);
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.retained_size, 0);
+  EXPECT_EQ(statistics.hit_count, 0);
+  EXPECT_EQ(statistics.miss_count, 0);
+}
+
+// Storage of a released buffer is reused by the next buffer of the same size
+// class, zeroed and aligned.
+TEST_F(HeapAllocatorCacheTest, ReusesReleasedStorage) {
+  CreateAllocator(1024 * 1024);
+
+  bool is_zero = false;
+  iree_hal_buffer_t* buffer = Allocate(1000);
+  uint8_t* first_data = MapContents(buffer, &is_zero);
+  EXPECT_TRUE(is_zero);
+  EXPECT_EQ((uintptr_t)first_data % 64, 0);
+  iree_hal_buffer_release(buffer);
+  EXPECT_GT(QueryStatistics().retained_size, 0);
+
+  buffer = Allocate(900);
+  uint8_t* second_data = MapContents(buffer, &is_zero);
+  EXPECT_TRUE(is_zero);
+  EXPECT_EQ(first_data, second_data);
+  iree_hal_buffer_release(buffer);
+
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.hit_count, 1);
+  EXPECT_EQ(statistics.miss_count, 1);
+}
+
+// Blocks released past the retention limit go back to the host allocator.
+TEST_F(HeapAllocatorCacheTest, RetentionLimit) {
+  CreateAllocator(8 * 1024);
+  iree_hal_buffer_t* buffers[8];
+  for (size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    buffers[i] = Allocate(2000);
+  }
+  for (size_t i = 0; i < IREE_ARRAYSIZE(buffers); ++i) {
+    iree_hal_buffer_release(buffers[i]);
+  }
+  auto statistics = QueryStatistics();
+  EXPECT_GT(statistics.retained_size, 0);
+  EXPECT_LE(statistics.retained_size, 8 * 1024);
+  EXPECT_EQ(statistics.high_water_retained_size, statistics.retained_size);
+}
+
+// Allocations larger than the maximum block size are never retained.
+TEST_F(HeapAllocatorCacheTest, LargeAllocationsBypassCache) {
+  CreateAllocator(16 * 1024 * 1024, /*max_block_size=*/64 * 1024);
+  iree_hal_buffer_release(Allocate(1024 * 1024));
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.retained_size, 0);
+  EXPECT_EQ(statistics.miss_count, 0);
+}
+
+// Trimming releases the largest blocks first down to the requested size and
+// resets the high-water mark.
+TEST_F(HeapAllocatorCacheTest, Trim) {
+  CreateAllocator(16 * 1024 * 1024);
+  iree_hal_buffer_t* small_buffer = Allocate(1024);
+  iree_hal_buffer_t* large_buffer = Allocate(32 * 1024);
+  iree_hal_buffer_release(small_buffer);
+  iree_host_size_t small_size = QueryStatistics().retained_size;
+  iree_hal_buffer_release(large_buffer);
+  EXPECT_GE(QueryStatistics().high_water_retained_size,
+            small_size + 32 * 1024);
+
+  iree_hal_heap_allocator_trim(allocator_, small_size);
+  auto statistics = QueryStatistics();
+  EXPECT_EQ(statistics.retained_size, small_size);
+  EXPECT_EQ(statistics.high_water_retained_size, small_size);
+
+  iree_hal_heap_allocator_trim(allocator_, 0);
+  EXPECT_EQ(QueryStatistics().retained_size, 0);
+}
+
+// Buffers may be released after the allocator that created them.
+TEST_F(HeapAllocatorCacheTest, BuffersOutliveAllocator) {
+  CreateAllocator(1024 * 1024);
+  iree_hal_buffer_t* retained_buffer = Allocate(4096);
+  iree_hal_buffer_release(Allocate(4096));
+  iree_hal_allocator_release(allocator_);
+  allocator_ = NULL;
+  iree_hal_buffer_release(retained_buffer);
+}
+
+}  // namespace
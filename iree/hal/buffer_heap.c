@@ -7,6 +7,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
+#include "iree/hal/buffer_heap_impl.h"
 #include "iree/hal/detail.h"
 
 typedef struct iree_hal_heap_buffer_s {
@@ -14,6 +15,10 @@ typedef struct iree_hal_heap_buffer_s {
 
   iree_byte_span_t data;
   iree_allocator_t data_allocator;
+
+  // Allocator the buffer itself (and for non-wrapped buffers the data) was
+  // allocated from and must be freed to.
+  iree_allocator_t host_allocator;
 } iree_hal_heap_buffer_t;
 
 static const iree_hal_buffer_vtable_t iree_hal_heap_buffer_vtable;
@@ -28,7 +33,8 @@ iree_status_t iree_hal_heap_buffer_create(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_heap_buffer_t* buffer = NULL;
-  iree_host_size_t header_size = iree_host_align(sizeof(*buffer), 16);
+  iree_host_size_t header_size =
+      iree_host_align(sizeof(*buffer), IREE_HAL_HEAP_BUFFER_ALIGNMENT);
   iree_host_size_t total_size = header_size + allocation_size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&buffer);
@@ -46,11 +52,12 @@ iree_status_t iree_hal_heap_buffer_create(
     buffer->data =
         iree_make_byte_span((uint8_t*)buffer + header_size, allocation_size);
     buffer->data_allocator = iree_allocator_null();  // freed with the buffer
+    buffer->host_allocator = host_allocator;
     *out_buffer = &buffer->base;
   }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_hal_heap_buffer_wrap(
@@ -64,9 +71,10 @@ IREE_API_EXPORT iree_status_t iree_hal_heap_buffer_wrap(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_heap_buffer_t* buffer = NULL;
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(allocator);
   iree_status_t status =
-      iree_allocator_malloc(iree_hal_allocator_host_allocator(allocator),
-                            sizeof(*buffer), (void**)&buffer);
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer);
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(&iree_hal_heap_buffer_vtable,
                                  &buffer->base.resource);
@@ -80,17 +88,17 @@ IREE_API_EXPORT iree_status_t iree_hal_heap_buffer_wrap(
     buffer->base.allowed_usage = allowed_usage;
     buffer->data = data;
     buffer->data_allocator = data_allocator;
+    buffer->host_allocator = host_allocator;
     *out_buffer = &buffer->base;
   }
 
   IREE_TRACE_ZONE_END(z0);
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   iree_hal_heap_buffer_t* buffer = (iree_hal_heap_buffer_t*)base_buffer;
-  iree_allocator_t host_allocator =
-      iree_hal_allocator_host_allocator(iree_hal_buffer_allocator(base_buffer));
+  iree_allocator_t host_allocator = buffer->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_allocator_free(buffer->data_allocator, buffer->data.data);
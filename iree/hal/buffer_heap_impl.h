@@ -18,7 +18,14 @@ extern "C" {
 // Private utilities for working with heap buffers
 //===----------------------------------------------------------------------===//
 
+// Alignment of heap buffer contents relative to the start of the allocation.
+// Contents are aligned to this in memory when the host allocator returns
+// allocations aligned to it (such as the heap allocator block cache).
+#define IREE_HAL_HEAP_BUFFER_ALIGNMENT 64
+
 // Allocates a new heap buffer from the specified |host_allocator|.
+// The buffer and its contents are allocated together and freed back to
+// |host_allocator| when the buffer is destroyed.
 // |out_buffer| must be released by the caller.
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
@@ -244,6 +244,242 @@ TEST_P(CommandBufferTest, CopySubBuffer) {
   iree_hal_buffer_release(host_buffer);
 }
 
+TEST_P(CommandBufferTest, ResubmitReusable) {
+  // Command buffers without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT may be
+  // submitted any number of times after recording.
+  iree_hal_command_buffer_t* command_buffer;
+  iree_status_t status = iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+      IREE_HAL_QUEUE_AFFINITY_ANY, &command_buffer);
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "reusable command buffers not supported by the driver";
+  }
+  IREE_ASSERT_OK(status);
+
+  iree_hal_buffer_t* device_buffer;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &device_buffer));
+
+  std::vector<uint8_t> reference_buffer(kBufferSize);
+
+  // Fill the first half, barrier, and then fill the second half so that the
+  // recorded DAG has more than one level.
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  uint8_t val1 = 0x07;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer,
+      /*target_offset=*/0, /*length=*/kBufferSize / 2, /*pattern=*/&val1,
+      /*pattern_length=*/sizeof(val1)));
+  std::memset(reference_buffer.data(), val1, kBufferSize / 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      IREE_HAL_EXECUTION_STAGE_TRANSFER, IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+      /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  uint8_t val2 = 0xbe;
+  IREE_ASSERT_OK(
+      iree_hal_command_buffer_fill_buffer(command_buffer, device_buffer,
+                                          /*target_offset=*/kBufferSize / 2,
+                                          /*length=*/kBufferSize / 2,
+                                          /*pattern=*/&val2,
+                                          /*pattern_length=*/sizeof(val2)));
+  std::memset(reference_buffer.data() + kBufferSize / 2, val2, kBufferSize / 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  for (int i = 0; i < 3; ++i) {
+    // Clear the buffer so that we know each submission wrote the results.
+    uint8_t zero = 0;
+    IREE_ASSERT_OK(iree_hal_buffer_fill(device_buffer, /*byte_offset=*/0,
+                                        /*byte_length=*/kBufferSize, &zero,
+                                        /*pattern_length=*/sizeof(zero)));
+
+    IREE_ASSERT_OK(SubmitCommandBufferAndWait(
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER, command_buffer));
+
+    std::vector<uint8_t> actual_data(kBufferSize);
+    IREE_ASSERT_OK(
+        iree_hal_buffer_read_data(device_buffer, /*source_offset=*/0,
+                                  /*target_buffer=*/actual_data.data(),
+                                  /*data_length=*/kBufferSize));
+    EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+  }
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(device_buffer);
+}
+
+TEST_P(CommandBufferTest, ResubmitReusableOverlapped) {
+  // Submitting a reusable command buffer again while a prior submission of it
+  // is still being issued or executed must not share in-flight state.
+  iree_hal_command_buffer_t* command_buffer;
+  iree_status_t status = iree_hal_command_buffer_create(
+      device_, /*mode=*/0, IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+      IREE_HAL_QUEUE_AFFINITY_ANY, &command_buffer);
+  if (iree_status_is_unimplemented(status)) {
+    iree_status_ignore(status);
+    GTEST_SKIP() << "reusable command buffers not supported by the driver";
+  }
+  IREE_ASSERT_OK(status);
+
+  iree_hal_buffer_t* source_buffer;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &source_buffer));
+  iree_hal_buffer_t* target_buffer;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &target_buffer));
+  uint8_t zero = 0;
+  IREE_ASSERT_OK(iree_hal_buffer_fill(target_buffer, /*byte_offset=*/0,
+                                      /*byte_length=*/kBufferSize, &zero,
+                                      /*pattern_length=*/sizeof(zero)));
+
+  // Fill, barrier, copy so that each submission runs a multi-level DAG.
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  uint8_t val = 0x5a;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, source_buffer, /*target_offset=*/0,
+      /*length=*/kBufferSize, /*pattern=*/&val,
+      /*pattern_length=*/sizeof(val)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+      command_buffer, IREE_HAL_EXECUTION_STAGE_TRANSFER,
+      IREE_HAL_EXECUTION_STAGE_TRANSFER, IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+      /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+      /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, /*source_buffer=*/source_buffer, /*source_offset=*/0,
+      /*target_buffer=*/target_buffer, /*target_offset=*/0,
+      /*length=*/kBufferSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  // Submit back-to-back without waiting so that later issues overlap the
+  // execution of earlier ones. Submissions may retire in any order so each
+  // signals its own semaphore.
+  static constexpr int kSubmissionCount = 16;
+  iree_hal_semaphore_t* signal_semaphores[kSubmissionCount];
+  for (int i = 0; i < kSubmissionCount; ++i) {
+    IREE_ASSERT_OK(
+        iree_hal_semaphore_create(device_, 0ull, &signal_semaphores[i]));
+    uint64_t signal_value = 1ull;
+    iree_hal_submission_batch_t submission_batch;
+    std::memset(&submission_batch, 0, sizeof(submission_batch));
+    submission_batch.command_buffer_count = 1;
+    submission_batch.command_buffers = &command_buffer;
+    submission_batch.signal_semaphores.count = 1;
+    submission_batch.signal_semaphores.semaphores = &signal_semaphores[i];
+    submission_batch.signal_semaphores.payload_values = &signal_value;
+    IREE_ASSERT_OK(iree_hal_device_queue_submit(
+        device_, IREE_HAL_COMMAND_CATEGORY_TRANSFER, /*queue_affinity=*/0,
+        /*batch_count=*/1, &submission_batch));
+  }
+  for (int i = 0; i < kSubmissionCount; ++i) {
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(signal_semaphores[i], 1ull,
+                                           iree_infinite_timeout()));
+    iree_hal_semaphore_release(signal_semaphores[i]);
+  }
+
+  std::vector<uint8_t> reference_buffer(kBufferSize, val);
+  std::vector<uint8_t> actual_data(kBufferSize);
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(target_buffer, /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+
+  // The command buffer remains reusable after the overlapped submissions.
+  IREE_ASSERT_OK(iree_hal_buffer_fill(target_buffer, /*byte_offset=*/0,
+                                      /*byte_length=*/kBufferSize, &zero,
+                                      /*pattern_length=*/sizeof(zero)));
+  IREE_ASSERT_OK(SubmitCommandBufferAndWait(IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+                                            command_buffer));
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(target_buffer, /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(source_buffer);
+  iree_hal_buffer_release(target_buffer);
+}
+
+TEST_P(CommandBufferTest, BarrierHazards) {
+  // Commands separated by barriers must observe the results of the commands
+  // before the barrier that they depend on regardless of how much independent
+  // work was recorded around them.
+  iree_hal_command_buffer_t* command_buffer;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &command_buffer));
+
+  iree_hal_buffer_t* device_buffer;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator_,
+      IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+      IREE_HAL_BUFFER_USAGE_ALL, kBufferSize, &device_buffer));
+  const iree_device_size_t kQuarterSize = kBufferSize / 4;
+
+  auto barrier = [&]() {
+    IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+        /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+        /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  };
+
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  // [0] = 0x01
+  uint8_t val1 = 0x01;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer, /*target_offset=*/0,
+      /*length=*/kQuarterSize, &val1, /*pattern_length=*/sizeof(val1)));
+  barrier();
+  // [1] = 0x02 (independent), [2] = [0] (read-after-write)
+  uint8_t val2 = 0x02;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer, /*target_offset=*/kQuarterSize,
+      /*length=*/kQuarterSize, &val2, /*pattern_length=*/sizeof(val2)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, device_buffer, /*source_offset=*/0, device_buffer,
+      /*target_offset=*/2 * kQuarterSize, /*length=*/kQuarterSize));
+  barrier();
+  // [0] = 0x03 (write-after-read), [3] = [2] (read-after-write)
+  uint8_t val3 = 0x03;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, device_buffer, /*target_offset=*/0,
+      /*length=*/kQuarterSize, &val3, /*pattern_length=*/sizeof(val3)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, device_buffer, /*source_offset=*/2 * kQuarterSize,
+      device_buffer, /*target_offset=*/3 * kQuarterSize,
+      /*length=*/kQuarterSize));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  IREE_ASSERT_OK(SubmitCommandBufferAndWait(IREE_HAL_COMMAND_CATEGORY_TRANSFER,
+                                            command_buffer));
+
+  std::vector<uint8_t> reference_buffer(kBufferSize);
+  std::memset(reference_buffer.data(), val3, kQuarterSize);
+  std::memset(reference_buffer.data() + kQuarterSize, val2, kQuarterSize);
+  std::memset(reference_buffer.data() + 2 * kQuarterSize, val1,
+              2 * kQuarterSize);
+  std::vector<uint8_t> actual_data(kBufferSize);
+  IREE_ASSERT_OK(iree_hal_buffer_read_data(device_buffer, /*source_offset=*/0,
+                                           /*target_buffer=*/actual_data.data(),
+                                           /*data_length=*/kBufferSize));
+  EXPECT_THAT(actual_data, ContainerEq(reference_buffer));
+
+  // Must release the command buffer before resources used by it.
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(device_buffer);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     AllDrivers, CommandBufferTest,
     ::testing::ValuesIn(testing::EnumerateAvailableDrivers()),
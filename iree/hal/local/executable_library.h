@@ -78,13 +78,16 @@ enum iree_hal_executable_library_version_e {
   // iree_hal_executable_library_v0_t is used as the API communication
   // structure.
   IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0 = 0u,
+  // iree_hal_executable_library_v1_t is used as the API communication
+  // structure. Adds per-worker local memory to each workgroup invocation.
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1 = 1u,
 };
 typedef uint32_t iree_hal_executable_library_version_t;
 
 // The latest version of the library API; can be used to populate the
 // iree_hal_executable_library_header_t::version when building libraries.
 #define IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION \
-  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1
 
 // A header present at the top of all versions of the library API used by the
 // runtime to ensure version compatibility.
@@ -208,4 +211,77 @@ typedef struct {
   // TODO(benvanik): optional import declarations.
 } iree_hal_executable_library_v0_t;
 
+//===----------------------------------------------------------------------===//
+// IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1
+//===----------------------------------------------------------------------===//
+
+// Minimum alignment of the local memory provided to each workgroup invocation.
+// Matches the destructive interference size of all supported targets such that
+// the local memory of two workers never shares a cache line.
+#define IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT 64
+
+// Read-only per-dispatch state passed to each workgroup in a dispatch.
+// Unchanged from v0.
+typedef iree_hal_executable_dispatch_state_v0_t
+    iree_hal_executable_dispatch_state_v1_t;
+
+// Per-invocation state passed to each workgroup in a dispatch.
+//
+// The workgroup ID is the first member such that a pointer to this structure
+// is also a valid `const iree_hal_vec3_t* workgroup_id` as passed to v0 entry
+// points; runtimes can use the same call path for both versions.
+typedef struct {
+  // Workgroup ID of the invocation within the dispatch workgroup count.
+  iree_hal_vec3_t workgroup_id;
+  uint32_t reserved;
+
+  // Scratch memory local to the worker executing the invocation. Aligned to at
+  // least IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT and at least as large as
+  // the requirement declared for the entry point in
+  // iree_hal_executable_library_v1_t::entry_point_local_memory_sizes.
+  //
+  // The memory is reused by all invocations executed by the same worker:
+  // contents are undefined on entry and must not be relied upon across
+  // invocations. Entry points that declare no requirement may receive NULL.
+  void* IREE_RESTRICT local_memory;
+  // Total size of |local_memory| in bytes. May be larger than requested.
+  size_t local_memory_size;
+} iree_hal_executable_workgroup_state_v1_t;
+
+// Function signature of exported executable entry points.
+// The same |dispatch_state| is passed to all workgroups in a dispatch while
+// |workgroup_state| will vary for each workgroup.
+//
+// Returns 0 on success and non-zero on failure; see
+// iree_hal_executable_dispatch_v0_t for details.
+typedef int (*iree_hal_executable_dispatch_v1_t)(
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state);
+
+// Structure used for v1 library interfaces.
+// All members up to and including |entry_point_tags| are layout compatible with
+// iree_hal_executable_library_v0_t.
+typedef struct {
+  // Version/metadata header. Will have a version of
+  // IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1.
+  const iree_hal_executable_library_header_t* header;
+
+  // The total number of entry points available in the library. Bounds all of
+  // the tables below.
+  uint32_t entry_point_count;
+  // Table of export function entry points matching the ordinals defined during
+  // library generation.
+  const iree_hal_executable_dispatch_v1_t* entry_points;
+  // Optional table of export function entry point names 1:1 with entry_points.
+  const char* const* entry_point_names;
+  // Optional table of entry point tags 1:1 with entry_points.
+  const char* const* entry_point_tags;
+
+  // Optional table of local memory requirements in bytes 1:1 with
+  // entry_points. The runtime allocates local memory once per worker and
+  // dispatches of entry points with requirements exceeding what it provides
+  // will fail. Omitted if no entry point requires local memory.
+  const uint32_t* entry_point_local_memory_sizes;
+} iree_hal_executable_library_v1_t;
+
 #endif  // IREE_HAL_LOCAL_EXECUTABLE_LIBRARY_H_
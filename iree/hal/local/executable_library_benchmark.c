@@ -40,6 +40,10 @@ IREE_FLAG(int32_t, workgroup_size_y, 1,
 IREE_FLAG(int32_t, workgroup_size_z, 1,
           "Z dimension of the workgroup size passed to the executable.");
 
+IREE_FLAG(int32_t, local_memory_size, 64 * 1024,
+          "Bytes of local memory passed to each workgroup invocation.\n"
+          "Entry points requiring more local memory will fail to run.");
+
 // Total number of bindings we (currently) allow any executable to have.
 #define IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT \
   (IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *   \
@@ -257,8 +261,22 @@ static iree_status_t iree_hal_executable_library_run(
     binding_lengths[i] = (size_t)buffer_mapping.contents.data_length;
   }
 
+  // Allocate local memory shared by all invocations as they are run serially.
+  iree_host_size_t local_memory_size = iree_host_align(
+      (iree_host_size_t)iree_max(0, FLAG_local_memory_size),
+      IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT);
+  void* local_memory_allocation = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      local_memory_size + IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT - 1,
+      &local_memory_allocation));
+  iree_byte_span_t local_memory = iree_make_byte_span(
+      (void*)iree_host_align((uintptr_t)local_memory_allocation,
+                             IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT),
+      local_memory_size);
+
   // Setup dispatch state.
-  iree_hal_executable_dispatch_state_v0_t dispatch_state = {
+  iree_hal_executable_dispatch_state_v1_t dispatch_state = {
       .workgroup_count = {{
           .x = FLAG_workgroup_count_x,
           .y = FLAG_workgroup_count_y,
@@ -288,7 +306,7 @@ static iree_status_t iree_hal_executable_library_run(
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z1, iree_hal_local_executable_issue_dispatch_inline(
                 iree_hal_local_executable_cast(executable), FLAG_entry_point,
-                &dispatch_state));
+                &dispatch_state, local_memory));
     ++dispatch_count;
   }
   IREE_TRACE_ZONE_END(z1);
@@ -306,6 +324,7 @@ static iree_status_t iree_hal_executable_library_run(
     iree_hal_buffer_view_release(buffer_views[i]);
   }
   iree_hal_allocator_release(heap_allocator);
+  iree_allocator_free(host_allocator, local_memory_allocation);
 
   // Unload.
   iree_allocator_free(host_allocator,
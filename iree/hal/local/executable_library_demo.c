@@ -9,10 +9,12 @@
 // An executable entry point, called one or more times based on the 3D XYZ
 // workgroup count specified during the dispatch. Each invocation gets access to
 // the dispatch state via |dispatch_state| such as workgroup parameters, push
-// constants providing small arguments, and buffer bindings.
+// constants providing small arguments, and buffer bindings. The per-invocation
+// |workgroup_state| contains the workgroup ID and worker-local memory.
 //
-// See the iree_hal_executable_dispatch_state_v0_t struct for more
-// information on the fields here and how they can be used.
+// See the iree_hal_executable_dispatch_state_v1_t and
+// iree_hal_executable_workgroup_state_v1_t structs for more information on the
+// fields here and how they can be used.
 //
 // WARNING: these functions must not access mutable global state: read-only data
 // may be used but as each invocation may be running concurrently with any
@@ -22,20 +24,25 @@
 // This is a simple scalar addition:
 //    binding[1] = binding[0] + push_constant[0]
 static int dispatch_tile_a(
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   const dispatch_tile_a_push_constants_t* push_constants =
       (const dispatch_tile_a_push_constants_t*)dispatch_state->push_constants;
   const float* src = ((const float*)dispatch_state->binding_ptrs[0]);
   float* dst = ((float*)dispatch_state->binding_ptrs[1]);
-  dst[workgroup_id->x] = src[workgroup_id->x] + push_constants->f0;
+  uint32_t x = workgroup_state->workgroup_id.x;
+  dst[x] = src[x] + push_constants->f0;
   return 0;
 }
 
-// Just another entry point.
+// Just another entry point; this one declares that it needs local memory (as
+// a packing buffer or the like would) and fails if it was not provided.
 static int dispatch_tile_b(
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
+  if (workgroup_state->local_memory_size < 4096) return 1;
+  float* scratch = (float*)workgroup_state->local_memory;
+  for (size_t i = 0; i < 4096 / sizeof(float); ++i) scratch[i] = 0.0f;
   return 0;
 }
 
@@ -51,7 +58,7 @@ static const iree_hal_executable_library_header_t header = {
     .sanitizer = IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
 };
 // Table of export function entry points.
-static const iree_hal_executable_dispatch_v0_t entry_points[2] = {
+static const iree_hal_executable_dispatch_v1_t entry_points[2] = {
     dispatch_tile_a,
     dispatch_tile_b,
 };
@@ -65,12 +72,18 @@ static const char* entry_point_tags[2] = {
     "matmul+div",
     "conv2d[512x512]",
 };
-static const iree_hal_executable_library_v0_t library = {
+// Local memory required by each entry point in bytes.
+static const uint32_t entry_point_local_memory_sizes[2] = {
+    0,
+    4096,
+};
+static const iree_hal_executable_library_v1_t library = {
     .header = &header,
     .entry_point_count = 2,
     .entry_points = entry_points,
     .entry_point_names = entry_point_names,
     .entry_point_tags = entry_point_tags,
+    .entry_point_local_memory_sizes = entry_point_local_memory_sizes,
 };
 
 // The primary access point to the executable: in a static library this is
@@ -84,7 +97,7 @@ static const iree_hal_executable_library_v0_t library = {
 // architecture-specific version.
 const iree_hal_executable_library_header_t** demo_executable_library_query(
     iree_hal_executable_library_version_t max_version, void* reserved) {
-  return max_version <= 0
+  return max_version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1
              ? (const iree_hal_executable_library_header_t**)&library
              : NULL;
 }
@@ -39,6 +39,7 @@ typedef union {
 // [1] 'dispatch_tile_b': conv2d[512x512]
 //       push constants: 0
 //       bindings: 0
+//       local memory: 4096 bytes
 //
 const iree_hal_executable_library_header_t** demo_executable_library_query(
     iree_hal_executable_library_version_t max_version, void* reserved);
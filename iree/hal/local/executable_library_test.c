@@ -17,8 +17,9 @@
 //
 // This shows what the various execution systems are doing (through a lot
 // of fancy means): all `inline_command_buffer.c` and `task_command_buffer.c`
-// lead up to just calling into the iree_hal_executable_dispatch_v0_t entry
-// point functions with a state structure and a workgroup XYZ.
+// lead up to just calling into the iree_hal_executable_dispatch_v1_t entry
+// point functions with a state structure and a per-workgroup state containing
+// the workgroup XYZ and worker-local memory.
 //
 // Below walks through acquiring the library pointer (which in this case is a
 // hand-coded example to show the codegen-side), setting up the I/O buffers and
@@ -31,7 +32,7 @@ int main(int argc, char** argv) {
   // but could be targeted at generated files or runtime-loaded shared objects.
   union {
     const iree_hal_executable_library_header_t** header;
-    const iree_hal_executable_library_v0_t* v0;
+    const iree_hal_executable_library_v1_t* v1;
   } library;
   library.header = demo_executable_library_query(
       IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, /*reserved=*/NULL);
@@ -42,7 +43,7 @@ int main(int argc, char** argv) {
       "expecting the library to have the same or older version as us");
   IREE_ASSERT(strcmp(header->name, "demo_library") == 0,
               "library name can be used to rendezvous in a registry");
-  IREE_ASSERT_GT(library.v0->entry_point_count, 0,
+  IREE_ASSERT_GT(library.v1->entry_point_count, 0,
                  "expected at least one entry point");
 
   // Push constants are an array of 4-byte values that are much more efficient
@@ -69,11 +70,19 @@ int main(int argc, char** argv) {
   };
 
   // Resolve the entry point by ordinal.
-  const iree_hal_executable_dispatch_v0_t entry_fn_ptr =
-      library.v0->entry_points[0];
+  const iree_hal_executable_dispatch_v1_t entry_fn_ptr =
+      library.v1->entry_points[0];
+
+  // Local memory is allocated once per worker and sized to the largest
+  // requirement of any entry point that may run on it. This demo runs all
+  // invocations serially and can use the same (cache line aligned) memory.
+  IREE_ASSERT_EQ(library.v1->entry_point_local_memory_sizes[0], 0,
+                 "entry point 0 requires no local memory");
+  static iree_alignas(IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT) uint8_t
+      local_memory[4096];
 
   // Dispatch each workgroup with the same state.
-  iree_hal_executable_dispatch_state_v0_t dispatch_state = {
+  iree_hal_executable_dispatch_state_v1_t dispatch_state = {
       .workgroup_count = {{4, 1, 1}},
       .workgroup_size = {{1, 1, 1}},
       .push_constant_count = IREE_ARRAYSIZE(push_constants.values),
@@ -87,8 +96,12 @@ int main(int argc, char** argv) {
     for (uint32_t y = 0; y < dispatch_state.workgroup_count.y; ++y) {
       for (uint32_t x = 0; x < dispatch_state.workgroup_count.x; ++x) {
         // Invoke the workgroup (x, y, z).
-        iree_hal_vec3_t workgroup_id = {{x, y, z}};
-        int ret = entry_fn_ptr(&dispatch_state, &workgroup_id);
+        iree_hal_executable_workgroup_state_v1_t workgroup_state = {
+            .workgroup_id = {{x, y, z}},
+            .local_memory = local_memory,
+            .local_memory_size = sizeof(local_memory),
+        };
+        int ret = entry_fn_ptr(&dispatch_state, &workgroup_state);
         IREE_ASSERT_EQ(
             ret, 0,
             "if we have bounds checking enabled the executable will signal "
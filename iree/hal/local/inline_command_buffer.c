@@ -25,6 +25,12 @@ typedef struct {
   iree_hal_command_category_t allowed_categories;
   iree_hal_queue_affinity_t queue_affinity;
 
+  // Local memory provided to dispatches executed inline. Grown on demand to the
+  // largest requirement of any dispatched entry point and retained across
+  // resets. |local_memory_allocation| is the unaligned allocation base.
+  void* local_memory_allocation;
+  iree_byte_span_t local_memory;
+
   struct {
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -52,7 +58,7 @@ typedef struct {
     // Cached and initialized dispatch state reused for all dispatches.
     // Individual dispatches must populate the dynamically changing fields like
     // push_constant_count and binding_count.
-    iree_hal_executable_dispatch_state_v0_t dispatch_state;
+    iree_hal_executable_dispatch_state_v1_t dispatch_state;
   } state;
 } iree_hal_inline_command_buffer_t;
 
@@ -70,7 +76,7 @@ static void iree_hal_inline_command_buffer_reset(
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
 
   // Setup the cached dispatch state pointers that don't change.
-  iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+  iree_hal_executable_dispatch_state_v1_t* dispatch_state =
       &command_buffer->state.dispatch_state;
   dispatch_state->push_constants = command_buffer->state.push_constants;
   dispatch_state->binding_ptrs = command_buffer->state.packed_bindings;
@@ -110,6 +116,8 @@ iree_status_t iree_hal_inline_command_buffer_create(
     command_buffer->mode = mode;
     command_buffer->allowed_categories = command_categories;
     command_buffer->queue_affinity = queue_affinity;
+    command_buffer->local_memory_allocation = NULL;
+    command_buffer->local_memory = iree_make_byte_span(NULL, 0);
     iree_hal_inline_command_buffer_reset(command_buffer);
 
     *out_command_buffer = (iree_hal_command_buffer_t*)command_buffer;
@@ -128,6 +136,7 @@ static void iree_hal_inline_command_buffer_destroy(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_inline_command_buffer_reset(command_buffer);
+  iree_allocator_free(host_allocator, command_buffer->local_memory_allocation);
   iree_allocator_free(host_allocator, command_buffer);
 
   IREE_TRACE_ZONE_END(z0);
@@ -366,6 +375,31 @@ static iree_status_t iree_hal_inline_command_buffer_bind_descriptor_set(
 // iree_hal_command_buffer_dispatch
 //===----------------------------------------------------------------------===//
 
+// Ensures that at least |minimum_size| bytes of local memory are available.
+static iree_status_t iree_hal_inline_command_buffer_reserve_local_memory(
+    iree_hal_inline_command_buffer_t* command_buffer,
+    iree_host_size_t minimum_size) {
+  if (IREE_LIKELY(minimum_size <= command_buffer->local_memory.data_length)) {
+    return iree_ok_status();
+  }
+  iree_allocator_t host_allocator =
+      iree_hal_device_host_allocator(command_buffer->device);
+  iree_host_size_t local_memory_size =
+      iree_host_align(minimum_size, IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT);
+  void* allocation = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      local_memory_size + IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT - 1,
+      &allocation));
+  iree_allocator_free(host_allocator, command_buffer->local_memory_allocation);
+  command_buffer->local_memory_allocation = allocation;
+  command_buffer->local_memory = iree_make_byte_span(
+      (void*)iree_host_align((uintptr_t)allocation,
+                             IREE_HAL_EXECUTABLE_LOCAL_MEMORY_ALIGNMENT),
+      local_memory_size);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_inline_command_buffer_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
@@ -378,9 +412,13 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   iree_hal_local_executable_layout_t* local_layout =
       local_executable->executable_layouts[entry_point];
 
-  iree_hal_executable_dispatch_state_v0_t* dispatch_state =
+  iree_hal_executable_dispatch_state_v1_t* dispatch_state =
       &command_buffer->state.dispatch_state;
 
+  IREE_RETURN_IF_ERROR(iree_hal_inline_command_buffer_reserve_local_memory(
+      command_buffer, iree_hal_local_executable_local_memory_size(
+                          local_executable, entry_point)));
+
   // TODO(benvanik): pull imports from layout.
   dispatch_state->imports = NULL;
 
@@ -427,7 +465,8 @@ static iree_status_t iree_hal_inline_command_buffer_dispatch(
   }
 
   return iree_hal_local_executable_issue_dispatch_inline(
-      local_executable, entry_point, dispatch_state);
+      local_executable, entry_point, dispatch_state,
+      command_buffer->local_memory);
 }
 
 static iree_status_t iree_hal_inline_command_buffer_dispatch_indirect(
@@ -28,6 +28,7 @@ typedef struct {
   union {
     const iree_hal_executable_library_header_t** header;
     const iree_hal_executable_library_v0_t* v0;
+    const iree_hal_executable_library_v1_t* v1;
   } library;
 } iree_hal_elf_executable_t;
 
@@ -73,6 +74,12 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
 
+  // v1 libraries may declare per-entry point local memory requirements.
+  if (header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1) {
+    executable->base.local_memory_sizes =
+        executable->library.v1->entry_point_local_memory_sizes;
+  }
+
   return iree_ok_status();
 }
 
@@ -153,11 +160,11 @@ static void iree_hal_elf_executable_destroy(
 
 static iree_status_t iree_hal_elf_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   iree_hal_elf_executable_t* executable =
       (iree_hal_elf_executable_t*)base_executable;
-  const iree_hal_executable_library_v0_t* library = executable->library.v0;
+  const iree_hal_executable_library_v1_t* library = executable->library.v1;
 
   if (IREE_UNLIKELY(ordinal >= library->entry_point_count)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -178,8 +185,10 @@ static iree_status_t iree_hal_elf_executable_issue_call(
       entry_point_name.data, entry_point_name.size, NULL, 0);
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
+  // NOTE: v0 entry points take a workgroup ID that is at the head of the
+  // workgroup state and can be called the same way.
   int ret = iree_elf_call_i_pp(library->entry_points[ordinal],
-                               (void*)dispatch_state, (void*)workgroup_id);
+                               (void*)dispatch_state, (void*)workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
 
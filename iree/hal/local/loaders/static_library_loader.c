@@ -20,8 +20,9 @@ typedef struct {
   iree_string_view_t identifier;
 
   union {
-    const iree_hal_executable_library_header_t* header;
+    const iree_hal_executable_library_header_t** header;
     const iree_hal_executable_library_v0_t* v0;
+    const iree_hal_executable_library_v1_t* v1;
   } library;
 } iree_hal_static_executable_t;
 
@@ -29,7 +30,7 @@ static const iree_hal_local_executable_vtable_t
     iree_hal_static_executable_vtable;
 
 static iree_status_t iree_hal_static_executable_create(
-    const iree_hal_executable_library_header_t* library_header,
+    const iree_hal_executable_library_header_t** library_header,
     iree_host_size_t executable_layout_count,
     iree_hal_executable_layout_t* const* executable_layouts,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
@@ -54,7 +55,12 @@ static iree_status_t iree_hal_static_executable_create(
         executable_layouts, executable_layouts_ptr, host_allocator,
         &executable->base);
     executable->library.header = library_header;
-    executable->identifier = iree_make_cstring_view(library_header->name);
+    executable->identifier = iree_make_cstring_view((*library_header)->name);
+    // v1 libraries may declare per-entry point local memory requirements.
+    if ((*library_header)->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1) {
+      executable->base.local_memory_sizes =
+          executable->library.v1->entry_point_local_memory_sizes;
+    }
     *out_executable = (iree_hal_executable_t*)executable;
   }
 
@@ -78,11 +84,11 @@ static void iree_hal_static_executable_destroy(
 
 static iree_status_t iree_hal_static_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   iree_hal_static_executable_t* executable =
       (iree_hal_static_executable_t*)base_executable;
-  const iree_hal_executable_library_v0_t* library = executable->library.v0;
+  const iree_hal_executable_library_v1_t* library = executable->library.v1;
 
   if (IREE_UNLIKELY(ordinal >= library->entry_point_count)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -103,7 +109,9 @@ static iree_status_t iree_hal_static_executable_issue_call(
       entry_point_name.data, entry_point_name.size, NULL, 0);
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  int ret = library->entry_points[ordinal](dispatch_state, workgroup_id);
+  // NOTE: v0 entry points take a workgroup ID that is at the head of the
+  // workgroup state and can be called the same way.
+  int ret = library->entry_points[ordinal](dispatch_state, workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -131,7 +139,7 @@ typedef struct {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
   iree_host_size_t library_count;
-  iree_hal_executable_library_header_t* const libraries[];
+  const iree_hal_executable_library_header_t** const libraries[];
 } iree_hal_static_library_loader_t;
 
 static const iree_hal_executable_loader_vtable_t
@@ -139,7 +147,7 @@ static const iree_hal_executable_loader_vtable_t
 
 iree_status_t iree_hal_static_library_loader_create(
     iree_host_size_t library_count,
-    const iree_hal_executable_library_header_t* const* libraries,
+    const iree_hal_executable_library_header_t** const* libraries,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
@@ -151,12 +159,12 @@ iree_status_t iree_hal_static_library_loader_create(
   // version of the IREE compiler that are then linked with an older version of
   // the runtime are difficult to spot otherwise.
   for (iree_host_size_t i = 0; i < library_count; ++i) {
-    if (libraries[i]->version > IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION) {
+    if ((*libraries[i])->version > IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION) {
       IREE_TRACE_ZONE_END(z0);
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "executable does not support this version of the "
                               "runtime (executable: %d, runtime: %d)",
-                              libraries[i]->version,
+                              (*libraries[i])->version,
                               IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION);
     }
   }
@@ -221,7 +229,7 @@ static iree_status_t iree_hal_static_library_loader_try_load(
   for (iree_host_size_t i = 0; i < executable_loader->library_count; ++i) {
     if (iree_string_view_equal(
             library_name,
-            iree_make_cstring_view(executable_loader->libraries[i]->name))) {
+            iree_make_cstring_view((*executable_loader->libraries[i])->name))) {
       return iree_hal_static_executable_create(
           executable_loader->libraries[i],
           executable_spec->executable_layout_count,
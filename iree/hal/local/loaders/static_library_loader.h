@@ -19,7 +19,8 @@ extern "C" {
 #endif  // __cplusplus
 
 // Creates a library loader that exposes the provided libraries to the HAL for
-// use as executables.
+// use as executables. Each library is the value returned from its query
+// function (a pointer to the library structure, which begins with the header).
 //
 // This loader will handle executable formats of 'static'. Version checks will
 // ensure that the IREE compiler-produced static library version is one that the
@@ -35,7 +36,7 @@ extern "C" {
 // within and across loaders will result in undefined behavior.
 iree_status_t iree_hal_static_library_loader_create(
     iree_host_size_t library_count,
-    const iree_hal_executable_library_header_t* const* libraries,
+    const iree_hal_executable_library_header_t** const* libraries,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
@@ -24,6 +24,7 @@ typedef struct {
   union {
     const iree_hal_executable_library_header_t* header;
     const iree_hal_executable_library_v0_t* v0;
+    const iree_hal_executable_library_v1_t* v1;
   } library;
 } iree_hal_system_executable_t;
 
@@ -57,6 +58,11 @@ static iree_status_t iree_hal_system_executable_create(
         executable_layouts, executable_layouts_ptr, host_allocator,
         &executable->base);
     executable->library.header = library_header;
+    // v1 libraries may declare per-entry point local memory requirements.
+    if (library_header->version >= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_1) {
+      executable->base.local_memory_sizes =
+          executable->library.v1->entry_point_local_memory_sizes;
+    }
     *out_executable = (iree_hal_executable_t*)executable;
   }
 
@@ -80,12 +86,12 @@ static void iree_hal_system_executable_destroy(
 
 static iree_status_t iree_hal_system_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   iree_hal_system_executable_t* executable =
       (iree_hal_system_executable_t*)base_executable;
 
-  iree_host_size_t ordinal_count = executable->library.v0->entry_point_count;
+  iree_host_size_t ordinal_count = executable->library.v1->entry_point_count;
   if (IREE_UNLIKELY(ordinal >= ordinal_count)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "entry point ordinal out of bounds");
@@ -93,7 +99,7 @@ static iree_status_t iree_hal_system_executable_issue_call(
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
   iree_string_view_t entry_point_name = iree_make_cstring_view(
-      executable->library.v0->entry_point_names[ordinal]);
+      executable->library.v1->entry_point_names[ordinal]);
   if (iree_string_view_is_empty(entry_point_name)) {
     entry_point_name = iree_make_cstring_view("unknown_dylib_call");
   }
@@ -101,8 +107,8 @@ static iree_status_t iree_hal_system_executable_issue_call(
                                       entry_point_name.size);
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
-  int ret = executable->library.v0->entry_points[ordinal](dispatch_state,
-                                                          workgroup_id);
+  int ret = executable->library.v1->entry_points[ordinal](dispatch_state,
+                                                          workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -138,8 +138,8 @@ static void iree_hal_vmvx_executable_destroy(
 
 static iree_status_t iree_hal_vmvx_executable_issue_call(
     iree_hal_local_executable_t* base_executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   iree_hal_vmvx_executable_t* executable =
       (iree_hal_vmvx_executable_t*)base_executable;
 
@@ -281,9 +281,9 @@ static iree_status_t iree_hal_vmvx_executable_issue_call(
               .ptr = binding_list,
               .offsetof_counter = 0,
           },
-      .workgroup_x = workgroup_id->x,
-      .workgroup_y = workgroup_id->y,
-      .workgroup_z = workgroup_id->z,
+      .workgroup_x = workgroup_state->workgroup_id.x,
+      .workgroup_y = workgroup_state->workgroup_id.y,
+      .workgroup_z = workgroup_state->workgroup_id.z,
       .workgroup_size_x = dispatch_state->workgroup_size.x,
       .workgroup_size_y = dispatch_state->workgroup_size.y,
       .workgroup_size_z = dispatch_state->workgroup_size.z,
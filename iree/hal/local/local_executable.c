@@ -22,6 +22,7 @@ void iree_hal_local_executable_initialize(
 
   out_base_executable->executable_layout_count = executable_layout_count;
   out_base_executable->executable_layouts = target_executable_layouts;
+  out_base_executable->local_memory_sizes = NULL;
   for (iree_host_size_t i = 0; i < executable_layout_count; ++i) {
     target_executable_layouts[i] =
         (iree_hal_local_executable_layout_t*)source_executable_layouts[i];
@@ -45,19 +46,20 @@ iree_hal_local_executable_t* iree_hal_local_executable_cast(
 
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state) {
   IREE_ASSERT_ARGUMENT(executable);
   IREE_ASSERT_ARGUMENT(dispatch_state);
-  IREE_ASSERT_ARGUMENT(workgroup_id);
+  IREE_ASSERT_ARGUMENT(workgroup_state);
   return ((const iree_hal_local_executable_vtable_t*)
               executable->resource.vtable)
-      ->issue_call(executable, ordinal, dispatch_state, workgroup_id);
+      ->issue_call(executable, ordinal, dispatch_state, workgroup_state);
 }
 
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state) {
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    iree_byte_span_t local_memory) {
   IREE_TRACE_ZONE_BEGIN(z0);
   // TODO(benvanik): annotate with executable name to calculate total time.
 
@@ -71,17 +73,31 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
   IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(z0, xyz_string, xyz_string_length);
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
+  iree_host_size_t local_memory_size =
+      iree_hal_local_executable_local_memory_size(executable, ordinal);
+  if (IREE_UNLIKELY(local_memory_size > local_memory.data_length)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "entry point requires %zu bytes of local memory "
+                            "but only %zu are available",
+                            local_memory_size, local_memory.data_length);
+  }
+
   iree_status_t status = iree_ok_status();
 
-  iree_hal_vec3_t workgroup_id;
-  for (workgroup_id.z = 0; workgroup_id.z < workgroup_count.z;
-       ++workgroup_id.z) {
-    for (workgroup_id.y = 0; workgroup_id.y < workgroup_count.y;
-         ++workgroup_id.y) {
-      for (workgroup_id.x = 0; workgroup_id.x < workgroup_count.x;
-           ++workgroup_id.x) {
+  iree_hal_executable_workgroup_state_v1_t workgroup_state;
+  memset(&workgroup_state, 0, sizeof(workgroup_state));
+  workgroup_state.local_memory = local_memory.data;
+  workgroup_state.local_memory_size = local_memory.data_length;
+  iree_hal_vec3_t* workgroup_id = &workgroup_state.workgroup_id;
+  for (workgroup_id->z = 0; workgroup_id->z < workgroup_count.z;
+       ++workgroup_id->z) {
+    for (workgroup_id->y = 0; workgroup_id->y < workgroup_count.y;
+         ++workgroup_id->y) {
+      for (workgroup_id->x = 0; workgroup_id->x < workgroup_count.x;
+           ++workgroup_id->x) {
         status = iree_hal_local_executable_issue_call(
-            executable, ordinal, dispatch_state, &workgroup_id);
+            executable, ordinal, dispatch_state, &workgroup_state);
         if (!iree_status_is_ok(status)) break;
       }
     }
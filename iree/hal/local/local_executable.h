@@ -21,6 +21,9 @@ typedef struct {
   iree_allocator_t host_allocator;
   iree_host_size_t executable_layout_count;
   iree_hal_local_executable_layout_t** executable_layouts;
+  // Optional table of per-entry point local memory requirements in bytes.
+  // NULL if no entry point requires local memory.
+  const uint32_t* local_memory_sizes;
 } iree_hal_local_executable_t;
 
 typedef struct {
@@ -28,8 +31,8 @@ typedef struct {
 
   iree_status_t(IREE_API_PTR* issue_call)(
       iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
-      const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-      const iree_hal_vec3_t* workgroup_id);
+      const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+      const iree_hal_executable_workgroup_state_v1_t* workgroup_state);
 } iree_hal_local_executable_vtable_t;
 
 // Callers must allocate memory for |target_executable_layouts| with at least
@@ -48,14 +51,25 @@ void iree_hal_local_executable_deinitialize(
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
+// Returns the local memory in bytes required by the entry point |ordinal|.
+static inline iree_host_size_t iree_hal_local_executable_local_memory_size(
+    const iree_hal_local_executable_t* executable, iree_host_size_t ordinal) {
+  return executable->local_memory_sizes
+             ? executable->local_memory_sizes[ordinal]
+             : 0;
+}
+
 iree_status_t iree_hal_local_executable_issue_call(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
-    const iree_hal_vec3_t* workgroup_id);
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v1_t* workgroup_state);
 
+// Issues all workgroups of the dispatch on the calling thread using
+// |local_memory| as the local memory for each invocation.
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
-    const iree_hal_executable_dispatch_state_v0_t* dispatch_state);
+    const iree_hal_executable_dispatch_state_v1_t* dispatch_state,
+    iree_byte_span_t local_memory);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -6,12 +6,115 @@
 
 #include "iree/hal/local/local_executable_cache.h"
 
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/local/local_executable.h"
+#include "iree/hal/local/local_executable_layout.h"
+
+//===----------------------------------------------------------------------===//
+// Executable content hashing
+//===----------------------------------------------------------------------===//
+
+// A 64-bit content key of an executable specification.
+// The key is only used to skip mismatched entries quickly; matching keys are
+// confirmed by comparing the full format, data, and layouts.
+typedef uint64_t iree_hal_executable_content_key_t;
+
+static inline uint64_t iree_hal_executable_hash_mix(uint64_t hash,
+                                                    uint64_t value) {
+  hash ^= value * 0x87C37B91114253D5ull;
+  hash = iree_math_rotl_u64(hash, 31) * 0x4CF5AD432745937Full;
+  return hash;
+}
+
+// Final avalanche from MurmurHash3 so that nearby inputs produce keys that
+// differ in all bits.
+static inline uint64_t iree_hal_executable_hash_finalize(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xFF51AFD7ED558CCDull;
+  hash ^= hash >> 33;
+  hash *= 0xC4CEB9FE1A85EC53ull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+static uint64_t iree_hal_executable_hash_bytes(uint64_t hash,
+                                               const uint8_t* data,
+                                               iree_host_size_t data_length) {
+  iree_host_size_t word_count = data_length / sizeof(uint64_t);
+  for (iree_host_size_t i = 0; i < word_count; ++i) {
+    uint64_t word;
+    memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+    hash = iree_hal_executable_hash_mix(hash, word);
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, data + word_count * sizeof(uint64_t),
+         data_length - word_count * sizeof(uint64_t));
+  return iree_hal_executable_hash_mix(hash, tail ^ data_length);
+}
+
+static iree_hal_executable_content_key_t iree_hal_executable_content_key(
+    const iree_hal_executable_spec_t* executable_spec) {
+  uint64_t hash = 0x9E3779B97F4A7C15ull;
+  hash = iree_hal_executable_hash_bytes(
+      hash, (const uint8_t*)executable_spec->executable_format.data,
+      executable_spec->executable_format.size);
+  hash = iree_hal_executable_hash_bytes(
+      hash, executable_spec->executable_data.data,
+      executable_spec->executable_data.data_length);
+  return iree_hal_executable_hash_finalize(hash);
+}
+
+// Returns true if the executable layouts |lhs| and |rhs| are interchangeable
+// when dispatching. Local executables only use the layouts to size the push
+// constants and pack the bindings.
+static bool iree_hal_local_executable_layout_equal(
+    const iree_hal_executable_layout_t* lhs,
+    const iree_hal_executable_layout_t* rhs) {
+  if (lhs == rhs) return true;
+  const iree_hal_local_executable_layout_t* local_lhs =
+      (const iree_hal_local_executable_layout_t*)lhs;
+  const iree_hal_local_executable_layout_t* local_rhs =
+      (const iree_hal_local_executable_layout_t*)rhs;
+  return local_lhs->push_constants == local_rhs->push_constants &&
+         local_lhs->dynamic_binding_count == local_rhs->dynamic_binding_count &&
+         local_lhs->used_bindings == local_rhs->used_bindings &&
+         local_lhs->set_layout_count == local_rhs->set_layout_count;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_executable_cache_t
+//===----------------------------------------------------------------------===//
+
+typedef struct {
+  // Content key of the executable specification used to load the executable.
+  iree_hal_executable_content_key_t key;
+  // Copies of the executable format and data used to load the executable
+  // stored in a single allocation owned by the entry.
+  iree_string_view_t format;
+  iree_const_byte_span_t data;
+  // Value of the cache use counter when the entry was last hit; the entry with
+  // the lowest value is evicted first.
+  uint64_t last_use;
+  // Retained executable or NULL if the entry is unused.
+  iree_hal_executable_t* executable;
+} iree_hal_local_executable_cache_entry_t;
 
 typedef struct {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
+
+  // Guards the entries table; loads happen outside of the lock.
+  iree_slim_mutex_t mutex;
+  // Monotonically increasing counter used for LRU ordering.
+  uint64_t use_counter;
+  // Total number of entries in the table (used or not). 0 if deduplication is
+  // disabled.
+  iree_host_size_t entry_capacity;
+  iree_hal_local_executable_cache_entry_t* entries;
+
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_local_executable_cache_t;
@@ -26,8 +129,9 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 }
 
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t loader_count,
-    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_string_view_t identifier, iree_host_size_t capacity,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(!loader_count || loaders);
   IREE_ASSERT_ARGUMENT(out_executable_cache);
@@ -36,9 +140,13 @@ iree_status_t iree_hal_local_executable_cache_create(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_local_executable_cache_t* executable_cache = NULL;
-  iree_host_size_t total_size =
+  iree_host_size_t entries_offset = iree_host_align(
       sizeof(*executable_cache) +
-      loader_count * sizeof(*executable_cache->loaders) + identifier.size;
+          loader_count * sizeof(*executable_cache->loaders),
+      iree_max_align_t);
+  iree_host_size_t total_size =
+      entries_offset + capacity * sizeof(*executable_cache->entries) +
+      identifier.size;
   iree_status_t status = iree_allocator_malloc(host_allocator, total_size,
                                                (void**)&executable_cache);
   if (iree_status_is_ok(status)) {
@@ -49,6 +157,15 @@ iree_status_t iree_hal_local_executable_cache_create(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
 
+    iree_slim_mutex_initialize(&executable_cache->mutex);
+    executable_cache->use_counter = 0;
+    executable_cache->entry_capacity = capacity;
+    executable_cache->entries =
+        (iree_hal_local_executable_cache_entry_t*)((uint8_t*)executable_cache +
+                                                   entries_offset);
+    memset(executable_cache->entries, 0,
+           capacity * sizeof(*executable_cache->entries));
+
     executable_cache->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
       executable_cache->loaders[i] = loaders[i];
@@ -69,6 +186,12 @@ static void iree_hal_local_executable_cache_destroy(
   iree_allocator_t host_allocator = executable_cache->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  for (iree_host_size_t i = 0; i < executable_cache->entry_capacity; ++i) {
+    iree_hal_executable_release(executable_cache->entries[i].executable);
+    iree_allocator_free(host_allocator,
+                        (void*)executable_cache->entries[i].data.data);
+  }
+  iree_slim_mutex_deinitialize(&executable_cache->mutex);
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     iree_hal_executable_loader_release(executable_cache->loaders[i]);
   }
@@ -92,12 +215,132 @@ static bool iree_hal_local_executable_cache_can_prepare_format(
   return false;
 }
 
-static iree_status_t iree_hal_local_executable_cache_prepare_executable(
-    iree_hal_executable_cache_t* base_executable_cache,
+// Returns true if |entry| holds an executable prepared from a specification
+// equivalent to |executable_spec| with content |key|.
+static bool iree_hal_local_executable_cache_entry_matches(
+    const iree_hal_local_executable_cache_entry_t* entry,
+    iree_hal_executable_content_key_t key,
+    const iree_hal_executable_spec_t* executable_spec) {
+  if (!entry->executable || entry->key != key ||
+      !iree_string_view_equal(entry->format,
+                              executable_spec->executable_format) ||
+      entry->data.data_length != executable_spec->executable_data.data_length ||
+      memcmp(entry->data.data, executable_spec->executable_data.data,
+             entry->data.data_length) != 0) {
+    return false;
+  }
+  const iree_hal_local_executable_t* executable =
+      (const iree_hal_local_executable_t*)entry->executable;
+  if (executable->executable_layout_count !=
+      executable_spec->executable_layout_count) {
+    return false;
+  }
+  for (iree_host_size_t i = 0; i < executable->executable_layout_count; ++i) {
+    if (!iree_hal_local_executable_layout_equal(
+            (const iree_hal_executable_layout_t*)
+                executable->executable_layouts[i],
+            executable_spec->executable_layouts[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Looks up an executable matching |executable_spec| and returns it retained in
+// |out_executable| or NULL if not found.
+static void iree_hal_local_executable_cache_lookup(
+    iree_hal_local_executable_cache_t* executable_cache,
+    iree_hal_executable_content_key_t key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  *out_executable = NULL;
+  iree_slim_mutex_lock(&executable_cache->mutex);
+  for (iree_host_size_t i = 0; i < executable_cache->entry_capacity; ++i) {
+    iree_hal_local_executable_cache_entry_t* entry =
+        &executable_cache->entries[i];
+    if (iree_hal_local_executable_cache_entry_matches(entry, key,
+                                                      executable_spec)) {
+      entry->last_use = ++executable_cache->use_counter;
+      iree_hal_executable_retain(entry->executable);
+      *out_executable = entry->executable;
+      break;
+    }
+  }
+  iree_slim_mutex_unlock(&executable_cache->mutex);
+}
+
+// Inserts the newly loaded |executable| into the cache, evicting the least
+// recently used entry if the cache is full. If another thread raced to insert
+// an equivalent executable then |executable| is released and the existing one
+// is returned instead such that all callers share the same instance.
+// If the specification can't be copied into the entry the executable is
+// returned without being cached.
+static iree_hal_executable_t* iree_hal_local_executable_cache_insert(
+    iree_hal_local_executable_cache_t* executable_cache,
+    iree_hal_executable_content_key_t key,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t* executable) {
+  // Copy the data and format outside of the lock.
+  iree_host_size_t data_length = executable_spec->executable_data.data_length;
+  iree_host_size_t format_length = executable_spec->executable_format.size;
+  uint8_t* spec_copy = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(executable_cache->host_allocator,
+                            data_length + format_length, (void**)&spec_copy);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return executable;
+  }
+  memcpy(spec_copy, executable_spec->executable_data.data, data_length);
+  memcpy(spec_copy + data_length, executable_spec->executable_format.data,
+         format_length);
+
+  iree_hal_executable_t* evicted_executable = NULL;
+  iree_slim_mutex_lock(&executable_cache->mutex);
+  iree_hal_local_executable_cache_entry_t* victim = NULL;
+  for (iree_host_size_t i = 0; i < executable_cache->entry_capacity; ++i) {
+    iree_hal_local_executable_cache_entry_t* entry =
+        &executable_cache->entries[i];
+    if (iree_hal_local_executable_cache_entry_matches(entry, key,
+                                                      executable_spec)) {
+      entry->last_use = ++executable_cache->use_counter;
+      iree_hal_executable_retain(entry->executable);
+      evicted_executable = executable;
+      executable = entry->executable;
+      victim = NULL;
+      break;
+    }
+    if (!victim || !entry->executable ||
+        (victim->executable && entry->last_use < victim->last_use)) {
+      victim = entry;
+    }
+  }
+  if (victim) {
+    evicted_executable = victim->executable;
+    uint8_t* evicted_spec_copy = (uint8_t*)victim->data.data;
+    victim->key = key;
+    victim->data = iree_make_const_byte_span(spec_copy, data_length);
+    victim->format = iree_make_string_view((const char*)spec_copy + data_length,
+                                           format_length);
+    spec_copy = evicted_spec_copy;
+    victim->last_use = ++executable_cache->use_counter;
+    victim->executable = executable;
+    iree_hal_executable_retain(executable);
+  }
+  iree_slim_mutex_unlock(&executable_cache->mutex);
+
+  // Released outside of the lock as destruction may be expensive (unloading
+  // libraries, etc). Evicted executables remain live for as long as any user
+  // has them retained.
+  iree_hal_executable_release(evicted_executable);
+  iree_allocator_free(executable_cache->host_allocator, spec_copy);
+  return executable;
+}
+
+static iree_status_t iree_hal_local_executable_cache_load(
+    iree_hal_local_executable_cache_t* executable_cache,
     const iree_hal_executable_spec_t* executable_spec,
     iree_hal_executable_t** out_executable) {
-  iree_hal_local_executable_cache_t* executable_cache =
-      iree_hal_local_executable_cache_cast(base_executable_cache);
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     if (!iree_hal_executable_loader_query_support(
             executable_cache->loaders[i], executable_spec->caching_mode,
@@ -126,6 +369,46 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
       executable_spec->executable_format.data);
 }
 
+static iree_status_t iree_hal_local_executable_cache_prepare_executable(
+    iree_hal_executable_cache_t* base_executable_cache,
+    const iree_hal_executable_spec_t* executable_spec,
+    iree_hal_executable_t** out_executable) {
+  iree_hal_local_executable_cache_t* executable_cache =
+      iree_hal_local_executable_cache_cast(base_executable_cache);
+  if (executable_cache->entry_capacity == 0) {
+    return iree_hal_local_executable_cache_load(
+        executable_cache, executable_spec, out_executable);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_executable_content_key_t key =
+      iree_hal_executable_content_key(executable_spec);
+  iree_hal_local_executable_cache_lookup(executable_cache, key,
+                                         executable_spec, out_executable);
+  if (*out_executable) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+
+  // Cached executables may outlive the caller that provided the data (such as
+  // when the module that first loaded it is unloaded while another context
+  // still uses it) and must own their data.
+  iree_hal_executable_spec_t owned_spec = *executable_spec;
+  owned_spec.caching_mode &=
+      ~IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+  iree_hal_executable_t* executable = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_local_executable_cache_load(executable_cache, &owned_spec,
+                                               &executable));
+  *out_executable = iree_hal_local_executable_cache_insert(
+      executable_cache, key, executable_spec, executable);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static const iree_hal_executable_cache_vtable_t
     iree_hal_local_executable_cache_vtable = {
         .destroy = iree_hal_local_executable_cache_destroy,
@@ -15,17 +15,27 @@
 extern "C" {
 #endif  // __cplusplus
 
-// TODO(benvanik): when we refactor executable caches this can become something
-// more specialized; like nop_executable_cache (does nothing but pass through)
-// or inproc_lru_executable_cache (simple in-memory LRU of recent executables).
-//
-// We can also set this up so they share storage. Ideally a JIT'ed executable in
-// one device is the same JIT'ed executable in another, and in multi-tenant
-// situations we're likely to want that isolation _and_ sharing.
+// Default number of executables retained by a local executable cache.
+#define IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFAULT_CAPACITY 64
 
+// Creates an executable cache that loads executables using |loaders|.
+//
+// When |capacity| is non-zero the cache deduplicates executables by content:
+// preparing an executable with the same format, data, and compatible layouts as
+// one already in the cache returns the existing executable instead of loading
+// it again. Up to |capacity| executables are retained and the least recently
+// used is released when the cache is full. Executables that have been evicted
+// remain valid for as long as any user retains them. Cached executables own
+// their data; IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA is ignored.
+//
+// The cache is thread-safe and may be shared across contexts such that a
+// module loaded into multiple contexts on the same device only loads its
+// executables once. A |capacity| of 0 disables deduplication and every prepare
+// produces a new executable.
 iree_status_t iree_hal_local_executable_cache_create(
-    iree_string_view_t identifier, iree_host_size_t loader_count,
-    iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
+    iree_string_view_t identifier, iree_host_size_t capacity,
+    iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
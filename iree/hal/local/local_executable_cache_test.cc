@@ -0,0 +1,199 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/local_executable_cache.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/executable_library_demo.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/hal/local/local_executable_layout.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class LocalExecutableCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const iree_hal_executable_library_header_t** library =
+        demo_executable_library_query(
+            IREE_HAL_EXECUTABLE_LIBRARY_LATEST_VERSION, /*reserved=*/NULL);
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        /*library_count=*/1, &library, iree_allocator_system(), &loader_));
+  }
+
+  void TearDown() override {
+    for (auto* executable_layout : executable_layouts_) {
+      iree_hal_executable_layout_release(executable_layout);
+    }
+    iree_hal_executable_loader_release(loader_);
+  }
+
+  iree_hal_executable_cache_t* CreateCache(iree_host_size_t capacity) {
+    iree_hal_executable_cache_t* executable_cache = NULL;
+    IREE_CHECK_OK(iree_hal_local_executable_cache_create(
+        iree_make_cstring_view("test"), capacity, /*loader_count=*/1, &loader_,
+        iree_allocator_system(), &executable_cache));
+    return executable_cache;
+  }
+
+  // Returns an executable layout with |push_constants| and no bindings.
+  // Executable layouts are only used to pack the dispatch state and differing
+  // push constant counts produce incompatible executables.
+  iree_hal_executable_layout_t* CreateExecutableLayout(
+      iree_host_size_t push_constants) {
+    iree_hal_executable_layout_t* executable_layout = NULL;
+    IREE_CHECK_OK(iree_hal_local_executable_layout_create(
+        push_constants, /*set_layout_count=*/0, /*set_layouts=*/NULL,
+        iree_allocator_system(), &executable_layout));
+    executable_layouts_.push_back(executable_layout);
+    return executable_layout;
+  }
+
+  // Prepares the demo library with the given |library_name| bytes (which may
+  // live anywhere in memory) for both of its entry points.
+  iree_hal_executable_t* Prepare(
+      iree_hal_executable_cache_t* executable_cache,
+      const std::string& library_name,
+      iree_hal_executable_layout_t* executable_layout) {
+    iree_hal_executable_layout_t* executable_layouts[2] = {executable_layout,
+                                                           executable_layout};
+    iree_hal_executable_spec_t executable_spec;
+    iree_hal_executable_spec_initialize(&executable_spec);
+    executable_spec.executable_format = iree_make_cstring_view("static");
+    executable_spec.executable_data = iree_make_const_byte_span(
+        library_name.data(), library_name.size());
+    executable_spec.executable_layout_count =
+        IREE_ARRAYSIZE(executable_layouts);
+    executable_spec.executable_layouts = executable_layouts;
+    iree_hal_executable_t* executable = NULL;
+    IREE_CHECK_OK(iree_hal_executable_cache_prepare_executable(
+        executable_cache, &executable_spec, &executable));
+    return executable;
+  }
+
+  iree_hal_executable_loader_t* loader_ = NULL;
+  std::vector<iree_hal_executable_layout_t*> executable_layouts_;
+};
+
+// Preparing the same contents from different memory must return the same
+// executable while it remains in the cache.
+TEST_F(LocalExecutableCacheTest, DeduplicatesByContent) {
+  iree_hal_executable_cache_t* executable_cache = CreateCache(4);
+  iree_hal_executable_layout_t* layout_a = CreateExecutableLayout(1);
+  iree_hal_executable_layout_t* layout_b = CreateExecutableLayout(1);
+
+  std::string name_0 = "demo_library";
+  std::string name_1 = "demo_library";
+  iree_hal_executable_t* executable_0 =
+      Prepare(executable_cache, name_0, layout_a);
+  // Distinct but compatible layouts (as if from another context) still hit.
+  iree_hal_executable_t* executable_1 =
+      Prepare(executable_cache, name_1, layout_b);
+  EXPECT_EQ(executable_0, executable_1);
+
+  iree_hal_executable_release(executable_1);
+  iree_hal_executable_release(executable_0);
+  iree_hal_executable_cache_release(executable_cache);
+}
+
+// Entries compare against their own copy of the data as the caller's data
+// may be freed or reused as soon as the executable is prepared.
+TEST_F(LocalExecutableCacheTest, ComparesOwnedData) {
+  iree_hal_executable_cache_t* executable_cache = CreateCache(4);
+  iree_hal_executable_layout_t* layout = CreateExecutableLayout(1);
+
+  std::string name_0 = "demo_library";
+  iree_hal_executable_t* executable_0 =
+      Prepare(executable_cache, name_0, layout);
+  std::memset(&name_0[0], 'x', name_0.size());
+  iree_hal_executable_t* executable_1 =
+      Prepare(executable_cache, "demo_library", layout);
+  EXPECT_EQ(executable_0, executable_1);
+
+  iree_hal_executable_release(executable_1);
+  iree_hal_executable_release(executable_0);
+  iree_hal_executable_cache_release(executable_cache);
+}
+
+// Incompatible layouts must not share an executable even with identical data.
+TEST_F(LocalExecutableCacheTest, DistinguishesLayouts) {
+  iree_hal_executable_cache_t* executable_cache = CreateCache(4);
+  iree_hal_executable_layout_t* layout_a = CreateExecutableLayout(1);
+  iree_hal_executable_layout_t* layout_b = CreateExecutableLayout(2);
+
+  iree_hal_executable_t* executable_a =
+      Prepare(executable_cache, "demo_library", layout_a);
+  iree_hal_executable_t* executable_b =
+      Prepare(executable_cache, "demo_library", layout_b);
+  EXPECT_NE(executable_a, executable_b);
+
+  iree_hal_executable_release(executable_b);
+  iree_hal_executable_release(executable_a);
+  iree_hal_executable_cache_release(executable_cache);
+}
+
+// The least recently used executable is evicted once the cache is full and
+// evicted executables remain valid for users still holding them.
+TEST_F(LocalExecutableCacheTest, EvictsLeastRecentlyUsed) {
+  iree_hal_executable_cache_t* executable_cache = CreateCache(2);
+  iree_hal_executable_layout_t* layout_1 = CreateExecutableLayout(1);
+  iree_hal_executable_layout_t* layout_2 = CreateExecutableLayout(2);
+  iree_hal_executable_layout_t* layout_3 = CreateExecutableLayout(3);
+
+  iree_hal_executable_t* executable_1 =
+      Prepare(executable_cache, "demo_library", layout_1);
+  iree_hal_executable_t* executable_2 =
+      Prepare(executable_cache, "demo_library", layout_2);
+
+  // Touch 1 so that 2 becomes the least recently used.
+  iree_hal_executable_t* executable_1_hit =
+      Prepare(executable_cache, "demo_library", layout_1);
+  EXPECT_EQ(executable_1, executable_1_hit);
+  iree_hal_executable_release(executable_1_hit);
+
+  // Inserting 3 evicts 2 but keeps 1.
+  iree_hal_executable_t* executable_3 =
+      Prepare(executable_cache, "demo_library", layout_3);
+  iree_hal_executable_t* executable_1_kept =
+      Prepare(executable_cache, "demo_library", layout_1);
+  EXPECT_EQ(executable_1, executable_1_kept);
+  iree_hal_executable_release(executable_1_kept);
+
+  // 2 was evicted and is loaded again; our reference is still valid.
+  iree_hal_executable_t* executable_2_reloaded =
+      Prepare(executable_cache, "demo_library", layout_2);
+  EXPECT_NE(executable_2, executable_2_reloaded);
+
+  iree_hal_executable_release(executable_2_reloaded);
+  iree_hal_executable_release(executable_3);
+  iree_hal_executable_release(executable_2);
+  iree_hal_executable_release(executable_1);
+  iree_hal_executable_cache_release(executable_cache);
+}
+
+// With no capacity every prepare loads a new executable.
+TEST_F(LocalExecutableCacheTest, ZeroCapacityDisablesSharing) {
+  iree_hal_executable_cache_t* executable_cache = CreateCache(0);
+  iree_hal_executable_layout_t* layout = CreateExecutableLayout(1);
+
+  iree_hal_executable_t* executable_0 =
+      Prepare(executable_cache, "demo_library", layout);
+  iree_hal_executable_t* executable_1 =
+      Prepare(executable_cache, "demo_library", layout);
+  EXPECT_NE(executable_0, executable_1);
+
+  iree_hal_executable_release(executable_1);
+  iree_hal_executable_release(executable_0);
+  iree_hal_executable_cache_release(executable_cache);
+}
+
+}  // namespace
@@ -22,6 +22,9 @@ typedef struct {
 
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t** loaders;
+  // Executable cache shared by all users of the device or NULL if each cache
+  // created from the device is independent.
+  iree_hal_executable_cache_t* executable_cache;
 
   iree_allocator_t host_allocator;
   iree_hal_allocator_t* device_allocator;
@@ -40,6 +43,10 @@ static iree_hal_sync_device_t* iree_hal_sync_device_cast(
 void iree_hal_sync_device_params_initialize(
     iree_hal_sync_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
+  out_params->executable_cache_capacity =
+      IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFAULT_CAPACITY;
+  iree_hal_heap_allocator_cache_params_initialize(&out_params->buffer_cache);
+  out_params->buffer_cache.max_retained_size = 0;
 }
 
 static iree_status_t iree_hal_sync_device_check_params(
@@ -86,8 +93,15 @@ iree_status_t iree_hal_sync_device_create(
   }
 
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(identifier, host_allocator,
-                                            &device->device_allocator);
+    status = iree_hal_allocator_create_heap_with_cache(
+        identifier, &params->buffer_cache, host_allocator,
+        &device->device_allocator);
+  }
+
+  if (iree_status_is_ok(status) && params->executable_cache_capacity > 0) {
+    status = iree_hal_local_executable_cache_create(
+        identifier, params->executable_cache_capacity, loader_count, loaders,
+        host_allocator, &device->executable_cache);
   }
 
   if (iree_status_is_ok(status)) {
@@ -106,6 +120,7 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
 
   iree_hal_sync_semaphore_state_deinitialize(&device->semaphore_state);
 
+  iree_hal_executable_cache_release(device->executable_cache);
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -186,8 +201,13 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  if (device->executable_cache) {
+    iree_hal_executable_cache_retain(device->executable_cache);
+    *out_executable_cache = device->executable_cache;
+    return iree_ok_status();
+  }
   return iree_hal_local_executable_cache_create(
-      identifier, device->loader_count, device->loaders,
+      identifier, /*capacity=*/0, device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -18,7 +18,17 @@ extern "C" {
 // Parameters configuring an iree_hal_sync_device_t.
 // Must be initialized with iree_hal_sync_device_params_initialize prior to use.
 typedef struct {
-  int reserved;
+  // Maximum number of executables retained by the executable cache shared by
+  // all users of the device. Executables prepared with the same contents
+  // through any iree_hal_executable_cache_t created from the device are loaded
+  // only once. 0 disables sharing and each cache loads its own executables.
+  iree_host_size_t executable_cache_capacity;
+
+  // Block cache used by the device allocator for buffer storage. Disabled by
+  // default (max_retained_size = 0); set max_retained_size to retain and reuse
+  // the storage of released transient buffers instead of returning it to the
+  // system allocator.
+  iree_hal_heap_allocator_cache_params_t buffer_cache;
 } iree_hal_sync_device_params_t;
 
 // Initializes |out_params| to default values.
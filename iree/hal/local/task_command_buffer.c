@@ -6,6 +6,9 @@
 
 #include "iree/hal/local/task_command_buffer.h"
 
+#include <inttypes.h>
+
+#include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/local_descriptor_set_layout.h"
 #include "iree/hal/local/local_executable.h"
@@ -14,18 +17,125 @@
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
+#if defined(IREE_ARCH_X86_64)
+#include <emmintrin.h>
+#endif  // IREE_ARCH_X86_64
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+// An edge in the command buffer task DAG to a task that must wait for the
+// task owning the edge to complete.
+typedef struct iree_hal_task_edge_s {
+  struct iree_hal_task_edge_s* next;
+  struct iree_hal_task_record_s* dependent;
+} iree_hal_task_edge_t;
+
+// A task emitted into the command buffer during recording.
+// Edges are accumulated as commands are recorded and only linked into the task
+// DAG at the end of recording once the full set of dependents of each task is
+// known. Records are also used to build the replay table of reusable command
+// buffers.
+typedef struct iree_hal_task_record_s {
+  struct iree_hal_task_record_s* next;
+  iree_task_t* task;
+  // Ordinal of the task in recording order.
+  iree_host_size_t ordinal;
+  // Number of tasks this task must wait on.
+  iree_host_size_t predecessor_count;
+  // Tasks that must wait on this task, most recently recorded first.
+  iree_hal_task_edge_t* dependents;
+  iree_host_size_t dependent_count;
+  // The most recently added dependent, used to drop duplicate edges when a
+  // command conflicts with more than one range accessed by this task.
+  struct iree_hal_task_record_s* last_dependent;
+} iree_hal_task_record_t;
+
+// A byte range [begin, end) of an allocated buffer accessed by a recorded
+// command. Ranges with no |buffer| cover all memory.
+typedef struct {
+  const iree_hal_buffer_t* buffer;
+  uintptr_t begin;
+  uintptr_t end;
+  bool is_write;
+} iree_hal_task_access_range_t;
+
+// A memory range accessed by a recorded task that subsequently recorded
+// commands may need to wait on.
+typedef struct iree_hal_task_access_s {
+  struct iree_hal_task_access_s* next;
+  iree_hal_task_record_t* record;
+  iree_hal_task_access_range_t range;
+  // A task waiting on this one that may write the entire range. Once that task
+  // is itself ordered before subsequent commands any hazard with this access
+  // is also a hazard with it and the access can be dropped. Until then
+  // commands recorded alongside the covering task must still see the access as
+  // the covering task may only read the range (dispatch bindings are
+  // conservatively writable).
+  iree_hal_task_record_t* covering_record;
+} iree_hal_task_access_t;
+
+// Maximum number of accesses checked for hazards by each recorded command.
+// Command buffers accessing more disjoint ranges than this fully order all
+// prior commands before subsequent ones at the next barrier so that recording
+// remains linear in the number of commands.
+#if !defined(IREE_HAL_TASK_COMMAND_BUFFER_MAX_ACCESSES)
+#define IREE_HAL_TASK_COMMAND_BUFFER_MAX_ACCESSES 256
+#endif  // !IREE_HAL_TASK_COMMAND_BUFFER_MAX_ACCESSES
+
+// Tracks the point in the command stream at which an event was signaled.
+typedef struct iree_hal_task_event_signal_s {
+  struct iree_hal_task_event_signal_s* next;
+  const iree_hal_event_t* event;
+  // Number of tasks recorded prior to the signal.
+  iree_host_size_t ordinal;
+} iree_hal_task_event_signal_t;
+
+enum iree_hal_task_replay_entry_flag_bits_e {
+  // Task has no dependencies within the command buffer and is enqueued
+  // directly into the submission.
+  IREE_HAL_TASK_REPLAY_ENTRY_FLAG_ROOT = 1u << 0,
+  // Task has no dependents within the command buffer and must be chained to
+  // the retire task of the submission.
+  IREE_HAL_TASK_REPLAY_ENTRY_FLAG_LEAF = 1u << 1,
+};
+typedef uint32_t iree_hal_task_replay_entry_flags_t;
+
+// Describes a single task in the DAG of a reusable command buffer.
+// The |snapshot| holds the task structure exactly as it was when recording
+// ended (dependency counts, flags, and embedded dispatch state) and is used to
+// reset or clone the task on each issue. Dependency edges are stored as
+// indices into the replay table so that the DAG can be relocated.
+typedef struct {
+  // Task as recorded within the command buffer arena.
+  iree_task_t* task;
+  // Pristine copy of the task structure taken at the end of recording.
+  const iree_task_t* snapshot;
+  // Size of the task structure (excluding any command payload).
+  uint32_t task_size;
+  iree_hal_task_replay_entry_flags_t flags;
+  // Index of the task->completion_task or -1 if none.
+  int32_t completion_index;
+  // Indices of the dependent tasks of barriers; NULL for all other types.
+  const uint32_t* dependent_indices;
+} iree_hal_task_replay_entry_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
-// data structures and we produce the iree_task_ts directly. In the steady state
-// all allocations are served from a shared per-device block pool with no
-// additional allocations required during recording or execution. That means our
-// command buffer here is essentially just a builder for the task system types
-// and manager of the lifetime of the tasks.
+// data structures and we produce the iree_task_ts directly.
+//
+// Execution barriers and events do not serialize the command stream. Instead
+// each command records the host memory ranges it reads and writes and only
+// waits on the prior commands ordered before it by a barrier (or by an event
+// it waits on) that it has a read-after-write, write-after-read, or
+// write-after-write hazard with. Independent commands, such as dispatches on
+// parallel branches of a model separated by barriers, are free to overlap.
+// In the steady state all allocations are served from a shared per-device block
+// pool with no additional allocations required during recording or execution.
+// That means our command buffer here is essentially just a builder for the task
+// system types and manager of the lifetime of the tasks.
 typedef struct {
   iree_hal_resource_t resource;
 
@@ -35,6 +145,9 @@ typedef struct {
   iree_hal_command_category_t allowed_categories;
   iree_hal_queue_affinity_t queue_affinity;
 
+  // Local memory available to each worker executing dispatch tiles.
+  iree_host_size_t worker_local_memory_size;
+
   // Arena used for all allocations; references the shared device block pool.
   iree_arena_allocator_t arena;
 
@@ -45,29 +158,34 @@ typedef struct {
 
   // One or more tasks at the leaves of the DAG.
   // Only once all these tasks have completed execution will the command buffer
-  // be considered completed as a whole.
-  //
-  // An empty list indicates that root_tasks are also the leaves.
-  iree_task_list_t leaf_tasks;
+  // be considered completed as a whole. A task with no dependencies and no
+  // dependents is both a root and a leaf.
+  iree_host_size_t leaf_task_count;
+  iree_task_t** leaf_tasks;
 
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
   struct {
-    // The last global barrier that was inserted, if any.
-    // The barrier is allocated and inserted into the DAG when requested but the
-    // actual barrier dependency list is only allocated and set on flushes.
-    // This lets us allocate the appropriately sized barrier task list from the
-    // arena even though when the barrier is recorded we don't yet know what
-    // other tasks we'll be emitting as we walk the command stream.
-    iree_task_barrier_t* open_barrier;
-
-    // The number of tasks in the open barrier (|open_tasks|), used to quickly
-    // allocate storage for the task list without needing to walk the list.
-    iree_host_size_t open_task_count;
-
-    // All execution tasks emitted that must execute after |open_barrier|.
-    iree_task_list_t open_tasks;
+    // Ordinal of the first task not ordered before subsequently recorded
+    // commands by an execution barrier or event wait. New commands only wait
+    // on the tasks prior to this that they have a hazard with and otherwise
+    // may execute concurrently with all other tasks.
+    iree_host_size_t barrier_ordinal;
+
+    // Memory ranges accessed by tasks recorded before the barrier was last
+    // moved. New commands check these for hazards. Ranges covered by a write
+    // that is itself ordered before new commands are dropped as the covering
+    // command carries the hazard forward.
+    iree_hal_task_access_t* accesses;
+    iree_host_size_t access_count;
+    // Memory ranges accessed by tasks recorded since the barrier was last
+    // moved. New commands can't have a hazard with these until a barrier
+    // orders them and they are moved into |accesses|.
+    iree_hal_task_access_t* pending_accesses;
+
+    // Events signaled within the command buffer, most recent first.
+    iree_hal_task_event_signal_t* event_signals;
 
     // A flattened list of all available descriptor set bindings.
     // As descriptor sets are pushed/bound the bindings will be updated to
@@ -79,12 +197,36 @@ typedef struct {
     iree_device_size_t
         binding_lengths[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
                         IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+    // The range accessed through each binding by dispatches. Bindings are
+    // writes if their layout allows writing.
+    iree_hal_task_access_range_t
+        binding_ranges[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                       IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
 
     // All available push constants updated each time push_constants is called.
     // Reset only with the command buffer and otherwise will maintain its values
     // during recording to allow for partial push_constants updates.
     uint32_t push_constants[IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT];
+
+    // All tasks emitted during recording in emission order.
+    iree_hal_task_record_t* task_records_head;
+    iree_hal_task_record_t* task_records_tail;
+    iree_host_size_t task_record_count;
   } state;
+
+  // Replay table for reusable (non-ONE_SHOT) command buffers built at the end
+  // of recording. Each issue instantiates the recorded DAG from the pristine
+  // snapshots: in-place if no prior issue of the command buffer is still
+  // in-flight and otherwise by cloning the tasks into the submission arena so
+  // that overlapping executions don't stomp on each other.
+  struct {
+    iree_host_size_t task_count;
+    iree_hal_task_replay_entry_t* entries;
+
+    // Number of issues currently executing the tasks in-place. Only one may be
+    // in-flight at a time; all others will be cloned.
+    iree_atomic_int32_t in_place_count;
+  } replay;
 } iree_hal_task_command_buffer_t;
 
 static const iree_hal_command_buffer_vtable_t
@@ -101,24 +243,16 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity,
+    iree_host_size_t worker_local_memory_size,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
+
+  // NOTE: command buffers without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT are
+  // reusable: the task DAG is snapshotted at the end of recording and each
+  // issue resets (or, if a prior issue is still executing, clones) the tasks.
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -134,10 +268,13 @@ iree_status_t iree_hal_task_command_buffer_create(
     command_buffer->mode = mode;
     command_buffer->allowed_categories = command_categories;
     command_buffer->queue_affinity = queue_affinity;
+    command_buffer->worker_local_memory_size = worker_local_memory_size;
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
-    iree_task_list_initialize(&command_buffer->leaf_tasks);
+    command_buffer->leaf_task_count = 0;
+    command_buffer->leaf_tasks = NULL;
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
+    memset(&command_buffer->replay, 0, sizeof(command_buffer->replay));
     *out_command_buffer = (iree_hal_command_buffer_t*)command_buffer;
   }
 
@@ -147,9 +284,17 @@ iree_status_t iree_hal_task_command_buffer_create(
 
 static void iree_hal_task_command_buffer_reset(
     iree_hal_task_command_buffer_t* command_buffer) {
+  IREE_ASSERT_EQ(0,
+                 iree_atomic_load_int32(&command_buffer->replay.in_place_count,
+                                        iree_memory_order_acquire));
   memset(&command_buffer->state, 0, sizeof(command_buffer->state));
-  iree_task_list_discard(&command_buffer->leaf_tasks);
-  iree_task_list_discard(&command_buffer->root_tasks);
+  command_buffer->replay.task_count = 0;
+  command_buffer->replay.entries = NULL;
+  // NOTE: all tasks are allocated from the arena and have no cleanup functions
+  // so any that were never issued can be dropped without walking the DAG.
+  iree_task_list_initialize(&command_buffer->root_tasks);
+  command_buffer->leaf_task_count = 0;
+  command_buffer->leaf_tasks = NULL;
   iree_arena_reset(&command_buffer->arena);
 }
 
@@ -184,7 +329,9 @@ iree_hal_task_command_buffer_allowed_categories(
 // iree_hal_task_command_buffer_t recording
 //===----------------------------------------------------------------------===//
 
-static iree_status_t iree_hal_task_command_buffer_flush_tasks(
+static iree_status_t iree_hal_task_command_buffer_link_tasks(
+    iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_build_replay(
     iree_hal_task_command_buffer_t* command_buffer);
 
 static iree_status_t iree_hal_task_command_buffer_begin(
@@ -200,133 +347,534 @@ static iree_status_t iree_hal_task_command_buffer_end(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  // Flush any open barriers.
+  // Link the task DAG now that all dependents of each task are known.
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_link_tasks(command_buffer));
+
+  // Snapshot the DAG so that it can be replayed if the command buffer is
+  // reusable.
+  if (!iree_all_bits_set(command_buffer->mode,
+                         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_build_replay(command_buffer));
+  }
+
+  return iree_ok_status();
+}
+
+// Records |task| as having been emitted into the command buffer so that it can
+// be linked into the DAG and included in the replay table.
+static iree_status_t iree_hal_task_command_buffer_record_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task,
+    iree_hal_task_record_t** out_record) {
+  iree_hal_task_record_t* record = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*record), (void**)&record));
+  memset(record, 0, sizeof(*record));
+  record->task = task;
+  record->ordinal = command_buffer->state.task_record_count;
+  if (command_buffer->state.task_records_tail) {
+    command_buffer->state.task_records_tail->next = record;
+  } else {
+    command_buffer->state.task_records_head = record;
+  }
+  command_buffer->state.task_records_tail = record;
+  ++command_buffer->state.task_record_count;
+  if (out_record) *out_record = record;
+  return iree_ok_status();
+}
+
+// Adds an edge such that |dependent| waits on |record| to complete.
+// Edges to a dependent are always added consecutively while the dependent is
+// being emitted and repeated edges are dropped.
+static iree_status_t iree_hal_task_command_buffer_add_edge(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_record_t* record, iree_hal_task_record_t* dependent) {
+  if (record->last_dependent == dependent) return iree_ok_status();
+  iree_hal_task_edge_t* edge = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*edge), (void**)&edge));
+  edge->next = record->dependents;
+  edge->dependent = dependent;
+  record->dependents = edge;
+  ++record->dependent_count;
+  record->last_dependent = dependent;
+  ++dependent->predecessor_count;
+  return iree_ok_status();
+}
+
+// Returns the range of the allocated buffer backing |buffer| accessed by a
+// command. The buffer is not mapped as mapping may have side effects such as
+// scribbling over discarded contents in debug builds. As with
+// iree_hal_buffer_test_overlap distinct allocated buffers are assumed not to
+// alias. Ranges that cannot be resolved are treated as aliasing all memory
+// such that the command is conservatively ordered against all others.
+static iree_hal_task_access_range_t iree_hal_task_buffer_access_range(
+    iree_hal_buffer_t* buffer, iree_device_size_t offset,
+    iree_device_size_t length, bool is_write) {
+  iree_hal_task_access_range_t range = {NULL, 0, UINTPTR_MAX, is_write};
+  if (length == 0) {
+    range.end = 0;
+    return range;
+  }
+  iree_device_size_t byte_length = iree_hal_buffer_byte_length(buffer);
+  if (offset > byte_length) return range;
+  if (length == IREE_WHOLE_BUFFER || length > byte_length - offset) {
+    length = byte_length - offset;
+  }
+  range.buffer = iree_hal_buffer_allocated_buffer(buffer);
+  range.begin = (uintptr_t)(iree_hal_buffer_byte_offset(buffer) + offset);
+  range.end = range.begin + (uintptr_t)length;
+  return range;
+}
+
+static bool iree_hal_task_access_ranges_overlap(
+    const iree_hal_task_access_range_t* lhs,
+    const iree_hal_task_access_range_t* rhs) {
+  if (lhs->buffer && rhs->buffer && lhs->buffer != rhs->buffer) return false;
+  return lhs->begin < rhs->end && rhs->begin < lhs->end;
+}
+
+// Emits the given execution |task| accessing the given memory |ranges|.
+// The task will wait on all tasks ordered before it by a barrier or event that
+// it has a hazard with and otherwise is free to execute concurrently.
+static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task,
+    iree_host_size_t range_count, const iree_hal_task_access_range_t* ranges) {
+  iree_hal_task_record_t* record = NULL;
   IREE_RETURN_IF_ERROR(
-      iree_hal_task_command_buffer_flush_tasks(command_buffer));
+      iree_hal_task_command_buffer_record_task(command_buffer, task, &record));
+
+  iree_host_size_t barrier_ordinal = command_buffer->state.barrier_ordinal;
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    const iree_hal_task_access_range_t* range = &ranges[i];
+    iree_hal_task_access_t** access_ptr = &command_buffer->state.accesses;
+    while (*access_ptr) {
+      iree_hal_task_access_t* access = *access_ptr;
+      if (access->record->ordinal < barrier_ordinal &&
+          (range->is_write || access->range.is_write) &&
+          iree_hal_task_access_ranges_overlap(range, &access->range)) {
+        IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_edge(
+            command_buffer, access->record, record));
+        if (!access->covering_record && range->is_write &&
+            (!range->buffer || range->buffer == access->range.buffer) &&
+            range->begin <= access->range.begin &&
+            range->end >= access->range.end) {
+          access->covering_record = record;
+        }
+      }
+      access_ptr = &access->next;
+    }
+  }
 
-  // Move the tasks from the leaf list (tail) to the root list (head) if this
-  // was the first set of tasks recorded.
-  if (iree_task_list_is_empty(&command_buffer->root_tasks) &&
-      !iree_task_list_is_empty(&command_buffer->leaf_tasks)) {
-    iree_task_list_move(&command_buffer->leaf_tasks,
-                        &command_buffer->root_tasks);
+  for (iree_host_size_t i = 0; i < range_count; ++i) {
+    if (ranges[i].begin >= ranges[i].end) continue;
+    iree_hal_task_access_t* access = NULL;
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                             sizeof(*access), (void**)&access));
+    access->next = command_buffer->state.pending_accesses;
+    access->record = record;
+    access->range = ranges[i];
+    access->covering_record = NULL;
+    command_buffer->state.pending_accesses = access;
   }
 
   return iree_ok_status();
 }
 
-// Flushes all open tasks to the previous barrier and prepares for more
-// recording. The root tasks are also populated here when required as this is
-// the one place where we can see both halves of the most recent synchronization
-// event: those tasks recorded prior (if any) and the task that marks the set of
-// tasks that will be recorded after (if any).
-static iree_status_t iree_hal_task_command_buffer_flush_tasks(
+// Orders all tasks prior to |barrier_ordinal| before subsequently recorded
+// commands. Accesses recorded since the last barrier become visible to new
+// commands and those covered by a task now ordered before them are dropped.
+// If too many accesses remain a join task is recorded that waits on all prior
+// tasks and subsequent commands wait on it instead.
+static iree_status_t iree_hal_task_command_buffer_move_barrier(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_host_size_t barrier_ordinal) {
+  command_buffer->state.barrier_ordinal = barrier_ordinal;
+
+  // Move the pending accesses to the front of the checked list.
+  iree_hal_task_access_t** access_ptr = &command_buffer->state.pending_accesses;
+  while (*access_ptr) {
+    access_ptr = &(*access_ptr)->next;
+    ++command_buffer->state.access_count;
+  }
+  *access_ptr = command_buffer->state.accesses;
+  command_buffer->state.accesses = command_buffer->state.pending_accesses;
+  command_buffer->state.pending_accesses = NULL;
+
+  access_ptr = &command_buffer->state.accesses;
+  while (*access_ptr) {
+    iree_hal_task_access_t* access = *access_ptr;
+    if (access->covering_record &&
+        access->covering_record->ordinal < barrier_ordinal) {
+      *access_ptr = access->next;
+      --command_buffer->state.access_count;
+      continue;
+    }
+    access_ptr = &access->next;
+  }
+  if (command_buffer->state.access_count <=
+      IREE_HAL_TASK_COMMAND_BUFFER_MAX_ACCESSES) {
+    return iree_ok_status();
+  }
+
+  // The join accesses all memory so that every subsequent command waits on it.
+  iree_task_nop_t* join_task = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*join_task), (void**)&join_task));
+  iree_task_nop_initialize(command_buffer->scope, join_task);
+  iree_hal_task_record_t* join_record = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_record_task(
+      command_buffer, &join_task->header, &join_record));
+  for (iree_hal_task_access_t* access = command_buffer->state.accesses;
+       access != NULL; access = access->next) {
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_add_edge(
+        command_buffer, access->record, join_record));
+  }
+  iree_hal_task_access_t* join_access = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, sizeof(*join_access), (void**)&join_access));
+  join_access->next = NULL;
+  join_access->record = join_record;
+  join_access->range.buffer = NULL;
+  join_access->range.begin = 0;
+  join_access->range.end = UINTPTR_MAX;
+  join_access->range.is_write = true;
+  join_access->covering_record = NULL;
+  command_buffer->state.accesses = join_access;
+  command_buffer->state.access_count = 1;
+  command_buffer->state.barrier_ordinal =
+      command_buffer->state.task_record_count;
+  return iree_ok_status();
+}
+
+// Links all recorded tasks into the task DAG based on the edges accumulated
+// during recording and populates the root and leaf task sets. Tasks with a
+// single dependent complete directly into it while those with more fan out
+// through a barrier.
+static iree_status_t iree_hal_task_command_buffer_link_tasks(
     iree_hal_task_command_buffer_t* command_buffer) {
-  iree_task_barrier_t* open_barrier = command_buffer->state.open_barrier;
-  if (open_barrier != NULL) {
-    // There is an open barrier we need to fixup the fork out to all of the open
-    // tasks that were recorded after it.
-    iree_task_t* task_head =
-        iree_task_list_front(&command_buffer->state.open_tasks);
-    iree_host_size_t dependent_task_count =
-        command_buffer->state.open_task_count;
-    if (dependent_task_count == 1) {
-      // Special-case: only one open task so we can avoid the additional barrier
-      // overhead by reusing the completion task.
-      iree_task_set_completion_task(&open_barrier->header, task_head);
-    } else if (dependent_task_count > 1) {
-      // Allocate the list of tasks we'll stash back on the previous barrier.
-      // Since we couldn't know at the time how many tasks would end up in the
-      // barrier we had to defer it until now.
+  iree_host_size_t leaf_task_count = 0;
+  for (iree_hal_task_record_t* record = command_buffer->state.task_records_head;
+       record != NULL; record = record->next) {
+    if (record->dependent_count == 0) ++leaf_task_count;
+  }
+  iree_task_t** leaf_tasks = NULL;
+  if (leaf_task_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_arena_allocate(
+        &command_buffer->arena, leaf_task_count * sizeof(*leaf_tasks),
+        (void**)&leaf_tasks));
+  }
+
+  // NOTE: fan-out barriers are recorded as we go so that they are included in
+  // the replay table but they are already fully linked and must not be
+  // revisited.
+  iree_hal_task_record_t* last_record = command_buffer->state.task_records_tail;
+  iree_host_size_t leaf_index = 0;
+  for (iree_hal_task_record_t* record = command_buffer->state.task_records_head;
+       record != NULL; record = record->next) {
+    if (record->predecessor_count == 0) {
+      iree_task_list_push_back(&command_buffer->root_tasks, record->task);
+    }
+    if (record->dependent_count == 0) {
+      leaf_tasks[leaf_index++] = record->task;
+    } else if (record->dependent_count == 1) {
+      iree_task_set_completion_task(record->task,
+                                    record->dependents->dependent->task);
+    } else {
+      iree_task_barrier_t* barrier = NULL;
+      IREE_RETURN_IF_ERROR(iree_arena_allocate(
+          &command_buffer->arena, sizeof(*barrier), (void**)&barrier));
       iree_task_t** dependent_tasks = NULL;
       IREE_RETURN_IF_ERROR(iree_arena_allocate(
-          &command_buffer->arena, dependent_task_count * sizeof(iree_task_t*),
+          &command_buffer->arena,
+          record->dependent_count * sizeof(*dependent_tasks),
           (void**)&dependent_tasks));
-      iree_task_t* task = task_head;
-      for (iree_host_size_t i = 0; i < dependent_task_count; ++i) {
-        dependent_tasks[i] = task;
-        task = task->next_task;
+      // Edges are most recent first; reverse so that dependents are readied in
+      // recording order.
+      iree_host_size_t i = record->dependent_count;
+      for (iree_hal_task_edge_t* edge = record->dependents; edge != NULL;
+           edge = edge->next) {
+        dependent_tasks[--i] = edge->dependent->task;
       }
-      iree_task_barrier_set_dependent_tasks(open_barrier, dependent_task_count,
-                                            dependent_tasks);
+      iree_task_barrier_initialize(command_buffer->scope,
+                                   record->dependent_count, dependent_tasks,
+                                   barrier);
+      iree_task_set_completion_task(record->task, &barrier->header);
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_record_task(
+          command_buffer, &barrier->header, NULL));
     }
+    if (record == last_record) break;
   }
-  command_buffer->state.open_barrier = NULL;
 
-  // Move the open tasks to the tail as they represent the first half of the
-  // *next* barrier that will be inserted.
-  if (command_buffer->state.open_task_count > 0) {
-    iree_task_list_move(&command_buffer->state.open_tasks,
-                        &command_buffer->leaf_tasks);
-    command_buffer->state.open_task_count = 0;
+  command_buffer->leaf_task_count = leaf_task_count;
+  command_buffer->leaf_tasks = leaf_tasks;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_task_command_buffer_t replay
+//===----------------------------------------------------------------------===//
+
+// Returns the size of the task structure of the given |type| as emitted by the
+// command buffer. Command payloads that follow the task are immutable during
+// execution and do not need to be snapshotted.
+static iree_host_size_t iree_hal_task_command_buffer_task_size(
+    iree_task_type_t type) {
+  switch (type) {
+    case IREE_TASK_TYPE_NOP:
+      return sizeof(iree_task_nop_t);
+    case IREE_TASK_TYPE_CALL:
+      return sizeof(iree_task_call_t);
+    case IREE_TASK_TYPE_BARRIER:
+      return sizeof(iree_task_barrier_t);
+    case IREE_TASK_TYPE_DISPATCH:
+      return sizeof(iree_task_dispatch_t);
+    default:
+      return 0;
   }
+}
 
-  return iree_ok_status();
+// NOTE: while building the replay table the (otherwise always NULL) pool field
+// of the recorded tasks is used to stash the task index so that edges can be
+// translated to indices without a lookup table.
+static void iree_hal_task_replay_stash_index(iree_task_t* task,
+                                             iree_host_size_t index) {
+  task->pool = (iree_task_pool_t*)(uintptr_t)(index + 1);
+}
+static int32_t iree_hal_task_replay_stashed_index(const iree_task_t* task) {
+  return (int32_t)((uintptr_t)task->pool - 1);
 }
 
-// Emits a global barrier, splitting execution into all prior recorded tasks
-// and all subsequent recorded tasks. This is currently the critical piece that
-// limits our concurrency: changing to fine-grained barriers (via barrier
-// buffers or events) will allow more work to overlap at the cost of more brain
-// to build out the proper task graph.
-static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
+// Builds the replay table from all recorded tasks. Must be called after the
+// DAG is fully linked at the end of recording. The root and leaf task lists
+// are cleared as the replay table subsumes them.
+static iree_status_t iree_hal_task_command_buffer_build_replay(
     iree_hal_task_command_buffer_t* command_buffer) {
-  // Flush open tasks to the previous barrier. This resets our state such that
-  // we can assign the new open barrier and start recording tasks for it.
-  // Previous tasks will be moved into the leaf_tasks list.
-  IREE_RETURN_IF_ERROR(
-      iree_hal_task_command_buffer_flush_tasks(command_buffer));
-
-  // Allocate the new open barrier.
-  // As we are recording forward we can't yet assign the dependent tasks (the
-  // second half of the synchronization domain) and instead are just inserting
-  // it so we can setup the join from previous tasks (the first half of the
-  // synchronization domain).
-  iree_task_barrier_t* barrier = NULL;
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           sizeof(*barrier), (void**)&barrier));
-  iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  iree_host_size_t task_count = command_buffer->state.task_record_count;
+  if (task_count == 0) return iree_ok_status();
+  if (IREE_UNLIKELY(task_count > INT32_MAX)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "too many commands in a reusable command buffer");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_task_replay_entry_t* entries = NULL;
+  iree_status_t status =
+      iree_arena_allocate(&command_buffer->arena, task_count * sizeof(*entries),
+                          (void**)&entries);
+
+  // Snapshot each task in its pristine state.
+  iree_host_size_t index = 0;
+  for (iree_hal_task_record_t* record = command_buffer->state.task_records_head;
+       record != NULL && iree_status_is_ok(status);
+       record = record->next, ++index) {
+    iree_hal_task_replay_entry_t* entry = &entries[index];
+    memset(entry, 0, sizeof(*entry));
+    entry->task = record->task;
+    entry->task_size =
+        (uint32_t)iree_hal_task_command_buffer_task_size(record->task->type);
+    entry->completion_index = -1;
+    iree_task_t* snapshot = NULL;
+    status = iree_arena_allocate(&command_buffer->arena, entry->task_size,
+                                 (void**)&snapshot);
+    if (iree_status_is_ok(status)) {
+      memcpy(snapshot, record->task, entry->task_size);
+      snapshot->next_task = NULL;
+      entry->snapshot = snapshot;
+    }
+  }
+  if (!iree_status_is_ok(status)) {
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
 
-  // If there were previous tasks then join them to the barrier.
-  for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
-       task != NULL; task = task->next_task) {
-    iree_task_set_completion_task(task, &barrier->header);
+  // Translate the edges in the DAG to indices.
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    iree_hal_task_replay_stash_index(entries[i].task, i);
+  }
+  for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
+       task = task->next_task) {
+    entries[iree_hal_task_replay_stashed_index(task)].flags |=
+        IREE_HAL_TASK_REPLAY_ENTRY_FLAG_ROOT;
+  }
+  for (iree_host_size_t i = 0; i < command_buffer->leaf_task_count; ++i) {
+    entries[iree_hal_task_replay_stashed_index(command_buffer->leaf_tasks[i])]
+        .flags |= IREE_HAL_TASK_REPLAY_ENTRY_FLAG_LEAF;
+  }
+  for (iree_host_size_t i = 0; i < task_count && iree_status_is_ok(status);
+       ++i) {
+    iree_hal_task_replay_entry_t* entry = &entries[i];
+    if (entry->snapshot->completion_task) {
+      entry->completion_index =
+          iree_hal_task_replay_stashed_index(entry->snapshot->completion_task);
+    }
+    if (entry->snapshot->type == IREE_TASK_TYPE_BARRIER &&
+        ((const iree_task_barrier_t*)entry->snapshot)->dependent_task_count) {
+      const iree_task_barrier_t* barrier =
+          (const iree_task_barrier_t*)entry->snapshot;
+      uint32_t* dependent_indices = NULL;
+      status = iree_arena_allocate(
+          &command_buffer->arena,
+          barrier->dependent_task_count * sizeof(*dependent_indices),
+          (void**)&dependent_indices);
+      if (!iree_status_is_ok(status)) break;
+      for (iree_host_size_t j = 0; j < barrier->dependent_task_count; ++j) {
+        dependent_indices[j] = (uint32_t)iree_hal_task_replay_stashed_index(
+            barrier->dependent_tasks[j]);
+      }
+      entry->dependent_indices = dependent_indices;
+    }
+  }
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    entries[i].task->pool = NULL;
+  }
+
+  if (iree_status_is_ok(status)) {
+    // The replay table now owns the DAG; the recorded tasks are never enqueued
+    // directly.
+    iree_task_list_initialize(&command_buffer->root_tasks);
+    command_buffer->leaf_task_count = 0;
+    command_buffer->leaf_tasks = NULL;
+    command_buffer->replay.task_count = task_count;
+    command_buffer->replay.entries = entries;
   }
 
-  // Move the tasks from the leaf list (tail) to the root list (head) if this
-  // was the first set of tasks recorded.
-  if (iree_task_list_is_empty(&command_buffer->root_tasks) &&
-      !iree_task_list_is_empty(&command_buffer->leaf_tasks)) {
-    iree_task_list_move(&command_buffer->leaf_tasks,
-                        &command_buffer->root_tasks);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// A task chained after all leaf tasks of an in-place replay that marks the
+// recorded tasks as available for reuse once it is cleaned up.
+typedef struct {
+  iree_task_nop_t task;
+  iree_hal_task_command_buffer_t* command_buffer;
+} iree_hal_task_replay_fence_t;
+
+static void iree_hal_task_replay_fence_cleanup(iree_task_t* task,
+                                               iree_status_t status) {
+  iree_hal_task_replay_fence_t* fence = (iree_hal_task_replay_fence_t*)task;
+  iree_atomic_fetch_sub_int32(&fence->command_buffer->replay.in_place_count, 1,
+                              iree_memory_order_release);
+}
+
+// Resets all recorded tasks to their pristine state so that they can be
+// executed again. Only valid if no other issue is using them.
+//
+// NOTE: the replay fence is only reached after every task in the DAG has
+// retired; a worker may still be within the cleanup of a retired task but that
+// only reads fields (pool/cleanup_fn) that the reset writes with the same
+// values they already hold.
+static void iree_hal_task_command_buffer_reset_in_place(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  for (iree_host_size_t i = 0; i < command_buffer->replay.task_count; ++i) {
+    const iree_hal_task_replay_entry_t* entry =
+        &command_buffer->replay.entries[i];
+    memcpy(entry->task, entry->snapshot, entry->task_size);
   }
+}
 
-  // Reset the tail of the command buffer to the barrier. This leaves us in a
-  // consistent state if the recording ends immediate after this (the barrier
-  // will be the last task).
-  iree_task_list_initialize(&command_buffer->leaf_tasks);
-  iree_task_list_push_back(&command_buffer->leaf_tasks, &barrier->header);
+// Clones all recorded tasks into |arena| and relinks their dependencies.
+// |out_tasks| will contain the cloned tasks in replay table order.
+static iree_status_t iree_hal_task_command_buffer_clone_tasks(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_arena_allocator_t* arena, iree_task_t*** out_tasks) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t task_count = command_buffer->replay.task_count;
+  const iree_hal_task_replay_entry_t* entries = command_buffer->replay.entries;
+
+  iree_task_t** tasks = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(arena, task_count * sizeof(*tasks),
+                              (void**)&tasks));
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(arena, entries[i].task_size,
+                                (void**)&tasks[i]));
+    memcpy(tasks[i], entries[i].snapshot, entries[i].task_size);
+  }
 
-  // NOTE: all new tasks emitted will be executed after this barrier.
-  command_buffer->state.open_barrier = barrier;
-  command_buffer->state.open_task_count = 0;
+  // Relink the edges now that all tasks have been allocated.
+  for (iree_host_size_t i = 0; i < task_count; ++i) {
+    const iree_hal_task_replay_entry_t* entry = &entries[i];
+    iree_task_t* task = tasks[i];
+    task->completion_task =
+        entry->completion_index >= 0 ? tasks[entry->completion_index] : NULL;
+    if (entry->dependent_indices) {
+      iree_task_barrier_t* barrier = (iree_task_barrier_t*)task;
+      iree_task_t** dependent_tasks = NULL;
+      IREE_RETURN_AND_END_ZONE_IF_ERROR(
+          z0, iree_arena_allocate(
+                  arena, barrier->dependent_task_count * sizeof(iree_task_t*),
+                  (void**)&dependent_tasks));
+      for (iree_host_size_t j = 0; j < barrier->dependent_task_count; ++j) {
+        dependent_tasks[j] = tasks[entry->dependent_indices[j]];
+      }
+      barrier->dependent_tasks = dependent_tasks;
+    }
+  }
 
+  *out_tasks = tasks;
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
-// Emits a the given execution |task| into the current open synchronization
-// scope (after state.open_barrier and before the next barrier).
-static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
-    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* task) {
-  if (command_buffer->state.open_barrier == NULL) {
-    // If there is no open barrier then we are at the head and going right into
-    // the task DAG.
-    iree_task_list_push_back(&command_buffer->leaf_tasks, task);
+// Issues a reusable command buffer from its replay table.
+static iree_status_t iree_hal_task_command_buffer_issue_replay(
+    iree_hal_task_command_buffer_t* command_buffer, iree_task_t* retire_task,
+    iree_arena_allocator_t* arena, iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (command_buffer->replay.task_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Fast path: if no prior issue is executing the recorded tasks we can reset
+  // and reuse them directly. Otherwise we copy-on-submit so that the two
+  // executions don't share task state.
+  iree_task_t** tasks = NULL;
+  iree_task_t* completion_task = retire_task;
+  int32_t expected_count = 0;
+  if (iree_atomic_compare_exchange_strong_int32(
+          &command_buffer->replay.in_place_count, &expected_count, 1,
+          iree_memory_order_acq_rel, iree_memory_order_relaxed)) {
+    iree_hal_task_replay_fence_t* fence = NULL;
+    iree_status_t status =
+        iree_arena_allocate(arena, sizeof(*fence), (void**)&fence);
+    if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+      iree_atomic_store_int32(&command_buffer->replay.in_place_count, 0,
+                              iree_memory_order_release);
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_task_nop_initialize(command_buffer->scope, &fence->task);
+    iree_task_set_cleanup_fn(&fence->task.header,
+                             iree_hal_task_replay_fence_cleanup);
+    fence->command_buffer = command_buffer;
+    iree_task_set_completion_task(&fence->task.header, retire_task);
+    completion_task = &fence->task.header;
+    iree_hal_task_command_buffer_reset_in_place(command_buffer);
   } else {
-    // Append to the open task list that will be flushed to the open barrier.
-    iree_task_list_push_back(&command_buffer->state.open_tasks, task);
-    ++command_buffer->state.open_task_count;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_task_command_buffer_clone_tasks(command_buffer, arena,
+                                                     &tasks));
   }
+
+  // Chain the leaves to the completion task and enqueue the roots.
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_host_size_t i = 0; i < command_buffer->replay.task_count; ++i) {
+    const iree_hal_task_replay_entry_t* entry =
+        &command_buffer->replay.entries[i];
+    iree_task_t* task = tasks ? tasks[i] : entry->task;
+    if (entry->flags & IREE_HAL_TASK_REPLAY_ENTRY_FLAG_LEAF) {
+      iree_task_set_completion_task(task, completion_task);
+    }
+    if (entry->flags & IREE_HAL_TASK_REPLAY_ENTRY_FLAG_ROOT) {
+      iree_task_list_push_back(&root_tasks, task);
+    }
+  }
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
@@ -341,27 +889,24 @@ iree_status_t iree_hal_task_command_buffer_issue(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
+  // Reusable command buffers are issued from their replay table and never
+  // hand over ownership of the recorded tasks.
+  if (!iree_all_bits_set(command_buffer->mode,
+                         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    return iree_hal_task_command_buffer_issue_replay(
+        command_buffer, retire_task, arena, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
     return iree_ok_status();
   }
 
-  bool has_leaf_tasks = !iree_task_list_is_empty(&command_buffer->leaf_tasks);
-  if (has_leaf_tasks) {
-    // Chain the retire task onto the leaf tasks as their completion indicates
-    // that all commands have completed.
-    for (iree_task_t* task = command_buffer->leaf_tasks.head; task != NULL;
-         task = task->next_task) {
-      iree_task_set_completion_task(task, retire_task);
-    }
-  } else {
-    // If we have no leaf tasks it means that this is a single layer DAG and
-    // after the root tasks complete the entire command buffer has completed.
-    for (iree_task_t* task = command_buffer->root_tasks.head; task != NULL;
-         task = task->next_task) {
-      iree_task_set_completion_task(task, retire_task);
-    }
+  // Chain the retire task onto the leaf tasks as their completion indicates
+  // that all commands have completed.
+  for (iree_host_size_t i = 0; i < command_buffer->leaf_task_count; ++i) {
+    iree_task_set_completion_task(command_buffer->leaf_tasks[i], retire_task);
   }
 
   // Enqueue all root tasks that are ready to run immediately.
@@ -369,7 +914,8 @@ iree_status_t iree_hal_task_command_buffer_issue(
   // we need to ensure the command buffer doesn't try to discard them.
   iree_task_submission_enqueue_list(pending_submission,
                                     &command_buffer->root_tasks);
-  iree_task_list_initialize(&command_buffer->leaf_tasks);
+  command_buffer->leaf_task_count = 0;
+  command_buffer->leaf_tasks = NULL;
 
   return iree_ok_status();
 }
@@ -390,19 +936,34 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  // TODO(benvanik): actual DAG construction. Right now we are just doing simple
-  // global barriers each time and forcing a join-fork point.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  // Orders all prior commands before all subsequent ones. Subsequent commands
+  // only wait on those they have a hazard with and the memory and buffer
+  // barriers are not needed as the hazards are derived from the ranges each
+  // command accesses.
+  return iree_hal_task_command_buffer_move_barrier(
+      command_buffer, command_buffer->state.task_record_count);
 }
 
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_signal_event
 //===----------------------------------------------------------------------===//
 
+// Events are resolved during recording into edges in the task DAG: a wait on
+// an event orders all commands recorded prior to the signal before those
+// recorded after the wait. Commands recorded between the signal and the wait
+// are unaffected and may overlap with both.
 static iree_status_t iree_hal_task_command_buffer_signal_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  iree_hal_task_event_signal_t* signal = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
+                                           sizeof(*signal), (void**)&signal));
+  signal->next = command_buffer->state.event_signals;
+  signal->event = event;
+  signal->ordinal = command_buffer->state.task_record_count;
+  command_buffer->state.event_signals = signal;
   return iree_ok_status();
 }
 
@@ -413,7 +974,17 @@ static iree_status_t iree_hal_task_command_buffer_signal_event(
 static iree_status_t iree_hal_task_command_buffer_reset_event(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_event_t* event,
     iree_hal_execution_stage_t source_stage_mask) {
-  // TODO(#4518): implement events. For now we just insert global barriers.
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  iree_hal_task_event_signal_t** signal_ptr =
+      &command_buffer->state.event_signals;
+  while (*signal_ptr) {
+    if ((*signal_ptr)->event == event) {
+      *signal_ptr = (*signal_ptr)->next;
+    } else {
+      signal_ptr = &(*signal_ptr)->next;
+    }
+  }
   return iree_ok_status();
 }
 
@@ -432,8 +1003,21 @@ static iree_status_t iree_hal_task_command_buffer_wait_events(
     const iree_hal_buffer_barrier_t* buffer_barriers) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
-  // TODO(#4518): implement events. For now we just insert global barriers.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  iree_host_size_t barrier_ordinal = command_buffer->state.barrier_ordinal;
+  for (iree_host_size_t i = 0; i < event_count; ++i) {
+    const iree_hal_task_event_signal_t* signal =
+        command_buffer->state.event_signals;
+    while (signal && signal->event != events[i]) signal = signal->next;
+    if (signal) {
+      barrier_ordinal = iree_max(barrier_ordinal, signal->ordinal);
+    } else {
+      // Signaled outside of this command buffer (or never); conservatively
+      // order everything recorded so far before subsequent commands.
+      barrier_ordinal = command_buffer->state.task_record_count;
+    }
+  }
+  return iree_hal_task_command_buffer_move_barrier(command_buffer,
+                                                   barrier_ordinal);
 }
 
 //===----------------------------------------------------------------------===//
@@ -445,12 +1029,160 @@ static iree_status_t iree_hal_task_command_buffer_discard_buffer(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// Transfer tiling
+//===----------------------------------------------------------------------===//
+// Large fills and copies are split into fixed-size tiles and issued as a
+// dispatch so that they are spread across all workers instead of serializing
+// hundreds of MB of memory traffic on a single one. Small transfers remain a
+// single call task as the dispatch overhead (and cross-core cache traffic)
+// outweighs any parallelism. Use task_command_buffer_benchmark to find the
+// crossover point for a particular machine.
+
+// Minimum length in bytes of a fill or copy that will be tiled.
+#if !defined(IREE_HAL_TASK_CMD_TRANSFER_TILING_MIN_LENGTH)
+#define IREE_HAL_TASK_CMD_TRANSFER_TILING_MIN_LENGTH (1 * 1024 * 1024)
+#endif  // !IREE_HAL_TASK_CMD_TRANSFER_TILING_MIN_LENGTH
+
+// Length in bytes of each tile of a tiled fill or copy. Must be a multiple of
+// 64 so that every tile starts at a cache line (relative to the transfer) and
+// at a multiple of the fill pattern length.
+#if !defined(IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH)
+#define IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH (256 * 1024)
+#endif  // !IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH
+
+// Minimum length in bytes of a tiled fill or copy that will use non-temporal
+// stores (where supported). Transfers this large are expected to exceed the
+// last-level cache and would otherwise evict the working set of every worker
+// for data that won't be read back until much later.
+#if !defined(IREE_HAL_TASK_CMD_TRANSFER_NONTEMPORAL_MIN_LENGTH)
+#define IREE_HAL_TASK_CMD_TRANSFER_NONTEMPORAL_MIN_LENGTH (32 * 1024 * 1024)
+#endif  // !IREE_HAL_TASK_CMD_TRANSFER_NONTEMPORAL_MIN_LENGTH
+
+static_assert(IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH % 64 == 0,
+              "transfer tiles must be a multiple of 64 bytes");
+
+// Returns the number of tiles a transfer of |length| bytes is split into.
+static iree_device_size_t iree_hal_task_cmd_transfer_tile_count(
+    iree_device_size_t length) {
+  return (length + IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH - 1) /
+         IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH;
+}
+
+// Returns true if a transfer of |length| bytes should be tiled.
+static bool iree_hal_task_cmd_transfer_is_tiled(iree_device_size_t length) {
+  return length != IREE_WHOLE_BUFFER &&
+         length >= IREE_HAL_TASK_CMD_TRANSFER_TILING_MIN_LENGTH &&
+         iree_hal_task_cmd_transfer_tile_count(length) <= UINT32_MAX;
+}
+
+// Returns true if a tiled transfer of |length| bytes should bypass the cache.
+static bool iree_hal_task_cmd_transfer_is_nontemporal(
+    iree_device_size_t length) {
+#if defined(IREE_ARCH_X86_64)
+  return length >= IREE_HAL_TASK_CMD_TRANSFER_NONTEMPORAL_MIN_LENGTH;
+#else
+  // TODO(benvanik): non-temporal stores on ARM (STNP).
+  return false;
+#endif  // IREE_ARCH_X86_64
+}
+
+// Initializes |out_task| as a dispatch over all tiles of a transfer of
+// |length| bytes.
+static void iree_hal_task_cmd_transfer_dispatch_initialize(
+    iree_task_scope_t* scope, iree_task_dispatch_closure_t closure,
+    iree_device_size_t length, iree_task_dispatch_t* out_task) {
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {
+      (uint32_t)iree_hal_task_cmd_transfer_tile_count(length),
+      1,
+      1,
+  };
+  iree_task_dispatch_initialize(scope, closure, workgroup_size,
+                                workgroup_count, out_task);
+  // Each tile is a large uniform chunk of memory bandwidth; reserving them one
+  // at a time lets every worker take a share of even short transfers.
+  out_task->tiles_per_reservation = 1;
+}
+
+// Returns the byte range of the transfer of |length| bytes that the tile
+// described by |tile_context| covers.
+static void iree_hal_task_cmd_transfer_tile_range(
+    const iree_task_tile_context_t* tile_context, iree_device_size_t length,
+    iree_device_size_t* out_tile_offset, iree_device_size_t* out_tile_length) {
+  iree_device_size_t tile_offset =
+      (iree_device_size_t)tile_context->workgroup_xyz[0] *
+      IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH;
+  *out_tile_offset = tile_offset;
+  *out_tile_length =
+      iree_min(length - tile_offset, IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH);
+}
+
+#if defined(IREE_ARCH_X86_64)
+
+// Fills |length| bytes at |target| with the repeating 4-byte |pattern| using
+// streaming stores. |target| must be at a multiple of 4 bytes from the start of
+// the pattern.
+static void iree_hal_task_fill_nontemporal(uint8_t* target,
+                                           iree_host_size_t length,
+                                           uint32_t pattern) {
+  const uint8_t* pattern_bytes = (const uint8_t*)&pattern;
+  iree_host_size_t i = 0;
+  for (; i < length && ((uintptr_t)(target + i) & 15); ++i) {
+    target[i] = pattern_bytes[i & 3];
+  }
+  // Rotate the pattern to the phase it has at the first aligned address.
+  uint32_t phase_bits = (uint32_t)(i & 3) * 8;
+  uint32_t phased_pattern =
+      phase_bits ? (pattern >> phase_bits) | (pattern << (32 - phase_bits))
+                 : pattern;
+  __m128i value = _mm_set1_epi32((int)phased_pattern);
+  for (; i + 64 <= length; i += 64) {
+    _mm_stream_si128((__m128i*)(target + i + 0), value);
+    _mm_stream_si128((__m128i*)(target + i + 16), value);
+    _mm_stream_si128((__m128i*)(target + i + 32), value);
+    _mm_stream_si128((__m128i*)(target + i + 48), value);
+  }
+  for (; i + 16 <= length; i += 16) {
+    _mm_stream_si128((__m128i*)(target + i), value);
+  }
+  for (; i < length; ++i) {
+    target[i] = pattern_bytes[i & 3];
+  }
+  // Streaming stores are weakly ordered; make them visible before the tile
+  // retires and dependent tasks on other workers begin reading.
+  _mm_sfence();
+}
+
+// Copies |length| bytes from |source| to |target| using streaming stores.
+static void iree_hal_task_copy_nontemporal(uint8_t* target,
+                                           const uint8_t* source,
+                                           iree_host_size_t length) {
+  iree_host_size_t i = iree_min(length, (16 - ((uintptr_t)target & 15)) & 15);
+  memcpy(target, source, i);
+  for (; i + 64 <= length; i += 64) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*)(source + i + 0));
+    __m128i v1 = _mm_loadu_si128((const __m128i*)(source + i + 16));
+    __m128i v2 = _mm_loadu_si128((const __m128i*)(source + i + 32));
+    __m128i v3 = _mm_loadu_si128((const __m128i*)(source + i + 48));
+    _mm_stream_si128((__m128i*)(target + i + 0), v0);
+    _mm_stream_si128((__m128i*)(target + i + 16), v1);
+    _mm_stream_si128((__m128i*)(target + i + 32), v2);
+    _mm_stream_si128((__m128i*)(target + i + 48), v3);
+  }
+  for (; i + 16 <= length; i += 16) {
+    _mm_stream_si128((__m128i*)(target + i),
+                     _mm_loadu_si128((const __m128i*)(source + i)));
+  }
+  memcpy(target + i, source + i, length - i);
+  _mm_sfence();
+}
+
+#endif  // IREE_ARCH_X86_64
+
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_fill_buffer
 //===----------------------------------------------------------------------===//
-// NOTE: for large fills we could dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; filling a 200KB
-// buffer: maybe not, filling a 200MB buffer: yeah.
 
 typedef struct {
   iree_task_call_t task;
@@ -474,6 +1206,105 @@ static iree_status_t iree_hal_cmd_fill_buffer(
   return status;
 }
 
+// A fill split into IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH tiles.
+typedef struct {
+  iree_task_dispatch_t task;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t target_offset;
+  iree_device_size_t length;
+  bool nontemporal;
+  uint32_t pattern_length;
+  uint8_t pattern[8];
+} iree_hal_cmd_fill_buffer_tiled_t;
+
+static iree_status_t iree_hal_cmd_fill_buffer_tile(
+    uintptr_t user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_fill_buffer_tiled_t* cmd =
+      (const iree_hal_cmd_fill_buffer_tiled_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_device_size_t tile_offset = 0;
+  iree_device_size_t tile_length = 0;
+  iree_hal_task_cmd_transfer_tile_range(tile_context, cmd->length,
+                                        &tile_offset, &tile_length);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, tile_length);
+
+  iree_status_t status = iree_ok_status();
+#if defined(IREE_ARCH_X86_64)
+  if (cmd->nontemporal) {
+    iree_hal_buffer_mapping_t target_mapping;
+    status = iree_hal_buffer_map_range(
+        cmd->target_buffer, IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+        cmd->target_offset + tile_offset, tile_length, &target_mapping);
+    if (iree_status_is_ok(status)) {
+      uint32_t pattern = 0;
+      memcpy(&pattern, cmd->pattern, cmd->pattern_length);
+      if (cmd->pattern_length == 1) {
+        pattern *= 0x01010101u;
+      } else if (cmd->pattern_length == 2) {
+        pattern |= pattern << 16;
+      }
+      iree_hal_task_fill_nontemporal(target_mapping.contents.data,
+                                     target_mapping.contents.data_length,
+                                     pattern);
+      iree_hal_buffer_unmap_range(&target_mapping);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+#endif  // IREE_ARCH_X86_64
+  status = iree_hal_buffer_fill(cmd->target_buffer,
+                                cmd->target_offset + tile_offset, tile_length,
+                                cmd->pattern, cmd->pattern_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_task_command_buffer_fill_buffer_tiled(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length, const void* pattern,
+    iree_host_size_t pattern_length) {
+  // Validate up-front as the tiles would otherwise each report the failure.
+  if (IREE_UNLIKELY(pattern_length != 1 && pattern_length != 2 &&
+                    pattern_length != 4)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "fill patterns must be 1, 2, or 4 bytes (got %zu)",
+                            pattern_length);
+  }
+  if (IREE_UNLIKELY((target_offset % pattern_length) != 0) ||
+      IREE_UNLIKELY((length % pattern_length) != 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "attempting to fill a range with %zu byte values "
+                            "that is not aligned (offset=%" PRIu64
+                            ", length=%" PRIu64 ")",
+                            pattern_length, target_offset, length);
+  }
+
+  iree_hal_cmd_fill_buffer_tiled_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+
+  iree_hal_task_cmd_transfer_dispatch_initialize(
+      command_buffer->scope,
+      iree_task_make_dispatch_closure(iree_hal_cmd_fill_buffer_tile,
+                                      (uintptr_t)cmd),
+      length, &cmd->task);
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  cmd->nontemporal = iree_hal_task_cmd_transfer_is_nontemporal(length);
+  memcpy(cmd->pattern, pattern, pattern_length);
+  cmd->pattern_length = pattern_length;
+
+  const iree_hal_task_access_range_t ranges[1] = {
+      iree_hal_task_buffer_access_range(target_buffer, target_offset, length,
+                                        /*is_write=*/true),
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(ranges), ranges);
+}
+
 static iree_status_t iree_hal_task_command_buffer_fill_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
@@ -482,6 +1313,12 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
+  if (iree_hal_task_cmd_transfer_is_tiled(length)) {
+    return iree_hal_task_command_buffer_fill_buffer_tiled(
+        command_buffer, target_buffer, target_offset, length, pattern,
+        pattern_length);
+  }
+
   iree_hal_cmd_fill_buffer_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
@@ -496,8 +1333,12 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   memcpy(cmd->pattern, pattern, pattern_length);
   cmd->pattern_length = pattern_length;
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_access_range_t ranges[1] = {
+      iree_hal_task_buffer_access_range(target_buffer, target_offset, length,
+                                        /*is_write=*/true),
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(ranges), ranges);
 }
 
 //===----------------------------------------------------------------------===//
@@ -549,16 +1390,17 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
   memcpy(cmd->source_buffer, (const uint8_t*)source_buffer + source_offset,
          cmd->length);
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_access_range_t ranges[1] = {
+      iree_hal_task_buffer_access_range(target_buffer, target_offset, length,
+                                        /*is_write=*/true),
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(ranges), ranges);
 }
 
 //===----------------------------------------------------------------------===//
 // iree_hal_command_buffer_copy_buffer
 //===----------------------------------------------------------------------===//
-// NOTE: for large copies we could dispatch this as tiles for parallelism.
-// We'd want to do some measurement for when it's worth it; copying a 200KB
-// buffer: maybe not, copying a 200MB buffer: yeah.
 
 typedef struct {
   iree_task_call_t task;
@@ -582,6 +1424,100 @@ static iree_status_t iree_hal_cmd_copy_buffer(
   return status;
 }
 
+// A copy split into IREE_HAL_TASK_CMD_TRANSFER_TILE_LENGTH tiles.
+typedef struct {
+  iree_task_dispatch_t task;
+  iree_hal_buffer_t* source_buffer;
+  iree_device_size_t source_offset;
+  iree_hal_buffer_t* target_buffer;
+  iree_device_size_t target_offset;
+  iree_device_size_t length;
+  bool nontemporal;
+} iree_hal_cmd_copy_buffer_tiled_t;
+
+static iree_status_t iree_hal_cmd_copy_buffer_tile(
+    uintptr_t user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_copy_buffer_tiled_t* cmd =
+      (const iree_hal_cmd_copy_buffer_tiled_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_device_size_t tile_offset = 0;
+  iree_device_size_t tile_length = 0;
+  iree_hal_task_cmd_transfer_tile_range(tile_context, cmd->length,
+                                        &tile_offset, &tile_length);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, tile_length);
+
+  iree_status_t status = iree_ok_status();
+#if defined(IREE_ARCH_X86_64)
+  if (cmd->nontemporal) {
+    iree_hal_buffer_mapping_t source_mapping;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_buffer_map_range(
+                cmd->source_buffer, IREE_HAL_MEMORY_ACCESS_READ,
+                cmd->source_offset + tile_offset, tile_length,
+                &source_mapping));
+    iree_hal_buffer_mapping_t target_mapping;
+    status = iree_hal_buffer_map_range(
+        cmd->target_buffer, IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE,
+        cmd->target_offset + tile_offset, tile_length, &target_mapping);
+    if (iree_status_is_ok(status)) {
+      iree_hal_task_copy_nontemporal(target_mapping.contents.data,
+                                     source_mapping.contents.data,
+                                     target_mapping.contents.data_length);
+      iree_hal_buffer_unmap_range(&target_mapping);
+    }
+    iree_hal_buffer_unmap_range(&source_mapping);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+#endif  // IREE_ARCH_X86_64
+  status = iree_hal_buffer_copy_data(
+      cmd->source_buffer, cmd->source_offset + tile_offset, cmd->target_buffer,
+      cmd->target_offset + tile_offset, tile_length);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_hal_task_command_buffer_copy_buffer_tiled(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+    iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+    iree_device_size_t length) {
+  // Validate up-front as each tile only checks its own subrange.
+  if (iree_hal_buffer_test_overlap(source_buffer, source_offset, length,
+                                   target_buffer, target_offset, length) !=
+      IREE_HAL_BUFFER_OVERLAP_DISJOINT) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "source and target ranges must not overlap within the same buffer");
+  }
+
+  iree_hal_cmd_copy_buffer_tiled_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+
+  iree_hal_task_cmd_transfer_dispatch_initialize(
+      command_buffer->scope,
+      iree_task_make_dispatch_closure(iree_hal_cmd_copy_buffer_tile,
+                                      (uintptr_t)cmd),
+      length, &cmd->task);
+  cmd->source_buffer = source_buffer;
+  cmd->source_offset = source_offset;
+  cmd->target_buffer = target_buffer;
+  cmd->target_offset = target_offset;
+  cmd->length = length;
+  cmd->nontemporal = iree_hal_task_cmd_transfer_is_nontemporal(length);
+
+  const iree_hal_task_access_range_t ranges[2] = {
+      iree_hal_task_buffer_access_range(source_buffer, source_offset, length,
+                                        /*is_write=*/false),
+      iree_hal_task_buffer_access_range(target_buffer, target_offset, length,
+                                        /*is_write=*/true),
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(ranges), ranges);
+}
+
 static iree_status_t iree_hal_task_command_buffer_copy_buffer(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
@@ -590,6 +1526,12 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
+  if (iree_hal_task_cmd_transfer_is_tiled(length)) {
+    return iree_hal_task_command_buffer_copy_buffer_tiled(
+        command_buffer, source_buffer, source_offset, target_buffer,
+        target_offset, length);
+  }
+
   iree_hal_cmd_copy_buffer_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(
       iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
@@ -604,8 +1546,14 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
   cmd->target_offset = target_offset;
   cmd->length = length;
 
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  const iree_hal_task_access_range_t ranges[2] = {
+      iree_hal_task_buffer_access_range(source_buffer, source_offset, length,
+                                        /*is_write=*/false),
+      iree_hal_task_buffer_access_range(target_buffer, target_offset, length,
+                                        /*is_write=*/true),
+  };
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, IREE_ARRAYSIZE(ranges), ranges);
 }
 
 //===----------------------------------------------------------------------===//
@@ -676,6 +1624,11 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
         buffer_mapping.contents.data;
     command_buffer->state.binding_lengths[binding_ordinal] =
         buffer_mapping.contents.data_length;
+    command_buffer->state.binding_ranges[binding_ordinal] =
+        iree_hal_task_buffer_access_range(
+            bindings[i].buffer, bindings[i].offset, bindings[i].length,
+            iree_any_bit_set(local_set_layout->bindings[binding_ordinal].access,
+                             IREE_HAL_MEMORY_ACCESS_WRITE));
   }
 
   return iree_ok_status();
@@ -726,7 +1679,7 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
       (const iree_hal_cmd_dispatch_t*)user_context;
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_executable_dispatch_state_v0_t state;
+  iree_hal_executable_dispatch_state_v1_t state;
   memset(&state, 0, sizeof(state));
   memcpy(state.workgroup_count.value, tile_context->workgroup_count,
          sizeof(state.workgroup_count));
@@ -750,9 +1703,17 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   // functions).
   state.imports = NULL;
 
+  // Local memory is allocated once per worker by the executor and the
+  // requirements of the entry point were checked against it when recording.
+  iree_hal_executable_workgroup_state_v1_t workgroup_state;
+  memcpy(workgroup_state.workgroup_id.value, tile_context->workgroup_xyz,
+         sizeof(workgroup_state.workgroup_id));
+  workgroup_state.reserved = 0;
+  workgroup_state.local_memory = tile_context->local_memory.data;
+  workgroup_state.local_memory_size = tile_context->local_memory.data_length;
+
   iree_status_t status = iree_hal_local_executable_issue_call(
-      cmd->executable, cmd->ordinal, &state,
-      (const iree_hal_vec3_t*)tile_context->workgroup_xyz);
+      cmd->executable, cmd->ordinal, &state, &workgroup_state);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -762,6 +1723,7 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
     uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z,
+    const iree_hal_task_access_range_t* workgroups_range,
     iree_hal_cmd_dispatch_t** out_cmd) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
@@ -782,6 +1744,20 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                             "too many bindings/push constants");
   }
 
+  // Local memory is allocated once per worker by the executor; entry points
+  // requiring more than it was configured with cannot run.
+  iree_host_size_t local_memory_size =
+      iree_hal_local_executable_local_memory_size(local_executable,
+                                                  entry_point);
+  if (IREE_UNLIKELY(local_memory_size >
+                    command_buffer->worker_local_memory_size)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "entry point %d requires %zu bytes of local memory "
+                            "but workers only have %zu",
+                            entry_point, local_memory_size,
+                            command_buffer->worker_local_memory_size);
+  }
+
   iree_hal_cmd_dispatch_t* cmd = NULL;
   iree_host_size_t total_cmd_size =
       sizeof(*cmd) + push_constant_count * sizeof(uint32_t) +
@@ -822,6 +1798,11 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   cmd_ptr += used_binding_count * sizeof(*binding_ptrs);
   size_t* binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += used_binding_count * sizeof(*binding_lengths);
+  iree_hal_task_access_range_t
+      ranges[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                 IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT +
+             1];
+  iree_host_size_t range_count = 0;
   iree_host_size_t binding_base = 0;
   for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
     int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
@@ -834,11 +1815,15 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "(flat) binding %d is NULL", binding_ordinal);
     }
+    ranges[range_count++] =
+        command_buffer->state.binding_ranges[binding_ordinal];
   }
 
+  if (workgroups_range) ranges[range_count++] = *workgroups_range;
+
   *out_cmd = cmd;
-  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
-                                                          &cmd->task.header);
+  return iree_hal_task_command_buffer_emit_execution_task(
+      command_buffer, &cmd->task.header, range_count, ranges);
 }
 
 static iree_status_t iree_hal_task_command_buffer_dispatch(
@@ -848,7 +1833,7 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
   iree_hal_cmd_dispatch_t* cmd = NULL;
   return iree_hal_task_command_buffer_build_dispatch(
       base_command_buffer, executable, entry_point, workgroup_x, workgroup_y,
-      workgroup_z, &cmd);
+      workgroup_z, /*workgroups_range=*/NULL, &cmd);
 }
 
 static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
@@ -862,9 +1847,14 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
       workgroups_buffer, IREE_HAL_MEMORY_ACCESS_READ, workgroups_offset,
       3 * sizeof(uint32_t), &buffer_mapping));
 
+  const iree_hal_task_access_range_t workgroups_range =
+      iree_hal_task_buffer_access_range(workgroups_buffer, workgroups_offset,
+                                        3 * sizeof(uint32_t),
+                                        /*is_write=*/false);
   iree_hal_cmd_dispatch_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_build_dispatch(
-      base_command_buffer, executable, entry_point, 0, 0, 0, &cmd));
+      base_command_buffer, executable, entry_point, 0, 0, 0, &workgroups_range,
+      &cmd));
   cmd->task.workgroup_count.ptr = (const uint32_t*)buffer_mapping.contents.data;
   cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
   return iree_ok_status();
@@ -17,11 +17,23 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Creates a command buffer that records directly into a task DAG.
+//
+// Command buffers without IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT may be issued
+// any number of times after recording ends. The recorded tasks are reused
+// in-place when no prior issue is still executing and are otherwise cloned
+// into the issuing submission's arena so that overlapping executions do not
+// share task state.
+//
+// |worker_local_memory_size| is the local memory available to each worker of
+// the executor the command buffer is issued on; dispatches of entry points
+// requiring more will fail to record.
 iree_status_t iree_hal_task_command_buffer_create(
     iree_hal_device_t* device, iree_task_scope_t* scope,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity,
+    iree_host_size_t worker_local_memory_size,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -41,6 +53,10 @@ iree_status_t iree_hal_task_command_buffer_create(
 //
 // |pending_submission| will receive the ready list of commands and must be
 // submitted to the executor (or discarded on failure) by the caller.
+//
+// One-shot command buffers transfer ownership of their tasks to the submission
+// and must not be issued again. Reusable command buffers must remain live until
+// all issues of them have retired.
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -0,0 +1,285 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/task_device.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+// Covers the transfer paths of the local-task command buffer that are only
+// taken for large fills and copies: tiling (>= 1MB) splits the transfer into
+// 256KB tiles spread across workers and non-temporal stores (>= 32MB on
+// x86-64) bypass the cache. Lengths are chosen to straddle the thresholds and
+// to leave a partial last tile, and offsets are not cache line aligned.
+
+namespace {
+
+constexpr iree_device_size_t kTilingMinLength = 1 * 1024 * 1024;
+constexpr iree_device_size_t kTileLength = 256 * 1024;
+constexpr iree_device_size_t kNonTemporalMinLength = 32 * 1024 * 1024;
+
+// Bytes before and after each transfer that must remain untouched.
+constexpr iree_device_size_t kGuardLength = 64;
+constexpr uint8_t kGuardValue = 0xCD;
+
+class TaskCommandBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+        /*worker_local_memory_size=*/0, iree_allocator_system(), &executor_));
+    iree_task_topology_deinitialize(&topology);
+
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        iree_make_cstring_view("test"), &params, executor_,
+        /*loader_count=*/0, /*loaders=*/NULL, iree_allocator_system(),
+        &device_));
+  }
+
+  void TearDown() override {
+    iree_hal_device_release(device_);
+    iree_task_executor_release(executor_);
+  }
+
+  // Allocates a buffer of |length| bytes filled with kGuardValue.
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t length) {
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_),
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE,
+        IREE_HAL_BUFFER_USAGE_ALL, length, &buffer));
+    IREE_CHECK_OK(iree_hal_buffer_fill(buffer, 0, length, &kGuardValue, 1));
+    return buffer;
+  }
+
+  std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> data(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(
+        iree_hal_buffer_read_data(buffer, 0, data.data(), data.size()));
+    return data;
+  }
+
+  // Records |record_fn| into a one-shot command buffer, submits it, and waits
+  // for it to complete.
+  template <typename F>
+  void RecordSubmitAndWait(F record_fn) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_command_buffer_create(
+        device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+        &command_buffer));
+    IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+    record_fn(command_buffer);
+    IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    uint64_t signal_value = 1ull;
+    iree_hal_submission_batch_t batch;
+    std::memset(&batch, 0, sizeof(batch));
+    batch.command_buffer_count = 1;
+    batch.command_buffers = &command_buffer;
+    batch.signal_semaphores.count = 1;
+    batch.signal_semaphores.semaphores = &semaphore;
+    batch.signal_semaphores.payload_values = &signal_value;
+    IREE_ASSERT_OK(iree_hal_device_queue_submit(
+        device_, IREE_HAL_COMMAND_CATEGORY_TRANSFER, /*queue_affinity=*/0,
+        /*batch_count=*/1, &batch));
+    IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore, signal_value,
+                                           iree_infinite_timeout()));
+    iree_hal_semaphore_release(semaphore);
+    iree_hal_command_buffer_release(command_buffer);
+  }
+
+  // Fills |length| bytes at |offset| with a |pattern_length| byte pattern and
+  // verifies the contents and surrounding guard bytes.
+  void TestFill(iree_device_size_t offset, iree_device_size_t length,
+                iree_host_size_t pattern_length) {
+    const uint8_t pattern[4] = {0x01, 0x23, 0x45, 0x67};
+    iree_hal_buffer_t* buffer = AllocateBuffer(offset + length + kGuardLength);
+    RecordSubmitAndWait([&](iree_hal_command_buffer_t* command_buffer) {
+      IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+          command_buffer, buffer, offset, length, pattern, pattern_length));
+    });
+    auto data = ReadBuffer(buffer);
+    for (iree_device_size_t i = 0; i < data.size(); ++i) {
+      uint8_t expected = kGuardValue;
+      if (i >= offset && i < offset + length) {
+        expected = pattern[(i - offset) % pattern_length];
+      }
+      ASSERT_EQ(expected, data[i]) << "offset " << offset << " length "
+                                   << length << " at byte " << i;
+    }
+    iree_hal_buffer_release(buffer);
+  }
+
+  // Copies |length| bytes of a ramp from |source_offset| to |target_offset|
+  // and verifies the contents and surrounding guard bytes.
+  void TestCopy(iree_device_size_t source_offset,
+                iree_device_size_t target_offset, iree_device_size_t length) {
+    iree_hal_buffer_t* source_buffer =
+        AllocateBuffer(source_offset + length + kGuardLength);
+    std::vector<uint8_t> source_data(length);
+    for (iree_device_size_t i = 0; i < length; ++i) {
+      // Not a power of two period so tiles have distinct contents.
+      source_data[i] = static_cast<uint8_t>(i % 251);
+    }
+    IREE_ASSERT_OK(iree_hal_buffer_write_data(
+        source_buffer, source_offset, source_data.data(), length));
+    iree_hal_buffer_t* target_buffer =
+        AllocateBuffer(target_offset + length + kGuardLength);
+    RecordSubmitAndWait([&](iree_hal_command_buffer_t* command_buffer) {
+      IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+          command_buffer, source_buffer, source_offset, target_buffer,
+          target_offset, length));
+    });
+    auto data = ReadBuffer(target_buffer);
+    for (iree_device_size_t i = 0; i < data.size(); ++i) {
+      uint8_t expected = kGuardValue;
+      if (i >= target_offset && i < target_offset + length) {
+        expected = source_data[i - target_offset];
+      }
+      ASSERT_EQ(expected, data[i]) << "length " << length << " at byte " << i;
+    }
+    iree_hal_buffer_release(source_buffer);
+    iree_hal_buffer_release(target_buffer);
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+};
+
+TEST_F(TaskCommandBufferTest, FillBelowTilingThreshold) {
+  TestFill(/*offset=*/3, kTilingMinLength - 1, /*pattern_length=*/1);
+}
+
+TEST_F(TaskCommandBufferTest, FillTiled) {
+  TestFill(/*offset=*/3, kTilingMinLength, /*pattern_length=*/1);
+  TestFill(/*offset=*/7, kTilingMinLength + 3 * kTileLength + 37,
+           /*pattern_length=*/1);
+  TestFill(/*offset=*/2, kTilingMinLength + kTileLength + 6,
+           /*pattern_length=*/2);
+  TestFill(/*offset=*/4, kTilingMinLength + 2 * kTileLength + 12,
+           /*pattern_length=*/4);
+}
+
+TEST_F(TaskCommandBufferTest, FillNonTemporal) {
+  TestFill(/*offset=*/4, kNonTemporalMinLength + kTileLength / 2 + 20,
+           /*pattern_length=*/4);
+  TestFill(/*offset=*/1, kNonTemporalMinLength + 13, /*pattern_length=*/1);
+}
+
+TEST_F(TaskCommandBufferTest, CopyBelowTilingThreshold) {
+  TestCopy(/*source_offset=*/5, /*target_offset=*/11, kTilingMinLength - 1);
+}
+
+TEST_F(TaskCommandBufferTest, CopyTiled) {
+  TestCopy(/*source_offset=*/0, /*target_offset=*/0, kTilingMinLength);
+  TestCopy(/*source_offset=*/5, /*target_offset=*/11,
+           kTilingMinLength + 3 * kTileLength + 37);
+}
+
+TEST_F(TaskCommandBufferTest, CopyNonTemporal) {
+  TestCopy(/*source_offset=*/13, /*target_offset=*/3,
+           kNonTemporalMinLength + kTileLength / 2 + 21);
+}
+
+// Recording transfers must not touch the target buffers; their contents only
+// change once the command buffer executes.
+TEST_F(TaskCommandBufferTest, RecordWithoutSubmit) {
+  constexpr iree_device_size_t kLength = 4096;
+  iree_hal_buffer_t* source_buffer = AllocateBuffer(kLength);
+  iree_hal_buffer_t* target_buffer = AllocateBuffer(kLength);
+  const uint8_t initial_value = 0x11;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_fill(target_buffer, 0, kLength, &initial_value, 1));
+
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_command_buffer_create(
+      device_, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      IREE_HAL_COMMAND_CATEGORY_TRANSFER, IREE_HAL_QUEUE_AFFINITY_ANY,
+      &command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  const uint8_t pattern = 0x22;
+  IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+      command_buffer, target_buffer, 0, kLength / 2, &pattern, 1));
+  std::vector<uint8_t> update_data(kLength / 4, 0x33);
+  IREE_ASSERT_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, update_data.data(), 0, target_buffer, kLength / 2,
+      update_data.size()));
+  IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+      command_buffer, source_buffer, 0, target_buffer, kLength * 3 / 4,
+      kLength / 4));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  auto data = ReadBuffer(target_buffer);
+  for (iree_device_size_t i = 0; i < kLength; ++i) {
+    ASSERT_EQ(initial_value, data[i]) << "at byte " << i;
+  }
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(source_buffer);
+  iree_hal_buffer_release(target_buffer);
+}
+
+// Records more disjoint accesses than are tracked for hazards such that
+// barriers fall back to joining all prior commands. The copy must observe every
+// fill before it and the refills must not start until the copy has read them.
+TEST_F(TaskCommandBufferTest, ManyDisjointAccesses) {
+  constexpr iree_device_size_t kChunkCount = 1024;
+  constexpr iree_device_size_t kChunkLength = 4096;
+  constexpr iree_device_size_t kLength = kChunkCount * kChunkLength;
+  iree_hal_buffer_t* source_buffer = AllocateBuffer(kLength);
+  iree_hal_buffer_t* target_buffer = AllocateBuffer(kLength);
+  auto barrier = [](iree_hal_command_buffer_t* command_buffer) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_STAGE_TRANSFER,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE,
+        /*memory_barrier_count=*/0, /*memory_barriers=*/NULL,
+        /*buffer_barrier_count=*/0, /*buffer_barriers=*/NULL));
+  };
+  RecordSubmitAndWait([&](iree_hal_command_buffer_t* command_buffer) {
+    for (iree_device_size_t i = 0; i < kChunkCount; ++i) {
+      uint8_t value = static_cast<uint8_t>(i * 7);
+      IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+          command_buffer, source_buffer, i * kChunkLength, kChunkLength,
+          &value, 1));
+      if (i % 100 == 99) barrier(command_buffer);
+    }
+    barrier(command_buffer);
+    IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+        command_buffer, source_buffer, 0, target_buffer, 0, kLength));
+    barrier(command_buffer);
+    for (iree_device_size_t i = 0; i < kChunkCount; ++i) {
+      uint8_t value = 0;
+      IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+          command_buffer, source_buffer, i * kChunkLength, kChunkLength,
+          &value, 1));
+    }
+  });
+  auto source_data = ReadBuffer(source_buffer);
+  auto target_data = ReadBuffer(target_buffer);
+  for (iree_device_size_t i = 0; i < kLength; ++i) {
+    ASSERT_EQ(0, source_data[i]) << "at byte " << i;
+    ASSERT_EQ(static_cast<uint8_t>(i / kChunkLength * 7), target_data[i])
+        << "at byte " << i;
+  }
+  iree_hal_buffer_release(source_buffer);
+  iree_hal_buffer_release(target_buffer);
+}
+
+}  // namespace
@@ -6,6 +6,7 @@
 
 #include "iree/hal/local/task_device.h"
 
+#include "iree/base/internal/numa.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/local/arena.h"
 #include "iree/hal/local/event_pool.h"
@@ -39,8 +40,14 @@ typedef struct {
 
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t** loaders;
+  // Executable cache shared by all users of the device or NULL if each cache
+  // created from the device is independent.
+  iree_hal_executable_cache_t* executable_cache;
 
   iree_allocator_t host_allocator;
+  // Allocator for arena blocks and buffers placed on the NUMA node of the
+  // executor, if any. Equal to host_allocator when placement is not possible.
+  iree_allocator_t node_allocator;
   iree_hal_allocator_t* device_allocator;
 
   iree_host_size_t queue_count;
@@ -59,6 +66,25 @@ void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
   out_params->queue_count = 8;
+  out_params->executable_cache_capacity =
+      IREE_HAL_LOCAL_EXECUTABLE_CACHE_DEFAULT_CAPACITY;
+  iree_hal_heap_allocator_cache_params_initialize(&out_params->buffer_cache);
+  out_params->buffer_cache.max_retained_size = 0;
+}
+
+// Returns the allocator used for arena blocks and buffers that are primarily
+// accessed by tasks running on |executor|. If all workers of the executor are
+// on a single NUMA node the memory is placed on that node. Only the system
+// allocator is bound as buffers may outlive the device and we have nowhere to
+// keep the state a wrapper around a custom allocator would need.
+static iree_allocator_t iree_hal_task_device_select_node_allocator(
+    iree_task_executor_t* executor, iree_allocator_t host_allocator) {
+  iree_numa_node_id_t numa_node = iree_task_executor_numa_node(executor);
+  if (numa_node == IREE_NUMA_NODE_ID_ANY || iree_numa_node_count() <= 1 ||
+      host_allocator.alloc != iree_allocator_system_allocate) {
+    return host_allocator;
+  }
+  return iree_numa_allocator_system(numa_node);
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -103,9 +129,12 @@ iree_status_t iree_hal_task_device_create(
         (char*)device + sizeof(*device) +
             params->queue_count * sizeof(*device->queues));
     device->host_allocator = host_allocator;
-    iree_arena_block_pool_initialize(4096, host_allocator,
+    device->node_allocator =
+        iree_hal_task_device_select_node_allocator(executor, host_allocator);
+    iree_arena_block_pool_initialize(4096, device->node_allocator,
                                      &device->small_block_pool);
-    iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
+    iree_arena_block_pool_initialize(params->arena_block_size,
+                                     device->node_allocator,
                                      &device->large_block_pool);
     device->event_pool = NULL;
 
@@ -131,8 +160,9 @@ iree_status_t iree_hal_task_device_create(
   }
 
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(identifier, host_allocator,
-                                            &device->device_allocator);
+    status = iree_hal_allocator_create_heap_with_cache(
+        identifier, &params->buffer_cache, device->node_allocator,
+        &device->device_allocator);
   }
 
   if (iree_status_is_ok(status)) {
@@ -141,6 +171,12 @@ iree_status_t iree_hal_task_device_create(
         &device->event_pool);
   }
 
+  if (iree_status_is_ok(status) && params->executable_cache_capacity > 0) {
+    status = iree_hal_local_executable_cache_create(
+        identifier, params->executable_cache_capacity, loader_count, loaders,
+        host_allocator, &device->executable_cache);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -158,6 +194,7 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
+  iree_hal_executable_cache_release(device->executable_cache);
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -171,6 +208,27 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+iree_status_t iree_hal_task_device_consume_statistics(
+    iree_hal_device_t* base_device,
+    iree_task_dispatch_statistics_t* out_dispatch_statistics,
+    iree_host_size_t worker_capacity,
+    iree_task_worker_statistics_t* out_worker_statistics,
+    iree_host_size_t* out_worker_count) {
+  IREE_ASSERT_ARGUMENT(out_dispatch_statistics);
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  memset(out_dispatch_statistics, 0, sizeof(*out_dispatch_statistics));
+  IREE_RETURN_IF_ERROR(iree_task_executor_consume_worker_statistics(
+      device->executor, worker_capacity, out_worker_statistics,
+      out_worker_count));
+  for (iree_host_size_t i = 0; i < device->queue_count; ++i) {
+    iree_task_dispatch_statistics_t queue_statistics =
+        iree_task_scope_consume_statistics(&device->queues[i].scope);
+    iree_task_dispatch_statistics_merge(&queue_statistics,
+                                        out_dispatch_statistics);
+  }
+  return iree_ok_status();
+}
+
 static iree_string_view_t iree_hal_task_device_id(
     iree_hal_device_t* base_device) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
@@ -223,7 +281,9 @@ static iree_status_t iree_hal_task_device_create_command_buffer(
       device, command_categories, queue_affinity);
   return iree_hal_task_command_buffer_create(
       base_device, &device->queues[queue_index].scope, mode, command_categories,
-      queue_affinity, &device->large_block_pool, out_command_buffer);
+      queue_affinity,
+      iree_task_executor_worker_local_memory_size(device->executor),
+      &device->large_block_pool, out_command_buffer);
 }
 
 static iree_status_t iree_hal_task_device_create_descriptor_set(
@@ -257,8 +317,13 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  if (device->executable_cache) {
+    iree_hal_executable_cache_retain(device->executable_cache);
+    *out_executable_cache = device->executable_cache;
+    return iree_ok_status();
+  }
   return iree_hal_local_executable_cache_create(
-      identifier, device->loader_count, device->loaders,
+      identifier, /*capacity=*/0, device->loader_count, device->loaders,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -276,8 +341,9 @@ static iree_status_t iree_hal_task_device_create_semaphore(
     iree_hal_device_t* base_device, uint64_t initial_value,
     iree_hal_semaphore_t** out_semaphore) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  return iree_hal_task_semaphore_create(device->event_pool, initial_value,
-                                        device->host_allocator, out_semaphore);
+  return iree_hal_task_semaphore_create(device->executor, device->event_pool,
+                                        initial_value, device->host_allocator,
+                                        out_semaphore);
 }
 
 static iree_status_t iree_hal_task_device_queue_submit(
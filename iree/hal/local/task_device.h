@@ -28,6 +28,18 @@ typedef struct {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+
+  // Maximum number of executables retained by the executable cache shared by
+  // all users of the device. Executables prepared with the same contents
+  // through any iree_hal_executable_cache_t created from the device are loaded
+  // only once. 0 disables sharing and each cache loads its own executables.
+  iree_host_size_t executable_cache_capacity;
+
+  // Block cache used by the device allocator for buffer storage. Disabled by
+  // default (max_retained_size = 0); set max_retained_size to retain and reuse
+  // the storage of released transient buffers instead of returning it to the
+  // system allocator.
+  iree_hal_heap_allocator_cache_params_t buffer_cache;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -43,6 +55,22 @@ iree_status_t iree_hal_task_device_create(
     iree_hal_executable_loader_t** loaders, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Returns and resets the dispatch statistics aggregated across all queues of
+// |device| and the per-worker statistics of the executor it schedules onto.
+// |out_worker_statistics| must have storage for at least |worker_capacity|
+// workers and |out_worker_count| will be set to the total number of workers.
+// Returns IREE_STATUS_UNAVAILABLE if the task system was built without
+// IREE_TASK_STATISTICS_ENABLE.
+//
+// Dispatches are only accounted once they have fully completed; query after
+// waiting for the device to idle to get a consistent snapshot.
+iree_status_t iree_hal_task_device_consume_statistics(
+    iree_hal_device_t* device,
+    iree_task_dispatch_statistics_t* out_dispatch_statistics,
+    iree_host_size_t worker_capacity,
+    iree_task_worker_statistics_t* out_worker_statistics,
+    iree_host_size_t* out_worker_count);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
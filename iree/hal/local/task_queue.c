@@ -179,6 +179,10 @@ typedef struct {
   // if we are the last issue pending.
   iree_hal_task_queue_t* queue;
 
+  // The issue of the next submission to the queue, if any, that is waiting on
+  // this issue to complete. Guarded by the queue mutex.
+  iree_task_t* next_issue_task;
+
   // Command buffers to be issued in the order the appeared in the submission.
   iree_host_size_t command_buffer_count;
   iree_hal_command_buffer_t* command_buffers[];
@@ -204,6 +208,21 @@ static iree_status_t iree_hal_task_queue_issue_cmd(
     }
   }
 
+  // Unblock the issue of the next submission (if any) now that ours is done.
+  // If we are the tail then no other submission can chain onto us after this.
+  iree_slim_mutex_lock(&cmd->queue->mutex);
+  iree_task_t* next_issue_task = cmd->next_issue_task;
+  cmd->next_issue_task = NULL;
+  if (cmd->queue->tail_issue_task == task) {
+    cmd->queue->tail_issue_task = NULL;
+  }
+  iree_slim_mutex_unlock(&cmd->queue->mutex);
+  if (next_issue_task &&
+      iree_atomic_fetch_sub_int32(&next_issue_task->pending_dependency_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    iree_task_submission_enqueue(pending_submission, next_issue_task);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -214,12 +233,28 @@ static void iree_hal_task_queue_issue_cmd_cleanup(iree_task_t* task,
                                                   iree_status_t status) {
   iree_hal_task_queue_issue_cmd_t* cmd = (iree_hal_task_queue_issue_cmd_t*)task;
 
-  // Reset queue tail issue task if it was us.
+  // Reset queue tail issue task if it was us. If we were discarded without
+  // executing then the next issue is still waiting on us.
   iree_slim_mutex_lock(&cmd->queue->mutex);
+  iree_task_t* next_issue_task = cmd->next_issue_task;
+  cmd->next_issue_task = NULL;
   if (cmd->queue->tail_issue_task == task) {
     cmd->queue->tail_issue_task = NULL;
   }
   iree_slim_mutex_unlock(&cmd->queue->mutex);
+
+  // Release the dependency the next issue holds on us so that the queue does
+  // not stall. The next issue belongs to another submission and runs (or
+  // fails) on its own. There is no pending submission during cleanup so the
+  // task is posted to the executor and picked up by the next coordination.
+  if (next_issue_task &&
+      iree_atomic_fetch_sub_int32(&next_issue_task->pending_dependency_count, 1,
+                                  iree_memory_order_acq_rel) == 1) {
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, next_issue_task);
+    iree_task_executor_submit(cmd->queue->executor, &submission);
+  }
 }
 
 // Allocates and initializes a iree_hal_task_queue_issue_cmd_t task.
@@ -241,6 +276,7 @@ static iree_status_t iree_hal_task_queue_issue_cmd_allocate(
                            iree_hal_task_queue_issue_cmd_cleanup);
   cmd->arena = arena;
   cmd->queue = queue;
+  cmd->next_issue_task = NULL;
 
   cmd->command_buffer_count = command_buffer_count;
   memcpy(cmd->command_buffers, command_buffers,
@@ -455,29 +491,37 @@ static iree_status_t iree_hal_task_queue_submit_batch(
   iree_task_submission_t submission;
   iree_task_submission_initialize(&submission);
 
+  iree_slim_mutex_lock(&queue->mutex);
+
+  // If there is an in-flight issue pending then we need to chain onto that
+  // so that we ensure FIFO submission order is preserved. Note that we are only
+  // waiting for the issue to complete and *not* all of the commands that are
+  // issued. The issue task already has the retire task as its completion task
+  // so the previous issue holds a dependency on us that it will release (and
+  // enqueue us if we are then ready) when it completes.
+  bool is_issue_chained = false;
+  if (queue->tail_issue_task != NULL) {
+    iree_hal_task_queue_issue_cmd_t* tail_issue_cmd =
+        (iree_hal_task_queue_issue_cmd_t*)queue->tail_issue_task;
+    iree_atomic_fetch_add_int32(
+        &issue_cmd->task.header.pending_dependency_count, 1,
+        iree_memory_order_relaxed);
+    tail_issue_cmd->next_issue_task = &issue_cmd->task.header;
+    is_issue_chained = true;
+  }
+  queue->tail_issue_task = &issue_cmd->task.header;
+
   // Sequencing: wait on semaphores or go directly into the executor queue.
   if (wait_cmd != NULL) {
     // Ensure that we only issue command buffers after all waits have completed.
     iree_task_set_completion_task(&wait_cmd->task.header,
                                   &issue_cmd->task.header);
     iree_task_submission_enqueue(&submission, &wait_cmd->task.header);
-  } else {
+  } else if (!is_issue_chained) {
     // No waits needed; directly enqueue.
     iree_task_submission_enqueue(&submission, &issue_cmd->task.header);
   }
 
-  iree_slim_mutex_lock(&queue->mutex);
-
-  // If there is an in-flight issue pending then we need to chain onto that
-  // so that we ensure FIFO submission order is preserved. Note that we are only
-  // waiting for the issue to complete and *not* all of the commands that are
-  // issued.
-  if (queue->tail_issue_task != NULL) {
-    iree_task_set_completion_task(queue->tail_issue_task,
-                                  &issue_cmd->task.header);
-  }
-  queue->tail_issue_task = &issue_cmd->task.header;
-
   iree_slim_mutex_unlock(&queue->mutex);
 
   // Submit the tasks immediately. The executor may queue them up until we
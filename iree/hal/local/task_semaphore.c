@@ -109,9 +109,10 @@ static void iree_hal_task_timepoint_list_take_ready(
 
 // Notifies all of the timepoints in the |ready_list| that their condition has
 // been satisfied. |ready_list| will be reset as ownership of the events is
-// held by the originator.
-static void iree_hal_task_timepoint_list_notify_ready(
+// held by the originator. Returns true if any timepoints were notified.
+static bool iree_hal_task_timepoint_list_notify_ready(
     iree_hal_task_timepoint_list_t* ready_list) {
+  bool any_notified = ready_list->head != NULL;
   iree_hal_task_timepoint_t* next = ready_list->head;
   while (next != NULL) {
     iree_hal_task_timepoint_t* timepoint = next;
@@ -121,6 +122,7 @@ static void iree_hal_task_timepoint_list_notify_ready(
     iree_event_set(&timepoint->event);
   }
   iree_hal_task_timepoint_list_initialize(ready_list);
+  return any_notified;
 }
 
 //===----------------------------------------------------------------------===//
@@ -130,6 +132,7 @@ static void iree_hal_task_timepoint_list_notify_ready(
 typedef struct {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
+  iree_task_executor_t* executor;
   iree_hal_local_event_pool_t* event_pool;
 
   // Guards all mutable fields. We expect low contention on semaphores and since
@@ -164,8 +167,10 @@ static iree_hal_task_semaphore_t* iree_hal_task_semaphore_cast(
 }
 
 iree_status_t iree_hal_task_semaphore_create(
-    iree_hal_local_event_pool_t* event_pool, uint64_t initial_value,
-    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
+    iree_task_executor_t* executor, iree_hal_local_event_pool_t* event_pool,
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore) {
+  IREE_ASSERT_ARGUMENT(executor);
   IREE_ASSERT_ARGUMENT(event_pool);
   IREE_ASSERT_ARGUMENT(out_semaphore);
   *out_semaphore = NULL;
@@ -178,6 +183,8 @@ iree_status_t iree_hal_task_semaphore_create(
     iree_hal_resource_initialize(&iree_hal_task_semaphore_vtable,
                                  &semaphore->resource);
     semaphore->host_allocator = host_allocator;
+    semaphore->executor = executor;
+    iree_task_executor_retain(semaphore->executor);
     semaphore->event_pool = event_pool;
 
     iree_slim_mutex_initialize(&semaphore->mutex);
@@ -203,6 +210,7 @@ static void iree_hal_task_semaphore_destroy(
   iree_status_free(semaphore->failure_status);
   iree_notification_deinitialize(&semaphore->notification);
   iree_slim_mutex_deinitialize(&semaphore->mutex);
+  iree_task_executor_release(semaphore->executor);
   iree_allocator_free(host_allocator, semaphore);
 
   IREE_TRACE_ZONE_END(z0);
@@ -256,8 +264,11 @@ static iree_status_t iree_hal_task_semaphore_signal(
   iree_notification_post(&semaphore->notification, IREE_ALL_WAITERS);
   iree_slim_mutex_unlock(&semaphore->mutex);
 
-  // Notify all waiters - note that this must happen outside the lock.
-  iree_hal_task_timepoint_list_notify_ready(&ready_list);
+  // Notify all waiters - note that this must happen outside the lock. Any wait
+  // tasks we resolved are scheduled immediately by flushing the executor.
+  if (iree_hal_task_timepoint_list_notify_ready(&ready_list)) {
+    iree_task_executor_flush(semaphore->executor);
+  }
 
   return iree_ok_status();
 }
@@ -292,6 +303,9 @@ static void iree_hal_task_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
   iree_slim_mutex_unlock(&semaphore->mutex);
 
   // Notify all waiters - note that this must happen outside the lock.
+  // Unlike signaling we don't flush the executor here as failures may be
+  // propagated from task cleanup while the executor is coordinating; any wait
+  // tasks resolved will be scheduled on the next flush.
   iree_hal_task_timepoint_list_notify_ready(&ready_list);
 }
 
@@ -11,6 +11,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/local/arena.h"
 #include "iree/hal/local/event_pool.h"
+#include "iree/task/executor.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 
@@ -19,10 +20,14 @@ extern "C" {
 #endif  // __cplusplus
 
 // Creates a semaphore that integrates with the task system to allow for
-// pipelined wait and signal operations.
+// pipelined wait and signal operations. |executor| is flushed whenever a signal
+// resolves a timepoint so that dependent tasks are scheduled without waiting on
+// a worker to notice; with an executor that has no workers this is where they
+// run.
 iree_status_t iree_hal_task_semaphore_create(
-    iree_hal_local_event_pool_t* event_pool, uint64_t initial_value,
-    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore);
+    iree_task_executor_t* executor, iree_hal_local_event_pool_t* event_pool,
+    uint64_t initial_value, iree_allocator_t host_allocator,
+    iree_hal_semaphore_t** out_semaphore);
 
 // Reserves a new timepoint in the timeline for the given minimum payload value.
 // |issue_task| will wait until the timeline semaphore is signaled to at least
@@ -271,6 +271,60 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_allocate,  //
   return iree_ok_status();
 }
 
+// Attempts to wrap the |offset| and |length| range of |source| in a HAL buffer
+// without copying. The storage of the VM buffer is retained for as long as the
+// HAL buffer is live: guest buffers retain themselves and module rodata retains
+// the owning module (keeping its mapped file or decompressed rodata cache
+// alive). Returns success with |out_buffer| set to NULL if the allocator cannot
+// reference the memory directly or the storage lifetime is unknown and the
+// caller must copy instead.
+static iree_status_t iree_hal_module_try_wrap_byte_buffer(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_types,
+    iree_hal_buffer_usage_t buffer_usage, iree_vm_buffer_t* source,
+    iree_host_size_t offset, iree_host_size_t length,
+    iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+
+  // Devices may assume buffers are aligned to at least the natural word size
+  // and empty buffers have no memory to reference.
+  uint8_t* data = source->data.data + offset;
+  if (length == 0 || ((uintptr_t)data % iree_max_align_t) != 0) {
+    return iree_ok_status();
+  }
+
+  iree_hal_buffer_compatibility_t compatibility =
+      iree_hal_allocator_query_buffer_compatibility(
+          allocator, memory_types, buffer_usage, buffer_usage, length);
+  if (!iree_all_bits_set(compatibility,
+                         IREE_HAL_BUFFER_COMPATIBILITY_IMPORTABLE)) {
+    return iree_ok_status();
+  }
+
+  // Immutable VM buffers must not be written through the HAL buffer.
+  iree_hal_memory_access_t allowed_access =
+      iree_all_bits_set(source->access, IREE_VM_BUFFER_ACCESS_MUTABLE)
+          ? IREE_HAL_MEMORY_ACCESS_ALL
+          : IREE_HAL_MEMORY_ACCESS_READ;
+
+  iree_allocator_t data_allocator = iree_allocator_null();
+  if (!iree_vm_buffer_retain_storage(source, &data_allocator)) {
+    return iree_ok_status();
+  }
+  iree_status_t status = iree_hal_allocator_wrap_buffer(
+      allocator, memory_types, allowed_access, buffer_usage,
+      iree_make_byte_span(data, length), data_allocator, out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(data_allocator, data);
+    if (iree_status_is_unavailable(status) ||
+        iree_status_is_unimplemented(status)) {
+      // Allocator does not support wrapping host memory; fall back to a copy.
+      iree_status_ignore(status);
+      return iree_ok_status();
+    }
+  }
+  return status;
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_allocator_wrap_byte_buffer,  //
                    iree_hal_module_state_t,                     //
                    riirii, r) {
@@ -283,8 +337,6 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_wrap_byte_buffer,  //
   iree_vm_size_t offset = (iree_vm_size_t)args->i4;
   iree_vm_size_t length = (iree_vm_size_t)args->i5;
 
-  // TODO(benvanik): wrap when supported.
-
   iree_host_size_t buffer_length = source->data.data_length;
   if (length == -1) {
     length = buffer_length;
@@ -297,7 +349,15 @@ IREE_VM_ABI_EXPORT(iree_hal_module_allocator_wrap_byte_buffer,  //
         (offset + length - 1), buffer_length);
   }
 
+  // Reference the source memory directly when the allocator can access it.
   iree_hal_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_module_try_wrap_byte_buffer(
+      allocator, memory_types, buffer_usage, source, offset, length, &buffer));
+  if (buffer) {
+    rets->r0 = iree_hal_buffer_move_ref(buffer);
+    return iree_ok_status();
+  }
+
   IREE_RETURN_IF_ERROR(
       iree_hal_allocator_allocate_buffer(allocator, memory_types, buffer_usage,
                                          length, &buffer),
@@ -980,6 +1040,15 @@ IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_fail,  //
   return iree_ok_status();
 }
 
+// Resolves a semaphore wait registered on a suspended VM stack.
+static iree_status_t iree_hal_module_semaphore_wait_fn(iree_vm_ref_t* target,
+                                                       uint64_t value,
+                                                       iree_timeout_t timeout) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_semaphore_check_deref(*target, &semaphore));
+  return iree_hal_semaphore_wait(semaphore, value, timeout);
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_await,  //
                    iree_hal_module_state_t,          //
                    ri, i) {
@@ -987,7 +1056,20 @@ IREE_VM_ABI_EXPORT(iree_hal_module_semaphore_await,  //
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_check_deref(args->r0, &semaphore));
   uint64_t new_value = (uint32_t)args->i1;
 
-  // TODO(benvanik): coroutine magic.
+  // When the caller can be suspended we avoid blocking the thread and instead
+  // hand the wait to the invoker; we'll be called again once it resolves.
+  if (iree_vm_stack_is_suspendable(stack)) {
+    uint64_t current_value = 0;
+    iree_status_t status = iree_hal_semaphore_query(semaphore, &current_value);
+    if (iree_status_is_ok(status) && current_value < new_value) {
+      iree_vm_ref_t semaphore_ref = args->r0;
+      return iree_vm_stack_wait(stack, iree_hal_module_semaphore_wait_fn,
+                                &semaphore_ref, new_value);
+    }
+    // Either reached or failed; the wait below returns immediately.
+    iree_status_ignore(status);
+  }
+
   iree_status_t status =
       iree_hal_semaphore_wait(semaphore, new_value, iree_infinite_timeout());
   if (iree_status_is_ok(status)) {
@@ -0,0 +1,314 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/hal/hal_module.h"
+
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/local/task_device.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace {
+
+using ::iree::Status;
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
+constexpr iree_host_size_t kLength = 256;
+
+class HALModuleTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_module_register_types());
+
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/1,
+                                                   &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+        /*worker_local_memory_size=*/0, iree_allocator_system(), &executor_));
+    iree_task_topology_deinitialize(&topology);
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_task_device_create(
+        iree_make_cstring_view("test"), &params, executor_,
+        /*loader_count=*/0, /*loaders=*/NULL, iree_allocator_system(),
+        &device_));
+
+    IREE_ASSERT_OK(
+        iree_vm_instance_create(iree_allocator_system(), &instance_));
+    iree_vm_module_t* hal_module = NULL;
+    IREE_ASSERT_OK(
+        iree_hal_module_create(device_, iree_allocator_system(), &hal_module));
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance_, &hal_module, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(hal_module);
+  }
+
+  void TearDown() override {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+    iree_hal_device_release(device_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_vm_function_t ResolveFunction(const char* full_name) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view(full_name), &function));
+    return function;
+  }
+
+  // Returns the arguments to hal.allocator.wrap.byte_buffer for all of
+  // |source|.
+  iree_vm_list_t* CreateWrapByteBufferInputs(iree_vm_buffer_t* source) {
+    iree_vm_list_t* inputs = NULL;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/NULL, 6,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_ref_t allocator_ref =
+        iree_hal_allocator_retain_ref(iree_hal_device_allocator(device_));
+    IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs, &allocator_ref));
+    iree_vm_value_t memory_types = iree_vm_value_make_i32(
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &memory_types));
+    iree_vm_value_t buffer_usage =
+        iree_vm_value_make_i32(IREE_HAL_BUFFER_USAGE_ALL);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &buffer_usage));
+    iree_vm_ref_t source_ref = iree_vm_buffer_retain_ref(source);
+    IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs, &source_ref));
+    iree_vm_value_t offset = iree_vm_value_make_i32(0);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &offset));
+    iree_vm_value_t length = iree_vm_value_make_i32(-1);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &length));
+    return inputs;
+  }
+
+  // Calls hal.allocator.wrap.byte_buffer on all of |source| and returns the
+  // resulting HAL buffer.
+  iree_hal_buffer_t* WrapByteBuffer(iree_vm_buffer_t* source) {
+    iree_vm_list_t* inputs = CreateWrapByteBufferInputs(source);
+    iree_vm_list_t* outputs = NULL;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/NULL, 1,
+                                      iree_allocator_system(), &outputs));
+
+    IREE_CHECK_OK(iree_vm_invoke(
+        context_, ResolveFunction("hal.allocator.wrap.byte_buffer"),
+        /*policy=*/NULL, inputs, outputs, iree_allocator_system()));
+
+    iree_vm_ref_t buffer_ref = {0};
+    IREE_CHECK_OK(iree_vm_list_get_ref_retain(outputs, 0, &buffer_ref));
+    iree_vm_list_release(outputs);
+    iree_vm_list_release(inputs);
+    return iree_hal_buffer_deref(buffer_ref);
+  }
+
+  // Creates an invocation of hal.semaphore.await on |semaphore| reaching
+  // |value|.
+  iree_vm_invocation_t* CreateSemaphoreAwait(iree_hal_semaphore_t* semaphore,
+                                             int32_t value) {
+    iree_vm_list_t* inputs = NULL;
+    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/NULL, 2,
+                                      iree_allocator_system(), &inputs));
+    iree_vm_ref_t semaphore_ref = iree_hal_semaphore_retain_ref(semaphore);
+    IREE_CHECK_OK(iree_vm_list_push_ref_move(inputs, &semaphore_ref));
+    iree_vm_value_t min_value = iree_vm_value_make_i32(value);
+    IREE_CHECK_OK(iree_vm_list_push_value(inputs, &min_value));
+    iree_vm_invocation_t* invocation = NULL;
+    IREE_CHECK_OK(iree_vm_invocation_create(
+        context_, ResolveFunction("hal.semaphore.await"), /*policy=*/NULL,
+        inputs, iree_allocator_system(), &invocation));
+    iree_vm_list_release(inputs);
+    return invocation;
+  }
+
+  // Returns the host pointer to the contents of |buffer|.
+  const uint8_t* MapBuffer(iree_hal_buffer_t* buffer) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(buffer, IREE_HAL_MEMORY_ACCESS_READ,
+                                            0, IREE_WHOLE_BUFFER, &mapping));
+    const uint8_t* data = mapping.contents.data;
+    iree_hal_buffer_unmap_range(&mapping);
+    return data;
+  }
+
+  void ExpectContents(iree_hal_buffer_t* buffer, uint8_t seed) {
+    ASSERT_EQ(kLength, iree_hal_buffer_byte_length(buffer));
+    uint8_t data[kLength];
+    IREE_ASSERT_OK(iree_hal_buffer_read_data(buffer, 0, data, kLength));
+    for (iree_host_size_t i = 0; i < kLength; ++i) {
+      ASSERT_EQ(static_cast<uint8_t>(seed + i), data[i]) << "at byte " << i;
+    }
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_vm_instance_t* instance_ = NULL;
+  iree_vm_context_t* context_ = NULL;
+};
+
+// Module constants without a known owning module cannot be kept live so the
+// returned buffer must be a copy that holds no reference to them.
+TEST_F(HALModuleTest, ReturnedConstantIsCopied) {
+  alignas(iree_max_align_t) uint8_t rodata[kLength];
+  for (iree_host_size_t i = 0; i < kLength; ++i) rodata[i] = (uint8_t)(7 + i);
+  iree_vm_buffer_t constant;
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                            iree_make_byte_span(rodata, kLength),
+                            iree_allocator_null(), &constant);
+
+  iree_hal_buffer_t* buffer = WrapByteBuffer(&constant);
+  EXPECT_NE(rodata, MapBuffer(buffer));
+  ExpectContents(buffer, 7);
+
+  // Aborts if the HAL buffer still references the constant.
+  iree_vm_buffer_deinitialize(&constant);
+  iree_hal_buffer_release(buffer);
+}
+
+// vm.const.ref.rodata buffers reference storage owned by their module and are
+// wrapped without copying; the HAL buffer retains the module to keep the
+// storage live.
+TEST_F(HALModuleTest, RodataConstantIsAliased) {
+  alignas(iree_max_align_t) uint8_t rodata[kLength];
+  for (iree_host_size_t i = 0; i < kLength; ++i) rodata[i] = (uint8_t)(9 + i);
+  iree_vm_module_t* owner = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_module_create(device_, iree_allocator_system(), &owner));
+  iree_vm_buffer_t constant;
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                            iree_make_byte_span(rodata, kLength),
+                            iree_vm_buffer_module_data_allocator(owner),
+                            &constant);
+
+  iree_hal_buffer_t* buffer = WrapByteBuffer(&constant);
+  EXPECT_EQ(rodata, MapBuffer(buffer));
+
+  // The HAL buffer references the module and not the constant itself.
+  iree_vm_buffer_deinitialize(&constant);
+  iree_vm_module_release(owner);
+
+  ExpectContents(buffer, 9);
+  iree_hal_buffer_release(buffer);
+}
+
+// Buffers wrapping module constants remain valid after the module state (and
+// with it the rodata storage) has been torn down.
+TEST_F(HALModuleTest, ConstantUsedAfterModuleTeardown) {
+  uint8_t* rodata = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(iree_allocator_system(), kLength,
+                                       (void**)&rodata));
+  for (iree_host_size_t i = 0; i < kLength; ++i) rodata[i] = (uint8_t)(3 + i);
+  iree_vm_buffer_t constant;
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                            iree_make_byte_span(rodata, kLength),
+                            iree_allocator_null(), &constant);
+
+  iree_hal_buffer_t* buffer = WrapByteBuffer(&constant);
+
+  iree_vm_buffer_deinitialize(&constant);
+  std::memset(rodata, 0xCD, kLength);
+  iree_allocator_free(iree_allocator_system(), rodata);
+  iree_vm_context_release(context_);
+  context_ = NULL;
+
+  ExpectContents(buffer, 3);
+  iree_hal_buffer_release(buffer);
+}
+
+// Buffers created by guest code are reference counted and are wrapped without
+// copying; the HAL buffer keeps the storage live.
+TEST_F(HALModuleTest, GuestBufferIsWrapped) {
+  iree_vm_buffer_t* source = NULL;
+  IREE_ASSERT_OK(iree_vm_buffer_create(
+      IREE_VM_BUFFER_ACCESS_MUTABLE | IREE_VM_BUFFER_ACCESS_ORIGIN_GUEST,
+      kLength, iree_allocator_system(), &source));
+  for (iree_host_size_t i = 0; i < kLength; ++i) {
+    source->data.data[i] = (uint8_t)(5 + i);
+  }
+
+  iree_hal_buffer_t* buffer = WrapByteBuffer(source);
+  EXPECT_EQ(source->data.data, MapBuffer(buffer));
+  iree_vm_buffer_release(source);
+
+  ExpectContents(buffer, 5);
+  iree_hal_buffer_release(buffer);
+}
+
+// Invocations own references to their arguments until they complete and must
+// release them even if the call is never issued.
+TEST_F(HALModuleTest, InvocationReleasedBeforeStart) {
+  alignas(iree_max_align_t) uint8_t rodata[kLength] = {0};
+  iree_vm_buffer_t constant;
+  iree_vm_buffer_initialize(IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+                            iree_make_byte_span(rodata, kLength),
+                            iree_allocator_null(), &constant);
+
+  iree_vm_list_t* inputs = CreateWrapByteBufferInputs(&constant);
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, ResolveFunction("hal.allocator.wrap.byte_buffer"),
+      /*policy=*/NULL, inputs, iree_allocator_system(), &invocation));
+  iree_vm_list_release(inputs);
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+
+  // Aborts if the invocation still references the constant.
+  iree_vm_buffer_deinitialize(&constant);
+}
+
+// hal.semaphore.await suspends asynchronous invocations until the semaphore
+// reaches the value instead of blocking the thread.
+TEST_F(HALModuleTest, SemaphoreAwaitSuspendsInvocation) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  iree_vm_invocation_t* invocation = CreateSemaphoreAwait(semaphore, 2);
+
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  EXPECT_THAT(Status(iree_vm_invocation_await(
+                  invocation, iree_time_now() + 1000000 /* 1ms */)),
+              StatusIs(StatusCode::kDeadlineExceeded));
+
+  // Not yet reached so the invocation remains suspended.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1ull));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 2ull));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  const iree_vm_list_t* outputs = iree_vm_invocation_output(invocation);
+  ASSERT_NE(nullptr, outputs);
+  iree_vm_value_t result;
+  IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &result));
+  EXPECT_EQ(0, result.i32);
+
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Aborting a suspended invocation drops the wait and its references.
+TEST_F(HALModuleTest, SemaphoreAwaitAborted) {
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  iree_vm_invocation_t* invocation = CreateSemaphoreAwait(semaphore, 1);
+
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_ASSERT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              IREE_TIME_INFINITE_FUTURE)),
+              StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+
+  IREE_ASSERT_OK(iree_vm_invocation_release(invocation));
+  iree_hal_semaphore_release(semaphore);
+}
+
+}  // namespace
@@ -208,23 +208,25 @@ iree_runtime_session_append_bytecode_module_from_file(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, file_path);
 
-  // TODO(#3909): actually map the memory here. For now we just load the
-  // contents.
-  iree_allocator_t flatbuffer_allocator =
-      iree_runtime_session_host_allocator(session);
-  iree_byte_span_t flatbuffer_data;
+  // Map the file so that only the portions of the module that are used are
+  // read from disk; rodata is verified on first use instead of up front.
+  iree_const_byte_span_t flatbuffer_data;
+  iree_allocator_t flatbuffer_allocator;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_file_read_contents(file_path, flatbuffer_allocator,
-                                  &flatbuffer_data));
+      z0, iree_file_map_contents(file_path,
+                                 iree_runtime_session_host_allocator(session),
+                                 &flatbuffer_data, &flatbuffer_allocator));
 
-  iree_status_t status =
-      iree_runtime_session_append_bytecode_module_from_memory(
-          session,
-          iree_make_const_byte_span(flatbuffer_data.data,
-                                    flatbuffer_data.data_length),
-          flatbuffer_allocator);
-  if (!iree_status_is_ok(status)) {
-    iree_allocator_free(flatbuffer_allocator, flatbuffer_data.data);
+  iree_vm_module_t* module = NULL;
+  iree_status_t status = iree_vm_bytecode_module_create_with_flags(
+      flatbuffer_data, IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION,
+      flatbuffer_allocator, iree_runtime_session_host_allocator(session),
+      &module);
+  if (iree_status_is_ok(status)) {
+    status = iree_runtime_session_append_module(session, module);
+    iree_vm_module_release(module);
+  } else {
+    iree_allocator_free(flatbuffer_allocator, (void*)flatbuffer_data.data);
   }
 
   IREE_TRACE_ZONE_END(z0);
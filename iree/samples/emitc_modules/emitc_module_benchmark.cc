@@ -0,0 +1,234 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Runs the same functions through the C module and the bytecode module
+// compiled from benchmark_module.mlir to compare the two targets.
+
+#include <array>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/logging.h"
+#include "iree/samples/emitc_modules/emitc_benchmark_bytecode_module_c.h"
+#include "iree/samples/emitc_modules/emitc_benchmark_module.h"
+#include "iree/vm/api.h"
+#include "iree/vm/bytecode_module.h"
+
+namespace {
+
+typedef iree_status_t (*create_module_t)(iree_allocator_t allocator,
+                                         iree_vm_module_t** out_module);
+
+// vm.import @native_import_module.add_1(%arg0 : i32) -> i32
+static iree_status_t native_import_module_add_1(
+    iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_native_function_target_t target_fn, void* module,
+    void* module_state, iree_vm_execution_result_t* out_result) {
+  // Add 1 to arg0 and return.
+  int32_t arg0 = *reinterpret_cast<int32_t*>(call->arguments.data);
+  int32_t ret0 = arg0 + 1;
+  *reinterpret_cast<int32_t*>(call->results.data) = ret0;
+  return iree_ok_status();
+}
+
+static const iree_vm_native_export_descriptor_t
+    native_import_module_exports_[] = {
+        {iree_make_cstring_view("add_1"), iree_make_cstring_view("0i_i"), 0,
+         NULL},
+};
+static const iree_vm_native_function_ptr_t native_import_module_funcs_[] = {
+    {(iree_vm_native_function_shim_t)native_import_module_add_1, NULL},
+};
+static_assert(IREE_ARRAYSIZE(native_import_module_funcs_) ==
+                  IREE_ARRAYSIZE(native_import_module_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t
+    native_import_module_descriptor_ = {
+        iree_make_cstring_view("native_import_module"),
+        0,
+        NULL,
+        IREE_ARRAYSIZE(native_import_module_exports_),
+        native_import_module_exports_,
+        IREE_ARRAYSIZE(native_import_module_funcs_),
+        native_import_module_funcs_,
+        0,
+        NULL,
+};
+
+static iree_status_t native_import_module_create(
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, NULL));
+  return iree_vm_native_module_create(
+      &interface, &native_import_module_descriptor_, allocator, out_module);
+}
+
+static iree_status_t bytecode_module_create(iree_allocator_t allocator,
+                                            iree_vm_module_t** out_module) {
+  const auto* module_file_toc =
+      iree_samples_emitc_modules_benchmark_bytecode_module_create();
+  return iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file_toc->data),
+          module_file_toc->size},
+      iree_allocator_null(), allocator, out_module);
+}
+
+// Benchmarks the given exported function of the module created with
+// |create_module|, optionally passing in arguments.
+static iree_status_t RunFunction(benchmark::State& state,
+                                 create_module_t create_module,
+                                 iree_string_view_t function_name,
+                                 std::vector<int32_t> i32_args,
+                                 int result_count, int64_t batch_size = 1) {
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(iree_allocator_system(), &instance));
+
+  iree_vm_module_t* import_module = NULL;
+  IREE_CHECK_OK(
+      native_import_module_create(iree_allocator_system(), &import_module));
+
+  iree_vm_module_t* module = NULL;
+  IREE_CHECK_OK(create_module(iree_allocator_system(), &module));
+
+  std::array<iree_vm_module_t*, 2> modules = {import_module, module};
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, modules.data(), modules.size(), iree_allocator_system(),
+      &context));
+
+  iree_vm_function_t function;
+  IREE_CHECK_OK(
+      iree_vm_context_resolve_function(context, function_name, &function));
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments =
+      iree_make_byte_span(iree_alloca(i32_args.size() * sizeof(int32_t)),
+                          i32_args.size() * sizeof(int32_t));
+  call.results =
+      iree_make_byte_span(iree_alloca(result_count * sizeof(int32_t)),
+                          result_count * sizeof(int32_t));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack, iree_vm_context_state_resolver(context), iree_allocator_system());
+  while (state.KeepRunningBatch(batch_size)) {
+    for (iree_host_size_t i = 0; i < i32_args.size(); ++i) {
+      reinterpret_cast<int32_t*>(call.arguments.data)[i] = i32_args[i];
+    }
+
+    iree_vm_execution_result_t result;
+    IREE_CHECK_OK(module->begin_call(module->self, stack, &call, &result));
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_module_release(import_module);
+  iree_vm_module_release(module);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+
+  return iree_ok_status();
+}
+
+static void BM_EmptyFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, bytecode_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.empty_func"), {},
+      /*result_count=*/0));
+}
+BENCHMARK(BM_EmptyFuncBytecode);
+
+static void BM_EmptyFuncEmitC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, emitc_benchmark_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.empty_func"), {},
+      /*result_count=*/0));
+}
+BENCHMARK(BM_EmptyFuncEmitC);
+
+static void BM_CallInternalFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, bytecode_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.call_internal_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/10));
+}
+BENCHMARK(BM_CallInternalFuncBytecode);
+
+static void BM_CallInternalFuncEmitC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, emitc_benchmark_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.call_internal_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/10));
+}
+BENCHMARK(BM_CallInternalFuncEmitC);
+
+static void BM_CallImportedFuncBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, bytecode_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.call_imported_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/10));
+}
+BENCHMARK(BM_CallImportedFuncBytecode);
+
+static void BM_CallImportedFuncEmitC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, emitc_benchmark_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.call_imported_func"),
+      {100},
+      /*result_count=*/1,
+      /*batch_size=*/10));
+}
+BENCHMARK(BM_CallImportedFuncEmitC);
+
+static void BM_LoopSumBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, bytecode_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.loop_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
+
+static void BM_LoopSumEmitC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, emitc_benchmark_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.loop_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumEmitC)->Arg(100000);
+
+static void BM_GlobalSumBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, bytecode_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.global_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_GlobalSumBytecode)->Arg(100000);
+
+static void BM_GlobalSumEmitC(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, emitc_benchmark_module_create,
+      iree_make_cstring_view("emitc_benchmark_module.global_sum"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_GlobalSumEmitC)->Arg(100000);
+
+}  // namespace
@@ -25,57 +25,238 @@ extern "C" {
 // iree_task_affinity_set_t
 //===----------------------------------------------------------------------===//
 
-typedef uint64_t iree_task_affinity_set_t;
+// Number of bits (workers) in each word of an affinity set.
+#define IREE_TASK_AFFINITY_SET_WORD_BITS 64
+
+// Number of 64-bit words required to hold one bit per possible worker.
+#define IREE_TASK_AFFINITY_SET_WORD_COUNT                                    \
+  ((IREE_TASK_EXECUTOR_MAX_WORKER_COUNT + IREE_TASK_AFFINITY_SET_WORD_BITS - \
+    1) /                                                                     \
+   IREE_TASK_AFFINITY_SET_WORD_BITS)
+
+// A bitset with one bit per worker in an executor.
+// Bit i of the set corresponds to bit (i % 64) of words[i / 64]. With
+// IREE_TASK_EXECUTOR_MAX_WORKER_COUNT <= 64 this is a single uint64_t passed
+// around in registers and all of the loops below fold away.
+typedef struct {
+  uint64_t words[IREE_TASK_AFFINITY_SET_WORD_COUNT];
+} iree_task_affinity_set_t;
+
+// Returns an empty set that allows no workers.
+static inline iree_task_affinity_set_t iree_task_affinity_set_empty(void) {
+  iree_task_affinity_set_t set;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) set.words[i] = 0;
+  return set;
+}
 
 // Allows for only a specific worker to be selected.
 static inline iree_task_affinity_set_t iree_task_affinity_for_worker(
-    uint8_t worker_index) {
-  return 1ull << worker_index;
+    iree_host_size_t worker_index) {
+  iree_task_affinity_set_t set = iree_task_affinity_set_empty();
+  set.words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS] =
+      1ull << (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS);
+  return set;
 }
 
-// Allows for a range of workers to be selected.
+// Allows for a range of workers [worker_start, worker_end) to be selected.
 static inline iree_task_affinity_set_t iree_task_affinity_for_worker_range(
-    uint8_t worker_start, uint8_t worker_end) {
-  return ((1ull << (worker_start - 1)) - 1) ^ ((1ull << worker_end) - 1);
+    iree_host_size_t worker_start, iree_host_size_t worker_end) {
+  iree_task_affinity_set_t set = iree_task_affinity_set_empty();
+  for (iree_host_size_t i = worker_start; i < worker_end; ++i) {
+    set.words[i / IREE_TASK_AFFINITY_SET_WORD_BITS] |=
+        1ull << (i % IREE_TASK_AFFINITY_SET_WORD_BITS);
+  }
+  return set;
 }
 
 // Allows for any worker to be selected.
 static inline iree_task_affinity_set_t iree_task_affinity_for_any_worker(void) {
-  return UINT64_MAX;
+  iree_task_affinity_set_t set;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    set.words[i] = UINT64_MAX;
+  }
+  return set;
+}
+
+// Returns true if no workers are in the set.
+static inline bool iree_task_affinity_set_is_empty(
+    iree_task_affinity_set_t set) {
+  uint64_t any = 0;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    any |= set.words[i];
+  }
+  return any == 0;
+}
+
+// Returns true if |worker_index| is in the set.
+static inline bool iree_task_affinity_set_test(iree_task_affinity_set_t set,
+                                               iree_host_size_t worker_index) {
+  return (set.words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS] >>
+          (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS)) &
+         1;
+}
+
+// Adds |worker_index| to the set.
+static inline void iree_task_affinity_set_insert(
+    iree_task_affinity_set_t* set, iree_host_size_t worker_index) {
+  set->words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS] |=
+      1ull << (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS);
+}
+
+// Removes |worker_index| from the set.
+static inline void iree_task_affinity_set_erase(
+    iree_task_affinity_set_t* set, iree_host_size_t worker_index) {
+  set->words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS] &=
+      ~(1ull << (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS));
+}
+
+// Returns |a| & |b|.
+static inline iree_task_affinity_set_t iree_task_affinity_set_and(
+    iree_task_affinity_set_t a, iree_task_affinity_set_t b) {
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    a.words[i] &= b.words[i];
+  }
+  return a;
+}
+
+// Returns |a| | |b|.
+static inline iree_task_affinity_set_t iree_task_affinity_set_or(
+    iree_task_affinity_set_t a, iree_task_affinity_set_t b) {
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    a.words[i] |= b.words[i];
+  }
+  return a;
 }
 
-#define iree_task_affinity_set_count_trailing_zeros \
-  iree_math_count_trailing_zeros_u64
-#define iree_task_affinity_set_count_ones iree_math_count_ones_u64
-#define iree_task_affinity_set_rotr iree_math_rotr_u64
+// Returns |a| & ~|b|.
+static inline iree_task_affinity_set_t iree_task_affinity_set_and_not(
+    iree_task_affinity_set_t a, iree_task_affinity_set_t b) {
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    a.words[i] &= ~b.words[i];
+  }
+  return a;
+}
+
+// Returns the total number of workers in the set.
+static inline int iree_task_affinity_set_count_ones(
+    iree_task_affinity_set_t set) {
+  int count = 0;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    count += iree_math_count_ones_u64(set.words[i]);
+  }
+  return count;
+}
+
+// Returns the lowest worker index in the set that is >= |start_index| or -1 if
+// there are none.
+static inline int iree_task_affinity_set_find_next(
+    iree_task_affinity_set_t set, iree_host_size_t start_index) {
+  iree_host_size_t word_index = start_index / IREE_TASK_AFFINITY_SET_WORD_BITS;
+  if (word_index >= IREE_TASK_AFFINITY_SET_WORD_COUNT) return -1;
+  uint64_t word =
+      set.words[word_index] &
+      (UINT64_MAX << (start_index % IREE_TASK_AFFINITY_SET_WORD_BITS));
+  while (!word) {
+    if (++word_index >= IREE_TASK_AFFINITY_SET_WORD_COUNT) return -1;
+    word = set.words[word_index];
+  }
+  return (int)(word_index * IREE_TASK_AFFINITY_SET_WORD_BITS) +
+         iree_math_count_trailing_zeros_u64(word);
+}
+
+// Returns the lowest worker index in the set or -1 if the set is empty.
+static inline int iree_task_affinity_set_find_first(
+    iree_task_affinity_set_t set) {
+  return iree_task_affinity_set_find_next(set, 0);
+}
+
+// Returns the lowest worker index in the set that is >= |start_index|,
+// wrapping around to the start of the set if there are none, or -1 if the set
+// is empty. Used to rotate through workers without favoring low indices.
+static inline int iree_task_affinity_set_find_next_wrapping(
+    iree_task_affinity_set_t set, iree_host_size_t start_index) {
+  int index = iree_task_affinity_set_find_next(set, start_index);
+  return index >= 0 ? index : iree_task_affinity_set_find_first(set);
+}
+
+// Iterates |index| (an int) over all worker indices in |set| in order.
+#define IREE_TASK_AFFINITY_SET_FOR_EACH(index, set)                    \
+  for (int index = iree_task_affinity_set_find_first(set); index >= 0; \
+       index = iree_task_affinity_set_find_next(set, index + 1))
 
 //===----------------------------------------------------------------------===//
 // iree_atomic_task_affinity_set_t
 //===----------------------------------------------------------------------===//
 
-typedef iree_atomic_int64_t iree_atomic_task_affinity_set_t;
+// An affinity set with each word updated atomically.
+// Operations are atomic per word only: a load may observe a mix of words from
+// before and after a concurrent update. That's fine for how the executor uses
+// these sets as each worker only ever changes its own bit (which lives in a
+// single word) and all readers treat the values as hints. Single-worker
+// updates (insert/erase) only touch the word holding the worker bit.
+typedef struct {
+  iree_atomic_int64_t words[IREE_TASK_AFFINITY_SET_WORD_COUNT];
+} iree_atomic_task_affinity_set_t;
 
 static inline iree_task_affinity_set_t iree_atomic_task_affinity_set_load(
     iree_atomic_task_affinity_set_t* set, iree_memory_order_t order) {
-  return iree_atomic_load_int64(set, order);
+  iree_task_affinity_set_t value;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    value.words[i] = (uint64_t)iree_atomic_load_int64(&set->words[i], order);
+  }
+  return value;
 }
 
 static inline void iree_atomic_task_affinity_set_store(
     iree_atomic_task_affinity_set_t* set, iree_task_affinity_set_t value,
     iree_memory_order_t order) {
-  iree_atomic_store_int64(set, value, order);
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    iree_atomic_store_int64(&set->words[i], (int64_t)value.words[i], order);
+  }
 }
 
+// Atomically ands |value| into |set| and returns the prior value.
 static inline iree_task_affinity_set_t iree_atomic_task_affinity_set_fetch_and(
     iree_atomic_task_affinity_set_t* set, iree_task_affinity_set_t value,
     iree_memory_order_t order) {
-  return iree_atomic_fetch_and_int64(set, value, order);
+  iree_task_affinity_set_t prior;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    prior.words[i] = (uint64_t)iree_atomic_fetch_and_int64(
+        &set->words[i], (int64_t)value.words[i], order);
+  }
+  return prior;
 }
 
+// Atomically ors |value| into |set| and returns the prior value.
 static inline iree_task_affinity_set_t iree_atomic_task_affinity_set_fetch_or(
     iree_atomic_task_affinity_set_t* set, iree_task_affinity_set_t value,
     iree_memory_order_t order) {
-  return iree_atomic_fetch_or_int64(set, value, order);
+  iree_task_affinity_set_t prior;
+  for (int i = 0; i < IREE_TASK_AFFINITY_SET_WORD_COUNT; ++i) {
+    prior.words[i] = (uint64_t)iree_atomic_fetch_or_int64(
+        &set->words[i], (int64_t)value.words[i], order);
+  }
+  return prior;
+}
+
+// Atomically adds |worker_index| to |set|.
+static inline void iree_atomic_task_affinity_set_insert(
+    iree_atomic_task_affinity_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  iree_atomic_fetch_or_int64(
+      &set->words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS],
+      (int64_t)(1ull << (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS)),
+      order);
+}
+
+// Atomically removes |worker_index| from |set|.
+static inline void iree_atomic_task_affinity_set_erase(
+    iree_atomic_task_affinity_set_t* set, iree_host_size_t worker_index,
+    iree_memory_order_t order) {
+  iree_atomic_fetch_and_int64(
+      &set->words[worker_index / IREE_TASK_AFFINITY_SET_WORD_BITS],
+      (int64_t)~(1ull << (worker_index % IREE_TASK_AFFINITY_SET_WORD_BITS)),
+      order);
 }
 
 #ifdef __cplusplus
@@ -0,0 +1,136 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/affinity_set.h"
+
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace {
+
+// Returns all worker indices in |set| in order.
+static std::vector<int> Enumerate(iree_task_affinity_set_t set) {
+  std::vector<int> indices;
+  IREE_TASK_AFFINITY_SET_FOR_EACH(index, set) { indices.push_back(index); }
+  return indices;
+}
+
+TEST(AffinitySetTest, Empty) {
+  iree_task_affinity_set_t set = iree_task_affinity_set_empty();
+  EXPECT_TRUE(iree_task_affinity_set_is_empty(set));
+  EXPECT_EQ(0, iree_task_affinity_set_count_ones(set));
+  EXPECT_EQ(-1, iree_task_affinity_set_find_first(set));
+  EXPECT_EQ(-1, iree_task_affinity_set_find_next_wrapping(set, 3));
+  EXPECT_TRUE(Enumerate(set).empty());
+}
+
+TEST(AffinitySetTest, AnyWorker) {
+  iree_task_affinity_set_t set = iree_task_affinity_for_any_worker();
+  EXPECT_FALSE(iree_task_affinity_set_is_empty(set));
+  EXPECT_EQ(IREE_TASK_AFFINITY_SET_WORD_COUNT * 64,
+            iree_task_affinity_set_count_ones(set));
+  for (int i = 0; i < IREE_TASK_EXECUTOR_MAX_WORKER_COUNT; ++i) {
+    EXPECT_TRUE(iree_task_affinity_set_test(set, i));
+  }
+}
+
+TEST(AffinitySetTest, ForWorker) {
+  for (int i = 0; i < IREE_TASK_EXECUTOR_MAX_WORKER_COUNT; ++i) {
+    iree_task_affinity_set_t set = iree_task_affinity_for_worker(i);
+    EXPECT_EQ(1, iree_task_affinity_set_count_ones(set));
+    EXPECT_TRUE(iree_task_affinity_set_test(set, i));
+    EXPECT_EQ(i, iree_task_affinity_set_find_first(set));
+  }
+}
+
+TEST(AffinitySetTest, ForWorkerRange) {
+  iree_task_affinity_set_t set = iree_task_affinity_for_worker_range(2, 5);
+  EXPECT_EQ((std::vector<int>{2, 3, 4}), Enumerate(set));
+  if (IREE_TASK_EXECUTOR_MAX_WORKER_COUNT > 64) {
+    // Ranges spanning words.
+    set = iree_task_affinity_for_worker_range(62, 67);
+    EXPECT_EQ((std::vector<int>{62, 63, 64, 65, 66}), Enumerate(set));
+  }
+}
+
+TEST(AffinitySetTest, InsertErase) {
+  const int last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_task_affinity_set_t set = iree_task_affinity_set_empty();
+  iree_task_affinity_set_insert(&set, 0);
+  iree_task_affinity_set_insert(&set, last_index);
+  EXPECT_EQ((std::vector<int>{0, last_index}), Enumerate(set));
+  iree_task_affinity_set_erase(&set, 0);
+  EXPECT_EQ((std::vector<int>{last_index}), Enumerate(set));
+  iree_task_affinity_set_erase(&set, last_index);
+  EXPECT_TRUE(iree_task_affinity_set_is_empty(set));
+}
+
+TEST(AffinitySetTest, BitwiseOps) {
+  const int last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_task_affinity_set_t a = iree_task_affinity_set_empty();
+  iree_task_affinity_set_insert(&a, 1);
+  iree_task_affinity_set_insert(&a, last_index);
+  iree_task_affinity_set_t b = iree_task_affinity_set_empty();
+  iree_task_affinity_set_insert(&b, 2);
+  iree_task_affinity_set_insert(&b, last_index);
+  EXPECT_EQ((std::vector<int>{last_index}),
+            Enumerate(iree_task_affinity_set_and(a, b)));
+  EXPECT_EQ((std::vector<int>{1, 2, last_index}),
+            Enumerate(iree_task_affinity_set_or(a, b)));
+  EXPECT_EQ((std::vector<int>{1}),
+            Enumerate(iree_task_affinity_set_and_not(a, b)));
+}
+
+TEST(AffinitySetTest, FindNextWrapping) {
+  const int last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_task_affinity_set_t set = iree_task_affinity_set_empty();
+  iree_task_affinity_set_insert(&set, 3);
+  iree_task_affinity_set_insert(&set, last_index);
+  EXPECT_EQ(3, iree_task_affinity_set_find_next_wrapping(set, 0));
+  EXPECT_EQ(3, iree_task_affinity_set_find_next_wrapping(set, 3));
+  EXPECT_EQ(last_index, iree_task_affinity_set_find_next_wrapping(set, 4));
+  EXPECT_EQ(3, iree_task_affinity_set_find_next_wrapping(set, last_index + 1));
+  EXPECT_EQ(-1, iree_task_affinity_set_find_next(set, last_index + 1));
+}
+
+TEST(AffinitySetTest, Atomic) {
+  const int last_index = IREE_TASK_EXECUTOR_MAX_WORKER_COUNT - 1;
+  iree_atomic_task_affinity_set_t atomic_set;
+  iree_atomic_task_affinity_set_store(
+      &atomic_set, iree_task_affinity_set_empty(), iree_memory_order_relaxed);
+
+  iree_atomic_task_affinity_set_insert(&atomic_set, 0,
+                                       iree_memory_order_relaxed);
+  iree_atomic_task_affinity_set_insert(&atomic_set, last_index,
+                                       iree_memory_order_relaxed);
+  EXPECT_EQ((std::vector<int>{0, last_index}),
+            Enumerate(iree_atomic_task_affinity_set_load(
+                &atomic_set, iree_memory_order_relaxed)));
+
+  // fetch_and clears the bits not in the value and returns the prior bits.
+  iree_task_affinity_set_t prior = iree_atomic_task_affinity_set_fetch_and(
+      &atomic_set,
+      iree_task_affinity_set_and_not(iree_task_affinity_for_any_worker(),
+                                     iree_task_affinity_for_worker(last_index)),
+      iree_memory_order_relaxed);
+  EXPECT_EQ((std::vector<int>{0, last_index}), Enumerate(prior));
+  EXPECT_EQ((std::vector<int>{0}),
+            Enumerate(iree_atomic_task_affinity_set_load(
+                &atomic_set, iree_memory_order_relaxed)));
+
+  prior = iree_atomic_task_affinity_set_fetch_or(
+      &atomic_set, iree_task_affinity_for_worker(last_index),
+      iree_memory_order_relaxed);
+  EXPECT_EQ((std::vector<int>{0}), Enumerate(prior));
+  iree_atomic_task_affinity_set_erase(&atomic_set, 0,
+                                      iree_memory_order_relaxed);
+  EXPECT_EQ((std::vector<int>{last_index}),
+            Enumerate(iree_atomic_task_affinity_set_load(
+                &atomic_set, iree_memory_order_relaxed)));
+}
+
+}  // namespace
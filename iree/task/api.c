@@ -29,6 +29,31 @@ IREE_FLAG(
     "threads that would otherwise need to perform the syscalls during\n"
     "coordination.");
 
+IREE_FLAG(
+    int32_t, task_worker_local_memory, 64 * 1024,
+    "Specifies the bytes of per-worker local memory allocated for use by\n"
+    "dispatched tiles. Dispatches requiring more local memory than available\n"
+    "will fail.");
+
+IREE_FLAG(
+    int32_t, task_dispatch_tiles_per_reservation, 0,
+    "Number of tiles each worker reserves from a dispatch grid at a time.\n"
+    "Larger values reduce overhead for dispatches with many cheap tiles while\n"
+    "smaller values improve load balance for expensive tiles. 0 uses the\n"
+    "default from iree/task/tuning.h.");
+
+IREE_FLAG(
+    int32_t, task_dispatch_reservation_duration_ns, 0,
+    "When non-zero workers size their dispatch tile reservations from the\n"
+    "observed tile execution time such that each reservation takes roughly\n"
+    "this many nanoseconds. Overrides --task_dispatch_tiles_per_reservation\n"
+    "for dispatches without a per-dispatch hint.");
+
+IREE_FLAG(
+    int32_t, task_max_theft_task_count, 0,
+    "Maximum number of tasks a worker steals from another at a time. 0 uses\n"
+    "the default from iree/task/tuning.h.");
+
 //===----------------------------------------------------------------------===//
 // Topology configuration
 //===----------------------------------------------------------------------===//
@@ -61,6 +86,13 @@ IREE_FLAG(
     "detected and used when --task_topology_group_count=0 and is ignored\n"
     "otherwise.\n");
 
+IREE_FLAG(
+    int32_t, task_topology_numa_node, -1,
+    "Restricts the 'physical_cores' --task_topology_mode to cores on the\n"
+    "given NUMA node. Workers, their local memory, and the memory of HAL\n"
+    "devices using the executor are then all placed on the node. -1 uses all\n"
+    "nodes.");
+
 // TODO(benvanik): add --task_topology_dump to dump out the current machine
 // configuration as seen by the topology utilities.
 
@@ -91,8 +123,22 @@ iree_status_t iree_task_executor_create_from_flags(
     iree_task_topology_initialize_from_group_count(
         FLAG_task_topology_group_count, &topology);
   } else if (strcmp(FLAG_task_topology_mode, "physical_cores") == 0) {
-    iree_task_topology_initialize_from_physical_cores(
-        FLAG_task_topology_max_group_count, &topology);
+    if (FLAG_task_topology_numa_node >= 0) {
+      if ((iree_host_size_t)FLAG_task_topology_numa_node >=
+          iree_numa_node_count()) {
+        status = iree_make_status(
+            IREE_STATUS_OUT_OF_RANGE,
+            "--task_topology_numa_node=%d out of range; %zu node(s) available",
+            FLAG_task_topology_numa_node, iree_numa_node_count());
+      } else {
+        iree_task_topology_initialize_from_numa_node(
+            (iree_numa_node_id_t)FLAG_task_topology_numa_node,
+            FLAG_task_topology_max_group_count, &topology);
+      }
+    } else {
+      iree_task_topology_initialize_from_physical_cores(
+          FLAG_task_topology_max_group_count, &topology);
+    }
   } else if (strcmp(FLAG_task_topology_mode, "unique_l2_cache_groups") == 0) {
     iree_task_topology_initialize_from_unique_l2_cache_groups(
         FLAG_task_topology_max_group_count, &topology);
@@ -104,9 +150,33 @@ iree_status_t iree_task_executor_create_from_flags(
         FLAG_task_topology_mode);
   }
 
+  iree_task_executor_t* executor = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_task_executor_create(
+        scheduling_mode, &topology,
+        (iree_host_size_t)iree_max(0, FLAG_task_worker_local_memory),
+        host_allocator, &executor);
+  }
+
   if (iree_status_is_ok(status)) {
-    status = iree_task_executor_create(scheduling_mode, &topology,
-                                       host_allocator, out_executor);
+    iree_task_executor_tuning_t tuning;
+    iree_task_executor_query_tuning(executor, &tuning);
+    if (FLAG_task_dispatch_tiles_per_reservation > 0) {
+      tuning.max_tiles_per_shard_reservation =
+          (uint32_t)FLAG_task_dispatch_tiles_per_reservation;
+    }
+    tuning.shard_reservation_duration_ns =
+        iree_max(0, FLAG_task_dispatch_reservation_duration_ns);
+    if (FLAG_task_max_theft_task_count > 0) {
+      tuning.max_theft_task_count = (uint32_t)FLAG_task_max_theft_task_count;
+    }
+    status = iree_task_executor_set_tuning(executor, &tuning);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_executor = executor;
+  } else {
+    iree_task_executor_release(executor);
   }
 
   iree_task_topology_deinitialize(&topology);
@@ -0,0 +1,291 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/deque.h"
+
+#include <assert.h>
+
+static_assert((IREE_TASK_DEQUE_CAPACITY & (IREE_TASK_DEQUE_CAPACITY - 1)) == 0,
+              "deque capacity must be a power of two");
+
+#define IREE_TASK_DEQUE_SLOT_MASK ((int64_t)IREE_TASK_DEQUE_CAPACITY - 1)
+
+void iree_task_deque_initialize(iree_task_deque_t* out_deque) {
+  memset(out_deque, 0, sizeof(*out_deque));
+  iree_atomic_store_int64(&out_deque->top, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int64(&out_deque->bottom, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&out_deque->overflow_count, 0,
+                          iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&out_deque->overflow_mutex);
+  iree_task_list_initialize(&out_deque->overflow_list);
+}
+
+void iree_task_deque_deinitialize(iree_task_deque_t* deque) {
+  // Gather up all tasks remaining in the ring. No thieves may be active so we
+  // can walk the ring directly.
+  iree_task_list_t discard_list;
+  iree_task_list_initialize(&discard_list);
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_acquire);
+  for (int64_t i = t; i < b; ++i) {
+    iree_task_t* task = (iree_task_t*)iree_atomic_load_intptr(
+        &deque->slots[i & IREE_TASK_DEQUE_SLOT_MASK],
+        iree_memory_order_relaxed);
+    iree_task_list_push_back(&discard_list, task);
+  }
+  iree_atomic_store_int64(&deque->top, b, iree_memory_order_relaxed);
+
+  iree_slim_mutex_lock(&deque->overflow_mutex);
+  iree_task_list_append(&discard_list, &deque->overflow_list);
+  iree_atomic_store_int32(&deque->overflow_count, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_unlock(&deque->overflow_mutex);
+
+  iree_task_list_discard(&discard_list);
+  iree_slim_mutex_deinitialize(&deque->overflow_mutex);
+}
+
+bool iree_task_deque_is_empty(iree_task_deque_t* deque) {
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_acquire);
+  return b <= t && iree_atomic_load_int32(&deque->overflow_count,
+                                          iree_memory_order_acquire) == 0;
+}
+
+// Moves the first |count| tasks of |list| into |out_prefix|.
+static void iree_task_deque_split_prefix(iree_task_list_t* list,
+                                         iree_host_size_t count,
+                                         iree_task_list_t* out_prefix) {
+  iree_task_list_initialize(out_prefix);
+  if (count == 0 || iree_task_list_is_empty(list)) return;
+  iree_task_t* prefix_tail = list->head;
+  while (--count > 0 && prefix_tail->next_task != NULL) {
+    prefix_tail = prefix_tail->next_task;
+  }
+  out_prefix->head = list->head;
+  out_prefix->tail = prefix_tail;
+  list->head = prefix_tail->next_task;
+  if (list->head == NULL) list->tail = NULL;
+  prefix_tail->next_task = NULL;
+}
+
+// Adds a FIFO |list| to the front of the overflow list such that it is the
+// first overflow processed by the owner.
+static void iree_task_deque_prepend_overflow(iree_task_deque_t* deque,
+                                             iree_task_list_t* list,
+                                             iree_host_size_t count) {
+  iree_slim_mutex_lock(&deque->overflow_mutex);
+  iree_task_list_prepend(&deque->overflow_list, list);
+  iree_atomic_fetch_add_int32(&deque->overflow_count, (int32_t)count,
+                              iree_memory_order_release);
+  iree_slim_mutex_unlock(&deque->overflow_mutex);
+}
+
+void iree_task_deque_push_front(iree_task_deque_t* deque, iree_task_t* task) {
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed);
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  if (IREE_UNLIKELY(b - t >= IREE_TASK_DEQUE_CAPACITY)) {
+    // Ring is full; the task will have to wait until the owner drains it.
+    iree_task_list_t list = {task, task};
+    task->next_task = NULL;
+    iree_task_deque_prepend_overflow(deque, &list, 1);
+    return;
+  }
+  iree_atomic_store_intptr(&deque->slots[b & IREE_TASK_DEQUE_SLOT_MASK],
+                           (intptr_t)task, iree_memory_order_relaxed);
+  iree_atomic_thread_fence(iree_memory_order_release);
+  iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+}
+
+void iree_task_deque_push_lifo_list(iree_task_deque_t* deque,
+                                    iree_task_list_t* list) {
+  if (iree_task_list_is_empty(list)) return;
+
+  // Thieves only ever increase top so the free space we calculate here is a
+  // conservative lower bound.
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed);
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  iree_host_size_t free_count =
+      (iree_host_size_t)(IREE_TASK_DEQUE_CAPACITY - (b - t));
+  iree_host_size_t list_count = iree_task_list_calculate_size(list);
+
+  // The head of the LIFO list is the task the owner gets to last. If there's
+  // not enough room in the ring then those go into the overflow list (which is
+  // processed after the ring) in FIFO order.
+  if (IREE_UNLIKELY(list_count > free_count)) {
+    iree_host_size_t overflow_count = list_count - free_count;
+    iree_task_list_t overflow_list;
+    iree_task_deque_split_prefix(list, overflow_count, &overflow_list);
+    iree_task_list_reverse(&overflow_list);
+    iree_task_deque_prepend_overflow(deque, &overflow_list, overflow_count);
+  }
+
+  // Store all tasks in the ring with the last task processed nearest the top
+  // and then publish them all at once with a single bottom update.
+  iree_task_t* task = list->head;
+  while (task != NULL) {
+    iree_task_t* next_task = task->next_task;
+    iree_atomic_store_intptr(&deque->slots[b & IREE_TASK_DEQUE_SLOT_MASK],
+                             (intptr_t)task, iree_memory_order_relaxed);
+    ++b;
+    task = next_task;
+  }
+  iree_atomic_thread_fence(iree_memory_order_release);
+  iree_atomic_store_int64(&deque->bottom, b, iree_memory_order_relaxed);
+  iree_task_list_initialize(list);
+}
+
+iree_task_t* iree_task_deque_flush_from_lifo_slist(
+    iree_task_deque_t* deque, iree_atomic_task_slist_t* source_slist) {
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (iree_atomic_task_slist_flush(
+          source_slist, IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO,
+          &list.head, &list.tail)) {
+    iree_task_deque_push_lifo_list(deque, &list);
+  }
+  return iree_task_deque_pop_front(deque);
+}
+
+// Takes the bottom-most task from the ring, racing with thieves for it if it
+// is the last one.
+static iree_task_t* iree_task_deque_take_from_ring(iree_task_deque_t* deque) {
+  int64_t b =
+      iree_atomic_load_int64(&deque->bottom, iree_memory_order_relaxed) - 1;
+  iree_atomic_store_int64(&deque->bottom, b, iree_memory_order_relaxed);
+  iree_atomic_thread_fence(iree_memory_order_seq_cst);
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_relaxed);
+  if (t > b) {
+    // Empty; restore bottom.
+    iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+    return NULL;
+  }
+  iree_task_t* task = (iree_task_t*)iree_atomic_load_intptr(
+      &deque->slots[b & IREE_TASK_DEQUE_SLOT_MASK], iree_memory_order_relaxed);
+  if (t == b) {
+    // Last task in the ring: race any thieves for it.
+    if (!iree_atomic_compare_exchange_strong_int64(
+            &deque->top, &t, t + 1, iree_memory_order_seq_cst,
+            iree_memory_order_relaxed)) {
+      task = NULL;  // lost the race
+    }
+    iree_atomic_store_int64(&deque->bottom, b + 1, iree_memory_order_relaxed);
+  }
+  return task;
+}
+
+// Refills the (empty) ring from the front of the overflow list.
+// Returns true if any tasks were moved into the ring.
+static bool iree_task_deque_refill_from_overflow(iree_task_deque_t* deque) {
+  if (iree_atomic_load_int32(&deque->overflow_count,
+                             iree_memory_order_acquire) == 0) {
+    return false;
+  }
+  iree_task_list_t refill_list;
+  iree_slim_mutex_lock(&deque->overflow_mutex);
+  iree_task_deque_split_prefix(&deque->overflow_list, IREE_TASK_DEQUE_CAPACITY,
+                               &refill_list);
+  iree_host_size_t refill_count = iree_task_list_calculate_size(&refill_list);
+  iree_atomic_fetch_sub_int32(&deque->overflow_count, (int32_t)refill_count,
+                              iree_memory_order_release);
+  iree_slim_mutex_unlock(&deque->overflow_mutex);
+  if (refill_count == 0) return false;
+  iree_task_list_reverse(&refill_list);
+  iree_task_deque_push_lifo_list(deque, &refill_list);
+  return true;
+}
+
+iree_task_t* iree_task_deque_pop_front(iree_task_deque_t* deque) {
+  iree_task_t* task = iree_task_deque_take_from_ring(deque);
+  if (IREE_LIKELY(task)) return task;
+  if (!iree_task_deque_refill_from_overflow(deque)) return NULL;
+  return iree_task_deque_take_from_ring(deque);
+}
+
+// Steals the top-most task from the ring of |deque|.
+// Returns NULL if the ring was empty or another thief (or the owner) won.
+static iree_task_t* iree_task_deque_steal_from_ring(iree_task_deque_t* deque) {
+  int64_t t = iree_atomic_load_int64(&deque->top, iree_memory_order_acquire);
+  iree_atomic_thread_fence(iree_memory_order_seq_cst);
+  int64_t b = iree_atomic_load_int64(&deque->bottom, iree_memory_order_acquire);
+  if (t >= b) return NULL;
+  iree_task_t* task = (iree_task_t*)iree_atomic_load_intptr(
+      &deque->slots[t & IREE_TASK_DEQUE_SLOT_MASK], iree_memory_order_relaxed);
+  if (!iree_atomic_compare_exchange_strong_int64(&deque->top, &t, t + 1,
+                                                 iree_memory_order_seq_cst,
+                                                 iree_memory_order_relaxed)) {
+    return NULL;
+  }
+  return task;
+}
+
+// Hands off the stolen |next_task| and the LIFO |stolen_list| to the owner of
+// |target_deque|, preserving whatever task the target would have run next.
+static iree_task_t* iree_task_deque_accept_stolen(
+    iree_task_deque_t* target_deque, iree_task_t* next_task,
+    iree_task_list_t* stolen_list) {
+  // If the target already has tasks we return the one it would have run next
+  // to retain its ordering; the stolen tasks are then processed after it.
+  iree_task_t* existing_task = NULL;
+  if (!iree_task_deque_is_empty(target_deque)) {
+    existing_task = iree_task_deque_pop_front(target_deque);
+  }
+  iree_task_deque_push_lifo_list(target_deque, stolen_list);
+  if (existing_task) {
+    iree_task_deque_push_front(target_deque, next_task);
+    next_task = existing_task;
+  }
+  return next_task;
+}
+
+iree_task_t* iree_task_deque_try_steal(iree_task_deque_t* source_deque,
+                                       iree_task_deque_t* target_deque,
+                                       iree_host_size_t max_tasks) {
+  if (max_tasks == 0) return NULL;
+
+  // Take at most half of the ring (rounding up so that we'll always take the
+  // last task if there's only one).
+  int64_t t =
+      iree_atomic_load_int64(&source_deque->top, iree_memory_order_acquire);
+  int64_t b =
+      iree_atomic_load_int64(&source_deque->bottom, iree_memory_order_acquire);
+  iree_host_size_t steal_count =
+      b > t ? iree_min(max_tasks, (iree_host_size_t)((b - t + 1) / 2)) : 0;
+
+  // Steal one task at a time from the top of the ring. The tasks are stolen in
+  // the reverse of the order the victim would have processed them and form a
+  // LIFO list; the last task stolen is the one we process first.
+  iree_task_list_t stolen_list;
+  iree_task_list_initialize(&stolen_list);
+  iree_task_t* next_task = NULL;
+  for (iree_host_size_t i = 0; i < steal_count; ++i) {
+    iree_task_t* task = iree_task_deque_steal_from_ring(source_deque);
+    if (!task) break;  // empty or lost a race; take what we've got
+    if (next_task) iree_task_list_push_back(&stolen_list, next_task);
+    next_task = task;
+  }
+
+  // If the ring was empty then try the overflow list. This is slow but only
+  // happens when the victim has more work than fits in its ring.
+  if (!next_task && iree_atomic_load_int32(&source_deque->overflow_count,
+                                           iree_memory_order_acquire) > 0) {
+    iree_task_list_t overflow_list;
+    iree_slim_mutex_lock(&source_deque->overflow_mutex);
+    iree_task_list_split(&source_deque->overflow_list, max_tasks,
+                         &overflow_list);
+    iree_host_size_t overflow_count =
+        iree_task_list_calculate_size(&overflow_list);
+    iree_atomic_fetch_sub_int32(&source_deque->overflow_count,
+                                (int32_t)overflow_count,
+                                iree_memory_order_release);
+    iree_slim_mutex_unlock(&source_deque->overflow_mutex);
+    next_task = iree_task_list_pop_front(&overflow_list);
+    iree_task_list_reverse(&overflow_list);
+    iree_task_list_move(&overflow_list, &stolen_list);
+  }
+
+  if (!next_task) return NULL;
+  return iree_task_deque_accept_stolen(target_deque, next_task, &stolen_list);
+}
@@ -0,0 +1,135 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TASK_DEQUE_H_
+#define IREE_TASK_DEQUE_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/task/list.h"
+#include "iree/task/task.h"
+#include "iree/task/tuning.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// A lock-free work-stealing deque based on the Chase-Lev dynamic circular
+// work-stealing deque as formalized for weak memory models in:
+//   "Correct and Efficient Work-Stealing for Weak Memory Models":
+//   https://fzn.fr/readings/ppopp13.pdf
+//
+// The owning worker pushes and pops tasks at the bottom of the deque without
+// any locks or atomic read-modify-write operations in the common case; only
+// when the owner and a thief race for the very last task is a CAS required.
+// Thieves steal from the top of the deque with a single CAS per task.
+//  +--------+ <- slots[top % IREE_TASK_DEQUE_CAPACITY]
+//  |  top   | <- thieves consume here:  task = slots[top++]
+//  |        |
+//  |   ||   |
+//  |   vv   |
+//  | bottom | <- owner pushes here:     slots[bottom++] = task
+//  |        |    owner consumes here:   task = slots[--bottom]
+//  +--------+
+//
+// The owner processes tasks in LIFO order relative to pushes and batches of
+// tasks are pushed in reverse so that the owner walks each batch in FIFO order
+// while thieves take from the opposite end - the tasks the owner would get to
+// last. This matches the behavior of iree_task_queue_t though FIFO order is
+// only preserved within a batch: a batch pushed while the deque is non-empty
+// will be processed by the owner before the tasks that were already present.
+// Dependencies between tasks are always expressed in the task DAG and not by
+// queue order so this only affects cache locality and not correctness.
+//
+// The ring of task pointers is fixed at IREE_TASK_DEQUE_CAPACITY to avoid the
+// need for allocating (and the hazards of reclaiming) growable arrays on the
+// hot path. If a push would exceed the capacity the excess tasks are placed in
+// a mutex-guarded overflow list. The owner refills the ring from the overflow
+// list only once the ring has been drained and thieves will steal from the
+// overflow list only once the ring is empty so the lock is only ever touched
+// when a worker has more work queued than fits in the ring.
+typedef struct {
+  // Index of the next task that thieves will steal. Only ever incremented and
+  // only with a CAS; contended between thieves and the owner (when taking the
+  // last task).
+  iree_atomic_int64_t top;
+
+  // Destructive interference padding between the thief-contended top and the
+  // owner-local bottom.
+  uint8_t _top_padding[iree_hardware_destructive_interference_size -
+                       sizeof(iree_atomic_int64_t)];
+
+  // Index one past the most recently pushed task. Only written by the owner.
+  iree_atomic_int64_t bottom;
+
+  // Total number of tasks in the overflow_list. Allows both the owner and
+  // thieves to skip the overflow_mutex when there is no overflow.
+  iree_atomic_int32_t overflow_count;
+
+  // Guards the overflow_list.
+  iree_slim_mutex_t overflow_mutex;
+
+  // FIFO list of tasks that did not fit in the ring.
+  iree_task_list_t overflow_list IREE_GUARDED_BY(overflow_mutex);
+
+  // Circular buffer of iree_task_t* indexed by [top, bottom) modulo capacity.
+  iree_atomic_intptr_t slots[IREE_TASK_DEQUE_CAPACITY];
+} iree_task_deque_t;
+
+// Initializes a work-stealing task deque in-place.
+void iree_task_deque_initialize(iree_task_deque_t* out_deque);
+
+// Deinitializes a task deque and discards all tasks that remain in it.
+// Must not be called while any other worker may be attempting to steal tasks.
+void iree_task_deque_deinitialize(iree_task_deque_t* deque);
+
+// Returns true if the deque is empty.
+// Note that due to races this may return both false-positives and -negatives.
+bool iree_task_deque_is_empty(iree_task_deque_t* deque);
+
+// Pushes a task to the bottom of the deque such that it is the next task popped
+// by the owner.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_deque_push_front(iree_task_deque_t* deque, iree_task_t* task);
+
+// Pushes a LIFO |list| of tasks to the bottom of the deque such that the owner
+// will pop them in FIFO order (the tail of |list| first). |list| will be reset.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_deque_push_lifo_list(iree_task_deque_t* deque,
+                                    iree_task_list_t* list);
+
+// Flushes the |source_slist| LIFO mailbox into the deque in FIFO order.
+// Returns the next task the owner should process upon success; the task may be
+// pre-existing or from the newly flushed tasks.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_deque_flush_from_lifo_slist(
+    iree_task_deque_t* deque, iree_atomic_task_slist_t* source_slist);
+
+// Pops a task from the bottom of the deque if any are available.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_deque_pop_front(iree_task_deque_t* deque);
+
+// Tries to steal up to |max_tasks| (and at most half) from the top of the
+// |source_deque|. Returns NULL if no tasks are available or the thief lost a
+// race with another thief. If more than one task is stolen the first task in
+// the owner's original processing order is returned and the remaining tasks
+// are pushed to the |target_deque|.
+//
+// Must only be called from the thread owning |target_deque|.
+iree_task_t* iree_task_deque_try_steal(iree_task_deque_t* source_deque,
+                                       iree_task_deque_t* target_deque,
+                                       iree_host_size_t max_tasks);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TASK_DEQUE_H_
@@ -0,0 +1,305 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/task/deque.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+TEST(DequeTest, Lifetime) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, Empty) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_FALSE(iree_task_deque_pop_front(&deque));
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushPop) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_task_t task_a = {0};
+  iree_task_deque_push_front(&deque, &task_a);
+  EXPECT_FALSE(iree_task_deque_is_empty(&deque));
+  iree_task_t task_b = {0};
+  iree_task_deque_push_front(&deque, &task_b);
+
+  EXPECT_EQ(&task_b, iree_task_deque_pop_front(&deque));
+  EXPECT_EQ(&task_a, iree_task_deque_pop_front(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_FALSE(iree_task_deque_pop_front(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, PushLifoListOrdered) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  // LIFO list: c (newest) -> b -> a (oldest); popped in FIFO order.
+  iree_task_t task_a = {0};
+  iree_task_t task_b = {0};
+  iree_task_t task_c = {0};
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  iree_task_list_push_front(&list, &task_a);
+  iree_task_list_push_front(&list, &task_b);
+  iree_task_list_push_front(&list, &task_c);
+  iree_task_deque_push_lifo_list(&deque, &list);
+  EXPECT_TRUE(iree_task_list_is_empty(&list));
+
+  EXPECT_EQ(&task_a, iree_task_deque_pop_front(&deque));
+  EXPECT_EQ(&task_b, iree_task_deque_pop_front(&deque));
+  EXPECT_EQ(&task_c, iree_task_deque_pop_front(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, FlushSlistOrdered) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_t task_a = {0};
+  iree_task_t task_b = {0};
+  iree_task_t task_c = {0};
+  iree_atomic_task_slist_push(&slist, &task_a);
+  iree_atomic_task_slist_push(&slist, &task_b);
+  iree_atomic_task_slist_push(&slist, &task_c);
+
+  EXPECT_EQ(&task_a, iree_task_deque_flush_from_lifo_slist(&deque, &slist));
+  EXPECT_EQ(&task_b, iree_task_deque_pop_front(&deque));
+  EXPECT_EQ(&task_c, iree_task_deque_pop_front(&deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, Overflow) {
+  iree_task_deque_t deque;
+  iree_task_deque_initialize(&deque);
+
+  // Push more tasks than fit in the ring; they must all come back out in
+  // order, spilling through the overflow list.
+  static constexpr int kTaskCount = IREE_TASK_DEQUE_CAPACITY * 2 + 3;
+  std::vector<iree_task_t> tasks(kTaskCount);
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  for (auto& task : tasks) {
+    memset(&task, 0, sizeof(task));
+    iree_task_list_push_front(&list, &task);
+  }
+  iree_task_deque_push_lifo_list(&deque, &list);
+
+  for (int i = 0; i < kTaskCount; ++i) {
+    EXPECT_EQ(&tasks[i], iree_task_deque_pop_front(&deque));
+  }
+  EXPECT_TRUE(iree_task_deque_is_empty(&deque));
+  EXPECT_FALSE(iree_task_deque_pop_front(&deque));
+
+  iree_task_deque_deinitialize(&deque);
+}
+
+TEST(DequeTest, TryStealEmpty) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  EXPECT_FALSE(iree_task_deque_try_steal(&source_deque, &target_deque, 1));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealLast) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t task_a = {0};
+  iree_task_deque_push_front(&source_deque, &task_a);
+
+  EXPECT_EQ(&task_a,
+            iree_task_deque_try_steal(&source_deque, &target_deque, 100));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&source_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealIntoExisting) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t task_a = {0};
+  iree_task_t task_b = {0};
+  iree_task_deque_push_front(&source_deque, &task_b);
+  iree_task_deque_push_front(&source_deque, &task_a);
+
+  iree_task_t task_existing = {0};
+  iree_task_deque_push_front(&target_deque, &task_existing);
+
+  EXPECT_EQ(&task_existing,
+            iree_task_deque_try_steal(&source_deque, &target_deque, 1));
+
+  EXPECT_EQ(&task_a, iree_task_deque_pop_front(&source_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&source_deque));
+
+  EXPECT_EQ(&task_b, iree_task_deque_pop_front(&target_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealHalf) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  iree_task_t task_a = {0};
+  iree_task_t task_b = {0};
+  iree_task_t task_c = {0};
+  iree_task_t task_d = {0};
+  iree_task_deque_push_front(&source_deque, &task_d);
+  iree_task_deque_push_front(&source_deque, &task_c);
+  iree_task_deque_push_front(&source_deque, &task_b);
+  iree_task_deque_push_front(&source_deque, &task_a);
+
+  // Only half of the tasks may be stolen regardless of the max.
+  EXPECT_EQ(&task_c,
+            iree_task_deque_try_steal(&source_deque, &target_deque, 1000));
+  EXPECT_EQ(&task_d, iree_task_deque_pop_front(&target_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  EXPECT_EQ(&task_a, iree_task_deque_pop_front(&source_deque));
+  EXPECT_EQ(&task_b, iree_task_deque_pop_front(&source_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&source_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+TEST(DequeTest, TryStealOverflow) {
+  iree_task_deque_t source_deque;
+  iree_task_deque_initialize(&source_deque);
+  iree_task_deque_t target_deque;
+  iree_task_deque_initialize(&target_deque);
+
+  static constexpr int kTaskCount = IREE_TASK_DEQUE_CAPACITY + 4;
+  std::vector<iree_task_t> tasks(kTaskCount);
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  for (auto& task : tasks) {
+    memset(&task, 0, sizeof(task));
+    iree_task_list_push_front(&list, &task);
+  }
+  iree_task_deque_push_lifo_list(&source_deque, &list);
+
+  // Drain the ring by stealing; thieves must then find the overflow tasks.
+  int stolen_count = 0;
+  while (iree_task_t* task =
+             iree_task_deque_try_steal(&source_deque, &target_deque, 64)) {
+    ++stolen_count;
+    while (iree_task_deque_pop_front(&target_deque)) ++stolen_count;
+  }
+  EXPECT_EQ(kTaskCount, stolen_count);
+  EXPECT_TRUE(iree_task_deque_is_empty(&source_deque));
+  EXPECT_TRUE(iree_task_deque_is_empty(&target_deque));
+
+  iree_task_deque_deinitialize(&source_deque);
+  iree_task_deque_deinitialize(&target_deque);
+}
+
+// Races a single owner popping against several thieves and ensures every task
+// is executed exactly once.
+TEST(DequeTest, ConcurrentSteal) {
+  static constexpr int kThiefCount = 4;
+  static constexpr int kTaskCount = 64 * 1024;
+  static constexpr int kBatchSize = 256;
+
+  std::vector<iree_task_t> tasks(kTaskCount);
+  std::unique_ptr<std::atomic<int>[]> hits(new std::atomic<int>[kTaskCount]);
+  for (int i = 0; i < kTaskCount; ++i) {
+    memset(&tasks[i], 0, sizeof(tasks[i]));
+    hits[i] = 0;
+  }
+  auto consume = [&](iree_task_t* task) { hits[task - tasks.data()]++; };
+
+  std::unique_ptr<iree_task_deque_t> owner_deque(new iree_task_deque_t());
+  iree_task_deque_initialize(owner_deque.get());
+
+  std::atomic<int> consumed_count{0};
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < kThiefCount; ++i) {
+    thieves.emplace_back([&]() {
+      std::unique_ptr<iree_task_deque_t> local_deque(new iree_task_deque_t());
+      iree_task_deque_initialize(local_deque.get());
+      while (consumed_count.load() < kTaskCount) {
+        iree_task_t* task = iree_task_deque_try_steal(
+            owner_deque.get(), local_deque.get(), kBatchSize / 8);
+        while (task) {
+          consume(task);
+          consumed_count++;
+          task = iree_task_deque_pop_front(local_deque.get());
+        }
+      }
+      iree_task_deque_deinitialize(local_deque.get());
+    });
+  }
+
+  for (int i = 0; i < kTaskCount; i += kBatchSize) {
+    iree_task_list_t list;
+    iree_task_list_initialize(&list);
+    for (int j = 0; j < kBatchSize; ++j) {
+      iree_task_list_push_front(&list, &tasks[i + j]);
+    }
+    iree_task_deque_push_lifo_list(owner_deque.get(), &list);
+    for (int j = 0; j < kBatchSize / 2; ++j) {
+      iree_task_t* task = iree_task_deque_pop_front(owner_deque.get());
+      if (!task) break;
+      consume(task);
+      consumed_count++;
+    }
+  }
+  while (iree_task_t* task = iree_task_deque_pop_front(owner_deque.get())) {
+    consume(task);
+    consumed_count++;
+  }
+
+  for (auto& thief : thieves) thief.join();
+  EXPECT_EQ(kTaskCount, consumed_count.load());
+  for (int i = 0; i < kTaskCount; ++i) {
+    EXPECT_EQ(1, hits[i].load());
+  }
+
+  iree_task_deque_deinitialize(owner_deque.get());
+}
+
+}  // namespace
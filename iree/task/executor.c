@@ -11,10 +11,40 @@
 #include "iree/task/task_impl.h"
 
 static void iree_task_executor_destroy(iree_task_executor_t* executor);
+static void iree_task_executor_run_inline(iree_task_executor_t* executor);
+
+void iree_task_executor_tuning_initialize(
+    iree_task_executor_tuning_t* out_tuning) {
+  memset(out_tuning, 0, sizeof(*out_tuning));
+  out_tuning->tiles_per_slice[0] = IREE_TASK_DISPATCH_TILES_PER_SLICE_X;
+  out_tuning->tiles_per_slice[1] = IREE_TASK_DISPATCH_TILES_PER_SLICE_Y;
+  out_tuning->tiles_per_slice[2] = IREE_TASK_DISPATCH_TILES_PER_SLICE_Z;
+  out_tuning->max_tiles_per_shard_reservation =
+      IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+  out_tuning->shard_reservation_duration_ns =
+      IREE_TASK_DISPATCH_SHARD_RESERVATION_DURATION_NS;
+  out_tuning->max_theft_attempts_divisor =
+      IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
+  out_tuning->max_theft_task_count = IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT;
+}
+
+// Publishes the theft parameters from the executor tuning for use by workers
+// when they run out of work.
+static void iree_task_executor_publish_theft_tuning(
+    iree_task_executor_t* executor, iree_host_size_t worker_count) {
+  iree_atomic_store_int32(
+      &executor->max_theft_attempts,
+      (int32_t)(worker_count / executor->tuning.max_theft_attempts_divisor),
+      iree_memory_order_relaxed);
+  iree_atomic_store_int32(&executor->max_theft_task_count,
+                          (int32_t)executor->tuning.max_theft_task_count,
+                          iree_memory_order_relaxed);
+}
 
 iree_status_t iree_task_executor_create(
     iree_task_scheduling_mode_t scheduling_mode,
-    const iree_task_topology_t* topology, iree_allocator_t allocator,
+    const iree_task_topology_t* topology,
+    iree_host_size_t worker_local_memory_size, iree_allocator_t allocator,
     iree_task_executor_t** out_executor) {
   iree_host_size_t worker_count = iree_task_topology_group_count(topology);
   if (worker_count > IREE_TASK_EXECUTOR_MAX_WORKER_COUNT) {
@@ -24,20 +54,25 @@ iree_status_t iree_task_executor_create(
         IREE_TASK_EXECUTOR_MAX_WORKER_COUNT);
   }
 
-  // TODO(benvanik): support a threadless mode where we have one dummy worker
-  // that just holds the lists but is pumped from donate_caller.
-  if (worker_count == 0) {
-    return iree_make_status(
-        IREE_STATUS_UNIMPLEMENTED,
-        "threadless donate-only executor mode not yet implemented");
-  }
-
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(out_executor);
   *out_executor = NULL;
 
-  iree_host_size_t executor_size =
+  // Worker local memory is allocated with the executor and placed after the
+  // workers with each worker's block aligned to a cache line so that workers
+  // never share a line. The extra alignment allows us to align the base. One
+  // additional block is reserved for use by a caller thread donated to the
+  // executor (see iree_task_executor_donate_caller).
+  iree_host_size_t worker_list_size =
       sizeof(iree_task_executor_t) + worker_count * sizeof(iree_task_worker_t);
+  worker_local_memory_size =
+      iree_host_align(worker_local_memory_size,
+                      iree_hardware_destructive_interference_size);
+  iree_host_size_t executor_size = worker_list_size;
+  if (worker_local_memory_size > 0) {
+    executor_size += iree_hardware_destructive_interference_size - 1 +
+                     (worker_count + 1) * worker_local_memory_size;
+  }
 
   iree_task_executor_t* executor = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -48,6 +83,7 @@ iree_status_t iree_task_executor_create(
   executor->scheduling_mode = scheduling_mode;
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_atomic_task_slist_initialize(&executor->incoming_waiting_slist);
+  iree_atomic_task_slist_initialize(&executor->inline_mailbox_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
   iree_slim_mutex_initialize(&executor->wait_mutex);
 
@@ -62,6 +98,11 @@ iree_status_t iree_task_executor_create(
                                   &seed_prng);
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(&seed_prng),
                                   &executor->donation_theft_prng);
+  iree_task_executor_tuning_initialize(&executor->tuning);
+  iree_task_executor_publish_theft_tuning(executor, worker_count);
+  executor->post_cursor = 0;
+  iree_prng_splitmix64_initialize(iree_prng_splitmix64_next(&seed_prng),
+                                  &executor->post_prng);
 
   iree_status_t status = iree_ok_status();
 
@@ -93,25 +134,49 @@ iree_status_t iree_task_executor_create(
 
   // Bring up the workers; the threads will be created here but be suspended
   // (if the platform supports it) awaiting the first tasks getting scheduled.
+  // With no workers the executor runs inline and all tasks execute on threads
+  // that flush the executor or donate themselves to it.
   if (iree_status_is_ok(status)) {
     executor->worker_count = worker_count;
     executor->workers = (iree_task_worker_t*)(executor + 1);
-    iree_task_affinity_set_t worker_idle_mask = 0;
-    iree_task_affinity_set_t worker_live_mask = 0;
-    iree_task_affinity_set_t worker_suspend_mask = 0;
+    executor->worker_local_memory_size = worker_local_memory_size;
+    uint8_t* local_memory_base = NULL;
+    if (worker_local_memory_size > 0) {
+      local_memory_base = (uint8_t*)iree_host_align(
+          (uintptr_t)executor + worker_list_size,
+          iree_hardware_destructive_interference_size);
+      executor->donor_local_memory = iree_make_byte_span(
+          local_memory_base + worker_count * worker_local_memory_size,
+          worker_local_memory_size);
+    }
+    iree_task_affinity_set_t worker_idle_mask = iree_task_affinity_set_empty();
+    iree_task_affinity_set_t worker_live_mask = iree_task_affinity_set_empty();
+    iree_task_affinity_set_t worker_suspend_mask =
+        iree_task_affinity_set_empty();
+    executor->numa_node = iree_task_topology_numa_node(topology);
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
-      iree_task_affinity_set_t worker_bit = iree_task_affinity_for_worker(i);
-      worker_idle_mask |= worker_bit;
-      worker_live_mask |= worker_bit;
+      iree_task_affinity_set_insert(&worker_idle_mask, i);
+      iree_task_affinity_set_insert(&worker_live_mask, i);
       if (executor->scheduling_mode &
           IREE_TASK_SCHEDULING_MODE_DEFER_WORKER_STARTUP) {
-        worker_suspend_mask |= worker_bit;
+        iree_task_affinity_set_insert(&worker_suspend_mask, i);
       }
 
+      iree_byte_span_t local_memory = iree_make_byte_span(NULL, 0);
+      if (worker_local_memory_size > 0) {
+        local_memory = iree_make_byte_span(
+            local_memory_base + i * worker_local_memory_size,
+            worker_local_memory_size);
+      }
+
+      const iree_task_topology_group_t* group =
+          iree_task_topology_get_group(topology, i);
+      iree_task_affinity_set_t numa_sharing_mask =
+          iree_task_topology_calculate_numa_sharing_mask(topology, i);
       iree_task_worker_t* worker = &executor->workers[i];
-      status = iree_task_worker_initialize(
-          executor, i, iree_task_topology_get_group(topology, i), &seed_prng,
-          worker);
+      status = iree_task_worker_initialize(executor, i, group,
+                                           numa_sharing_mask, local_memory,
+                                           &seed_prng, worker);
       if (!iree_status_is_ok(status)) break;
     }
     iree_atomic_task_affinity_set_store(&executor->worker_live_mask,
@@ -157,6 +222,11 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
     iree_task_worker_deinitialize(worker);
   }
 
+  // Inline executors may have tasks that were posted but never run if the
+  // user stopped flushing; like worker mailboxes they are discarded.
+  iree_atomic_task_slist_discard(&executor->inline_mailbox_slist);
+  iree_atomic_task_slist_deinitialize(&executor->inline_mailbox_slist);
+
   iree_wait_set_free(executor->wait_set);
   iree_slim_mutex_deinitialize(&executor->wait_mutex);
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
@@ -181,6 +251,56 @@ void iree_task_executor_release(iree_task_executor_t* executor) {
   }
 }
 
+void iree_task_executor_query_tuning(iree_task_executor_t* executor,
+                                     iree_task_executor_tuning_t* out_tuning) {
+  iree_slim_mutex_lock(&executor->coordinator_mutex);
+  memcpy(out_tuning, &executor->tuning, sizeof(*out_tuning));
+  iree_slim_mutex_unlock(&executor->coordinator_mutex);
+}
+
+iree_status_t iree_task_executor_set_tuning(
+    iree_task_executor_t* executor, const iree_task_executor_tuning_t* tuning) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(tuning);
+  if (tuning->tiles_per_slice[0] == 0 || tuning->tiles_per_slice[1] == 0 ||
+      tuning->tiles_per_slice[2] == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tiles per slice must be non-zero; have %ux%ux%u",
+                            tuning->tiles_per_slice[0],
+                            tuning->tiles_per_slice[1],
+                            tuning->tiles_per_slice[2]);
+  } else if (tuning->max_tiles_per_shard_reservation == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tiles per shard reservation must be non-zero");
+  } else if (tuning->shard_reservation_duration_ns < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "shard reservation duration must be >= 0");
+  } else if (tuning->max_theft_attempts_divisor == 0 ||
+             tuning->max_theft_task_count == 0 ||
+             tuning->max_theft_task_count > INT32_MAX) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "theft attempts divisor and task count must be in "
+                            "[1, INT32_MAX]");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&executor->coordinator_mutex);
+  memcpy(&executor->tuning, tuning, sizeof(executor->tuning));
+  iree_task_executor_publish_theft_tuning(executor, executor->worker_count);
+  iree_slim_mutex_unlock(&executor->coordinator_mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_numa_node_id_t iree_task_executor_numa_node(
+    const iree_task_executor_t* executor) {
+  return executor->numa_node;
+}
+
+iree_host_size_t iree_task_executor_worker_local_memory_size(
+    const iree_task_executor_t* executor) {
+  return executor->worker_local_memory_size;
+}
+
 iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence) {
@@ -194,6 +314,33 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
   return iree_ok_status();
 }
 
+iree_status_t iree_task_executor_consume_worker_statistics(
+    iree_task_executor_t* executor, iree_host_size_t worker_capacity,
+    iree_task_worker_statistics_t* out_worker_statistics,
+    iree_host_size_t* out_worker_count) {
+  IREE_ASSERT_ARGUMENT(executor);
+  IREE_ASSERT_ARGUMENT(out_worker_count);
+  *out_worker_count = executor->worker_count;
+#if IREE_TASK_STATISTICS_ENABLE
+  if (worker_capacity < executor->worker_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "worker statistics capacity %zu insufficient for "
+                            "%zu workers",
+                            worker_capacity, executor->worker_count);
+  }
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_task_worker_consume_statistics(&executor->workers[i],
+                                        &out_worker_statistics[i]);
+  }
+  return iree_ok_status();
+#else
+  return iree_make_status(
+      IREE_STATUS_UNAVAILABLE,
+      "task system statistics disabled; build with "
+      "IREE_TASK_STATISTICS_ENABLE=1");
+#endif  // IREE_TASK_STATISTICS_ENABLE
+}
+
 // Schedules a generic task to a worker matching its affinity.
 // The task will be posted to the worker mailbox and available for the worker to
 // begin processing as soon as the |post_batch| is submitted.
@@ -267,13 +414,13 @@ void iree_task_executor_schedule_ready_tasks(
                                     pending_submission);
         } else {
           if (task->flags & IREE_TASK_FLAG_DISPATCH_SLICED) {
-            iree_task_dispatch_issue_sliced((iree_task_dispatch_t*)task,
-                                            &executor->dispatch_task_pool,
-                                            pending_submission, post_batch);
+            iree_task_dispatch_issue_sliced(
+                (iree_task_dispatch_t*)task, &executor->tuning,
+                &executor->dispatch_task_pool, pending_submission, post_batch);
           } else {
-            iree_task_dispatch_issue_sharded((iree_task_dispatch_t*)task,
-                                             &executor->dispatch_task_pool,
-                                             pending_submission, post_batch);
+            iree_task_dispatch_issue_sharded(
+                (iree_task_dispatch_t*)task, &executor->tuning,
+                &executor->dispatch_task_pool, pending_submission, post_batch);
           }
         }
         break;
@@ -321,6 +468,11 @@ void iree_task_executor_flush(iree_task_executor_t* executor) {
   iree_task_executor_coordinate(executor, /*current_worker=*/NULL,
                                 /*wait_on_idle=*/false);
 
+  // Without workers there's no one else to run the tasks; do it now.
+  if (executor->worker_count == 0) {
+    iree_task_executor_run_inline(executor);
+  }
+
   IREE_TRACE_ZONE_END(z0);
 }
 
@@ -563,7 +715,8 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
     // a cache miss by making them live here in the stack of the chosen thread.
     iree_task_post_batch_t* post_batch =
         iree_alloca(sizeof(iree_task_post_batch_t) +
-                    executor->worker_count * sizeof(iree_task_list_t));
+                    iree_max(1, executor->worker_count) *
+                        sizeof(iree_task_list_t));
     iree_task_post_batch_initialize(executor, current_worker, post_batch);
 
     // Poll the waiting tasks to see if any have resolved. This dramatically
@@ -618,31 +771,24 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
     uint32_t max_theft_attempts, int rotation_offset,
-    iree_task_queue_t* local_task_queue) {
-  if (!victim_mask) return NULL;
+    iree_task_priority_queue_t* local_task_queue) {
+  if (iree_task_affinity_set_is_empty(victim_mask)) return NULL;
   max_theft_attempts = iree_min(max_theft_attempts,
                                 iree_task_affinity_set_count_ones(victim_mask));
-  victim_mask = iree_task_affinity_set_rotr(victim_mask, rotation_offset);
 
-  int worker_index = rotation_offset;
-  iree_task_affinity_set_t mask =
-      iree_task_affinity_set_rotr(victim_mask, worker_index);
+  int victim_index = rotation_offset % (int)executor->worker_count;
   for (uint32_t i = 0; i < max_theft_attempts; ++i) {
-    // Find the last set bit and skip to it. This avoids the need for doing
-    // a full O(n) scan and instead gets us at O(popcnt) * O(ctz).
+    // Skip to the next set bit at or after the last victim, wrapping around
+    // to the start of the set. This avoids the need for doing a full O(n)
+    // scan and instead gets us at O(popcnt) * O(ctz) even with multi-word
+    // sets.
     //
-    // Example: sharing mask = 0b01010101
-    //          mask_rotation = 3 (randomly selected)
-    //          mask = 0b01010101 rotr 3 = 0b10101010
-    //          for (i = 0; i < 4; ++i)
-    //            offset = ctz(0b10101010) = 1
-    //            mask_rotation += 1 = 4
-    //            mask >>= 1 = 0b01010101
-    //            victim_index = 4 % 64 = 4
-    int offset = iree_task_affinity_set_count_trailing_zeros(mask);
-    int victim_index = (worker_index + offset) % executor->worker_count;
-    worker_index += offset + 1;
-    mask = iree_shr(mask, offset + 1);
+    // Example: victim mask = 0b01010101
+    //          rotation_offset = 3 (randomly selected)
+    //          victim_index = next(mask, 3) = 4, then 6, then 0, then 2
+    victim_index =
+        iree_task_affinity_set_find_next_wrapping(victim_mask, victim_index);
+    iree_task_affinity_set_erase(&victim_mask, victim_index);
     iree_task_worker_t* victim_worker = &executor->workers[victim_index];
 
     // Policy: steal a chunk of tasks at the tail of the victim queue.
@@ -653,7 +799,8 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     // lead to a relatively even distribution.
     iree_task_t* task = iree_task_worker_try_steal_task(
         victim_worker, local_task_queue,
-        /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
+        /*max_tasks=*/(iree_host_size_t)iree_atomic_load_int32(
+            &executor->max_theft_task_count, iree_memory_order_relaxed));
     if (task) return task;
   }
 
@@ -668,7 +815,10 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 // We do a scan through ideal victims indicated by the
 // |constructive_sharing_mask|; these are the workers most likely to have some
 // cache benefits to taking their work as they share some level of the cache
-// hierarchy and should be better to steal from than any random worker.
+// hierarchy and should be better to steal from than any random worker. Next
+// are the remaining workers on the same NUMA node per |numa_sharing_mask| as
+// their tasks likely operate on memory local to our node, and only then do we
+// reach across nodes.
 //
 // To prevent biasing any particular victim we use a fast prng function to
 // select where in the set of potential victims defined by the topology
@@ -678,39 +828,51 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_affinity_set_t numa_sharing_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_priority_queue_t* local_task_queue) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Limit the workers we will steal from to the ones that are currently live
   // and not idle.
-  iree_task_affinity_set_t victim_mask =
+  iree_task_affinity_set_t victim_mask = iree_task_affinity_set_and_not(
       iree_atomic_task_affinity_set_load(&executor->worker_live_mask,
-                                         iree_memory_order_relaxed) &
-      ~iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
-                                          iree_memory_order_relaxed);
+                                         iree_memory_order_relaxed),
+      iree_atomic_task_affinity_set_load(&executor->worker_idle_mask,
+                                         iree_memory_order_relaxed));
 
   // TODO(benvanik): it may be possible to rework this such that we better
   // use the prng; for example, instead of all this rotating stuff we could just
   // generate an 8-bit number (or even split it into two 4-bit numbers) per
   // theft attempt. The current rotation strategy is biased toward the same try
   // ordering vs. what we may really want with an unbiased random selection.
-  int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng) &
-                        (8 * sizeof(iree_task_affinity_set_t) - 1);
+  int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng);
 
   // Try first with the workers we may have some caches shared with. This
   // helps to prevent cache invalidations/availability updates as it's likely
   // that we won't need to go back to main memory (or higher cache tiers) in the
   // event that the thief and victim are running close to each other in time.
   iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
+      executor,
+      iree_task_affinity_set_and(victim_mask, constructive_sharing_mask),
+      max_theft_attempts, rotation_offset, local_task_queue);
   if (task) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
   } else {
+    victim_mask =
+        iree_task_affinity_set_and_not(victim_mask, constructive_sharing_mask);
     task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+        executor, iree_task_affinity_set_and(victim_mask, numa_sharing_mask),
+        max_theft_attempts, rotation_offset, local_task_queue);
+    if (task) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "node-local");
+    }
+  }
+  if (!task) {
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor,
+        iree_task_affinity_set_and_not(victim_mask, numa_sharing_mask),
+        max_theft_attempts, rotation_offset, local_task_queue);
     if (task) {
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
     }
@@ -720,17 +882,245 @@ iree_task_t* iree_task_executor_try_steal_task(
   return task;
 }
 
+// Executes |task| on a donated thread.
+static void iree_task_executor_donate_execute(
+    iree_task_executor_t* executor, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  // Donated threads act as an extra worker with an id past the real ones.
+  iree_status_t status = iree_task_worker_execute_task(
+      task, executor->worker_count, executor->donor_local_memory,
+      pending_submission);
+
+  // TODO(#4026): propagate failure to task scope.
+  // As with workers we drop the error here as it should have already been
+  // propagated to the scope.
+  IREE_ASSERT_TRUE(iree_status_is_ok(status));
+  iree_status_ignore(status);
+}
+
+// Executes a single task on behalf of the executor from a donated thread.
+// Tasks are taken from |local_task_queue| (filled by prior thefts) and
+// otherwise stolen from any live worker. Returns false if there were no tasks
+// available.
+static bool iree_task_executor_donate_pump_once(
+    iree_task_executor_t* executor,
+    iree_task_priority_queue_t* local_task_queue,
+    iree_task_submission_t* pending_submission) {
+  iree_task_t* task = iree_task_priority_queue_pop_front(local_task_queue);
+  if (!task) {
+    // Unlike workers we also steal from idle workers: those are likely the
+    // ones that were just posted work and have yet to wake, and taking their
+    // tasks is precisely what avoids waiting on the wake.
+    iree_task_affinity_set_t victim_mask = iree_atomic_task_affinity_set_load(
+        &executor->worker_live_mask, iree_memory_order_relaxed);
+    int rotation_offset =
+        iree_prng_minilcg128_next_uint8(&executor->donation_theft_prng);
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor, victim_mask, (uint32_t)executor->worker_count,
+        rotation_offset, local_task_queue);
+  }
+  if (!task) return false;
+  iree_task_executor_donate_execute(executor, task, pending_submission);
+  return true;
+}
+
+// Hands any tasks readied by donated execution to the executor and schedules
+// them (and anything else that has been submitted) to workers.
+static void iree_task_executor_donate_flush(
+    iree_task_executor_t* executor,
+    iree_task_submission_t* pending_submission) {
+  if (!iree_task_submission_is_empty(pending_submission)) {
+    iree_task_executor_merge_submission(executor, pending_submission);
+  }
+  iree_task_executor_coordinate(executor, /*current_worker=*/NULL,
+                                /*wait_on_idle=*/false);
+}
+
+void iree_task_executor_post_inline_tasks(iree_task_executor_t* executor,
+                                          iree_task_list_t* list) {
+  // Move the list into the mailbox. Note that the mailbox is LIFO and this list
+  // is concatenated with its current order preserved (which should be LIFO).
+  iree_atomic_task_slist_concat(&executor->inline_mailbox_slist, list->head,
+                                list->tail);
+  memset(list, 0, sizeof(*list));
+  iree_atomic_store_int32(&executor->inline_pending, 1,
+                          iree_memory_order_seq_cst);
+}
+
+// Executes all tasks posted to an executor with no workers on the calling
+// thread until no more are ready. Tasks blocked on waits remain pending until
+// a later flush or donation observes the wait resolving.
+//
+// If another thread is already running tasks then this returns immediately;
+// that thread will pick up anything we posted before it stops.
+static void iree_task_executor_run_inline(iree_task_executor_t* executor) {
+  while (iree_atomic_load_int32(&executor->inline_pending,
+                                iree_memory_order_seq_cst)) {
+    if (iree_atomic_exchange_int32(&executor->donor_active, 1,
+                                   iree_memory_order_seq_cst) != 0) {
+      return;
+    }
+    IREE_TRACE_ZONE_BEGIN(z0);
+
+    iree_task_priority_queue_t local_task_queue;
+    iree_task_priority_queue_initialize(&local_task_queue);
+    iree_task_submission_t pending_submission;
+    iree_task_submission_initialize(&pending_submission);
+    // The pending flag is always cleared prior to checking the mailbox: a
+    // post that lands after the check sets it again and causes another pass.
+    iree_atomic_store_int32(&executor->inline_pending, 0,
+                            iree_memory_order_seq_cst);
+    while (true) {
+      iree_task_t* task = iree_task_priority_queue_flush_from_lifo_slist(
+          &local_task_queue, &executor->inline_mailbox_slist);
+      if (!task) {
+        // Out of tasks; coordinate in case the tasks we ran resolved any
+        // waits and try once more before giving up.
+        iree_atomic_store_int32(&executor->inline_pending, 0,
+                                iree_memory_order_seq_cst);
+        iree_task_executor_donate_flush(executor, &pending_submission);
+        task = iree_task_priority_queue_flush_from_lifo_slist(
+            &local_task_queue, &executor->inline_mailbox_slist);
+        if (!task) break;
+      }
+      iree_task_executor_donate_execute(executor, task, &pending_submission);
+
+      // Schedule any newly-readied tasks; they'll be posted back to our
+      // mailbox.
+      if (!iree_task_submission_is_empty(&pending_submission)) {
+        iree_task_executor_donate_flush(executor, &pending_submission);
+      }
+    }
+    iree_task_priority_queue_deinitialize(&local_task_queue);
+
+    iree_atomic_store_int32(&executor->donor_active, 0,
+                            iree_memory_order_seq_cst);
+    IREE_TRACE_ZONE_END(z0);
+  }
+}
+
+// Blocks the caller until either |wait_handle| or one of the wait tasks
+// pending in an executor with no workers resolves.
+static iree_status_t iree_task_executor_wait_inline(
+    iree_task_executor_t* executor, iree_wait_handle_t* wait_handle,
+    iree_time_t deadline_ns) {
+  // If another thread is already waiting on the wait tasks it will flush the
+  // executor when one resolves and we only need to wait on our own handle.
+  if (!iree_slim_mutex_try_lock(&executor->wait_mutex)) {
+    return iree_wait_one(wait_handle, deadline_ns);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_wait_set_insert(executor->wait_set, *wait_handle);
+  if (iree_status_is_ok(status)) {
+    iree_wait_handle_t wake_handle;
+    status = iree_wait_any(executor->wait_set, deadline_ns, &wake_handle);
+    iree_wait_set_erase(executor->wait_set, *wait_handle);
+  }
+  iree_slim_mutex_unlock(&executor->wait_mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Donates the caller to an executor with no workers: runs all ready tasks and
+// then waits for either |wait_handle| or a wait task to resolve, repeating
+// until |wait_handle| resolves. Ready tasks are always run to completion even
+// if |wait_handle| resolves in the meantime as there are no workers that would
+// otherwise pick them up.
+static iree_status_t iree_task_executor_donate_caller_inline(
+    iree_task_executor_t* executor, iree_wait_handle_t* wait_handle,
+    iree_time_t deadline_ns) {
+  while (true) {
+    iree_task_executor_flush(executor);
+    iree_status_t status = iree_wait_one(wait_handle, IREE_TIME_INFINITE_PAST);
+    if (!iree_status_is_deadline_exceeded(status)) return status;
+    iree_status_ignore(status);
+    IREE_RETURN_IF_ERROR(
+        iree_task_executor_wait_inline(executor, wait_handle, deadline_ns));
+  }
+}
+
 iree_status_t iree_task_executor_donate_caller(iree_task_executor_t* executor,
                                                iree_wait_handle_t* wait_handle,
                                                iree_time_t deadline_ns) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (executor->worker_count == 0) {
+    iree_status_t status = iree_task_executor_donate_caller_inline(
+        executor, wait_handle, deadline_ns);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   // Perform an immediate flush/coordination (in case the caller queued).
   iree_task_executor_flush(executor);
 
-  // Wait until completed.
-  // TODO(benvanik): make this steal tasks until wait_handle resolves.
-  iree_status_t status = iree_wait_one(wait_handle, deadline_ns);
+  // Only one caller may execute tasks at a time; others wait as if they had
+  // not donated.
+  if (iree_atomic_exchange_int32(&executor->donor_active, 1,
+                                 iree_memory_order_acquire) != 0) {
+    iree_status_t status = iree_wait_one(wait_handle, deadline_ns);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Steal and execute tasks until the wait handle resolves. The handle is
+  // polled between tasks so that we return as soon as possible once it has
+  // resolved instead of continuing to process unrelated work.
+  iree_task_priority_queue_t local_task_queue;
+  iree_task_priority_queue_initialize(&local_task_queue);
+  iree_task_submission_t pending_submission;
+  iree_task_submission_initialize(&pending_submission);
+  iree_status_t status = iree_ok_status();
+  while (true) {
+    status = iree_wait_one(wait_handle, IREE_TIME_INFINITE_PAST);
+    if (!iree_status_is_deadline_exceeded(status)) break;
+    iree_status_ignore(status);
+    if (iree_time_now() >= deadline_ns) {
+      status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+      break;
+    }
+
+    if (iree_task_executor_donate_pump_once(executor, &local_task_queue,
+                                            &pending_submission)) {
+      // Make any newly-readied tasks available immediately so that workers
+      // (or we on the next pass) can begin executing them.
+      if (!iree_task_submission_is_empty(&pending_submission)) {
+        iree_task_executor_donate_flush(executor, &pending_submission);
+      }
+      continue;
+    }
+
+    // Out of tasks; coordinate in case anything has become ready (such as a
+    // resolved wait task) and try once more before giving up.
+    iree_task_executor_donate_flush(executor, &pending_submission);
+    if (iree_task_executor_donate_pump_once(executor, &local_task_queue,
+                                            &pending_submission)) {
+      iree_task_executor_donate_flush(executor, &pending_submission);
+      continue;
+    }
+
+    // Nothing to do; block as if we had not donated. Workers will complete
+    // the remaining work.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
+                                "iree_task_executor_donate_caller_wait");
+    status = iree_wait_one(wait_handle, deadline_ns);
+    IREE_TRACE_ZONE_END(z_wait);
+    break;
+  }
+
+  // Any tasks we stole but did not get to must still execute as they are no
+  // longer visible to the workers.
+  if (!iree_task_priority_queue_is_empty(&local_task_queue)) {
+    iree_task_t* task = NULL;
+    while ((task = iree_task_priority_queue_pop_front(&local_task_queue))) {
+      iree_task_executor_donate_execute(executor, task, &pending_submission);
+    }
+    iree_task_executor_donate_flush(executor, &pending_submission);
+  }
+  iree_task_priority_queue_deinitialize(&local_task_queue);
+
+  iree_atomic_store_int32(&executor->donor_active, 0,
+                          iree_memory_order_release);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -294,15 +294,60 @@ enum iree_task_scheduling_mode_e {
 };
 typedef uint32_t iree_task_scheduling_mode_t;
 
+// Runtime tuning parameters of an executor controlling scheduling
+// granularity. Different workloads want very different granularity: many cheap
+// tiles favor large slices/reservations that amortize scheduling overhead while
+// few expensive tiles favor small ones that let idle workers help finish the
+// dispatch sooner. Defaults come from iree/task/tuning.h.
+typedef struct {
+  // Number of tiles batched into a single slice along each XYZ dimension of
+  // dispatches issued with IREE_TASK_FLAG_DISPATCH_SLICED.
+  uint32_t tiles_per_slice[3];
+
+  // Number of tiles a shard reserves from the dispatch grid at a time.
+  // Dispatches too small to give each worker this many tiles reserve one tile
+  // at a time. Ignored for dispatches with a tiles_per_reservation hint.
+  uint32_t max_tiles_per_shard_reservation;
+
+  // When non-zero shards size their reservations from the observed execution
+  // time of the tiles they have executed so that each reservation takes
+  // roughly this long: cheap tiles are reserved in large batches (reducing
+  // contention on the shared grid) and expensive ones individually (improving
+  // balance). Shards start with a single tile and never reserve more than an
+  // even split of the grid. Adds a clock read per reservation.
+  iree_duration_t shard_reservation_duration_ns;
+
+  // Divides the number of other workers a worker will try to steal from when
+  // it runs out of work; 1 tries all workers.
+  uint32_t max_theft_attempts_divisor;
+
+  // Maximum number of tasks stolen from another worker at a time.
+  uint32_t max_theft_task_count;
+} iree_task_executor_tuning_t;
+
+// Initializes |out_tuning| to the defaults from iree/task/tuning.h.
+void iree_task_executor_tuning_initialize(
+    iree_task_executor_tuning_t* out_tuning);
+
 // Base task system executor interface.
 typedef struct iree_task_executor_s iree_task_executor_t;
 
 // Creates a task executor using the specified topology.
 // |topology| is only used during creation and need not live beyond this call.
+// |worker_local_memory_size| bytes of local memory will be allocated once per
+// worker and provided to each tile executed by the worker; it may be 0 if no
+// dispatches require local memory.
+//
+// If |topology| has no groups then the executor runs inline with no threads of
+// its own: all tasks execute on threads calling iree_task_executor_flush or
+// iree_task_executor_donate_caller, avoiding any thread handoff. This is useful
+// when running many single-threaded runtimes within a process.
+//
 // |out_executor| must be released by the caller.
 iree_status_t iree_task_executor_create(
     iree_task_scheduling_mode_t scheduling_mode,
-    const iree_task_topology_t* topology, iree_allocator_t allocator,
+    const iree_task_topology_t* topology,
+    iree_host_size_t worker_local_memory_size, iree_allocator_t allocator,
     iree_task_executor_t** out_executor);
 
 // Retains the given |executor| for the caller.
@@ -311,6 +356,30 @@ void iree_task_executor_retain(iree_task_executor_t* executor);
 // Releases the given |executor| from the caller.
 void iree_task_executor_release(iree_task_executor_t* executor);
 
+// Returns the current tuning parameters of |executor| in |out_tuning|.
+void iree_task_executor_query_tuning(iree_task_executor_t* executor,
+                                     iree_task_executor_tuning_t* out_tuning);
+
+// Changes the tuning parameters of |executor|. Dispatches issued and thefts
+// attempted after the call use the new parameters while those already issued
+// complete with the ones they started with. Safe to call from any thread.
+// Returns IREE_STATUS_INVALID_ARGUMENT if any parameter is out of range.
+iree_status_t iree_task_executor_set_tuning(
+    iree_task_executor_t* executor, const iree_task_executor_tuning_t* tuning);
+
+// Returns the NUMA node all workers of |executor| are placed on or
+// IREE_NUMA_NODE_ID_ANY if they span nodes or their placement is unknown.
+// Memory used primarily by tasks scheduled on the executor can be placed on
+// the node with iree_numa_bind_memory.
+iree_numa_node_id_t iree_task_executor_numa_node(
+    const iree_task_executor_t* executor);
+
+// Returns the size in bytes of the local memory available to each worker of
+// |executor| when executing dispatch tiles. This may be larger than requested
+// when the executor was created.
+iree_host_size_t iree_task_executor_worker_local_memory_size(
+    const iree_task_executor_t* executor);
+
 // Acquires a fence for the given |scope| from the executor fence pool.
 iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
@@ -341,8 +410,43 @@ void iree_task_executor_submit(iree_task_executor_t* executor,
 //
 // NOTE: due to races it's possible for new work to arrive from other threads
 // after the flush has occurred but prior to this call returning.
+//
+// If the executor has no workers then all ready tasks are executed on the
+// calling thread prior to returning. Tasks waiting on wait handles execute in
+// a later flush or donation after the handles resolve.
 void iree_task_executor_flush(iree_task_executor_t* executor);
 
+// Statistics tracked per worker when IREE_TASK_STATISTICS_ENABLE is set.
+// Comparing busy time across workers shows how evenly work was distributed.
+typedef struct {
+  // Total number of tasks executed by the worker.
+  int64_t task_count;
+  // Number of tasks the worker stole from other workers after running out of
+  // its own work.
+  int64_t steal_count;
+  // Time in nanoseconds the worker spent executing tasks.
+  int64_t busy_time_ns;
+  // Hardware counters sampled on the worker thread while executing tasks.
+  // Only populated when IREE_TASK_STATISTICS_PERF_COUNTERS is set and the
+  // platform supports it.
+  int64_t cycle_count;
+  int64_t instruction_count;
+} iree_task_worker_statistics_t;
+
+// Returns and resets the statistics of each worker in |executor|.
+// |out_worker_statistics| must have storage for at least |worker_capacity|
+// workers and |out_worker_count| will be set to the total number of workers.
+// Returns IREE_STATUS_OUT_OF_RANGE if the capacity is insufficient or
+// IREE_STATUS_UNAVAILABLE if the task system was built without
+// IREE_TASK_STATISTICS_ENABLE.
+//
+// Safe to call from any thread. Statistics of tasks that are executing at the
+// time of the call will be attributed to the next query.
+iree_status_t iree_task_executor_consume_worker_statistics(
+    iree_task_executor_t* executor, iree_host_size_t worker_capacity,
+    iree_task_worker_statistics_t* out_worker_statistics,
+    iree_host_size_t* out_worker_count);
+
 // Donates the calling thread to the executor until either |wait_handle|
 // resolves or |deadline_ns| is exceeded. Flushes any pending task batches prior
 // to doing any work or waiting.
@@ -370,6 +474,10 @@ void iree_task_executor_flush(iree_task_executor_t* executor);
 // Especially in large applications it's almost certainly better to do something
 // useful with the calling thread (even if that's go to sleep).
 //
+// If the executor has no workers then the caller executes all ready tasks and
+// waits on both |wait_handle| and any pending wait tasks until |wait_handle|
+// resolves.
+//
 // Safe to call from any thread (though bad to reentrantly call from workers).
 iree_status_t iree_task_executor_donate_caller(iree_task_executor_t* executor,
                                                iree_wait_handle_t* wait_handle,
@@ -0,0 +1,596 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/base/internal/wait_handle.h"
+#include "iree/task/api.h"
+
+// Measures submit-to-complete latency of a small task graph (a dispatch
+// followed by a call that signals an event) across worker counts and dispatch
+// sizes. BM_SubmitWait flushes and blocks the caller on the event while
+// BM_SubmitDonate hands the caller thread to the executor with
+// iree_task_executor_donate_caller so that it can execute tasks itself instead
+// of waiting for a worker to wake. Small graphs are dominated by the wake
+// latency and benefit the most from donation; a single tile BM_SubmitWait is
+// the submit+wait round trip. With 0 workers the executor runs inline and all
+// tasks execute on the benchmark thread during the flush or donation.
+//
+// BM_FanOut measures throughput and load balance of a fan-out heavy DAG: a root
+// barrier releasing |width| barriers that each release |width| small call
+// tasks. All of the calls are posted to workers by coordinators and so the
+// distribution depends on how post batches select workers. When the task
+// system is built with IREE_TASK_STATISTICS_ENABLE the per-worker statistics
+// are reported as counters: max_share is the largest share of tasks executed by
+// any one worker relative to an even split (1.0 is perfectly balanced) and
+// steal_ratio is the fraction of tasks that had to be stolen.
+//
+// The remaining benchmarks measure the per-task overheads of the individual
+// task types and scheduling behaviors used to tune the executor (dispatch
+// slicing, theft parameters, worker counts). They are additionally
+// parameterized by the topology used to place the workers (see TopologyMode)
+// and report the number of workers actually created as the "workers" counter
+// as physical topologies are clamped to the cores present on the machine.
+
+namespace {
+
+enum TopologyMode {
+  // iree_task_topology_initialize_from_group_count: unpinned workers.
+  kTopologyGroupCount = 0,
+  // iree_task_topology_initialize_from_physical_cores: one pinned worker per
+  // physical core.
+  kTopologyPhysicalCores = 1,
+  // iree_task_topology_initialize_from_unique_l2_cache_groups: one pinned
+  // worker per L2 cache.
+  kTopologyUniqueL2 = 2,
+};
+
+// Burns roughly |iterations| dependent multiply-adds to simulate task cost.
+void SpinWork(uint64_t seed, uint32_t iterations) {
+  uint64_t value = seed;
+  for (uint32_t i = 0; i < iterations; ++i) {
+    value = value * 6364136223846793005ull + 1;
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// Owns an executor with up to |worker_count| workers placed according to
+// |topology_mode| and the scope used to track when all tasks submitted through
+// it have retired.
+class Executor {
+ public:
+  explicit Executor(int worker_count,
+                    int topology_mode = kTopologyGroupCount) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize(&topology);
+    switch (topology_mode) {
+      default:
+      case kTopologyGroupCount:
+        iree_task_topology_initialize_from_group_count(worker_count, &topology);
+        break;
+      case kTopologyPhysicalCores:
+        iree_task_topology_initialize_from_physical_cores(worker_count,
+                                                          &topology);
+        break;
+      case kTopologyUniqueL2:
+        iree_task_topology_initialize_from_unique_l2_cache_groups(
+            worker_count, &topology);
+        break;
+    }
+    worker_count_ = iree_task_topology_group_count(&topology);
+    IREE_CHECK_OK(iree_task_executor_create(
+        IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+        /*worker_local_memory_size=*/0, iree_allocator_system(), &executor_));
+    iree_task_topology_deinitialize(&topology);
+    iree_task_scope_initialize(iree_make_cstring_view("benchmark"), &scope_);
+    IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false, &event_));
+  }
+
+  ~Executor() {
+    iree_event_deinitialize(&event_);
+    iree_task_scope_deinitialize(&scope_);
+    iree_task_executor_release(executor_);
+  }
+
+  iree_task_executor_t* executor() { return executor_; }
+  iree_task_scope_t* scope() { return &scope_; }
+  iree_event_t* event() { return &event_; }
+  iree_host_size_t worker_count() const { return worker_count_; }
+
+  // Submits a dispatch of |tile_count| tiles each costing |tile_cost|
+  // iterations of SpinWork followed by a call that signals event() and a fence
+  // used to know when the task storage can be reused. The caller must wait for
+  // the event and then WaitIdle before submitting again.
+  void Submit(uint32_t tile_count, uint32_t tile_cost = 0) {
+    iree_event_reset(&event_);
+
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_initialize(
+        &scope_,
+        iree_task_make_dispatch_closure(
+            [](uintptr_t user_context,
+               const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              benchmark::DoNotOptimize(tile_context->workgroup_xyz[0]);
+              SpinWork(tile_context->workgroup_xyz[0], (uint32_t)user_context);
+              return iree_ok_status();
+            },
+            (uintptr_t)tile_cost),
+        workgroup_size, workgroup_count, &dispatch_);
+
+    iree_task_call_initialize(
+        &scope_,
+        iree_task_make_call_closure(
+            [](uintptr_t user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              iree_event_set((iree_event_t*)user_context);
+              return iree_ok_status();
+            },
+            (uintptr_t)&event_),
+        &signal_);
+    iree_task_set_completion_task(&dispatch_.header, &signal_.header);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor_, &scope_, &fence));
+    iree_task_set_completion_task(&signal_.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_.header);
+    iree_task_executor_submit(executor_, &submission);
+  }
+
+  // Waits until the fence from the last Submit has retired.
+  void WaitIdle() {
+    IREE_CHECK_OK(
+        iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  }
+
+  // Submits |submission| with |tail_tasks| all completing into a fence and
+  // waits until the fence retires.
+  void SubmitAndWaitIdle(iree_task_submission_t* submission,
+                         iree_task_t* const* tail_tasks,
+                         iree_host_size_t tail_task_count) {
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor_, &scope_, &fence));
+    for (iree_host_size_t i = 0; i < tail_task_count; ++i) {
+      iree_task_set_completion_task(tail_tasks[i], &fence->header);
+    }
+    iree_task_executor_submit(executor_, submission);
+    iree_task_executor_flush(executor_);
+    WaitIdle();
+  }
+
+ private:
+  iree_host_size_t worker_count_ = 0;
+  iree_task_executor_t* executor_ = NULL;
+  iree_task_scope_t scope_;
+  iree_event_t event_;
+  iree_task_dispatch_t dispatch_;
+  iree_task_call_t signal_;
+};
+
+void LatencyArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"tiles", "workers"});
+  for (int64_t tile_count : {1, 16, 256}) {
+    for (int64_t worker_count : {0, 1, 4}) {
+      benchmark->Args({tile_count, worker_count});
+    }
+  }
+}
+
+void BM_SubmitWait(benchmark::State& state) {
+  const uint32_t tile_count = static_cast<uint32_t>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    executor.Submit(tile_count);
+    iree_task_executor_flush(executor.executor());
+    IREE_CHECK_OK(iree_wait_one(executor.event(), IREE_TIME_INFINITE_FUTURE));
+    executor.WaitIdle();
+  }
+  state.SetItemsProcessed(state.iterations() * tile_count);
+}
+BENCHMARK(BM_SubmitWait)->Apply(LatencyArgs)->UseRealTime();
+
+void BM_SubmitDonate(benchmark::State& state) {
+  const uint32_t tile_count = static_cast<uint32_t>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)));
+  for (auto _ : state) {
+    executor.Submit(tile_count);
+    IREE_CHECK_OK(iree_task_executor_donate_caller(
+        executor.executor(), executor.event(), IREE_TIME_INFINITE_FUTURE));
+    executor.WaitIdle();
+  }
+  state.SetItemsProcessed(state.iterations() * tile_count);
+}
+BENCHMARK(BM_SubmitDonate)->Apply(LatencyArgs)->UseRealTime();
+
+// A two-level fan-out DAG of |width|*|width| leaf calls that all complete into
+// a call signaling the executor event.
+class FanOutGraph {
+ public:
+  FanOutGraph(Executor* executor, int width)
+      : executor_(executor),
+        width_(width),
+        branch_barriers_(width),
+        branch_tasks_(width),
+        leaf_calls_(width * width),
+        leaf_tasks_(width * width) {}
+
+  void Submit() {
+    iree_task_scope_t* scope = executor_->scope();
+    iree_event_reset(executor_->event());
+
+    iree_task_call_initialize(
+        scope,
+        iree_task_make_call_closure(
+            [](uintptr_t user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              iree_event_set((iree_event_t*)user_context);
+              return iree_ok_status();
+            },
+            (uintptr_t)executor_->event()),
+        &signal_);
+    for (size_t i = 0; i < leaf_calls_.size(); ++i) {
+      iree_task_call_initialize(
+          scope,
+          iree_task_make_call_closure(
+              [](uintptr_t user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                // A small amount of work so that imbalance shows up in time.
+                SpinWork(user_context, 1024);
+                return iree_ok_status();
+              },
+              i),
+          &leaf_calls_[i]);
+      leaf_tasks_[i] = &leaf_calls_[i].header;
+      iree_task_set_completion_task(&leaf_calls_[i].header, &signal_.header);
+    }
+    for (int i = 0; i < width_; ++i) {
+      iree_task_barrier_initialize(scope, width_, &leaf_tasks_[i * width_],
+                                   &branch_barriers_[i]);
+      branch_tasks_[i] = &branch_barriers_[i].header;
+    }
+    iree_task_barrier_initialize(scope, width_, branch_tasks_.data(), &root_);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(
+        iree_task_executor_acquire_fence(executor_->executor(), scope, &fence));
+    iree_task_set_completion_task(&signal_.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &root_.header);
+    iree_task_executor_submit(executor_->executor(), &submission);
+  }
+
+ private:
+  Executor* executor_;
+  int width_;
+  iree_task_barrier_t root_;
+  std::vector<iree_task_barrier_t> branch_barriers_;
+  std::vector<iree_task_t*> branch_tasks_;
+  std::vector<iree_task_call_t> leaf_calls_;
+  std::vector<iree_task_t*> leaf_tasks_;
+  iree_task_call_t signal_;
+};
+
+// Reports the distribution of tasks across workers since the last call to
+// |state| (if not NULL). Does nothing if the task system was built without
+// statistics.
+void ReportLoadBalance(benchmark::State* state,
+                       iree_task_executor_t* executor) {
+  std::vector<iree_task_worker_statistics_t> statistics(
+      IREE_TASK_EXECUTOR_MAX_WORKER_COUNT);
+  iree_host_size_t worker_count = 0;
+  iree_status_t status = iree_task_executor_consume_worker_statistics(
+      executor, statistics.size(), statistics.data(), &worker_count);
+  if (!iree_status_is_ok(status) || worker_count == 0) {
+    iree_status_ignore(status);
+    return;
+  }
+  int64_t total_count = 0;
+  int64_t max_count = 0;
+  int64_t steal_count = 0;
+  for (iree_host_size_t i = 0; i < worker_count; ++i) {
+    total_count += statistics[i].task_count;
+    max_count = std::max(max_count, statistics[i].task_count);
+    steal_count += statistics[i].steal_count;
+  }
+  if (!state || total_count == 0) return;
+  state->counters["max_share"] =
+      (double)max_count * worker_count / (double)total_count;
+  state->counters["steal_ratio"] = (double)steal_count / (double)total_count;
+}
+
+void FanOutArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"width", "workers"});
+  for (int64_t width : {8, 32}) {
+    for (int64_t worker_count : {1, 4, 8}) {
+      benchmark->Args({width, worker_count});
+    }
+  }
+}
+
+void BM_FanOut(benchmark::State& state) {
+  const int width = static_cast<int>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)));
+  FanOutGraph graph(&executor, width);
+  // Drop anything accumulated while the executor was starting up.
+  ReportLoadBalance(/*state=*/NULL, executor.executor());
+  for (auto _ : state) {
+    graph.Submit();
+    iree_task_executor_flush(executor.executor());
+    IREE_CHECK_OK(iree_wait_one(executor.event(), IREE_TIME_INFINITE_FUTURE));
+    executor.WaitIdle();
+  }
+  ReportLoadBalance(&state, executor.executor());
+  state.SetItemsProcessed(state.iterations() * width * width);
+}
+BENCHMARK(BM_FanOut)->Apply(FanOutArgs)->UseRealTime();
+
+// Runs the benchmark loop around |submit_fn| and reports common counters.
+template <typename SubmitFn>
+void RunBenchmark(benchmark::State& state, Executor& executor,
+                  int64_t items_per_iteration, SubmitFn submit_fn) {
+  ReportLoadBalance(/*state=*/NULL, executor.executor());
+  for (auto _ : state) {
+    submit_fn();
+  }
+  ReportLoadBalance(&state, executor.executor());
+  state.counters["workers"] = (double)executor.worker_count();
+  state.SetItemsProcessed(state.iterations() * items_per_iteration);
+}
+
+void WorkerTopologyArgs(benchmark::internal::Benchmark* benchmark,
+                        const char* name,
+                        std::initializer_list<int64_t> values) {
+  benchmark->ArgNames({name, "workers", "topology"});
+  for (int64_t value : values) {
+    for (int64_t worker_count : {1, 4}) {
+      for (int64_t topology_mode : {kTopologyGroupCount, kTopologyPhysicalCores,
+                                    kTopologyUniqueL2}) {
+        benchmark->Args({value, worker_count, topology_mode});
+      }
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Nop/call throughput
+//===----------------------------------------------------------------------===//
+// |tasks| independent tasks are submitted together and each completes into the
+// fence. Measures the per-task scheduling and retirement overhead.
+
+void BM_NopThroughput(benchmark::State& state) {
+  const int task_count = static_cast<int>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)),
+                    static_cast<int>(state.range(2)));
+  std::vector<iree_task_nop_t> nops(task_count);
+  std::vector<iree_task_t*> tasks(task_count);
+  RunBenchmark(state, executor, task_count, [&]() {
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (int i = 0; i < task_count; ++i) {
+      iree_task_nop_initialize(executor.scope(), &nops[i]);
+      tasks[i] = &nops[i].header;
+      iree_task_submission_enqueue(&submission, tasks[i]);
+    }
+    executor.SubmitAndWaitIdle(&submission, tasks.data(), tasks.size());
+  });
+}
+BENCHMARK(BM_NopThroughput)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      WorkerTopologyArgs(benchmark, "tasks", {64, 1024});
+    })
+    ->UseRealTime();
+
+void BM_CallThroughput(benchmark::State& state) {
+  const int task_count = static_cast<int>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)),
+                    static_cast<int>(state.range(2)));
+  std::vector<iree_task_call_t> calls(task_count);
+  std::vector<iree_task_t*> tasks(task_count);
+  RunBenchmark(state, executor, task_count, [&]() {
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (int i = 0; i < task_count; ++i) {
+      iree_task_call_initialize(
+          executor.scope(),
+          iree_task_make_call_closure(
+              [](uintptr_t user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                benchmark::DoNotOptimize(user_context);
+                return iree_ok_status();
+              },
+              (uintptr_t)i),
+          &calls[i]);
+      tasks[i] = &calls[i].header;
+      iree_task_submission_enqueue(&submission, tasks[i]);
+    }
+    executor.SubmitAndWaitIdle(&submission, tasks.data(), tasks.size());
+  });
+}
+BENCHMARK(BM_CallThroughput)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      WorkerTopologyArgs(benchmark, "tasks", {64, 1024});
+    })
+    ->UseRealTime();
+
+//===----------------------------------------------------------------------===//
+// Dispatch fan-out
+//===----------------------------------------------------------------------===//
+// A single dispatch of |tiles| tiles each costing |cost| iterations of work.
+// Cheap tiles expose the slicing/sharding overhead (and the choice of
+// IREE_TASK_DISPATCH_TILES_PER_SLICE_*) while expensive ones show how well
+// tiles are spread across workers.
+
+void BM_DispatchFanOut(benchmark::State& state) {
+  const uint32_t tile_count = static_cast<uint32_t>(state.range(0));
+  const uint32_t tile_cost = static_cast<uint32_t>(state.range(1));
+  Executor executor(static_cast<int>(state.range(2)),
+                    static_cast<int>(state.range(3)));
+  RunBenchmark(state, executor, tile_count, [&]() {
+    executor.Submit(tile_count, tile_cost);
+    iree_task_executor_flush(executor.executor());
+    IREE_CHECK_OK(iree_wait_one(executor.event(), IREE_TIME_INFINITE_FUTURE));
+    executor.WaitIdle();
+  });
+}
+BENCHMARK(BM_DispatchFanOut)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      benchmark->ArgNames({"tiles", "cost", "workers", "topology"});
+      for (int64_t tile_count : {1, 64, 4096}) {
+        for (int64_t tile_cost : {0, 1024}) {
+          for (int64_t worker_count : {1, 4}) {
+            for (int64_t topology_mode :
+                 {kTopologyGroupCount, kTopologyPhysicalCores}) {
+              benchmark->Args(
+                  {tile_count, tile_cost, worker_count, topology_mode});
+            }
+          }
+        }
+      }
+    })
+    ->UseRealTime();
+
+//===----------------------------------------------------------------------===//
+// Barrier fan-in
+//===----------------------------------------------------------------------===//
+// |tasks| calls all completing into a single barrier that then retires into
+// the fence. Measures contention on the shared dependency counter as tasks
+// retire concurrently on all workers.
+
+void BM_BarrierFanIn(benchmark::State& state) {
+  const int task_count = static_cast<int>(state.range(0));
+  Executor executor(static_cast<int>(state.range(1)),
+                    static_cast<int>(state.range(2)));
+  std::vector<iree_task_call_t> calls(task_count);
+  iree_task_barrier_t barrier;
+  RunBenchmark(state, executor, task_count, [&]() {
+    iree_task_barrier_initialize_empty(executor.scope(), &barrier);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (int i = 0; i < task_count; ++i) {
+      iree_task_call_initialize(
+          executor.scope(),
+          iree_task_make_call_closure(
+              [](uintptr_t user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                return iree_ok_status();
+              },
+              0),
+          &calls[i]);
+      iree_task_set_completion_task(&calls[i].header, &barrier.header);
+      iree_task_submission_enqueue(&submission, &calls[i].header);
+    }
+    iree_task_t* tail_task = &barrier.header;
+    executor.SubmitAndWaitIdle(&submission, &tail_task, 1);
+  });
+}
+BENCHMARK(BM_BarrierFanIn)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      WorkerTopologyArgs(benchmark, "tasks", {64, 1024});
+    })
+    ->UseRealTime();
+
+//===----------------------------------------------------------------------===//
+// Stealing under imbalance
+//===----------------------------------------------------------------------===//
+// |tasks| calls of |cost| iterations each are all given an affinity for worker
+// 0 so that they are posted to its queue and the remaining workers can only
+// make progress by stealing. Workers are only woken when work is posted to them
+// so each other worker is also posted a wake call (nops retire on the
+// coordinator and never reach a worker). Idle workers are not stolen from and
+// so the wake calls hold their workers until worker 0 has begun running its
+// queue; after that they find their own queues empty and steal from it.
+// Compare against BM_CallThroughput to see how much of the ideal parallelism
+// theft recovers.
+
+struct StealImbalanceContext {
+  uint32_t task_cost;
+  // Set once worker 0 (or a thief) has started running the imbalanced calls.
+  std::atomic<bool> started;
+};
+
+void BM_StealImbalance(benchmark::State& state) {
+  const int task_count = static_cast<int>(state.range(0));
+  const uint32_t task_cost = static_cast<uint32_t>(state.range(1));
+  Executor executor(static_cast<int>(state.range(2)),
+                    static_cast<int>(state.range(3)));
+  const iree_host_size_t worker_count = executor.worker_count();
+  std::vector<iree_task_call_t> calls(task_count);
+  std::vector<iree_task_call_t> wakes(worker_count);
+  std::vector<iree_task_t*> tasks(task_count + worker_count);
+  StealImbalanceContext context;
+  context.task_cost = task_cost;
+  RunBenchmark(state, executor, task_count, [&]() {
+    context.started.store(false, std::memory_order_relaxed);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    for (iree_host_size_t i = 1; i < worker_count; ++i) {
+      iree_task_call_initialize(
+          executor.scope(),
+          iree_task_make_call_closure(
+              [](uintptr_t user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                auto* context =
+                    reinterpret_cast<StealImbalanceContext*>(user_context);
+                while (!context->started.load(std::memory_order_acquire)) {
+                  std::this_thread::yield();
+                }
+                return iree_ok_status();
+              },
+              (uintptr_t)&context),
+          &wakes[i]);
+      wakes[i].header.affinity_set = iree_task_affinity_for_worker(i);
+      tasks[task_count + i - 1] = &wakes[i].header;
+      iree_task_submission_enqueue(&submission, &wakes[i].header);
+    }
+    for (int i = 0; i < task_count; ++i) {
+      iree_task_call_initialize(
+          executor.scope(),
+          iree_task_make_call_closure(
+              [](uintptr_t user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                auto* context =
+                    reinterpret_cast<StealImbalanceContext*>(user_context);
+                context->started.store(true, std::memory_order_release);
+                SpinWork((uint64_t)(uintptr_t)task, context->task_cost);
+                return iree_ok_status();
+              },
+              (uintptr_t)&context),
+          &calls[i]);
+      calls[i].header.affinity_set = iree_task_affinity_for_worker(0);
+      tasks[i] = &calls[i].header;
+      iree_task_submission_enqueue(&submission, tasks[i]);
+    }
+    executor.SubmitAndWaitIdle(&submission, tasks.data(),
+                               task_count + worker_count - 1);
+  });
+}
+BENCHMARK(BM_StealImbalance)
+    ->Apply([](benchmark::internal::Benchmark* benchmark) {
+      benchmark->ArgNames({"tasks", "cost", "workers", "topology"});
+      for (int64_t task_cost : {0, 4096}) {
+        for (int64_t worker_count : {1, 4}) {
+          for (int64_t topology_mode :
+               {kTopologyGroupCount, kTopologyPhysicalCores}) {
+            benchmark->Args({256, task_cost, worker_count, topology_mode});
+          }
+        }
+      }
+    })
+    ->UseRealTime();
+
+}  // namespace
@@ -40,6 +40,32 @@ struct iree_task_executor_s {
   // extra layer of PRNG anyway ;)
   iree_prng_minilcg128_state_t donation_theft_prng;
 
+  // Tuning parameters used when issuing dispatches.
+  // Guarded by |coordinator_mutex| as dispatches are only issued while
+  // coordinating.
+  iree_task_executor_tuning_t tuning;
+
+  // Theft parameters derived from |tuning| and read by workers without
+  // holding any lock.
+  iree_atomic_int32_t max_theft_attempts;
+  iree_atomic_int32_t max_theft_task_count;
+
+  // Set while a caller thread is donated to the executor and executing tasks.
+  // Only one donated thread may execute tasks at a time as they share the
+  // |donor_local_memory|; any others wait as if they had not donated.
+  iree_atomic_int32_t donor_active;
+  // Worker-local memory used by the donated thread when executing tasks.
+  iree_byte_span_t donor_local_memory;
+
+  // Tasks posted for execution when the executor has no workers ("inline"
+  // mode). They are executed by whichever thread flushes the executor or
+  // donates itself to it while holding |donor_active|.
+  iree_atomic_task_slist_t inline_mailbox_slist;
+  // Set after tasks are posted to |inline_mailbox_slist| and cleared by the
+  // thread draining it so that tasks posted while another thread is draining
+  // are not missed when that thread stops.
+  iree_atomic_int32_t inline_pending;
+
   // Pools of transient dispatch tasks shared across all workers.
   // Depending on configuration the task pool may allocate after creation using
   // the allocator provided upon executor creation.
@@ -94,11 +120,25 @@ struct iree_task_executor_s {
   // on already woken workers.
   iree_atomic_task_affinity_set_t worker_idle_mask;
 
+  // Rotating cursor and PRNG used when selecting which worker receives newly
+  // posted tasks so that no worker is systematically favored. Only touched by
+  // post batches while holding |coordinator_mutex|.
+  uint32_t post_cursor;
+  iree_prng_splitmix64_state_t post_prng;
+
   // Specifies how many workers threads there are.
   // For now this number is fixed per executor however if we wanted to enable
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // NUMA node all workers are placed on or IREE_NUMA_NODE_ID_ANY if the
+  // workers span nodes or the placement is unknown.
+  iree_numa_node_id_t numa_node;
+
+  // Size in bytes of the local memory available to each worker and to a
+  // caller thread donated to the executor.
+  iree_host_size_t worker_local_memory_size;
 };
 
 // Merges a submission into the primary FIFO queues.
@@ -109,6 +149,12 @@ struct iree_task_executor_s {
 void iree_task_executor_merge_submission(iree_task_executor_t* executor,
                                          iree_task_submission_t* submission);
 
+// Posts a LIFO |list| of tasks for execution on the thread flushing or donated
+// to an executor with no workers. |list| will be reset.
+// Only called during coordination and expects the coordinator lock to be held.
+void iree_task_executor_post_inline_tasks(iree_task_executor_t* executor,
+                                          iree_task_list_t* list);
+
 // Schedules all ready tasks in the |pending_submission| list.
 // Only called during coordination and expects the coordinator lock to be held.
 void iree_task_executor_schedule_ready_tasks(
@@ -133,8 +179,9 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_affinity_set_t numa_sharing_mask, uint32_t max_theft_attempts,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_priority_queue_t* local_task_queue);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -6,9 +6,12 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 #include "iree/base/internal/prng.h"
+#include "iree/base/internal/wait_handle.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -56,8 +59,9 @@ TEST(ExecutorTest, Any) {
   iree_task_executor_t* executor = NULL;
   iree_task_scheduling_mode_t scheduling_mode =
       IREE_TASK_SCHEDULING_MODE_RESERVED;
-  IREE_CHECK_OK(iree_task_executor_create(scheduling_mode, &topology, allocator,
-                                          &executor));
+  IREE_CHECK_OK(iree_task_executor_create(scheduling_mode, &topology,
+                                          /*worker_local_memory_size=*/0,
+                                          allocator, &executor));
   iree_task_topology_deinitialize(&topology);
 
   //
@@ -89,8 +93,6 @@ TEST(ExecutorTest, Any) {
             IREE_TRACE_SCOPE0("tile0");
             EXPECT_EQ(0, user_context);
             simulate_work(tile_context);
-            iree_atomic_fetch_add_int32(&tile_context->statistics->reserved, 1,
-                                        iree_memory_order_relaxed);
             return iree_ok_status();
           },
           0),
@@ -109,8 +111,6 @@ TEST(ExecutorTest, Any) {
             IREE_TRACE_SCOPE0("tile1");
             EXPECT_EQ(0, user_context);
             simulate_work(tile_context);
-            iree_atomic_fetch_add_int32(&tile_context->statistics->reserved, 1,
-                                        iree_memory_order_relaxed);
             return iree_ok_status();
           },
           0),
@@ -166,8 +166,542 @@ TEST(ExecutorTest, Any) {
 
   IREE_CHECK_OK(iree_task_scope_wait_idle(&scope_a, IREE_TIME_INFINITE_FUTURE));
 
+#if IREE_TASK_STATISTICS_ENABLE
+  // All dispatches have retired and merged their statistics into the scope.
+  iree_task_dispatch_statistics_t statistics =
+      iree_task_scope_consume_statistics(&scope_a);
+  EXPECT_EQ(2, iree_atomic_load_int64(&statistics.dispatch_count,
+                                      iree_memory_order_relaxed));
+  EXPECT_EQ(32 * 4 * 2 + 16 * 2 * 1,
+            iree_atomic_load_int64(&statistics.tile_count,
+                                   iree_memory_order_relaxed));
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
   iree_task_scope_deinitialize(&scope_a);
   iree_task_executor_release(executor);
 }
 
+TEST(ExecutorTest, ConsumeWorkerStatistics) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/2, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/0, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_worker_statistics_t worker_statistics[2];
+  iree_host_size_t worker_count = 0;
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_status_t status = iree_task_executor_consume_worker_statistics(
+      executor, 1, worker_statistics, &worker_count);
+  EXPECT_TRUE(iree_status_is_out_of_range(status));
+  iree_status_ignore(status);
+  EXPECT_EQ(2, worker_count);
+  IREE_EXPECT_OK(iree_task_executor_consume_worker_statistics(
+      executor, IREE_ARRAYSIZE(worker_statistics), worker_statistics,
+      &worker_count));
+  EXPECT_EQ(2, worker_count);
+#else
+  iree_status_t status = iree_task_executor_consume_worker_statistics(
+      executor, IREE_ARRAYSIZE(worker_statistics), worker_statistics,
+      &worker_count);
+  EXPECT_TRUE(iree_status_is_unavailable(status));
+  iree_status_ignore(status);
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
+  iree_task_executor_release(executor);
+}
+
+TEST(ExecutorTest, WorkerLocalMemory) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/1000, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  // Each tile scribbles over all of its local memory and verifies it can read
+  // back what it wrote; tiles on the same worker share the memory but never
+  // run concurrently.
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 4, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](uintptr_t user_context,
+             const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            iree_byte_span_t local_memory = tile_context->local_memory;
+            if (local_memory.data_length < 1000 ||
+                ((uintptr_t)local_memory.data %
+                 iree_hardware_destructive_interference_size) != 0) {
+              return iree_make_status(IREE_STATUS_INTERNAL,
+                                      "bad local memory");
+            }
+            uint8_t pattern = (uint8_t)(tile_context->workgroup_xyz[0] +
+                                        tile_context->workgroup_xyz[1]);
+            memset(local_memory.data, pattern, local_memory.data_length);
+            for (iree_host_size_t i = 0; i < local_memory.data_length; ++i) {
+              if (local_memory.data[i] != pattern) {
+                return iree_make_status(IREE_STATUS_INTERNAL,
+                                        "local memory shared across workers");
+              }
+            }
+            return iree_ok_status();
+          },
+          0),
+      workgroup_size, workgroup_count, &dispatch);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope));
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Executors with more workers than fit in a single 64-bit affinity word must
+// be able to post to, wake, and steal from all of them.
+TEST(ExecutorTest, MoreThan64Workers) {
+  static constexpr iree_host_size_t kWorkerCount =
+      IREE_TASK_EXECUTOR_MAX_WORKER_COUNT < 80
+          ? IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
+          : 80;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(kWorkerCount, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/0, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  // Each tile counts itself so we can verify all ran exactly once. With more
+  // tiles than workers every worker gets posted at least one shard.
+  struct tile_state_t {
+    iree_atomic_int32_t tile_counts[4 * kWorkerCount];
+  } tile_state;
+  for (auto& tile_count : tile_state.tile_counts) {
+    iree_atomic_store_int32(&tile_count, 0, iree_memory_order_relaxed);
+  }
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {4 * kWorkerCount, 1, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](uintptr_t user_context,
+             const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            auto* tile_state = (tile_state_t*)user_context;
+            iree_atomic_fetch_add_int32(
+                &tile_state->tile_counts[tile_context->workgroup_xyz[0]], 1,
+                iree_memory_order_relaxed);
+            return iree_ok_status();
+          },
+          (uintptr_t)&tile_state),
+      workgroup_size, workgroup_count, &dispatch);
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope));
+  for (auto& tile_count : tile_state.tile_counts) {
+    EXPECT_EQ(1,
+              iree_atomic_load_int32(&tile_count, iree_memory_order_relaxed));
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Executors with no workers run all tasks on the thread flushing them.
+TEST(ExecutorTest, InlineFlush) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/0, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/64, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  struct State {
+    std::thread::id thread_id = std::this_thread::get_id();
+    int tile_count = 0;
+    int call_count = 0;
+    bool wrong_thread = false;
+  } state;
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {8, 2, 1};
+  iree_task_dispatch_t dispatch;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          [](uintptr_t user_context,
+             const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (State*)user_context;
+            if (std::this_thread::get_id() != state->thread_id ||
+                tile_context->local_memory.data_length < 64) {
+              state->wrong_thread = true;
+            }
+            ++state->tile_count;
+            return iree_ok_status();
+          },
+          (uintptr_t)&state),
+      workgroup_size, workgroup_count, &dispatch);
+  iree_task_call_t call;
+  iree_task_call_initialize(&scope,
+                            iree_task_make_call_closure(
+                                [](uintptr_t user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  auto* state = (State*)user_context;
+                                  if (std::this_thread::get_id() !=
+                                      state->thread_id) {
+                                    state->wrong_thread = true;
+                                  }
+                                  ++state->call_count;
+                                  return iree_ok_status();
+                                },
+                                (uintptr_t)&state),
+                            &call);
+  iree_task_set_completion_task(&dispatch.header, &call.header);
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&call.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &dispatch.header);
+  iree_task_executor_submit(executor, &submission);
+  EXPECT_EQ(0, state.tile_count);
+
+  // Everything is ready and must have completed by the time flush returns.
+  iree_task_executor_flush(executor);
+  EXPECT_TRUE(iree_task_scope_is_idle(&scope));
+  EXPECT_EQ(8 * 2, state.tile_count);
+  EXPECT_EQ(1, state.call_count);
+  EXPECT_FALSE(state.wrong_thread);
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope));
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Donating to an executor with no workers runs tasks that become ready after
+// waits resolve on the donating thread.
+TEST(ExecutorTest, InlineDonateWait) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/0, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/0, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  iree_event_t gate_event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &gate_event));
+  iree_event_t done_event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &done_event));
+
+  struct State {
+    std::thread::id thread_id = std::this_thread::get_id();
+    iree_event_t* done_event;
+    bool wrong_thread = false;
+  } state;
+  state.done_event = &done_event;
+
+  // wait(gate) -> call(set done) -> fence
+  iree_task_wait_t wait;
+  iree_task_wait_initialize(&scope, gate_event, &wait);
+  iree_task_call_t call;
+  iree_task_call_initialize(&scope,
+                            iree_task_make_call_closure(
+                                [](uintptr_t user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  auto* state = (State*)user_context;
+                                  if (std::this_thread::get_id() !=
+                                      state->thread_id) {
+                                    state->wrong_thread = true;
+                                  }
+                                  iree_event_set(state->done_event);
+                                  return iree_ok_status();
+                                },
+                                (uintptr_t)&state),
+                            &call);
+  iree_task_set_completion_task(&wait.header, &call.header);
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&call.header, &fence->header);
+
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, &wait.header);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+  EXPECT_FALSE(iree_task_scope_is_idle(&scope));
+
+  // Times out as nothing signals the gate.
+  iree_status_t status = iree_task_executor_donate_caller(
+      executor, &done_event, iree_time_now() + 1000000);
+  EXPECT_TRUE(iree_status_is_deadline_exceeded(status));
+  iree_status_ignore(status);
+
+  // Another thread opens the gate; it does nothing but set the event and the
+  // donating thread must notice the wait resolving and run the call.
+  std::thread signaler([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    iree_event_set(&gate_event);
+  });
+  IREE_EXPECT_OK(iree_task_executor_donate_caller(executor, &done_event,
+                                                  IREE_TIME_INFINITE_FUTURE));
+  signaler.join();
+  EXPECT_TRUE(iree_task_scope_is_idle(&scope));
+  EXPECT_FALSE(state.wrong_thread);
+
+  iree_event_deinitialize(&done_event);
+  iree_event_deinitialize(&gate_event);
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Spins until |condition| returns true or a generous timeout elapses so that a
+// broken donation path fails the test instead of hanging it.
+template <typename F>
+static bool SpinUntil(F condition) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() >= deadline) return false;
+    std::this_thread::yield();
+  }
+  return true;
+}
+
+// Two calls that each block until the other has started can only complete on
+// an executor with a single worker if the donating thread steals one of them.
+TEST(ExecutorTest, DonateCallerStealsWork) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/0, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  iree_event_t done_event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &done_event));
+
+  struct State {
+    std::thread::id donor_thread_id = std::this_thread::get_id();
+    iree_event_t* done_event;
+    std::atomic<int> arrived_count{0};
+    std::atomic<int> donor_count{0};
+    std::atomic<bool> timed_out{false};
+  } state;
+  state.done_event = &done_event;
+
+  // call[0] + call[1] -> join(set done) -> fence
+  iree_task_call_t join;
+  iree_task_call_initialize(&scope,
+                            iree_task_make_call_closure(
+                                [](uintptr_t user_context, iree_task_t* task,
+                                   iree_task_submission_t* pending_submission) {
+                                  auto* state = (State*)user_context;
+                                  iree_event_set(state->done_event);
+                                  return iree_ok_status();
+                                },
+                                (uintptr_t)&state),
+                            &join);
+  iree_task_call_t calls[2];
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  for (auto& call : calls) {
+    iree_task_call_initialize(
+        &scope,
+        iree_task_make_call_closure(
+            [](uintptr_t user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              auto* state = (State*)user_context;
+              if (std::this_thread::get_id() == state->donor_thread_id) {
+                ++state->donor_count;
+              }
+              ++state->arrived_count;
+              if (!SpinUntil([&]() { return state->arrived_count == 2; })) {
+                state->timed_out = true;
+              }
+              return iree_ok_status();
+            },
+            (uintptr_t)&state),
+        &call);
+    iree_task_set_completion_task(&call.header, &join.header);
+    iree_task_submission_enqueue(&submission, &call.header);
+  }
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_set_completion_task(&join.header, &fence->header);
+  iree_task_executor_submit(executor, &submission);
+
+  IREE_EXPECT_OK(iree_task_executor_donate_caller(executor, &done_event,
+                                                  IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_FALSE(state.timed_out);
+  EXPECT_EQ(2, state.arrived_count);
+  EXPECT_EQ(1, state.donor_count);
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope));
+
+  iree_event_deinitialize(&done_event);
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Tasks stolen by a donating thread are no longer visible to workers and must
+// be executed before it returns even if its wait resolved in the meantime.
+// While the donor is active a second donating thread must only wait.
+TEST(ExecutorTest, DonateCallerDrainsStolenTasks) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/1, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(
+      IREE_TASK_SCHEDULING_MODE_RESERVED, &topology,
+      /*worker_local_memory_size=*/0, iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"), &scope);
+
+  iree_event_t done_event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &done_event));
+
+  struct State {
+    iree_task_executor_t* executor;
+    std::thread::id donor_thread_id = std::this_thread::get_id();
+    std::thread::id worker_thread_id;
+    iree_event_t* done_event;
+    // The first task run by the worker blocks it until released such that
+    // the remaining tasks sit in its queue for the donor to steal.
+    std::atomic<bool> worker_blocked{false};
+    std::atomic<bool> worker_released{false};
+    std::atomic<bool> second_donor_started{false};
+    iree_status_code_t second_donor_status = IREE_STATUS_OK;
+    std::atomic<int> call_count{0};
+    std::atomic<int> donor_count{0};
+    std::atomic<int> second_donor_count{0};
+    std::atomic<bool> timed_out{false};
+  } state;
+  state.executor = executor;
+  state.done_event = &done_event;
+
+  iree_task_fence_t* fence = NULL;
+  IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+  iree_task_call_t calls[5];
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  for (auto& call : calls) {
+    iree_task_call_initialize(
+        &scope,
+        iree_task_make_call_closure(
+            [](uintptr_t user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              auto* state = (State*)user_context;
+              auto thread_id = std::this_thread::get_id();
+              if (!state->worker_blocked) {
+                // Only the worker runs tasks before the donor starts.
+                state->worker_thread_id = thread_id;
+                state->worker_blocked = true;
+                auto is_released = [&]() {
+                  return state->worker_released.load();
+                };
+                if (!SpinUntil(is_released)) state->timed_out = true;
+                return iree_ok_status();
+              }
+              ++state->call_count;
+              if (thread_id == state->worker_thread_id) return iree_ok_status();
+              if (thread_id != state->donor_thread_id) {
+                ++state->second_donor_count;
+                return iree_ok_status();
+              }
+              ++state->donor_count;
+              if (!state->second_donor_started.exchange(true)) {
+                // Donate from another thread while this one holds the
+                // executor; it must time out without stealing the tasks
+                // remaining in the worker queue.
+                iree_event_t second_event;
+                IREE_CHECK_OK(iree_event_initialize(/*initial_state=*/false,
+                                                    &second_event));
+                std::thread second_donor([&]() {
+                  iree_status_t status = iree_task_executor_donate_caller(
+                      state->executor, &second_event,
+                      iree_time_now() + 10000000);
+                  state->second_donor_status = iree_status_code(status);
+                  iree_status_ignore(status);
+                });
+                second_donor.join();
+                iree_event_deinitialize(&second_event);
+              }
+              iree_event_set(state->done_event);
+              return iree_ok_status();
+            },
+            (uintptr_t)&state),
+        &call);
+    iree_task_set_completion_task(&call.header, &fence->header);
+    iree_task_submission_enqueue(&submission, &call.header);
+  }
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+
+  // Once the worker is running its first task the others are in its queue.
+  ASSERT_TRUE(SpinUntil([&]() { return state.worker_blocked.load(); }));
+  IREE_EXPECT_OK(iree_task_executor_donate_caller(executor, &done_event,
+                                                  IREE_TIME_INFINITE_FUTURE));
+
+  // The donor steals half of the 4 queued tasks and the first it runs
+  // resolves the wait; the other must have been run before returning.
+  EXPECT_EQ(2, state.donor_count);
+  EXPECT_EQ(0, state.second_donor_count);
+  EXPECT_EQ(IREE_STATUS_DEADLINE_EXCEEDED, state.second_donor_status);
+
+  state.worker_released = true;
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_FALSE(state.timed_out);
+  EXPECT_EQ(4, state.call_count);
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope));
+
+  iree_event_deinitialize(&done_event);
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
 }  // namespace
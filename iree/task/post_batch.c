@@ -17,31 +17,76 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
                                      iree_task_post_batch_t* out_post_batch) {
   out_post_batch->executor = executor;
   out_post_batch->current_worker = current_worker;
-  out_post_batch->worker_pending_mask = 0;
+  out_post_batch->worker_pending_mask = iree_task_affinity_set_empty();
   memset(&out_post_batch->worker_pending_lifos, 0,
-         executor->worker_count * sizeof(iree_task_list_t));
+         iree_task_post_batch_worker_count(out_post_batch) *
+             sizeof(iree_task_list_t));
 }
 
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch) {
-  return post_batch->executor->worker_count;
+  // Executors without workers run everything inline and look like they have a
+  // single worker for the purposes of distributing work.
+  return iree_max(1, post_batch->executor->worker_count);
 }
 
-static iree_host_size_t iree_task_post_batch_select_random_worker(
-    iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set) {
+// Returns the estimated load of the worker at |worker_index|: the tasks
+// already queued on it plus one if this batch has already assigned it work
+// (as that work isn't reflected in the worker's hint until the batch submits).
+static int32_t iree_task_post_batch_worker_load(
+    iree_task_post_batch_t* post_batch, iree_host_size_t worker_index) {
+  int32_t queue_depth = iree_atomic_load_int32(
+      &post_batch->executor->workers[worker_index].queue_depth_hint,
+      iree_memory_order_relaxed);
+  // Thieves decrement their own hint for tasks they didn't receive via posts.
+  if (queue_depth < 0) queue_depth = 0;
+  return queue_depth + (iree_task_affinity_set_test(
+                            post_batch->worker_pending_mask, worker_index)
+                            ? 1
+                            : 0);
+}
+
+// Selects a worker from |affinity_set| by rotating through the live workers so
+// that consecutive selections spread across the set. When |load_aware| is set
+// a second worker is sampled at random and the one with the least estimated
+// load is chosen ("power of two choices"); this avoids piling onto a backed-up
+// worker while only ever looking at two hints.
+static iree_host_size_t iree_task_post_batch_select_rotating_worker(
+    iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set,
+    bool load_aware) {
+  iree_task_executor_t* executor = post_batch->executor;
   iree_task_affinity_set_t worker_live_mask =
-      iree_atomic_task_affinity_set_load(
-          &post_batch->executor->worker_live_mask, iree_memory_order_relaxed);
-  iree_task_affinity_set_t valid_worker_mask = affinity_set & worker_live_mask;
-  if (!valid_worker_mask) {
+      iree_atomic_task_affinity_set_load(&executor->worker_live_mask,
+                                         iree_memory_order_relaxed);
+  iree_task_affinity_set_t valid_worker_mask =
+      iree_task_affinity_set_and(affinity_set, worker_live_mask);
+  if (iree_task_affinity_set_is_empty(valid_worker_mask)) {
     // No valid workers as desired; for now just bail to worker 0.
     return 0;
   }
 
-  // TODO(benvanik): rotate through workers here. Instead, if the affinity set
-  // has the current_worker allowed we just use that to avoid needing a
-  // cross-thread hop.
-  return iree_task_affinity_set_count_trailing_zeros(valid_worker_mask);
+  const uint32_t worker_count = (uint32_t)executor->worker_count;
+  int first_index = iree_task_affinity_set_find_next_wrapping(
+      valid_worker_mask, (int)(executor->post_cursor % worker_count));
+  executor->post_cursor = (uint32_t)first_index + 1;
+  if (!load_aware ||
+      iree_task_affinity_set_count_ones(valid_worker_mask) == 1) {
+    return (iree_host_size_t)first_index;
+  }
+
+  // Sample a second distinct candidate and keep whichever is less loaded.
+  // Ties go to the rotation so that equally loaded workers still round-robin.
+  uint64_t sample = iree_prng_splitmix64_next(&executor->post_prng);
+  int second_index = iree_task_affinity_set_find_next_wrapping(
+      valid_worker_mask, (int)(sample % worker_count));
+  if (second_index == first_index) {
+    second_index = iree_task_affinity_set_find_next_wrapping(valid_worker_mask,
+                                                             first_index + 1);
+  }
+  return iree_task_post_batch_worker_load(post_batch, second_index) <
+                 iree_task_post_batch_worker_load(post_batch, first_index)
+             ? (iree_host_size_t)second_index
+             : (iree_host_size_t)first_index;
 }
 
 iree_host_size_t iree_task_post_batch_select_worker(
@@ -49,11 +94,11 @@ iree_host_size_t iree_task_post_batch_select_worker(
   if (post_batch->current_worker) {
     // Posting from a worker - prefer sending right back to this worker if we
     // haven't already scheduled for it.
-    if ((affinity_set & post_batch->current_worker->worker_bit) &&
-        !(post_batch->worker_pending_mask &
-          post_batch->current_worker->worker_bit)) {
-      return iree_task_affinity_set_count_trailing_zeros(
-          post_batch->current_worker->worker_bit);
+    iree_host_size_t worker_index = post_batch->current_worker->worker_index;
+    if (iree_task_affinity_set_test(affinity_set, worker_index) &&
+        !iree_task_affinity_set_test(post_batch->worker_pending_mask,
+                                     worker_index)) {
+      return worker_index;
     }
   }
 
@@ -62,20 +107,24 @@ iree_host_size_t iree_task_post_batch_select_worker(
   // waking should (hopefully) be less than the latency of waiting for a
   // worker's queue to finish. Note that we only consider workers idle if we
   // ourselves in this batch haven't already queued work for them (as then they
-  // aren't going to be idle).
+  // aren't going to be idle). Idle workers all have empty queues so we just
+  // rotate through them.
   iree_task_affinity_set_t worker_idle_mask =
       iree_atomic_task_affinity_set_load(
           &post_batch->executor->worker_idle_mask, iree_memory_order_relaxed);
-  worker_idle_mask &= ~post_batch->worker_pending_mask;
-  iree_task_affinity_set_t idle_affinity_set = affinity_set & worker_idle_mask;
-  if (idle_affinity_set) {
-    return iree_task_post_batch_select_random_worker(post_batch,
-                                                     idle_affinity_set);
+  worker_idle_mask = iree_task_affinity_set_and_not(
+      worker_idle_mask, post_batch->worker_pending_mask);
+  iree_task_affinity_set_t idle_affinity_set =
+      iree_task_affinity_set_and(affinity_set, worker_idle_mask);
+  if (!iree_task_affinity_set_is_empty(idle_affinity_set)) {
+    return iree_task_post_batch_select_rotating_worker(
+        post_batch, idle_affinity_set, /*load_aware=*/false);
   }
 
-  // No more workers are idle; farm out at random. In the worst case work
-  // stealing will help balance things out on the backend.
-  return iree_task_post_batch_select_random_worker(post_batch, affinity_set);
+  // No more workers are idle; pick the less loaded of two candidates. In the
+  // worst case work stealing will help balance things out on the backend.
+  return iree_task_post_batch_select_rotating_worker(post_batch, affinity_set,
+                                                     /*load_aware=*/true);
 }
 
 void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
@@ -83,15 +132,16 @@ void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
                                   iree_task_t* task) {
   iree_task_list_push_front(&post_batch->worker_pending_lifos[worker_index],
                             task);
-  post_batch->worker_pending_mask |=
-      iree_task_affinity_for_worker(worker_index);
+  iree_task_affinity_set_insert(&post_batch->worker_pending_mask,
+                                worker_index);
 }
 
 // Wakes each worker indicated in the |wake_mask|, if needed.
 static void iree_task_post_batch_wake_workers(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t wake_mask) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_VALUE(z0, iree_math_count_ones_u64(wake_mask));
+  IREE_TRACE_ZONE_APPEND_VALUE(z0,
+                               iree_task_affinity_set_count_ones(wake_mask));
 
   iree_task_executor_t* executor = post_batch->executor;
 
@@ -99,18 +149,14 @@ static void iree_task_post_batch_wake_workers(
   // wake (hopefully none in the common case) and mark that we've woken them so
   // that we don't double-resume.
   iree_task_affinity_set_t resume_mask =
-      iree_atomic_task_affinity_set_fetch_and(&executor->worker_suspend_mask,
-                                              ~wake_mask,
-                                              iree_memory_order_acquire);
-  resume_mask &= wake_mask;
-  if (IREE_UNLIKELY(resume_mask)) {
-    int resume_count = iree_task_affinity_set_count_ones(resume_mask);
-    int worker_index = 0;
-    for (int i = 0; i < resume_count; ++i) {
-      int offset = iree_task_affinity_set_count_trailing_zeros(resume_mask) + 1;
-      int resume_index = worker_index + offset;
-      worker_index += offset + 1;
-      resume_mask = iree_shr(resume_mask, offset + 1);
+      iree_atomic_task_affinity_set_fetch_and(
+          &executor->worker_suspend_mask,
+          iree_task_affinity_set_and_not(iree_task_affinity_for_any_worker(),
+                                         wake_mask),
+          iree_memory_order_acquire);
+  resume_mask = iree_task_affinity_set_and(resume_mask, wake_mask);
+  if (IREE_UNLIKELY(!iree_task_affinity_set_is_empty(resume_mask))) {
+    IREE_TASK_AFFINITY_SET_FOR_EACH(resume_index, resume_mask) {
       iree_thread_resume(executor->workers[resume_index].thread);
     }
   }
@@ -123,14 +169,7 @@ static void iree_task_post_batch_wake_workers(
   // information the kernel could use to avoid core migration as it knows when N
   // threads will be needed simultaneously and can hopefully perform any needed
   // migrations prior to beginning execution.
-  int wake_count = iree_task_affinity_set_count_ones(wake_mask);
-  int worker_index = 0;
-  for (int i = 0; i < wake_count; ++i) {
-    int offset = iree_task_affinity_set_count_trailing_zeros(wake_mask);
-    int wake_index = worker_index + offset;
-    worker_index += offset + 1;
-    wake_mask = iree_shr(wake_mask, offset + 1);
-
+  IREE_TASK_AFFINITY_SET_FOR_EACH(wake_index, wake_mask) {
     // Wake workers if they are waiting - workers are the only thing that can
     // wait on this notification so this should almost always be either free (an
     // atomic load) if a particular worker isn't waiting or it's required to
@@ -143,42 +182,53 @@ static void iree_task_post_batch_wake_workers(
 }
 
 bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
-  if (!post_batch->worker_pending_mask) return false;
+  if (iree_task_affinity_set_is_empty(post_batch->worker_pending_mask)) {
+    return false;
+  }
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Executors without workers have all tasks routed to "worker" 0 and we hand
+  // them to the executor to run on whichever thread flushes it.
+  if (post_batch->executor->worker_count == 0) {
+    post_batch->worker_pending_mask = iree_task_affinity_set_empty();
+    iree_task_executor_post_inline_tasks(post_batch->executor,
+                                         &post_batch->worker_pending_lifos[0]);
+    IREE_TRACE_ZONE_END(z0);
+    return true;
+  }
+
   // Run through each worker that has a bit set in the pending mask and post
   // the pending tasks.
   iree_task_affinity_set_t worker_mask = post_batch->worker_pending_mask;
-  post_batch->worker_pending_mask = 0;
-  int worker_index = 0;
-  int post_count = iree_task_affinity_set_count_ones(worker_mask);
-  iree_task_affinity_set_t worker_wake_mask = 0;
-  for (int i = 0; i < post_count; ++i) {
-    int offset = iree_task_affinity_set_count_trailing_zeros(worker_mask);
-    int target_index = worker_index + offset;
-    worker_index += offset + 1;
-    worker_mask = iree_shr(worker_mask, offset + 1);
-
+  post_batch->worker_pending_mask = iree_task_affinity_set_empty();
+  int post_count = 0;
+  iree_task_affinity_set_t worker_wake_mask = iree_task_affinity_set_empty();
+  IREE_TASK_AFFINITY_SET_FOR_EACH(target_index, worker_mask) {
+    ++post_count;
     iree_task_worker_t* worker = &post_batch->executor->workers[target_index];
     iree_task_list_t* target_pending_lifo =
         &post_batch->worker_pending_lifos[target_index];
+    iree_atomic_fetch_add_int32(
+        &worker->queue_depth_hint,
+        (int32_t)iree_task_list_calculate_size(target_pending_lifo),
+        iree_memory_order_relaxed);
     if (worker == post_batch->current_worker) {
       // Fast-path for posting to self; this happens when a worker plays the
       // role of coordinator and we want to ensure we aren't doing a fully
       // block-and-flush loop when we could just be popping the next new task
       // off the list.
-      iree_task_queue_append_from_lifo_list_unsafe(&worker->local_task_queue,
-                                                   target_pending_lifo);
+      iree_task_priority_queue_append_from_lifo_list_unsafe(
+          &worker->local_task_queue, target_pending_lifo);
     } else {
       iree_task_worker_post_tasks(worker, target_pending_lifo);
-      worker_wake_mask |= iree_task_affinity_for_worker(target_index);
+      iree_task_affinity_set_insert(&worker_wake_mask, target_index);
     }
   }
 
   // Wake all workers that now have pending work. If a worker is not already
   // waiting this will be cheap (no syscall).
-  if (worker_wake_mask != 0) {
+  if (!iree_task_affinity_set_is_empty(worker_wake_mask)) {
     iree_task_post_batch_wake_workers(post_batch, worker_wake_mask);
   }
 
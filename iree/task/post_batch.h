@@ -47,7 +47,10 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch);
 
-// Selects a random worker from the given affinity set.
+// Selects a worker from the given affinity set to post a task to. The posting
+// worker (if any) is preferred, then idle workers in rotation, and otherwise
+// the less loaded of two candidates based on their queue depth hints.
+// Must be called while holding the executor coordinator mutex.
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
 
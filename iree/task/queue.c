@@ -8,6 +8,50 @@
 
 #include <assert.h>
 
+#include "iree/base/internal/math.h"
+#include "iree/task/scope.h"
+
+#if IREE_TASK_QUEUE_LOCK_FREE
+
+void iree_task_queue_initialize(iree_task_queue_t* out_queue) {
+  iree_task_deque_initialize(&out_queue->deque);
+}
+
+void iree_task_queue_deinitialize(iree_task_queue_t* queue) {
+  iree_task_deque_deinitialize(&queue->deque);
+}
+
+bool iree_task_queue_is_empty(iree_task_queue_t* queue) {
+  return iree_task_deque_is_empty(&queue->deque);
+}
+
+void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task) {
+  iree_task_deque_push_front(&queue->deque, task);
+}
+
+void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
+                                                  iree_task_list_t* list) {
+  iree_task_deque_push_lifo_list(&queue->deque, list);
+}
+
+iree_task_t* iree_task_queue_flush_from_lifo_slist(
+    iree_task_queue_t* queue, iree_atomic_task_slist_t* source_slist) {
+  return iree_task_deque_flush_from_lifo_slist(&queue->deque, source_slist);
+}
+
+iree_task_t* iree_task_queue_pop_front(iree_task_queue_t* queue) {
+  return iree_task_deque_pop_front(&queue->deque);
+}
+
+iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
+                                       iree_task_queue_t* target_queue,
+                                       iree_host_size_t max_tasks) {
+  return iree_task_deque_try_steal(&source_queue->deque, &target_queue->deque,
+                                   max_tasks);
+}
+
+#else
+
 void iree_task_queue_initialize(iree_task_queue_t* out_queue) {
   memset(out_queue, 0, sizeof(*out_queue));
   iree_slim_mutex_initialize(&out_queue->mutex);
@@ -87,3 +131,147 @@ iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
   }
   return next_task;
 }
+
+#endif  // IREE_TASK_QUEUE_LOCK_FREE
+
+//===----------------------------------------------------------------------===//
+// iree_task_priority_queue_t
+//===----------------------------------------------------------------------===//
+
+// Returns the band of |task| in an iree_task_priority_queue_t.
+static int iree_task_priority_queue_band(const iree_task_t* task) {
+  iree_thread_priority_class_t priority_class =
+      task->scope ? iree_task_scope_priority_class(task->scope)
+                  : IREE_THREAD_PRIORITY_CLASS_NORMAL;
+  int band = IREE_THREAD_PRIORITY_CLASS_HIGHEST - priority_class;
+  return iree_min(iree_max(band, 0), IREE_TASK_PRIORITY_QUEUE_BAND_COUNT - 1);
+}
+
+void iree_task_priority_queue_initialize(
+    iree_task_priority_queue_t* out_queue) {
+  iree_atomic_store_int32(&out_queue->band_mask, 0, iree_memory_order_relaxed);
+  for (int i = 0; i < IREE_TASK_PRIORITY_QUEUE_BAND_COUNT; ++i) {
+    iree_task_queue_initialize(&out_queue->bands[i]);
+  }
+}
+
+void iree_task_priority_queue_deinitialize(iree_task_priority_queue_t* queue) {
+  for (int i = 0; i < IREE_TASK_PRIORITY_QUEUE_BAND_COUNT; ++i) {
+    iree_task_queue_deinitialize(&queue->bands[i]);
+  }
+  iree_atomic_store_int32(&queue->band_mask, 0, iree_memory_order_relaxed);
+}
+
+bool iree_task_priority_queue_is_empty(iree_task_priority_queue_t* queue) {
+  uint32_t band_mask = (uint32_t)iree_atomic_load_int32(
+      &queue->band_mask, iree_memory_order_relaxed);
+  while (band_mask) {
+    int band = iree_math_count_trailing_zeros_u32(band_mask);
+    if (!iree_task_queue_is_empty(&queue->bands[band])) return false;
+    band_mask &= ~(1u << band);
+  }
+  return true;
+}
+
+// Marks |band_bits| as (possibly) non-empty. Must only be called by the owner.
+static void iree_task_priority_queue_set_bands(
+    iree_task_priority_queue_t* queue, uint32_t band_bits) {
+  int32_t band_mask =
+      iree_atomic_load_int32(&queue->band_mask, iree_memory_order_relaxed);
+  if ((band_mask & band_bits) == band_bits) return;
+  iree_atomic_store_int32(&queue->band_mask, band_mask | (int32_t)band_bits,
+                          iree_memory_order_relaxed);
+}
+
+void iree_task_priority_queue_append_from_lifo_list_unsafe(
+    iree_task_priority_queue_t* queue, iree_task_list_t* list) {
+  if (iree_task_list_is_empty(list)) return;
+
+  // Fast-path for the common case of all tasks sharing a priority: the list
+  // can be appended to the band as-is. We have to walk the list to find out
+  // but it's about to be walked by the queue anyway and will be hot.
+  int first_band = iree_task_priority_queue_band(list->head);
+  bool is_uniform = true;
+  for (iree_task_t* task = list->head->next_task; task;
+       task = task->next_task) {
+    if (iree_task_priority_queue_band(task) != first_band) {
+      is_uniform = false;
+      break;
+    }
+  }
+  if (is_uniform) {
+    iree_task_queue_append_from_lifo_list_unsafe(&queue->bands[first_band],
+                                                 list);
+    iree_task_priority_queue_set_bands(queue, 1u << first_band);
+    return;
+  }
+
+  // Split the list into per-band LIFO lists (preserving relative order) and
+  // append each.
+  iree_task_list_t band_lists[IREE_TASK_PRIORITY_QUEUE_BAND_COUNT];
+  for (int i = 0; i < IREE_TASK_PRIORITY_QUEUE_BAND_COUNT; ++i) {
+    iree_task_list_initialize(&band_lists[i]);
+  }
+  uint32_t band_bits = 0;
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(list))) {
+    int band = iree_task_priority_queue_band(task);
+    iree_task_list_push_back(&band_lists[band], task);
+    band_bits |= 1u << band;
+  }
+  for (int i = 0; i < IREE_TASK_PRIORITY_QUEUE_BAND_COUNT; ++i) {
+    if (band_bits & (1u << i)) {
+      iree_task_queue_append_from_lifo_list_unsafe(&queue->bands[i],
+                                                   &band_lists[i]);
+    }
+  }
+  iree_task_priority_queue_set_bands(queue, band_bits);
+}
+
+iree_task_t* iree_task_priority_queue_flush_from_lifo_slist(
+    iree_task_priority_queue_t* queue, iree_atomic_task_slist_t* source_slist) {
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (iree_atomic_task_slist_flush(
+          source_slist, IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_LIFO,
+          &list.head, &list.tail)) {
+    iree_task_priority_queue_append_from_lifo_list_unsafe(queue, &list);
+  }
+  return iree_task_priority_queue_pop_front(queue);
+}
+
+iree_task_t* iree_task_priority_queue_pop_front(
+    iree_task_priority_queue_t* queue) {
+  uint32_t band_mask = (uint32_t)iree_atomic_load_int32(
+      &queue->band_mask, iree_memory_order_relaxed);
+  while (band_mask) {
+    int band = iree_math_count_trailing_zeros_u32(band_mask);
+    iree_task_t* task = iree_task_queue_pop_front(&queue->bands[band]);
+    if (task) return task;
+    // Band is empty (possibly drained by thieves); only we can refill it so
+    // the bit can be safely cleared.
+    band_mask &= ~(1u << band);
+    iree_atomic_store_int32(&queue->band_mask, (int32_t)band_mask,
+                            iree_memory_order_relaxed);
+  }
+  return NULL;
+}
+
+iree_task_t* iree_task_priority_queue_try_steal(
+    iree_task_priority_queue_t* source_queue,
+    iree_task_priority_queue_t* target_queue, iree_host_size_t max_tasks) {
+  uint32_t band_mask = (uint32_t)iree_atomic_load_int32(
+      &source_queue->band_mask, iree_memory_order_relaxed);
+  while (band_mask) {
+    int band = iree_math_count_trailing_zeros_u32(band_mask);
+    iree_task_t* task = iree_task_queue_try_steal(
+        &source_queue->bands[band], &target_queue->bands[band], max_tasks);
+    if (task) {
+      // Any remaining stolen tasks are now in our band.
+      iree_task_priority_queue_set_bands(target_queue, 1u << band);
+      return task;
+    }
+    band_mask &= ~(1u << band);
+  }
+  return NULL;
+}
@@ -9,8 +9,10 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/task/deque.h"
 #include "iree/task/list.h"
 #include "iree/task/task.h"
+#include "iree/task/tuning.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -100,12 +102,23 @@ extern "C" {
 // list we can't easily just walk backward and we don't want to be introducing
 // cache line contention as thieves start touching the same tasks as the worker
 // is while processing.
+//
+// When IREE_TASK_QUEUE_LOCK_FREE is set the queue is instead backed by the
+// lock-free iree_task_deque_t (an actual Chase-Lev deque with a bounded ring and
+// a locked overflow list). This trades strict FIFO order across batches for
+// lock-free pops and steals; see deque.h for details.
 typedef struct {
+#if IREE_TASK_QUEUE_LOCK_FREE
+  // Lock-free work-stealing deque. The owner pops from the bottom and thieves
+  // steal from the top.
+  iree_task_deque_t deque;
+#else
   // Must be held when manipulating the queue. >90% accesses are by the owner.
   iree_slim_mutex_t mutex;
 
   // FIFO task list.
   iree_task_list_t list IREE_GUARDED_BY(mutex);
+#endif  // IREE_TASK_QUEUE_LOCK_FREE
 } iree_task_queue_t;
 
 // Initializes a work-stealing task queue in-place.
@@ -157,6 +170,73 @@ iree_task_t* iree_task_queue_try_steal(iree_task_queue_t* source_queue,
                                        iree_task_queue_t* target_queue,
                                        iree_host_size_t max_tasks);
 
+//===----------------------------------------------------------------------===//
+// iree_task_priority_queue_t
+//===----------------------------------------------------------------------===//
+
+// Number of bands in an iree_task_priority_queue_t; one per
+// iree_thread_priority_class_t from HIGHEST (band 0) to LOWEST.
+#define IREE_TASK_PRIORITY_QUEUE_BAND_COUNT 5
+
+// A work-stealing queue partitioned into one iree_task_queue_t band per scope
+// priority class. Tasks are placed into bands based on the priority of their
+// scope and always popped (and stolen) from the highest-priority band that
+// has tasks. Order within each band is the same as iree_task_queue_t.
+//
+// A mask of non-empty bands is maintained by the owner so that in the common
+// case of all tasks sharing a priority only a single band is ever touched.
+// Thieves may empty bands without updating the mask; the owner clears the bit
+// the next time it finds the band empty. Thieves use the mask only as a hint.
+typedef struct {
+  // Bit i set if bands[i] (may) have tasks. Written only by the owner.
+  iree_atomic_int32_t band_mask;
+
+  // Task queues indexed by band with the highest priority first.
+  iree_task_queue_t bands[IREE_TASK_PRIORITY_QUEUE_BAND_COUNT];
+} iree_task_priority_queue_t;
+
+// Initializes a work-stealing priority task queue in-place.
+void iree_task_priority_queue_initialize(
+    iree_task_priority_queue_t* out_queue);
+
+// Deinitializes a priority task queue and clears all references.
+// Must not be called while any other worker may be attempting to steal tasks.
+void iree_task_priority_queue_deinitialize(iree_task_priority_queue_t* queue);
+
+// Returns true if the queue is empty.
+// Note that due to races this may return both false-positives and -negatives.
+bool iree_task_priority_queue_is_empty(iree_task_priority_queue_t* queue);
+
+// Appends a LIFO |list| of tasks to the queue, distributing them into bands
+// based on their scope priority. Order within each band is preserved.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_priority_queue_append_from_lifo_list_unsafe(
+    iree_task_priority_queue_t* queue, iree_task_list_t* list);
+
+// Flushes the |source_slist| LIFO mailbox into the queue bands in FIFO order.
+// Returns the highest-priority task in the queue upon success; the task may be
+// pre-existing or from the newly flushed tasks.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_priority_queue_flush_from_lifo_slist(
+    iree_task_priority_queue_t* queue, iree_atomic_task_slist_t* source_slist);
+
+// Pops a task from the front of the highest-priority non-empty band.
+//
+// Must only be called from the owning worker's thread.
+iree_task_t* iree_task_priority_queue_pop_front(
+    iree_task_priority_queue_t* queue);
+
+// Tries to steal up to |max_tasks| from the back of the highest-priority band
+// of |source_queue| that has tasks. Stolen tasks are moved into the same band
+// of |target_queue| and the first of them is returned.
+//
+// Must only be called from the thread owning |target_queue|.
+iree_task_t* iree_task_priority_queue_try_steal(
+    iree_task_priority_queue_t* source_queue,
+    iree_task_priority_queue_t* target_queue, iree_host_size_t max_tasks);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
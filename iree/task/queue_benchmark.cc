@@ -0,0 +1,206 @@
+// Copyright 2021 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "iree/task/deque.h"
+#include "iree/task/queue.h"
+
+// Compares the worker-local iree_task_queue_t (in whichever mode was selected
+// by IREE_TASK_QUEUE_LOCK_FREE) against the lock-free iree_task_deque_t both
+// uncontended and with a varying number of thieves hammering on the owner.
+
+namespace {
+
+//==============================================================================
+// Queue type adapters
+//==============================================================================
+
+template <typename QueueType>
+struct QueueTraits;
+
+template <>
+struct QueueTraits<iree_task_queue_t> {
+  static void Initialize(iree_task_queue_t* queue) {
+    iree_task_queue_initialize(queue);
+  }
+  static void Deinitialize(iree_task_queue_t* queue) {
+    iree_task_queue_deinitialize(queue);
+  }
+  static void PushLifoList(iree_task_queue_t* queue, iree_task_list_t* list) {
+    iree_task_queue_append_from_lifo_list_unsafe(queue, list);
+  }
+  static iree_task_t* PopFront(iree_task_queue_t* queue) {
+    return iree_task_queue_pop_front(queue);
+  }
+  static iree_task_t* TrySteal(iree_task_queue_t* source_queue,
+                               iree_task_queue_t* target_queue,
+                               iree_host_size_t max_tasks) {
+    return iree_task_queue_try_steal(source_queue, target_queue, max_tasks);
+  }
+};
+
+template <>
+struct QueueTraits<iree_task_deque_t> {
+  static void Initialize(iree_task_deque_t* deque) {
+    iree_task_deque_initialize(deque);
+  }
+  static void Deinitialize(iree_task_deque_t* deque) {
+    iree_task_deque_deinitialize(deque);
+  }
+  static void PushLifoList(iree_task_deque_t* deque, iree_task_list_t* list) {
+    iree_task_deque_push_lifo_list(deque, list);
+  }
+  static iree_task_t* PopFront(iree_task_deque_t* deque) {
+    return iree_task_deque_pop_front(deque);
+  }
+  static iree_task_t* TrySteal(iree_task_deque_t* source_deque,
+                               iree_task_deque_t* target_deque,
+                               iree_host_size_t max_tasks) {
+    return iree_task_deque_try_steal(source_deque, target_deque, max_tasks);
+  }
+};
+
+// Heap-allocated and initialized queue; the deque is too large for the stack
+// of some benchmark threads.
+template <typename QueueType>
+class ScopedQueue {
+ public:
+  ScopedQueue() : queue_(new QueueType()) {
+    QueueTraits<QueueType>::Initialize(queue_.get());
+  }
+  ~ScopedQueue() { QueueTraits<QueueType>::Deinitialize(queue_.get()); }
+  QueueType* get() { return queue_.get(); }
+
+ private:
+  std::unique_ptr<QueueType> queue_;
+};
+
+// Builds a LIFO list from |tasks| such that they will be popped in order.
+void MakeLifoList(std::vector<iree_task_t>& tasks, iree_task_list_t* out_list) {
+  iree_task_list_initialize(out_list);
+  for (auto& task : tasks) {
+    iree_task_list_push_front(out_list, &task);
+  }
+}
+
+//==============================================================================
+// Uncontended owner push/pop
+//==============================================================================
+
+// Measures the owner-only path: a batch of tasks is flushed into the queue and
+// then popped one at a time. This is the >90% case when work is well balanced.
+template <typename QueueType>
+void BM_PushPop(benchmark::State& state) {
+  using Traits = QueueTraits<QueueType>;
+  ScopedQueue<QueueType> queue;
+  std::vector<iree_task_t> tasks(state.range(0));
+  for (auto _ : state) {
+    iree_task_list_t list;
+    MakeLifoList(tasks, &list);
+    Traits::PushLifoList(queue.get(), &list);
+    while (iree_task_t* task = Traits::PopFront(queue.get())) {
+      benchmark::DoNotOptimize(task);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_PushPop, iree_task_queue_t)->Arg(1)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PushPop, iree_task_deque_t)->Arg(1)->Arg(64)->Arg(1024);
+
+//==============================================================================
+// Owner pop vs. thieves
+//==============================================================================
+
+// Measures the owner draining batches of tasks while |state.range(1)| thieves
+// continuously try to steal from it. Each iteration completes only when every
+// task in the batch has been consumed by either the owner or a thief so that
+// the task storage can be reused.
+template <typename QueueType>
+void BM_Contended(benchmark::State& state) {
+  using Traits = QueueTraits<QueueType>;
+  const int batch_size = static_cast<int>(state.range(0));
+  const int thief_count = static_cast<int>(state.range(1));
+
+  ScopedQueue<QueueType> owner_queue;
+  std::vector<iree_task_t> tasks(batch_size);
+  std::atomic<int> thief_consumed_count{0};
+  std::atomic<int> thief_steal_count{0};
+  std::atomic<bool> should_exit{false};
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < thief_count; ++i) {
+    thieves.emplace_back([&]() {
+      ScopedQueue<QueueType> local_queue;
+      while (!should_exit.load(std::memory_order_relaxed)) {
+        iree_task_t* task =
+            Traits::TrySteal(owner_queue.get(), local_queue.get(),
+                             IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
+        if (!task) {
+          std::this_thread::yield();
+          continue;
+        }
+        thief_steal_count.fetch_add(1, std::memory_order_relaxed);
+        int consumed_count = 0;
+        while (task) {
+          benchmark::DoNotOptimize(task);
+          ++consumed_count;
+          task = Traits::PopFront(local_queue.get());
+        }
+        thief_consumed_count.fetch_add(consumed_count,
+                                       std::memory_order_acq_rel);
+      }
+    });
+  }
+
+  int64_t owner_consumed_total = 0;
+  for (auto _ : state) {
+    thief_consumed_count.store(0, std::memory_order_relaxed);
+    iree_task_list_t list;
+    MakeLifoList(tasks, &list);
+    Traits::PushLifoList(owner_queue.get(), &list);
+    int owner_consumed_count = 0;
+    while (iree_task_t* task = Traits::PopFront(owner_queue.get())) {
+      benchmark::DoNotOptimize(task);
+      ++owner_consumed_count;
+    }
+    owner_consumed_total += owner_consumed_count;
+    while (owner_consumed_count +
+               thief_consumed_count.load(std::memory_order_acquire) <
+           batch_size) {
+      std::this_thread::yield();
+    }
+  }
+
+  should_exit = true;
+  for (auto& thief : thieves) thief.join();
+
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  state.counters["owner%"] = benchmark::Counter(
+      100.0 * owner_consumed_total / (state.iterations() * batch_size));
+  state.counters["steals"] = benchmark::Counter(
+      thief_steal_count.load(), benchmark::Counter::kAvgIterations);
+}
+void ContendedArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"batch", "thieves"});
+  for (int batch_size : {64, 1024}) {
+    for (int thief_count : {1, 2, 4, 8}) {
+      benchmark->Args({batch_size, thief_count});
+    }
+  }
+}
+BENCHMARK_TEMPLATE(BM_Contended, iree_task_queue_t)
+    ->Apply(ContendedArgs)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Contended, iree_task_deque_t)
+    ->Apply(ContendedArgs)
+    ->UseRealTime();
+
+}  // namespace
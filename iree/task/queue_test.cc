@@ -6,6 +6,7 @@
 
 #include "iree/task/queue.h"
 
+#include "iree/task/scope.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -320,4 +321,129 @@ TEST(QueueTest, TryStealAll) {
   iree_task_queue_deinitialize(&target_queue);
 }
 
+class PriorityQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_task_scope_initialize_with_priority(
+        iree_make_cstring_view("low"), IREE_THREAD_PRIORITY_CLASS_LOW,
+        &low_scope_);
+    iree_task_scope_initialize(iree_make_cstring_view("normal"),
+                               &normal_scope_);
+    iree_task_scope_initialize_with_priority(
+        iree_make_cstring_view("high"), IREE_THREAD_PRIORITY_CLASS_HIGH,
+        &high_scope_);
+  }
+
+  void TearDown() override {
+    iree_task_scope_deinitialize(&low_scope_);
+    iree_task_scope_deinitialize(&normal_scope_);
+    iree_task_scope_deinitialize(&high_scope_);
+  }
+
+  iree_task_scope_t low_scope_;
+  iree_task_scope_t normal_scope_;
+  iree_task_scope_t high_scope_;
+};
+
+TEST_F(PriorityQueueTest, Empty) {
+  iree_task_priority_queue_t queue;
+  iree_task_priority_queue_initialize(&queue);
+  EXPECT_TRUE(iree_task_priority_queue_is_empty(&queue));
+  EXPECT_FALSE(iree_task_priority_queue_pop_front(&queue));
+  iree_task_priority_queue_deinitialize(&queue);
+}
+
+// Tasks pop in priority order and FIFO order within each priority.
+TEST_F(PriorityQueueTest, AppendListOrdered) {
+  iree_task_priority_queue_t queue;
+  iree_task_priority_queue_initialize(&queue);
+
+  iree_task_t task_a = {0};
+  task_a.scope = &low_scope_;
+  iree_task_t task_b = {0};
+  task_b.scope = &normal_scope_;
+  iree_task_t task_c = {0};
+  task_c.scope = &high_scope_;
+  iree_task_t task_d = {0};
+  task_d.scope = &normal_scope_;
+  iree_task_list_t list = {0};
+  iree_task_list_push_front(&list, &task_a);
+  iree_task_list_push_front(&list, &task_b);
+  iree_task_list_push_front(&list, &task_c);
+  iree_task_list_push_front(&list, &task_d);
+
+  iree_task_priority_queue_append_from_lifo_list_unsafe(&queue, &list);
+  EXPECT_TRUE(iree_task_list_is_empty(&list));
+  EXPECT_FALSE(iree_task_priority_queue_is_empty(&queue));
+
+  EXPECT_EQ(&task_c, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_EQ(&task_b, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_EQ(&task_d, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_EQ(&task_a, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_TRUE(iree_task_priority_queue_is_empty(&queue));
+  EXPECT_FALSE(iree_task_priority_queue_pop_front(&queue));
+
+  iree_task_priority_queue_deinitialize(&queue);
+}
+
+// Newly flushed higher-priority tasks are ordered ahead of queued ones.
+TEST_F(PriorityQueueTest, FlushSlistPreempts) {
+  iree_task_priority_queue_t queue;
+  iree_task_priority_queue_initialize(&queue);
+
+  iree_task_t task_a = {0};
+  task_a.scope = &low_scope_;
+  iree_task_t task_b = {0};
+  task_b.scope = &low_scope_;
+  iree_task_list_t list = {0};
+  iree_task_list_push_front(&list, &task_a);
+  iree_task_list_push_front(&list, &task_b);
+  iree_task_priority_queue_append_from_lifo_list_unsafe(&queue, &list);
+
+  iree_atomic_task_slist_t slist;
+  iree_atomic_task_slist_initialize(&slist);
+  iree_task_t task_c = {0};
+  task_c.scope = &high_scope_;
+  iree_atomic_task_slist_push(&slist, &task_c);
+
+  EXPECT_EQ(&task_c,
+            iree_task_priority_queue_flush_from_lifo_slist(&queue, &slist));
+  EXPECT_EQ(&task_a, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_EQ(&task_b, iree_task_priority_queue_pop_front(&queue));
+  EXPECT_TRUE(iree_task_priority_queue_is_empty(&queue));
+
+  iree_atomic_task_slist_deinitialize(&slist);
+  iree_task_priority_queue_deinitialize(&queue);
+}
+
+// Thieves take from the highest-priority band first.
+TEST_F(PriorityQueueTest, TryStealHighestFirst) {
+  iree_task_priority_queue_t source_queue;
+  iree_task_priority_queue_initialize(&source_queue);
+  iree_task_priority_queue_t target_queue;
+  iree_task_priority_queue_initialize(&target_queue);
+
+  iree_task_t task_a = {0};
+  task_a.scope = &low_scope_;
+  iree_task_t task_b = {0};
+  task_b.scope = &high_scope_;
+  iree_task_list_t list = {0};
+  iree_task_list_push_front(&list, &task_a);
+  iree_task_list_push_front(&list, &task_b);
+  iree_task_priority_queue_append_from_lifo_list_unsafe(&source_queue, &list);
+
+  EXPECT_EQ(&task_b, iree_task_priority_queue_try_steal(&source_queue,
+                                                        &target_queue, 1000));
+  EXPECT_TRUE(iree_task_priority_queue_is_empty(&target_queue));
+
+  EXPECT_EQ(&task_a, iree_task_priority_queue_try_steal(&source_queue,
+                                                        &target_queue, 1000));
+  EXPECT_TRUE(iree_task_priority_queue_is_empty(&source_queue));
+  EXPECT_FALSE(iree_task_priority_queue_try_steal(&source_queue, &target_queue,
+                                                  1000));
+
+  iree_task_priority_queue_deinitialize(&source_queue);
+  iree_task_priority_queue_deinitialize(&target_queue);
+}
+
 }  // namespace
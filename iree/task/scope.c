@@ -8,9 +8,17 @@
 
 void iree_task_scope_initialize(iree_string_view_t name,
                                 iree_task_scope_t* out_scope) {
+  iree_task_scope_initialize_with_priority(
+      name, IREE_THREAD_PRIORITY_CLASS_NORMAL, out_scope);
+}
+
+void iree_task_scope_initialize_with_priority(
+    iree_string_view_t name, iree_thread_priority_class_t priority_class,
+    iree_task_scope_t* out_scope) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   memset(out_scope, 0, sizeof(*out_scope));
+  out_scope->priority_class = priority_class;
 
   iree_host_size_t name_length =
       iree_min(name.size, IREE_ARRAYSIZE(out_scope->name) - 1);
@@ -54,6 +62,11 @@ iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope) {
   return iree_make_cstring_view(scope->name);
 }
 
+iree_thread_priority_class_t iree_task_scope_priority_class(
+    const iree_task_scope_t* scope) {
+  return scope->priority_class;
+}
+
 iree_task_dispatch_statistics_t iree_task_scope_consume_statistics(
     iree_task_scope_t* scope) {
   iree_task_dispatch_statistics_t result = scope->dispatch_statistics;
@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/base/internal/atomics.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/base/tracing.h"
 #include "iree/task/task.h"
 
@@ -32,6 +33,13 @@ extern "C" {
 // the scope that allows for an efficient roll-up of activity over specific
 // durations.
 //
+// Scopes carry a priority class shared by all of their tasks. Workers always
+// run ready tasks from higher-priority scopes before those from lower-priority
+// scopes (and thieves steal them first) such that latency-sensitive producers
+// can share an executor with batch producers. Priorities are not preemptive:
+// a task that has begun executing runs to completion regardless of what
+// arrives after it.
+//
 // Task producers can decide whether to create new scopes for each batch of
 // tasks they submit or reuse scopes for the lifetime of their subprocess. Scope
 // overhead is low and the only advantage of reusing them is that lifetime can
@@ -43,6 +51,10 @@ typedef struct iree_task_scope_s {
   // Name used for logging and tracing.
   char name[16];
 
+  // Priority of all tasks within the scope relative to other scopes sharing
+  // the same executor. Immutable after initialization.
+  iree_thread_priority_class_t priority_class;
+
   // Base color used for tasks in this scope.
   // The color will be modulated based on task type.
   IREE_TRACE(uint32_t task_trace_color;)
@@ -87,6 +99,13 @@ typedef struct iree_task_scope_s {
 void iree_task_scope_initialize(iree_string_view_t name,
                                 iree_task_scope_t* out_scope);
 
+// Initializes a caller-allocated scope whose tasks are scheduled with the given
+// |priority_class|. iree_task_scope_initialize uses
+// IREE_THREAD_PRIORITY_CLASS_NORMAL.
+void iree_task_scope_initialize_with_priority(
+    iree_string_view_t name, iree_thread_priority_class_t priority_class,
+    iree_task_scope_t* out_scope);
+
 // Deinitializes an task scope.
 // No tasks may be pending and the scope must be idle.
 void iree_task_scope_deinitialize(iree_task_scope_t* scope);
@@ -95,6 +114,10 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope);
 // string.
 iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope);
 
+// Returns the priority class of tasks within the scope.
+iree_thread_priority_class_t iree_task_scope_priority_class(
+    const iree_task_scope_t* scope);
+
 // Returns and resets the statistics for the scope.
 // Statistics may experience tearing (non-atomic update across fields) if this
 // is performed while tasks are in-flight.
@@ -33,6 +33,22 @@ TEST(ScopeTest, LongNameTruncation) {
   iree_task_scope_deinitialize(&scope);
 }
 
+TEST(ScopeTest, Priority) {
+  iree_task_scope_t normal_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("normal"), &normal_scope);
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_NORMAL,
+            iree_task_scope_priority_class(&normal_scope));
+  iree_task_scope_deinitialize(&normal_scope);
+
+  iree_task_scope_t high_scope;
+  iree_task_scope_initialize_with_priority(iree_make_cstring_view("high"),
+                                           IREE_THREAD_PRIORITY_CLASS_HIGHEST,
+                                           &high_scope);
+  EXPECT_EQ(IREE_THREAD_PRIORITY_CLASS_HIGHEST,
+            iree_task_scope_priority_class(&high_scope));
+  iree_task_scope_deinitialize(&high_scope);
+}
+
 TEST(ScopeTest, AbortEmpty) {
   iree_task_scope_t scope;
   iree_task_scope_initialize(iree_make_cstring_view("scope_a"), &scope);
@@ -353,8 +353,53 @@ static uint32_t iree_task_tile_to_color(
 void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target) {
-  // TODO(benvanik): statistics.
+#if IREE_TASK_STATISTICS_ENABLE
+  // NOTE: the const is dropped as not all atomic implementations accept it.
+  iree_task_dispatch_statistics_t* mutable_source =
+      (iree_task_dispatch_statistics_t*)source;
+#define IREE_TASK_STATISTICS_MERGE(field)                                \
+  iree_atomic_fetch_add_int64(                                          \
+      &target->field,                                                   \
+      iree_atomic_load_int64(&mutable_source->field,                    \
+                             iree_memory_order_relaxed),                \
+      iree_memory_order_relaxed)
+  IREE_TASK_STATISTICS_MERGE(dispatch_count);
+  IREE_TASK_STATISTICS_MERGE(tile_count);
+  IREE_TASK_STATISTICS_MERGE(stolen_tile_count);
+  IREE_TASK_STATISTICS_MERGE(shard_count);
+  IREE_TASK_STATISTICS_MERGE(stolen_shard_count);
+  IREE_TASK_STATISTICS_MERGE(wall_time_ns);
+  IREE_TASK_STATISTICS_MERGE(busy_time_ns);
+#undef IREE_TASK_STATISTICS_MERGE
+#endif  // IREE_TASK_STATISTICS_ENABLE
+}
+
+#if IREE_TASK_STATISTICS_ENABLE
+// Records the execution of a shard (or slice) of |tile_count| tiles starting
+// at |start_time_ns| by worker |worker_id| into the local |statistics|.
+static void iree_task_dispatch_statistics_record_shard(
+    const iree_task_t* task, iree_host_size_t worker_id, uint32_t tile_count,
+    iree_time_t start_time_ns, iree_task_dispatch_statistics_t* statistics) {
+  // Shards are tagged with the worker they were posted to when issued; if
+  // another worker (or a donated caller thread, which has an id beyond the
+  // range of the affinity set) executes them then they must have been stolen.
+  bool is_stolen =
+      worker_id >= IREE_TASK_EXECUTOR_MAX_WORKER_COUNT ||
+      !iree_task_affinity_set_test(task->affinity_set, worker_id);
+  iree_atomic_store_int64(&statistics->tile_count, tile_count,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&statistics->stolen_tile_count,
+                          is_stolen ? tile_count : 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&statistics->shard_count, 1,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&statistics->stolen_shard_count, is_stolen ? 1 : 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&statistics->busy_time_ns,
+                          iree_time_now() - start_time_ns,
+                          iree_memory_order_relaxed);
 }
+#endif  // IREE_TASK_STATISTICS_ENABLE
 
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH
@@ -368,6 +413,7 @@ static void iree_task_dispatch_initialize_base(
   memcpy(out_task->workgroup_size, workgroup_size,
          sizeof(out_task->workgroup_size));
   out_task->shared_memory_size = 0;
+  out_task->tiles_per_reservation = 0;
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
 }
 
@@ -390,15 +436,20 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
-void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
-                                     iree_task_pool_t* slice_task_pool,
-                                     iree_task_submission_t* pending_submission,
-                                     iree_task_post_batch_t* post_batch) {
+void iree_task_dispatch_issue_sliced(
+    iree_task_dispatch_t* dispatch_task,
+    const iree_task_executor_tuning_t* tuning,
+    iree_task_pool_t* slice_task_pool,
+    iree_task_submission_t* pending_submission,
+    iree_task_post_batch_t* post_batch) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Mark the dispatch as having been issued; the next time it retires it'll be
   // because all work has completed.
   dispatch_task->header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+#if IREE_TASK_STATISTICS_ENABLE
+  dispatch_task->issue_time_ns = iree_time_now();
+#endif  // IREE_TASK_STATISTICS_ENABLE
 
   // Fetch the workgroup count (directly or indirectly).
   // By the task being ready to execute we know any dependencies on the
@@ -429,9 +480,9 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
 #endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
   // Divide up all tiles into slices, our finest-granularity scheduling task.
-  const uint32_t tiles_per_slice_x = IREE_TASK_DISPATCH_TILES_PER_SLICE_X;
-  const uint32_t tiles_per_slice_y = IREE_TASK_DISPATCH_TILES_PER_SLICE_Y;
-  const uint32_t tiles_per_slice_z = IREE_TASK_DISPATCH_TILES_PER_SLICE_Z;
+  const uint32_t tiles_per_slice_x = tuning->tiles_per_slice[0];
+  const uint32_t tiles_per_slice_y = tuning->tiles_per_slice[1];
+  const uint32_t tiles_per_slice_z = tuning->tiles_per_slice[2];
   uint32_t slice_count_x = iree_max(1, workgroup_count[0] / tiles_per_slice_x);
   uint32_t slice_count_y = iree_max(1, workgroup_count[1] / tiles_per_slice_y);
   uint32_t slice_count_z = iree_max(1, workgroup_count[2] / tiles_per_slice_z);
@@ -477,6 +528,9 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
                                               slice_task_pool);
 
         // Enqueue on the worker selected for the task.
+        // The slice is tagged with the worker so that theft can be detected.
+        slice_task->header.affinity_set =
+            iree_task_affinity_for_worker(worker_index % worker_count);
         iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
                                      &slice_task->header);
         if (++worker_slice_count >= slices_per_worker) {
@@ -502,7 +556,9 @@ void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
 }
 
 void iree_task_dispatch_issue_sharded(
-    iree_task_dispatch_t* dispatch_task, iree_task_pool_t* shard_task_pool,
+    iree_task_dispatch_t* dispatch_task,
+    const iree_task_executor_tuning_t* tuning,
+    iree_task_pool_t* shard_task_pool,
     iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -510,6 +566,9 @@ void iree_task_dispatch_issue_sharded(
   // Mark the dispatch as having been issued; the next time it retires it'll be
   // because all work has completed.
   dispatch_task->header.flags |= IREE_TASK_FLAG_DISPATCH_RETIRE;
+#if IREE_TASK_STATISTICS_ENABLE
+  dispatch_task->issue_time_ns = iree_time_now();
+#endif  // IREE_TASK_STATISTICS_ENABLE
 
   iree_task_dispatch_shard_state_t* shared_state =
       &dispatch_task->shared.shard_state;
@@ -557,13 +616,24 @@ void iree_task_dispatch_issue_sharded(
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
   // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (shared_state->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
+  shared_state->reservation_duration_ns = 0;
+  if (dispatch_task->tiles_per_reservation != 0) {
+    // Producer knows best.
+    shared_state->tiles_per_reservation = dispatch_task->tiles_per_reservation;
+  } else if (tuning->shard_reservation_duration_ns > 0) {
+    // Shards will size their reservations as they observe tile costs; bound
+    // them to an even split so that no shard can starve the others.
+    shared_state->reservation_duration_ns =
+        tuning->shard_reservation_duration_ns;
+    shared_state->tiles_per_reservation = iree_max(
+        1, shared_state->tile_count / (uint32_t)iree_max(1, shard_count));
+  } else if (shared_state->tile_count <
+             worker_count * tuning->max_tiles_per_shard_reservation) {
     // Grid is small - allow it to be eagerly sliced up.
     shared_state->tiles_per_reservation = 1;
   } else {
     shared_state->tiles_per_reservation =
-        IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+        tuning->max_tiles_per_shard_reservation;
   }
 
   // Randomize starting worker.
@@ -577,6 +647,9 @@ void iree_task_dispatch_issue_sharded(
         dispatch_task, shared_state, shard_task_pool);
 
     // Enqueue on the worker selected for the task.
+    // The shard is tagged with the worker so that theft can be detected.
+    shard_task->header.affinity_set =
+        iree_task_affinity_for_worker(worker_index % worker_count);
     iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
                                  &shard_task->header);
     ++worker_index;
@@ -602,6 +675,14 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 
   // TODO(benvanik): attach statistics to the tracy zone.
 
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_atomic_store_int64(&dispatch_task->statistics.dispatch_count, 1,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int64(&dispatch_task->statistics.wall_time_ns,
+                          iree_time_now() - dispatch_task->issue_time_ns,
+                          iree_memory_order_relaxed);
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
   // Merge the statistics from the dispatch into the scope so we can track all
   // of the work without tracking all the dispatches at a global level.
   iree_task_dispatch_statistics_merge(
@@ -665,9 +746,12 @@ iree_task_dispatch_slice_t* iree_task_dispatch_slice_allocate(
 }
 
 iree_status_t iree_task_dispatch_slice_execute(
-    iree_task_dispatch_slice_t* task,
-    iree_task_submission_t* pending_submission) {
+    iree_task_dispatch_slice_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
+#if IREE_TASK_STATISTICS_ENABLE
+  const iree_time_t start_time_ns = iree_time_now();
+#endif  // IREE_TASK_STATISTICS_ENABLE
   IREE_TRACE_ZONE_SET_COLOR(z0,
                             iree_math_ptr_to_xrgb(task->closure.user_context));
 
@@ -682,6 +766,7 @@ iree_status_t iree_task_dispatch_slice_execute(
   memcpy(&tile_context.workgroup_count, task->workgroup_count,
          sizeof(tile_context.workgroup_count));
   tile_context.shared_memory = task->shared_memory;
+  tile_context.local_memory = local_memory;
   tile_context.statistics = &task->slice_statistics;
 
   const uint32_t base_x = task->workgroup_base[0];
@@ -723,6 +808,12 @@ iree_status_t iree_task_dispatch_slice_execute(
   }
 
   // Push aggregate statistics up to the dispatch.
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_task_dispatch_statistics_record_shard(
+      &task->header, worker_id,
+      (range_x - base_x + 1) * (range_y - base_y + 1) * (range_z - base_z + 1),
+      start_time_ns, &task->slice_statistics);
+#endif  // IREE_TASK_STATISTICS_ENABLE
   if (task->dispatch_statistics) {
     iree_task_dispatch_statistics_merge(&task->slice_statistics,
                                         task->dispatch_statistics);
@@ -764,10 +855,31 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
+// Returns the number of tiles a shard should reserve next so that executing
+// them takes roughly |target_duration_ns| given that the last reservation of
+// |tile_count| tiles took |elapsed_ns|. Reservations at most double each time
+// so that a single fast sample (or timer granularity) can't cause a shard to
+// grab a large chunk of expensive tiles while they shrink immediately.
+static uint32_t iree_task_dispatch_shard_size_reservation(
+    iree_duration_t target_duration_ns, iree_duration_t elapsed_ns,
+    uint32_t tile_count, uint32_t max_tile_count) {
+  uint64_t growth_limit = (uint64_t)tile_count * 2;
+  uint64_t ideal_count = growth_limit;
+  if (elapsed_ns > 0) {
+    ideal_count = (uint64_t)target_duration_ns * tile_count / elapsed_ns;
+  }
+  ideal_count = iree_min(ideal_count, growth_limit);
+  return (uint32_t)iree_max(1, iree_min(ideal_count, max_tile_count));
+}
+
 iree_status_t iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task,
-    iree_task_submission_t* pending_submission) {
+    iree_task_dispatch_shard_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
+#if IREE_TASK_STATISTICS_ENABLE
+  const iree_time_t start_time_ns = iree_time_now();
+  uint32_t executed_tile_count = 0;
+#endif  // IREE_TASK_STATISTICS_ENABLE
 
   iree_task_dispatch_t* dispatch_task = task->dispatch_task;
   IREE_TRACE_ZONE_SET_COLOR(
@@ -781,6 +893,7 @@ iree_status_t iree_task_dispatch_shard_execute(
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
   tile_context.shared_memory = shared_state->shared_memory;
+  tile_context.local_memory = local_memory;
   uint32_t workgroup_count_x = tile_context.workgroup_count[0];
   uint32_t workgroup_count_y = tile_context.workgroup_count[1];
 
@@ -792,15 +905,27 @@ iree_status_t iree_task_dispatch_shard_execute(
   tile_context.statistics = &shard_statistics;
 
   // Loop over all tiles until they are all processed.
+  // Adaptive shards start with a single tile to observe how long tiles take
+  // and size their following reservations from that.
   const uint32_t tile_count = shared_state->tile_count;
-  const uint32_t tiles_per_reservation = shared_state->tiles_per_reservation;
+  const iree_duration_t reservation_duration_ns =
+      shared_state->reservation_duration_ns;
+  const bool is_adaptive = reservation_duration_ns > 0;
+  uint32_t tiles_per_reservation =
+      is_adaptive ? 1 : shared_state->tiles_per_reservation;
   uint32_t tile_base = iree_atomic_fetch_add_int32(&shared_state->tile_index,
                                                    tiles_per_reservation,
                                                    iree_memory_order_relaxed);
   while (tile_base < tile_count) {
-    const uint32_t next_tile_base = iree_atomic_fetch_add_int32(
-        &shared_state->tile_index, tiles_per_reservation,
-        iree_memory_order_relaxed);
+    uint32_t next_tile_base = 0;
+    iree_time_t reservation_start_ns = 0;
+    if (is_adaptive) {
+      reservation_start_ns = iree_time_now();
+    } else {
+      next_tile_base = iree_atomic_fetch_add_int32(&shared_state->tile_index,
+                                                   tiles_per_reservation,
+                                                   iree_memory_order_relaxed);
+    }
 
     const uint32_t tile_range =
         iree_min(tile_base + tiles_per_reservation, tile_count);
@@ -838,11 +963,27 @@ iree_status_t iree_task_dispatch_shard_execute(
         return status;
       }
     }
-
+#if IREE_TASK_STATISTICS_ENABLE
+    executed_tile_count += tile_range - tile_base;
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
+    if (is_adaptive) {
+      tiles_per_reservation = iree_task_dispatch_shard_size_reservation(
+          reservation_duration_ns, iree_time_now() - reservation_start_ns,
+          tile_range - tile_base, shared_state->tiles_per_reservation);
+      next_tile_base = iree_atomic_fetch_add_int32(&shared_state->tile_index,
+                                                   tiles_per_reservation,
+                                                   iree_memory_order_relaxed);
+    }
     tile_base = next_tile_base;
   }
 
   // Push aggregate statistics up to the dispatch.
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_task_dispatch_statistics_record_shard(&task->header, worker_id,
+                                             executed_tile_count, start_time_ns,
+                                             &shard_statistics);
+#endif  // IREE_TASK_STATISTICS_ENABLE
   iree_task_dispatch_statistics_merge(&shard_statistics,
                                       &dispatch_task->statistics);
 
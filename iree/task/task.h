@@ -13,6 +13,7 @@
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/wait_handle.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/tuning.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -382,11 +383,33 @@ void iree_task_wait_initialize(iree_task_scope_t* scope,
 // If we find ourselves with a lot of hardware-specific counters (vs more
 // generic ones like 'l2 cache misses' or 'ipc') then we can sprinkle in some
 // #ifdefs.
+//
+// NOTE: each counter increases the command buffer storage requirements and the
+// counters are only present when IREE_TASK_STATISTICS_ENABLE is set.
 typedef struct {
-  // TODO(benvanik): statistics counters.
-  // NOTE: each of these increases the command buffer storage requirements; we
-  // should always guard these with a compiler flag.
+#if IREE_TASK_STATISTICS_ENABLE
+  // Total number of dispatches that have retired.
+  iree_atomic_int64_t dispatch_count;
+  // Total number of tiles executed.
+  iree_atomic_int64_t tile_count;
+  // Number of tiles executed by shards (or slices) that were stolen from the
+  // worker they were originally posted to.
+  iree_atomic_int64_t stolen_tile_count;
+  // Total number of shards (or slices) executed.
+  iree_atomic_int64_t shard_count;
+  // Number of shards (or slices) executed by a worker other than the one they
+  // were originally posted to.
+  iree_atomic_int64_t stolen_shard_count;
+  // Wall time in nanoseconds from when each dispatch was issued until its last
+  // shard completed.
+  iree_atomic_int64_t wall_time_ns;
+  // Time in nanoseconds spent executing tiles summed across all workers.
+  // Compare against wall_time_ns multiplied by the worker count to get the
+  // fraction of the workers that were kept busy by the dispatches.
+  iree_atomic_int64_t busy_time_ns;
+#else
   iree_atomic_int32_t reserved;
+#endif  // IREE_TASK_STATISTICS_ENABLE
 } iree_task_dispatch_statistics_t;
 
 // Merges statistics from |source| to |target| atomically per-field.
@@ -428,6 +451,12 @@ typedef iree_alignas(iree_max_align_t) struct {
   // use atomic operations to ensure proper memory ordering.
   iree_byte_span_t shared_memory;
 
+  // Memory local to the worker executing the tile. Aligned to a cache line and
+  // reused by all tiles executed by the worker: contents are undefined on entry
+  // and must not be relied upon across tiles. May be empty if the executor was
+  // created without worker local memory.
+  iree_byte_span_t local_memory;
+
   // Shared statistics counters for the dispatch slice.
   iree_task_dispatch_statistics_t* statistics;
 
@@ -446,10 +475,15 @@ typedef iree_alignas(iree_max_align_t) struct {
   uint32_t tile_count;
 
   // Maximum number of tiles to fetch per tile reservation from the grid.
-  // Bounded by IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION and a
-  // reasonable number chosen based on the tile and shard counts.
+  // Chosen from the dispatch hint or the executor tuning based on the tile and
+  // shard counts.
   uint32_t tiles_per_reservation;
 
+  // Target duration of each reservation when shards adaptively size their
+  // reservations (up to tiles_per_reservation) from the observed tile
+  // execution time or 0 to always reserve tiles_per_reservation tiles.
+  iree_duration_t reservation_duration_ns;
+
   // Incoherent memory shared across all invocations of the task.
   // Aligned to at least the natural pointer size of the machine. Functions must
   // use atomic operations to ensure proper memory ordering.
@@ -534,9 +568,21 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_s {
   // closure.
   uint32_t shared_memory_size;
 
+  // Number of tiles each shard reserves from the grid at a time or 0 to let
+  // the executor decide based on its tuning. Producers that know the cost of
+  // their tiles can use this to override the executor-wide granularity for
+  // individual dispatches: expensive tiles want 1 so that idle workers can
+  // share in the work while very cheap tiles want large reservations.
+  uint32_t tiles_per_reservation;
+
   // Statistics storage used for aggregating counters across all slices.
   iree_task_dispatch_statistics_t statistics;
 
+#if IREE_TASK_STATISTICS_ENABLE
+  // Time the dispatch was issued, used to compute its wall time on retire.
+  iree_time_t issue_time_ns;
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
   // Shared state across all slices/shards/etc.
   // Stored once per dispatch and then referenced by all subtasks.
   union {
@@ -7,6 +7,7 @@
 #ifndef IREE_TASK_TASK_IMPL_H_
 #define IREE_TASK_TASK_IMPL_H_
 
+#include "iree/task/executor.h"
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
@@ -83,22 +84,29 @@ void iree_task_wait_retire(iree_task_wait_t* task,
 // and are generally not user-visible - they'll just see their dispatch begin
 // execution prior to the slices and end execution after the last slice
 // finishes.
+// Slices are sized based on the executor |tuning|.
 //
 // Only called during coordination and expects the coordinator lock to be held.
-void iree_task_dispatch_issue_sliced(iree_task_dispatch_t* dispatch_task,
-                                     iree_task_pool_t* slice_task_pool,
-                                     iree_task_submission_t* pending_submission,
-                                     iree_task_post_batch_t* post_batch);
+void iree_task_dispatch_issue_sliced(
+    iree_task_dispatch_t* dispatch_task,
+    const iree_task_executor_tuning_t* tuning,
+    iree_task_pool_t* slice_task_pool,
+    iree_task_submission_t* pending_submission,
+    iree_task_post_batch_t* post_batch);
 
 // Schedules a dispatch by forking out to zero or more shards that will be
 // executed on workers. The shards are allocated from an executor-owned pool
 // and are generally not user-visible - they'll just see their dispatch begin
 // execution prior to the slices and end execution after the last shard
 // finishes.
+// Shard reservations are sized based on the dispatch hint, if any, and
+// otherwise the executor |tuning|.
 //
 // Only called during coordination and expects the coordinator lock to be held.
 void iree_task_dispatch_issue_sharded(
-    iree_task_dispatch_t* dispatch_task, iree_task_pool_t* shard_task_pool,
+    iree_task_dispatch_t* dispatch_task,
+    const iree_task_executor_tuning_t* tuning,
+    iree_task_pool_t* shard_task_pool,
     iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch);
 
@@ -124,9 +132,13 @@ iree_task_dispatch_slice_t* iree_task_dispatch_slice_allocate(
 // called from threads owned by or donated to the executor.
 // Returns ok if all tiles were successfully executed and otherwise returns
 // an unspecified status (probably the first non-ok status hit).
+//
+// |worker_id| is the index of the worker executing the slice and is used to
+// attribute statistics. |local_memory| is the worker-local memory provided to
+// each tile.
 iree_status_t iree_task_dispatch_slice_execute(
-    iree_task_dispatch_slice_t* task,
-    iree_task_submission_t* pending_submission);
+    iree_task_dispatch_slice_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission);
 
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH_SHARD
@@ -145,9 +157,13 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // Returns ok if all tiles processed in the shard successfully executed and
 // otherwise returns an unspecified status (probably the first non-ok status
 // hit).
+//
+// |worker_id| is the index of the worker executing the shard and is used to
+// attribute statistics. |local_memory| is the worker-local memory provided to
+// each tile.
 iree_status_t iree_task_dispatch_shard_execute(
-    iree_task_dispatch_shard_t* task,
-    iree_task_submission_t* pending_submission);
+    iree_task_dispatch_shard_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <cstring>
 #include <vector>
 
 #include "iree/task/testing/task_test.h"
@@ -62,7 +63,8 @@ class TaskDispatchTest : public TaskTest {
  public:
   void DispatchAndVerifyGrid(const uint32_t workgroup_size[3],
                              const uint32_t workgroup_count[3],
-                             uint32_t dispatch_flags) {
+                             uint32_t dispatch_flags,
+                             uint32_t tiles_per_reservation = 0) {
     GridCoverage coverage(workgroup_count);
     iree_task_dispatch_t task;
     iree_task_dispatch_initialize(&scope_,
@@ -70,6 +72,7 @@ class TaskDispatchTest : public TaskTest {
                                       GridCoverage::Tile, (uintptr_t)&coverage),
                                   workgroup_size, workgroup_count, &task);
     task.header.flags |= dispatch_flags;
+    task.tiles_per_reservation = tiles_per_reservation;
     IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
     EXPECT_TRUE(coverage.Verify());
   }
@@ -127,6 +130,67 @@ TEST_F(TaskDispatchTest, Issue345Sliced) {
                         IREE_TASK_FLAG_DISPATCH_SLICED);
 }
 
+TEST_F(TaskDispatchTest, IssueReservationHint) {
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {31, 4, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0,
+                        /*tiles_per_reservation=*/1);
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0,
+                        /*tiles_per_reservation=*/7);
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0,
+                        /*tiles_per_reservation=*/10000);
+}
+
+TEST_F(TaskDispatchTest, IssueAdaptiveSharded) {
+  iree_task_executor_tuning_t tuning;
+  iree_task_executor_query_tuning(executor_, &tuning);
+  tuning.shard_reservation_duration_ns = 10000;
+  IREE_ASSERT_OK(iree_task_executor_set_tuning(executor_, &tuning));
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {1000, 7, 3};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0);
+  // Explicit hints take precedence over the adaptive mode.
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, 0,
+                        /*tiles_per_reservation=*/3);
+}
+
+TEST_F(TaskDispatchTest, IssueTunedSliced) {
+  iree_task_executor_tuning_t tuning;
+  iree_task_executor_query_tuning(executor_, &tuning);
+  tuning.tiles_per_slice[0] = 2;
+  tuning.tiles_per_slice[1] = 3;
+  tuning.tiles_per_slice[2] = 1;
+  IREE_ASSERT_OK(iree_task_executor_set_tuning(executor_, &tuning));
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 6, 5};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount,
+                        IREE_TASK_FLAG_DISPATCH_SLICED);
+}
+
+TEST_F(TaskDispatchTest, InvalidTuning) {
+  iree_task_executor_tuning_t default_tuning;
+  iree_task_executor_tuning_initialize(&default_tuning);
+  iree_task_executor_tuning_t tuning;
+  iree_task_executor_query_tuning(executor_, &tuning);
+  EXPECT_EQ(0, memcmp(&default_tuning, &tuning, sizeof(tuning)));
+
+  tuning.tiles_per_slice[1] = 0;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        iree_task_executor_set_tuning(executor_, &tuning));
+  tuning = default_tuning;
+  tuning.max_tiles_per_shard_reservation = 0;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        iree_task_executor_set_tuning(executor_, &tuning));
+  tuning = default_tuning;
+  tuning.max_theft_task_count = 0;
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT,
+                        iree_task_executor_set_tuning(executor_, &tuning));
+
+  // Failed updates leave the tuning unchanged.
+  iree_task_executor_query_tuning(executor_, &tuning);
+  EXPECT_EQ(0, memcmp(&default_tuning, &tuning, sizeof(tuning)));
+}
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
   static const uint32_t kWorkgroupCount[3] = {3, 4, 5};
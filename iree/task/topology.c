@@ -15,12 +15,13 @@
 #include "iree/task/tuning.h"
 
 void iree_task_topology_group_initialize(
-    uint8_t group_index, iree_task_topology_group_t* out_group) {
+    uint16_t group_index, iree_task_topology_group_t* out_group) {
   memset(out_group, 0, sizeof(*out_group));
   out_group->group_index = group_index;
   snprintf(out_group->name, IREE_ARRAYSIZE(out_group->name), "worker[%u]",
            group_index);
   iree_thread_affinity_set_any(&out_group->ideal_thread_affinity);
+  out_group->numa_node = IREE_NUMA_NODE_ID_ANY;
   out_group->constructive_sharing_mask = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
 }
 
@@ -66,6 +67,34 @@ const iree_task_topology_group_t* iree_task_topology_get_group(
   return &topology->groups[group_index];
 }
 
+iree_numa_node_id_t iree_task_topology_numa_node(
+    const iree_task_topology_t* topology) {
+  if (!topology->group_count) return IREE_NUMA_NODE_ID_ANY;
+  iree_numa_node_id_t numa_node = topology->groups[0].numa_node;
+  for (iree_host_size_t i = 1; i < topology->group_count; ++i) {
+    if (topology->groups[i].numa_node != numa_node) {
+      return IREE_NUMA_NODE_ID_ANY;
+    }
+  }
+  return numa_node;
+}
+
+iree_task_topology_group_mask_t iree_task_topology_calculate_numa_sharing_mask(
+    const iree_task_topology_t* topology, iree_host_size_t group_index) {
+  iree_task_topology_group_mask_t mask = iree_task_affinity_set_empty();
+  iree_numa_node_id_t numa_node = topology->groups[group_index].numa_node;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    if (i == group_index) continue;
+    iree_numa_node_id_t other_numa_node = topology->groups[i].numa_node;
+    if (numa_node == IREE_NUMA_NODE_ID_ANY ||
+        other_numa_node == IREE_NUMA_NODE_ID_ANY ||
+        numa_node == other_numa_node) {
+      iree_task_affinity_set_insert(&mask, i);
+    }
+  }
+  return mask;
+}
+
 iree_status_t iree_task_topology_push_group(
     iree_task_topology_t* topology, const iree_task_topology_group_t* group) {
   if (topology->group_count + 1 > IREE_ARRAYSIZE(topology->groups)) {
@@ -84,6 +113,7 @@ void iree_task_topology_initialize_from_group_count(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_task_topology_initialize(out_topology);
+  group_count = iree_min(group_count, IREE_ARRAYSIZE(out_topology->groups));
   for (iree_host_size_t i = 0; i < group_count; ++i) {
     iree_task_topology_group_t* group = &out_topology->groups[i];
     iree_task_topology_group_initialize(i, group);
@@ -174,33 +204,35 @@ static void iree_task_topology_set_affinity_from_processor(
 #endif  // cpuinfo-like platform field
 }
 
-// Returns a bitset with all *processors* that share the same |cache|.
-static uint64_t iree_task_topology_calculate_cache_bits(
-    const struct cpuinfo_cache* cache) {
-  if (!cache) return 0;
-  uint64_t mask = 0;
-  for (uint32_t processor_i = 0; processor_i < cache->processor_count;
-       ++processor_i) {
-    uint32_t i = cache->processor_start + processor_i;
-    if (i < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT) {
-      mask |= 1ull << i;
-    }
-  }
-  return mask;
+// Returns the NUMA node of the cpuinfo |processor|.
+static iree_numa_node_id_t iree_task_topology_numa_node_from_processor(
+    const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+  return iree_numa_node_for_processor((uint32_t)processor->linux_id);
+#else
+  // TODO(benvanik): GetNumaProcessorNodeEx on Windows.
+  return 0;
+#endif  // cpuinfo-like platform field
 }
 
-// Constructs a constructive sharing mask for all *processors* that share the
-// same cache as the specified |processor|.
-static uint64_t iree_task_topology_calculate_constructive_sharing_mask(
-    const struct cpuinfo_processor* processor) {
-  uint64_t mask = 0;
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1i);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l1d);
-  mask |= iree_task_topology_calculate_cache_bits(processor->cache.l2);
-  // TODO(benvanik): include L3 here too (for systems that have it)? Or use L3
-  // info purely for distribution and focus the group mask on lower-latency
-  // caches?
-  return mask;
+// Returns true if |a| and |b| are the same cache.
+// cpuinfo deduplicates caches so processors sharing a cache reference the same
+// cpuinfo_cache; NULL indicates the level is not present or not known.
+static bool iree_task_topology_is_same_cache(const struct cpuinfo_cache* a,
+                                             const struct cpuinfo_cache* b) {
+  return a && a == b;
+}
+
+// Returns true if processors |a| and |b| share any level of cache hierarchy.
+// L3 is included as on machines with many cores it is the level that partitions
+// them into complexes (CCXs, clusters, etc) and work stealing across complexes
+// is significantly more expensive than within one.
+static bool iree_task_topology_processors_share_cache(
+    const struct cpuinfo_processor* a, const struct cpuinfo_processor* b) {
+  return iree_task_topology_is_same_cache(a->cache.l1i, b->cache.l1i) ||
+         iree_task_topology_is_same_cache(a->cache.l1d, b->cache.l1d) ||
+         iree_task_topology_is_same_cache(a->cache.l2, b->cache.l2) ||
+         iree_task_topology_is_same_cache(a->cache.l3, b->cache.l3);
 }
 
 // Populates |our_group| with the information from |core|.
@@ -219,6 +251,7 @@ static void iree_task_topology_group_initialize_from_core(
       cpuinfo_get_processor(processor_i);
   iree_task_topology_set_affinity_from_processor(
       processor, &out_group->ideal_thread_affinity);
+  out_group->numa_node = iree_task_topology_numa_node_from_processor(processor);
 }
 
 // Fixes constructive_sharing_mask values such that they represent other chosen
@@ -227,23 +260,22 @@ static void iree_task_topology_group_initialize_from_core(
 // processor IDs a particular group is mapped to.
 static void iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_t* topology) {
-  // O(n^2), but n is always <= 64 (and often <= 8).
+  // O(n^2), but n is always <= IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (and often
+  // <= 8) and this only runs once when the topology is constructed.
   for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
     iree_task_topology_group_t* group = &topology->groups[i];
+    const struct cpuinfo_processor* processor =
+        cpuinfo_get_processor(group->processor_index);
 
-    // Compute the processors that we can constructively share with.
-    uint64_t constructive_sharing_mask =
-        iree_task_topology_calculate_constructive_sharing_mask(
-            cpuinfo_get_processor(group->processor_index));
-
-    iree_task_topology_group_mask_t group_mask = 0;
+    iree_task_topology_group_mask_t group_mask = iree_task_affinity_set_empty();
     for (iree_host_size_t j = 0; j < topology->group_count; ++j) {
       if (i == j) continue;
       const iree_task_topology_group_t* other_group = &topology->groups[j];
-      uint64_t group_processor_bits =
-          iree_math_rotl_u64(1ull, other_group->processor_index);
-      if (constructive_sharing_mask & group_processor_bits) {
-        group_mask |= iree_math_rotl_u64(1ull, other_group->group_index);
+      const struct cpuinfo_processor* other_processor =
+          cpuinfo_get_processor(other_group->processor_index);
+      if (iree_task_topology_processors_share_cache(processor,
+                                                    other_processor)) {
+        iree_task_affinity_set_insert(&group_mask, other_group->group_index);
       }
     }
 
@@ -336,6 +368,27 @@ void iree_task_topology_initialize_from_physical_cores_with_filter(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Matches only cores on the NUMA node specified in |user_data|.
+static bool iree_task_topology_core_filter_numa_node(
+    const struct cpuinfo_core* core, uintptr_t user_data) {
+  return iree_task_topology_numa_node_from_processor(
+             cpuinfo_get_processor(core->processor_start)) ==
+         (iree_numa_node_id_t)user_data;
+}
+
+void iree_task_topology_initialize_from_numa_node(
+    iree_numa_node_id_t node_id, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology) {
+  if (node_id == IREE_NUMA_NODE_ID_ANY) {
+    iree_task_topology_initialize_from_physical_cores(max_core_count,
+                                                      out_topology);
+    return;
+  }
+  iree_task_topology_initialize_from_physical_cores_with_filter(
+      iree_task_topology_core_filter_numa_node, node_id, max_core_count,
+      out_topology);
+}
+
 void iree_task_topology_initialize_from_unique_l2_cache_groups(
     iree_host_size_t max_group_count, iree_task_topology_t* out_topology) {
   if (!iree_task_topology_is_cpuinfo_available() ||
@@ -349,6 +402,7 @@ void iree_task_topology_initialize_from_unique_l2_cache_groups(
 
   iree_host_size_t cache_count = cpuinfo_get_l2_caches_count();
   cache_count = iree_min(cache_count, max_group_count);
+  cache_count = iree_min(cache_count, IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT);
 
   iree_task_topology_initialize(out_topology);
 
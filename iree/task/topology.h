@@ -10,7 +10,9 @@
 #include <limits.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/numa.h"
 #include "iree/base/internal/threading.h"
+#include "iree/task/affinity_set.h"
 #include "iree/task/tuning.h"
 
 #ifdef __cplusplus
@@ -21,11 +23,12 @@ struct cpuinfo_core;
 
 // A bitmask indicating which other groups from 0 to N may constructively share
 // caches. For example, a value of 0b1100 indicates that group 2 and 3 share.
-typedef uint64_t iree_task_topology_group_mask_t;
+// Groups map 1:1 with executor workers and the mask is used directly as the
+// worker affinity set.
+typedef iree_task_affinity_set_t iree_task_topology_group_mask_t;
 
-#define IREE_TASK_TOPOLOGY_GROUP_MASK_ALL UINT64_MAX
-#define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT \
-  (sizeof(iree_task_topology_group_mask_t) * 8)
+#define IREE_TASK_TOPOLOGY_GROUP_MASK_ALL iree_task_affinity_for_any_worker()
+#define IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
 
 // Information about a particular group within the topology.
 // Groups may be of varying levels of granularity even within the same topology
@@ -33,7 +36,7 @@ typedef uint64_t iree_task_topology_group_mask_t;
 typedef struct {
   // Group index within the topology matching a particular bit in
   // iree_task_topology_group_mask_t.
-  uint8_t group_index;
+  uint16_t group_index;
 
   // A name assigned to executor workers used for logging/tracing.
   char name[16];
@@ -46,6 +49,11 @@ typedef struct {
   // allows us to model Simultaneous Multi-Threading (SMT) (aka hyperthreading).
   iree_thread_affinity_t ideal_thread_affinity;
 
+  // NUMA node the processor belongs to or IREE_NUMA_NODE_ID_ANY if unknown.
+  // Workers prefer stealing from other workers on the same node and place their
+  // local memory on the node.
+  iree_numa_node_id_t numa_node;
+
   // A bitmask of other group indices that share some level of the cache
   // hierarchy. Workers of this group are more likely to constructively share
   // some cache levels higher up with these other groups. For example, if the
@@ -55,7 +63,7 @@ typedef struct {
 } iree_task_topology_group_t;
 
 // Initializes |out_group| with a |group_index| derived name.
-void iree_task_topology_group_initialize(uint8_t group_index,
+void iree_task_topology_group_initialize(uint16_t group_index,
                                          iree_task_topology_group_t* out_group);
 
 // Task system topology information used to define the workers within an
@@ -108,6 +116,18 @@ iree_host_size_t iree_task_topology_group_count(
 const iree_task_topology_group_t* iree_task_topology_get_group(
     const iree_task_topology_t* topology, iree_host_size_t group_index);
 
+// Returns the NUMA node all groups in the topology are placed on or
+// IREE_NUMA_NODE_ID_ANY if they span nodes, the topology is empty, or any group
+// has an unknown node.
+iree_numa_node_id_t iree_task_topology_numa_node(
+    const iree_task_topology_t* topology);
+
+// Returns a mask of the groups other than |group_index| that are on the same
+// NUMA node as |group_index|. Groups with an unknown node are considered to be
+// on the same node as all others.
+iree_task_topology_group_mask_t iree_task_topology_calculate_numa_sharing_mask(
+    const iree_task_topology_t* topology, iree_host_size_t group_index);
+
 // Pushes a new group onto the topology set.
 // The provided group data will be copied into the topology structure.
 iree_status_t iree_task_topology_push_group(
@@ -151,6 +171,18 @@ void iree_task_topology_initialize_from_physical_cores_with_filter(
     iree_task_topology_core_filter_t filter_fn, uintptr_t filter_fn_data,
     iree_host_size_t max_core_count, iree_task_topology_t* out_topology);
 
+// Initializes a topology with one group for each physical core in the machine
+// that belongs to the given NUMA |node_id|. Creating one executor per node
+// keeps workers, and the memory they access, local to each node on
+// multi-socket systems.
+//
+// If NUMA information is not available all cores are considered to be on node
+// 0 and this has the same behavior as
+// iree_task_topology_initialize_from_physical_cores.
+void iree_task_topology_initialize_from_numa_node(
+    iree_numa_node_id_t node_id, iree_host_size_t max_core_count,
+    iree_task_topology_t* out_topology);
+
 // Initializes a topology with one group for each unique L2 cache group across
 // all available cores. This optimizes for temporal and spatial cache locality
 // but may suffer from oversubscription if there are other processes trying to
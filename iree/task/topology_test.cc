@@ -143,4 +143,48 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, FromNumaNode) {
+  static constexpr iree_host_size_t kMaxGroupCount = 4;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  iree_task_topology_initialize_from_numa_node(/*node_id=*/0, kMaxGroupCount,
+                                               &topology);
+  EnsureTopologyValid(kMaxGroupCount, &topology);
+  iree_task_topology_deinitialize(&topology);
+}
+
+TEST(TopologyTest, NumaSharing) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  EXPECT_EQ(IREE_NUMA_NODE_ID_ANY, iree_task_topology_numa_node(&topology));
+
+  // Groups 0 and 2 on node 0, 1 and 3 on node 1.
+  for (iree_host_size_t i = 0; i < 4; ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    EXPECT_EQ(IREE_NUMA_NODE_ID_ANY, group.numa_node);
+    group.numa_node = i % 2;
+    IREE_EXPECT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+  EXPECT_EQ(IREE_NUMA_NODE_ID_ANY, iree_task_topology_numa_node(&topology));
+  iree_task_topology_group_mask_t mask =
+      iree_task_topology_calculate_numa_sharing_mask(&topology, 0);
+  EXPECT_EQ(1, iree_task_affinity_set_count_ones(mask));
+  EXPECT_TRUE(iree_task_affinity_set_test(mask, 2));
+  mask = iree_task_topology_calculate_numa_sharing_mask(&topology, 3);
+  EXPECT_EQ(1, iree_task_affinity_set_count_ones(mask));
+  EXPECT_TRUE(iree_task_affinity_set_test(mask, 1));
+
+  // Groups with an unknown node share with everyone.
+  topology.groups[1].numa_node = IREE_NUMA_NODE_ID_ANY;
+  mask = iree_task_topology_calculate_numa_sharing_mask(&topology, 1);
+  EXPECT_EQ(3, iree_task_affinity_set_count_ones(mask));
+
+  // All groups on the same node.
+  for (iree_host_size_t i = 0; i < 4; ++i) topology.groups[i].numa_node = 1;
+  EXPECT_EQ(1, iree_task_topology_numa_node(&topology));
+
+  iree_task_topology_deinitialize(&topology);
+}
+
 }  // namespace
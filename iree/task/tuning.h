@@ -12,10 +12,15 @@ extern "C" {
 #endif  // __cplusplus
 
 // Maximum number of workers that an executor can manage.
-// A 64 worker hard limit is based on us using uint64_t as a bitmask to select
-// workers. It's easy to go smaller (just use fewer bits) if it's known that
-// only <64 will ever be used (such as for devices with 2 cores).
-#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (64)
+// Workers are selected with iree_task_affinity_set_t bitsets that use one
+// 64-bit word per 64 workers and this sizes them along with the fixed arrays in
+// the topology. Each additional word adds 8 bytes to every task and a few
+// instructions to each affinity set operation so it's worth going smaller if
+// it's known that only <=64 will ever be used (such as for devices with 2
+// cores). Raising the limit only requires defining this at build time.
+#if !defined(IREE_TASK_EXECUTOR_MAX_WORKER_COUNT)
+#define IREE_TASK_EXECUTOR_MAX_WORKER_COUNT (256)
+#endif  // !IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
 
 // Initial number of slice tasks that are allocated in the executor pool.
 // Increasing this number will decrease initial allocation storms in cases of
@@ -52,6 +57,10 @@ extern "C" {
 // sources.
 #define IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS (64 - 1)
 
+// NOTE: the theft and dispatch granularity parameters below are only the
+// defaults of iree_task_executor_tuning_t and can be changed per executor at
+// runtime with iree_task_executor_set_tuning.
+
 // Allows for dividing the total number of attempts that a worker will make to
 // steal tasks from other workers. By default all other workers will be
 // attempted while setting this to 2, for example, will try for only half of
@@ -75,8 +84,29 @@ extern "C" {
 // In real-time systems too few tasks is better (slightly more work for much
 // lower variance in execution) while in batch mode systems too many tasks is
 // better (as latencies don't matter so long as throughput is maximized).
-#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT \
-  IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
+#define IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT (64)
+
+// Selects the lock-free Chase-Lev iree_task_deque_t as the implementation of
+// the per-worker iree_task_queue_t instead of the futex-guarded task list.
+//
+// The lock-free queue avoids a lock round-trip on every task pop at the cost of
+// only loosely preserving FIFO order across separate batches of tasks posted to
+// the same worker and a fixed per-worker ring of task pointers (see
+// IREE_TASK_DEQUE_CAPACITY). Prefer it on machines with many cores where
+// thieves frequently contend with queue owners; measure with
+// iree/task/queue_benchmark.
+#if !defined(IREE_TASK_QUEUE_LOCK_FREE)
+#define IREE_TASK_QUEUE_LOCK_FREE 0
+#endif  // !IREE_TASK_QUEUE_LOCK_FREE
+
+// Number of task pointers that can be stored in the lock-free ring of an
+// iree_task_deque_t. Must be a power of two. Tasks pushed beyond this capacity
+// spill into a slower mutex-guarded overflow list that remains stealable.
+//
+// Each worker owns one deque and the ring is stored inline in the worker so
+// this directly contributes to the executor memory footprint:
+//   worker_count * capacity * sizeof(void*)
+#define IREE_TASK_DEQUE_CAPACITY (1024)
 
 // Number of tiles that will be batched into a single slice along each XYZ dim.
 //
@@ -110,6 +140,31 @@ extern "C" {
 // memory).
 #define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
 
+// Target duration of each shard reservation when reservations are sized
+// adaptively from observed tile execution time, or 0 to always use
+// IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION. See
+// iree_task_executor_tuning_t::shard_reservation_duration_ns.
+#define IREE_TASK_DISPATCH_SHARD_RESERVATION_DURATION_NS (0)
+
+// Enables programmatic (non-tracing) task system statistics: per-dispatch tile,
+// shard, and steal counts and timing aggregated into each iree_task_scope_t and
+// per-worker busy time that can be queried from the executor. Each counter adds
+// a clock read or atomic update to the dispatch hot path and increases the size
+// of every dispatch task (and thus command buffer storage) so the statistics
+// are disabled by default.
+#if !defined(IREE_TASK_STATISTICS_ENABLE)
+#define IREE_TASK_STATISTICS_ENABLE 0
+#endif  // !IREE_TASK_STATISTICS_ENABLE
+
+// Enables sampling of hardware performance counters (CPU cycles and retired
+// instructions) around each task executed by a worker when
+// IREE_TASK_STATISTICS_ENABLE is set. Only supported on Linux via
+// perf_event_open; the counters read as zero elsewhere or if the kernel denies
+// access (see /proc/sys/kernel/perf_event_paranoid).
+#if !defined(IREE_TASK_STATISTICS_PERF_COUNTERS)
+#define IREE_TASK_STATISTICS_PERF_COUNTERS 0
+#endif  // !IREE_TASK_STATISTICS_PERF_COUNTERS
+
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
 // TODO(#4017): make per-tile color tracing fast enough to always have on.
@@ -10,23 +10,37 @@
 #include "iree/task/executor_impl.h"
 #include "iree/task/task_impl.h"
 
+#if IREE_TASK_WORKER_PERF_COUNTERS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
+
 static int iree_task_worker_main(iree_task_worker_t* worker);
 
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
+    iree_task_affinity_set_t numa_sharing_mask, iree_byte_span_t local_memory,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
-  out_worker->worker_bit = iree_task_affinity_for_worker(worker_index);
+  out_worker->worker_index = worker_index;
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
-  out_worker->max_theft_attempts =
-      executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
+  out_worker->numa_node = topology_group->numa_node;
+  out_worker->numa_sharing_mask = numa_sharing_mask;
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
+  out_worker->local_memory = local_memory;
+  iree_numa_bind_memory(local_memory.data, local_memory.data_length,
+                        out_worker->numa_node);
+#if IREE_TASK_WORKER_PERF_COUNTERS
+  out_worker->perf_cycle_fd = -1;
+  out_worker->perf_instruction_fd = -1;
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   if (executor->scheduling_mode &
@@ -43,7 +57,11 @@ iree_status_t iree_task_worker_initialize(
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
-  iree_task_queue_initialize(&out_worker->local_task_queue);
+  iree_atomic_store_int32(&out_worker->mailbox_pending, 0,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int32(&out_worker->queue_depth_hint, 0,
+                          iree_memory_order_relaxed);
+  iree_task_priority_queue_initialize(&out_worker->local_task_queue);
 
   iree_thread_create_params_t thread_params;
   memset(&thread_params, 0, sizeof(thread_params));
@@ -88,12 +106,11 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
+  iree_task_priority_queue_deinitialize(&worker->local_task_queue);
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
-  iree_task_queue_deinitialize(&worker->local_task_queue);
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -135,16 +152,17 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
   // is concatenated with its current order preserved (which should be LIFO).
   iree_atomic_task_slist_concat(&worker->mailbox_slist, list->head, list->tail);
   memset(list, 0, sizeof(*list));
+  iree_atomic_store_int32(&worker->mailbox_pending, 1,
+                          iree_memory_order_release);
 }
 
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks) {
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker, iree_task_priority_queue_t* target_queue,
+    iree_host_size_t max_tasks) {
   // Try to grab tasks from the worker; if more than one task is stolen then the
   // first will be returned and the remaining will be added to the target queue.
-  iree_task_t* task = iree_task_queue_try_steal(
-      &worker->local_task_queue, target_queue,
-      /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
+  iree_task_t* task = iree_task_priority_queue_try_steal(
+      &worker->local_task_queue, target_queue, max_tasks);
   if (task) return task;
 
   // If we still didn't steal any tasks then let's try the slist instead.
@@ -154,12 +172,113 @@ iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
   return NULL;
 }
 
-// Executes a task on a worker.
-// Only task types that are scheduled to workers are handled; all others must be
-// handled by the coordinator during scheduling.
-static iree_status_t iree_task_worker_execute(
-    iree_task_worker_t* worker, iree_task_t* task,
-    iree_task_submission_t* pending_submission) {
+//===----------------------------------------------------------------------===//
+// Worker statistics
+//===----------------------------------------------------------------------===//
+
+#if IREE_TASK_WORKER_PERF_COUNTERS
+
+// Opens a hardware counter for the calling thread on whichever CPU it runs.
+// Returns -1 if the counter is unavailable (unsupported or denied).
+static int iree_task_worker_perf_event_open(uint64_t config) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return (int)syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                      /*group_fd=*/-1, /*flags=*/0);
+}
+
+static int64_t iree_task_worker_perf_event_read(int fd) {
+  uint64_t value = 0;
+  if (fd < 0 || read(fd, &value, sizeof(value)) != sizeof(value)) return 0;
+  return (int64_t)value;
+}
+
+static void iree_task_worker_perf_event_close(int* fd) {
+  if (*fd >= 0) close(*fd);
+  *fd = -1;
+}
+
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
+
+#if IREE_TASK_STATISTICS_ENABLE
+
+// A point-in-time sample of the worker counters.
+typedef struct {
+  iree_time_t time_ns;
+  int64_t cycle_count;
+  int64_t instruction_count;
+} iree_task_worker_sample_t;
+
+static void iree_task_worker_sample(iree_task_worker_t* worker,
+                                    iree_task_worker_sample_t* out_sample) {
+  out_sample->time_ns = iree_time_now();
+#if IREE_TASK_WORKER_PERF_COUNTERS
+  out_sample->cycle_count =
+      iree_task_worker_perf_event_read(worker->perf_cycle_fd);
+  out_sample->instruction_count =
+      iree_task_worker_perf_event_read(worker->perf_instruction_fd);
+#else
+  out_sample->cycle_count = 0;
+  out_sample->instruction_count = 0;
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
+}
+
+// Accumulates the counters since |start_sample| into the worker statistics.
+static void iree_task_worker_record_task(
+    iree_task_worker_t* worker, const iree_task_worker_sample_t* start_sample,
+    bool is_stolen) {
+  iree_task_worker_sample_t end_sample;
+  iree_task_worker_sample(worker, &end_sample);
+  iree_atomic_fetch_add_int64(&worker->statistics.task_count, 1,
+                              iree_memory_order_relaxed);
+  if (is_stolen) {
+    iree_atomic_fetch_add_int64(&worker->statistics.steal_count, 1,
+                                iree_memory_order_relaxed);
+  }
+  iree_atomic_fetch_add_int64(&worker->statistics.busy_time_ns,
+                              end_sample.time_ns - start_sample->time_ns,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(
+      &worker->statistics.cycle_count,
+      end_sample.cycle_count - start_sample->cycle_count,
+      iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(
+      &worker->statistics.instruction_count,
+      end_sample.instruction_count - start_sample->instruction_count,
+      iree_memory_order_relaxed);
+}
+
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
+void iree_task_worker_consume_statistics(
+    iree_task_worker_t* worker, iree_task_worker_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+#if IREE_TASK_STATISTICS_ENABLE
+  out_statistics->task_count = iree_atomic_exchange_int64(
+      &worker->statistics.task_count, 0, iree_memory_order_relaxed);
+  out_statistics->steal_count = iree_atomic_exchange_int64(
+      &worker->statistics.steal_count, 0, iree_memory_order_relaxed);
+  out_statistics->busy_time_ns = iree_atomic_exchange_int64(
+      &worker->statistics.busy_time_ns, 0, iree_memory_order_relaxed);
+  out_statistics->cycle_count = iree_atomic_exchange_int64(
+      &worker->statistics.cycle_count, 0, iree_memory_order_relaxed);
+  out_statistics->instruction_count = iree_atomic_exchange_int64(
+      &worker->statistics.instruction_count, 0, iree_memory_order_relaxed);
+#endif  // IREE_TASK_STATISTICS_ENABLE
+}
+
+//===----------------------------------------------------------------------===//
+// Worker main loop
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_task_worker_execute_task(
+    iree_task_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission) {
   // Execute the task and resolve the task and gather any tasks that are now
   // ready for submission to the executor. They'll be scheduled the next time
   // the coordinator runs.
@@ -176,12 +295,14 @@ static iree_status_t iree_task_worker_execute(
     }
     case IREE_TASK_TYPE_DISPATCH_SLICE: {
       IREE_RETURN_IF_ERROR(iree_task_dispatch_slice_execute(
-          (iree_task_dispatch_slice_t*)task, pending_submission));
+          (iree_task_dispatch_slice_t*)task, worker_id, local_memory,
+          pending_submission));
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
       IREE_RETURN_IF_ERROR(iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, pending_submission));
+          (iree_task_dispatch_shard_t*)task, worker_id, local_memory,
+          pending_submission));
       break;
     }
     default:
@@ -195,6 +316,15 @@ static iree_status_t iree_task_worker_execute(
   return iree_ok_status();
 }
 
+// Executes a task on a worker.
+static iree_status_t iree_task_worker_execute(
+    iree_task_worker_t* worker, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  return iree_task_worker_execute_task(task, worker->worker_index,
+                                       worker->local_memory,
+                                       pending_submission);
+}
+
 // Pumps the worker thread once, processing a single task.
 // Returns true if pumping should continue as there are more tasks remaining or
 // false if the caller should wait for more tasks to be posted.
@@ -202,10 +332,23 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Check the local work queue for any work we know we should start
-  // processing immediately. Other workers may try to steal some of this work
-  // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
+  // If new work has been posted since we last checked then move it into our
+  // local queues first so that it is ordered by priority with what we already
+  // have; otherwise a high-priority task could wait behind an arbitrarily
+  // long list of low-priority ones.
+  iree_task_t* task = NULL;
+  if (iree_atomic_load_int32(&worker->mailbox_pending,
+                             iree_memory_order_relaxed)) {
+    iree_atomic_store_int32(&worker->mailbox_pending, 0,
+                            iree_memory_order_relaxed);
+    task = iree_task_priority_queue_flush_from_lifo_slist(
+        &worker->local_task_queue, &worker->mailbox_slist);
+  } else {
+    // Check the local work queue for any work we know we should start
+    // processing immediately. Other workers may try to steal some of this work
+    // if we take too long.
+    task = iree_task_priority_queue_pop_front(&worker->local_task_queue);
+  }
 
   // Check the mailbox to see if we have incoming work that has been posted.
   // We try to greedily move it to our local work list so that we can work
@@ -217,19 +360,30 @@ static bool iree_task_worker_pump_once(
     // first place (large uneven workloads for various workers, bad distribution
     // in the face of heterogenous multi-core architectures where some workers
     // complete tasks faster than others, etc).
-    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
-                                                 &worker->mailbox_slist);
+    task = iree_task_priority_queue_flush_from_lifo_slist(
+        &worker->local_task_queue, &worker->mailbox_slist);
+  }
+
+  // Everything posted to us has been executed or stolen; resynchronize the
+  // load hint so that drift from theft doesn't accumulate.
+  if (!task) {
+    iree_atomic_store_int32(&worker->queue_depth_hint, 0,
+                            iree_memory_order_relaxed);
   }
 
   // If we ran out of work assigned to this specific worker try to steal some
   // from other workers that we hopefully share some of the cache hierarchy
   // with. Their tasks will be moved from their local queue into ours and the
   // the first task in the queue is popped off and returned.
+  bool is_stolen = false;
   if (!task) {
+    uint32_t max_theft_attempts = (uint32_t)iree_atomic_load_int32(
+        &worker->executor->max_theft_attempts, iree_memory_order_relaxed);
     task = iree_task_executor_try_steal_task(
         worker->executor, worker->constructive_sharing_mask,
-        worker->max_theft_attempts, &worker->theft_prng,
+        worker->numa_sharing_mask, max_theft_attempts, &worker->theft_prng,
         &worker->local_task_queue);
+    is_stolen = task != NULL;
   }
 
   // No tasks to run; let the caller know we want to wait for more.
@@ -240,8 +394,19 @@ static bool iree_task_worker_pump_once(
 
   // Execute the task (may call out to arbitrary user code and may submit more
   // tasks for execution).
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_task_worker_sample_t start_sample;
+  iree_task_worker_sample(worker, &start_sample);
+#endif  // IREE_TASK_STATISTICS_ENABLE
   iree_status_t status =
       iree_task_worker_execute(worker, task, pending_submission);
+  iree_atomic_fetch_sub_int32(&worker->queue_depth_hint, 1,
+                              iree_memory_order_relaxed);
+#if IREE_TASK_STATISTICS_ENABLE
+  iree_task_worker_record_task(worker, &start_sample, is_stolen);
+#else
+  (void)is_stolen;
+#endif  // IREE_TASK_STATISTICS_ENABLE
 
   // TODO(#4026): propagate failure to task scope.
   // We currently drop the error on the floor here; that's because the error
@@ -271,9 +436,9 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // structures we use.
     iree_wait_token_t wait_token =
         iree_notification_prepare_wait(&worker->wake_notification);
-    iree_atomic_task_affinity_set_fetch_and(&worker->executor->worker_idle_mask,
-                                            ~worker->worker_bit,
-                                            iree_memory_order_seq_cst);
+    iree_atomic_task_affinity_set_erase(&worker->executor->worker_idle_mask,
+                                        worker->worker_index,
+                                        iree_memory_order_seq_cst);
 
     // Check state to see if we've been asked to exit.
     if (iree_atomic_load_int32(&worker->state, iree_memory_order_seq_cst) ==
@@ -301,9 +466,9 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // We've finished all the work we have scheduled so set our idle flag.
     // This ensures that if any other thread comes in and wants to give us
     // work we will properly coordinate/wake below.
-    iree_atomic_task_affinity_set_fetch_or(&worker->executor->worker_idle_mask,
-                                           worker->worker_bit,
-                                           iree_memory_order_seq_cst);
+    iree_atomic_task_affinity_set_insert(&worker->executor->worker_idle_mask,
+                                         worker->worker_index,
+                                         iree_memory_order_seq_cst);
 
     // When we encounter a complete lack of work we can self-nominate to check
     // the global work queue and distribute work to other threads. Only one
@@ -320,7 +485,7 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // coordination didn't find anything) we go idle. Otherwise we fall
     // through and try the loop again.
     if (schedule_dirty ||
-        !iree_task_queue_is_empty(&worker->local_task_queue)) {
+        !iree_task_priority_queue_is_empty(&worker->local_task_queue)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
     } else {
@@ -352,8 +517,22 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
                                  iree_memory_order_seq_cst) !=
       IREE_TASK_WORKER_STATE_EXITING;
   if (IREE_LIKELY(should_run)) {
+#if IREE_TASK_WORKER_PERF_COUNTERS
+    // Counters must be opened from the worker thread as they count only the
+    // thread that opens them.
+    worker->perf_cycle_fd =
+        iree_task_worker_perf_event_open(PERF_COUNT_HW_CPU_CYCLES);
+    worker->perf_instruction_fd =
+        iree_task_worker_perf_event_open(PERF_COUNT_HW_INSTRUCTIONS);
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
+
     // << work happens here >>
     iree_task_worker_pump_until_exit(worker);
+
+#if IREE_TASK_WORKER_PERF_COUNTERS
+    iree_task_worker_perf_event_close(&worker->perf_cycle_fd);
+    iree_task_worker_perf_event_close(&worker->perf_instruction_fd);
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
   }
 
   IREE_TRACE_ZONE_END(thread_zone);
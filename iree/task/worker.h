@@ -7,6 +7,7 @@
 #ifndef IREE_TASK_WORKER_H_
 #define IREE_TASK_WORKER_H_
 
+#include "iree/base/internal/numa.h"
 #include "iree/base/internal/prng.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/base/internal/threading.h"
@@ -21,6 +22,14 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Hardware performance counters are sampled with perf_event_open.
+#if IREE_TASK_STATISTICS_ENABLE && IREE_TASK_STATISTICS_PERF_COUNTERS && \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_TASK_WORKER_PERF_COUNTERS 1
+#else
+#define IREE_TASK_WORKER_PERF_COUNTERS 0
+#endif  // IREE_TASK_STATISTICS_PERF_COUNTERS && IREE_PLATFORM_LINUX
+
 // Indicates the current state of a worker or, in the case of EXITING, the state
 // the worker should transition to.
 //
@@ -61,6 +70,20 @@ typedef struct iree_task_worker_s {
   // LAYOUT: must be 64b away from local_task_queue.
   iree_atomic_task_slist_t mailbox_slist;
 
+  // Set when tasks are posted to mailbox_slist and cleared by the worker when
+  // it flushes the mailbox. Checked by the worker before each task so that
+  // newly posted higher-priority tasks are ordered ahead of queued ones.
+  // LAYOUT: next to mailbox_slist as posters touch both.
+  iree_atomic_int32_t mailbox_pending;
+
+  // Approximate number of tasks posted to the worker that it has not yet
+  // executed. Incremented by posters, decremented by the worker as it executes
+  // tasks and reset when it runs out of work. Tasks stolen by other workers
+  // are not accounted for so this may transiently be over (or, on the thief,
+  // under) the real depth and must only be used as a load-balancing hint.
+  // LAYOUT: next to mailbox_slist as posters touch both.
+  iree_atomic_int32_t queue_depth_hint;
+
   // Current state of the worker (iree_task_worker_state_t).
   // LAYOUT: frequent access; next to wake_notification as they are always
   //         accessed together.
@@ -79,8 +102,9 @@ typedef struct iree_task_worker_s {
   // pool. Executors always outlive the workers they own.
   iree_task_executor_t* executor;
 
-  // Bit the worker represents in the various worker bitsets.
-  iree_task_affinity_set_t worker_bit;
+  // Index of the worker in the executor and the bit it represents in the
+  // various worker bitsets.
+  iree_host_size_t worker_index;
 
   // Ideal thread affinity for the worker thread.
   iree_thread_affinity_t ideal_thread_affinity;
@@ -92,10 +116,13 @@ typedef struct iree_task_worker_s {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
-  // Maximum number of attempts to make when trying to steal tasks from other
-  // workers. This could be 64 (try stealing from all workers) or just a handful
-  // (try stealing from these 3 other cores that share your L3 cache).
-  uint32_t max_theft_attempts;
+  // NUMA node the worker is placed on or IREE_NUMA_NODE_ID_ANY if unknown.
+  iree_numa_node_id_t numa_node;
+
+  // A bitmask of other workers on the same NUMA node. Stealing from these is
+  // preferred over workers on other nodes as their tasks are more likely to be
+  // operating on memory local to this worker's node.
+  iree_task_affinity_set_t numa_sharing_mask;
 
   // Rotation counter for work stealing (ensures we don't favor one victim).
   // Only ever touched by the worker thread as it steals work.
@@ -105,6 +132,28 @@ typedef struct iree_task_worker_s {
   // remain valid so that the executor can query its state.
   iree_thread_t* thread;
 
+  // Worker-local memory provided to each tile executed by the worker.
+  // Allocated by the executor and aligned to a cache line. May be empty.
+  iree_byte_span_t local_memory;
+
+#if IREE_TASK_STATISTICS_ENABLE
+  // Statistics accumulated by the worker thread as it executes tasks and
+  // consumed by iree_task_executor_consume_worker_statistics from any thread.
+  struct {
+    iree_atomic_int64_t task_count;
+    iree_atomic_int64_t steal_count;
+    iree_atomic_int64_t busy_time_ns;
+    iree_atomic_int64_t cycle_count;
+    iree_atomic_int64_t instruction_count;
+  } statistics;
+#if IREE_TASK_WORKER_PERF_COUNTERS
+  // perf_event_open file descriptors counting on the worker thread or -1 if
+  // unavailable. Only touched by the worker thread.
+  int perf_cycle_fd;
+  int perf_instruction_fd;
+#endif  // IREE_TASK_WORKER_PERF_COUNTERS
+#endif  // IREE_TASK_STATISTICS_ENABLE
+
   // Destructive interference padding between the mailbox and local task queue
   // to ensure that the worker - who is pounding on local_task_queue - doesn't
   // contend with submissions or coordinators dropping new tasks in the mailbox.
@@ -114,11 +163,12 @@ typedef struct iree_task_worker_s {
   // stuff above, but it'd be nice to guarantee it.
   uint8_t _padding[8];
 
-  // Worker-local FIFO queue containing the slices that will be processed by the
-  // worker. This queue supports work-stealing by other workers if they run out
-  // of work of their own.
+  // Worker-local FIFO queues (one per scope priority) containing the slices
+  // that will be processed by the worker. Higher-priority queues are always
+  // drained first. This queue supports work-stealing by other workers if they
+  // run out of work of their own.
   // LAYOUT: must be 64b away from mailbox_slist.
-  iree_task_queue_t local_task_queue;
+  iree_task_priority_queue_t local_task_queue;
 } iree_task_worker_t;
 static_assert(offsetof(iree_task_worker_t, mailbox_slist) +
                       sizeof(iree_atomic_task_slist_t) <
@@ -133,9 +183,13 @@ static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
 // tasks. Where supported the worker will be created in a suspended state so
 // that we aren't creating a thundering herd on startup:
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
+//
+// |local_memory| is owned by the executor and must remain valid for the
+// lifetime of the worker.
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
+    iree_task_affinity_set_t numa_sharing_mask, iree_byte_span_t local_memory,
     iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
 
 // Deinitializes a worker that has successfully exited. The worker must be in
@@ -158,12 +212,32 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
 
 // Tries to steal up to |max_tasks| from the back of the queue.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
-// that were at the tail of the worker FIFO will be moved to the |target_queue|
-// and the first of the stolen tasks is returned. While tasks from the FIFO
-// are preferred this may also steal tasks from the mailbox.
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks);
+// that were at the tail of the highest-priority non-empty worker FIFO will be
+// moved to the |target_queue| and the first of the stolen tasks is returned.
+// While tasks from the FIFO are preferred this may also steal tasks from the
+// mailbox.
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker, iree_task_priority_queue_t* target_queue,
+    iree_host_size_t max_tasks);
+
+// Executes |task| on the calling thread as worker |worker_id| using
+// |local_memory| as the worker-local scratch memory. Only task types that are
+// scheduled to workers are handled; all others must be handled by the
+// coordinator during scheduling. Any tasks readied by the execution are added
+// to |pending_submission|.
+//
+// Used by workers and by caller threads donated to the executor; donated
+// threads use a |worker_id| outside of the range of the executor workers.
+iree_status_t iree_task_worker_execute_task(
+    iree_task_t* task, iree_host_size_t worker_id,
+    iree_byte_span_t local_memory, iree_task_submission_t* pending_submission);
+
+// Returns and resets the statistics accumulated by |worker|.
+// The statistics are all zero unless IREE_TASK_STATISTICS_ENABLE is set.
+//
+// May be called from any thread.
+void iree_task_worker_consume_statistics(
+    iree_task_worker_t* worker, iree_task_worker_statistics_t* out_statistics);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -116,16 +116,18 @@ void RegisterModuleBenchmarks(const std::string& function_name,
       ->Unit(benchmark::kMillisecond);
 }
 
-iree_status_t GetModuleContentsFromFlags(std::string* out_contents) {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
+// Loads the module specified by flags. Modules read from stdin are stored in
+// |out_contents|, which must outlive |out_module|; files are mapped.
+iree_status_t LoadModuleFromFlags(std::string* out_contents,
+                                  iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("LoadModuleFromFlags");
   auto module_file = std::string(FLAG_module_file);
   if (module_file == "-") {
     *out_contents = std::string{std::istreambuf_iterator<char>(std::cin),
                                 std::istreambuf_iterator<char>()};
-  } else {
-    IREE_RETURN_IF_ERROR(GetFileContents(module_file.c_str(), out_contents));
+    return LoadBytecodeModule(*out_contents, out_module);
   }
-  return iree_ok_status();
+  return LoadBytecodeModuleFromFile(module_file.c_str(), out_module);
 }
 
 // TODO(hanchung): Consider to refactor this out and reuse in iree-run-module.
@@ -171,8 +173,6 @@ class IREEBenchmark {
     IREE_TRACE_SCOPE0("IREEBenchmark::Init");
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
 
-    IREE_RETURN_IF_ERROR(GetModuleContentsFromFlags(&module_data_));
-
     IREE_RETURN_IF_ERROR(iree_hal_module_register_types());
     IREE_RETURN_IF_ERROR(
         iree_vm_instance_create(iree_allocator_system(), &instance_));
@@ -180,7 +180,7 @@ class IREEBenchmark {
     // Create IREE's device and module.
     IREE_RETURN_IF_ERROR(iree::CreateDevice(FLAG_driver, &device_));
     IREE_RETURN_IF_ERROR(CreateHalModule(device_, &hal_module_));
-    IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data_, &input_module_));
+    IREE_RETURN_IF_ERROR(LoadModuleFromFlags(&module_data_, &input_module_));
 
     // Order matters. The input module will likely be dependent on the hal
     // module.
@@ -82,17 +82,16 @@ iree_status_t Run(std::string module_file_path, int* out_exit_code) {
       "creating instance");
 
   std::string module_data;
+  iree_vm_module_t* input_module = nullptr;
   if (module_file_path == "-") {
     module_data = std::string{std::istreambuf_iterator<char>(std::cin),
                               std::istreambuf_iterator<char>()};
+    IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
   } else {
     IREE_RETURN_IF_ERROR(
-        GetFileContents(module_file_path.c_str(), &module_data));
+        LoadBytecodeModuleFromFile(module_file_path.c_str(), &input_module));
   }
 
-  iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
-
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(FLAG_driver, &device));
   iree_vm_module_t* hal_module = nullptr;
@@ -61,16 +61,18 @@ IREE_FLAG_CALLBACK(
 namespace iree {
 namespace {
 
-iree_status_t GetModuleContentsFromFlags(std::string* out_contents) {
-  IREE_TRACE_SCOPE0("GetModuleContentsFromFlags");
+// Loads the module specified by flags. Modules read from stdin are stored in
+// |out_contents|, which must outlive |out_module|; files are mapped.
+iree_status_t LoadModuleFromFlags(std::string* out_contents,
+                                  iree_vm_module_t** out_module) {
+  IREE_TRACE_SCOPE0("LoadModuleFromFlags");
   auto module_file = std::string(FLAG_module_file);
   if (module_file == "-") {
     *out_contents = std::string{std::istreambuf_iterator<char>(std::cin),
                                 std::istreambuf_iterator<char>()};
-  } else {
-    IREE_RETURN_IF_ERROR(GetFileContents(module_file.c_str(), out_contents));
+    return LoadBytecodeModule(*out_contents, out_module);
   }
-  return iree_ok_status();
+  return LoadBytecodeModuleFromFile(module_file.c_str(), out_module);
 }
 
 iree_status_t Run() {
@@ -84,9 +86,8 @@ iree_status_t Run() {
       "creating instance");
 
   std::string module_data;
-  IREE_RETURN_IF_ERROR(GetModuleContentsFromFlags(&module_data));
   iree_vm_module_t* input_module = nullptr;
-  IREE_RETURN_IF_ERROR(LoadBytecodeModule(module_data, &input_module));
+  IREE_RETURN_IF_ERROR(LoadModuleFromFlags(&module_data, &input_module));
 
   iree_hal_device_t* device = nullptr;
   IREE_RETURN_IF_ERROR(CreateDevice(FLAG_driver, &device));
@@ -219,4 +219,21 @@ Status LoadBytecodeModule(absl::string_view module_data,
       "deserializing module");
   return OkStatus();
 }
+
+Status LoadBytecodeModuleFromFile(const char* path,
+                                  iree_vm_module_t** out_module) {
+  iree_const_byte_span_t module_data;
+  iree_allocator_t module_deallocator;
+  IREE_RETURN_IF_ERROR(iree_file_map_contents(path, iree_allocator_system(),
+                                              &module_data,
+                                              &module_deallocator));
+  iree_status_t status = iree_vm_bytecode_module_create_with_flags(
+      module_data, IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION,
+      module_deallocator, iree_allocator_system(), out_module);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(module_deallocator, (void*)module_data.data);
+    return iree_status_annotate_f(status, "deserializing module '%s'", path);
+  }
+  return OkStatus();
+}
 }  // namespace iree
@@ -66,6 +66,13 @@ Status CreateHalModule(iree_hal_device_t* device,
 Status LoadBytecodeModule(absl::string_view module_data,
                           iree_vm_module_t** out_module);
 
+// Loads a VM bytecode module from the file at |path|.
+// The file is mapped into memory when supported so that only the portions of
+// the module that are used are read and rodata is verified lazily.
+// The returned |out_module| must be released by the caller.
+Status LoadBytecodeModuleFromFile(const char* path,
+                                  iree_vm_module_t** out_module);
+
 }  // namespace iree
 
 #endif  // IREE_TOOLS_UTILS_VM_UTIL_H_
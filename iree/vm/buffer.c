@@ -83,6 +83,53 @@ IREE_API_EXPORT void iree_vm_buffer_deinitialize(iree_vm_buffer_t* buffer) {
   iree_allocator_free(buffer->allocator, buffer->data.data);
 }
 
+static void IREE_API_PTR iree_vm_buffer_module_data_free(void* self,
+                                                         void* ptr) {
+  // Module memory is owned by the module and freed when it is destroyed.
+}
+
+IREE_API_EXPORT iree_allocator_t
+iree_vm_buffer_module_data_allocator(iree_vm_module_t* module) {
+  iree_allocator_t allocator = {
+      .self = module,
+      .alloc = NULL,
+      .free = iree_vm_buffer_module_data_free,
+  };
+  return allocator;
+}
+
+static void IREE_API_PTR iree_vm_buffer_release_module_storage(void* self,
+                                                               void* ptr) {
+  iree_vm_module_release((iree_vm_module_t*)self);
+}
+
+static void IREE_API_PTR iree_vm_buffer_release_guest_storage(void* self,
+                                                              void* ptr) {
+  iree_vm_buffer_release((iree_vm_buffer_t*)self);
+}
+
+IREE_API_EXPORT bool iree_vm_buffer_retain_storage(
+    iree_vm_buffer_t* buffer, iree_allocator_t* out_release_allocator) {
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_ASSERT_ARGUMENT(out_release_allocator);
+  *out_release_allocator = iree_allocator_null();
+  if (iree_all_bits_set(buffer->access, IREE_VM_BUFFER_ACCESS_ORIGIN_GUEST)) {
+    iree_vm_buffer_retain(buffer);
+    out_release_allocator->self = buffer;
+    out_release_allocator->free = iree_vm_buffer_release_guest_storage;
+    return true;
+  } else if (iree_all_bits_set(buffer->access,
+                               IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE) &&
+             buffer->allocator.free == iree_vm_buffer_module_data_free) {
+    iree_vm_module_t* module = (iree_vm_module_t*)buffer->allocator.self;
+    iree_vm_module_retain(module);
+    out_release_allocator->self = module;
+    out_release_allocator->free = iree_vm_buffer_release_module_storage;
+    return true;
+  }
+  return false;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_buffer_create(
     iree_vm_buffer_access_t access, iree_host_size_t length,
     iree_allocator_t allocator, iree_vm_buffer_t** out_buffer) {
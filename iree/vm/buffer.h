@@ -8,6 +8,7 @@
 #define IREE_VM_BUFFER_H_
 
 #include "iree/base/api.h"
+#include "iree/vm/module.h"
 #include "iree/vm/ref.h"
 
 #ifdef __cplusplus
@@ -23,7 +24,9 @@ enum iree_vm_buffer_access_e {
   IREE_VM_BUFFER_ACCESS_MUTABLE = 1u << 0,
 
   // Buffer references memory in the module space (rodata or rwdata) that is
-  // guaranteed to be live for the lifetime of the module.
+  // guaranteed to be live for the lifetime of the module. Buffers initialized
+  // with iree_vm_buffer_module_data_allocator know their module and their
+  // storage can be retained with iree_vm_buffer_retain_storage.
   IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE = 1u << 1,
   // Buffer references memory created by the guest module code. It has a
   // lifetime less than that of the module but is always tracked with proper
@@ -88,6 +91,26 @@ IREE_API_EXPORT void iree_vm_buffer_initialize(iree_vm_buffer_access_t access,
 // remaining.
 IREE_API_EXPORT void iree_vm_buffer_deinitialize(iree_vm_buffer_t* buffer);
 
+// Returns an allocator for use with iree_vm_buffer_initialize on buffers
+// referencing memory owned by |module| (IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE).
+// The data is not freed when the buffer is deinitialized and |module| must
+// outlive the buffer.
+IREE_API_EXPORT iree_allocator_t
+iree_vm_buffer_module_data_allocator(iree_vm_module_t* module);
+
+// Retains the storage referenced by |buffer| such that its data remains valid
+// after the buffer itself has been released or deinitialized. This allows the
+// contents to be aliased without copying (such as by HAL buffers wrapping
+// them). |out_release_allocator| receives an allocator that releases the
+// storage when its free is called with the buffer data pointer.
+//
+// Guest buffers retain themselves and module buffers retain their module.
+// Returns false if the lifetime of the storage is unknown (host memory or
+// module memory initialized without iree_vm_buffer_module_data_allocator) and
+// the contents must be copied instead.
+IREE_API_EXPORT bool iree_vm_buffer_retain_storage(
+    iree_vm_buffer_t* buffer, iree_allocator_t* out_release_allocator);
+
 // Creates a new zero-initialized buffer of the given byte |length|.
 // The underlying storage buffer may be allocated larger to ensure alignment.
 // The allocated data will be aligned to iree_max_align_t.
@@ -23,12 +23,13 @@
 // This assumes that the remapping list is properly ordered such that there are
 // no swapping hazards (such as 0->1,1->0). The register allocator in the
 // compiler should ensure this is the case when it can occur.
-static void iree_vm_bytecode_dispatch_remap_branch_registers(
+//
+// iree_vm_BytecodeVersionDef_V0 modules interleave i32 and ref registers in a
+// single list and are remapped by checking the register type of every pair.
+static void iree_vm_bytecode_dispatch_remap_branch_registers_v0(
     const iree_vm_registers_t regs,
-    const iree_vm_register_remap_list_t* IREE_RESTRICT remap_list) {
+    const iree_vm_register_remap_list_v0_t* IREE_RESTRICT remap_list) {
   for (int i = 0; i < remap_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
     uint16_t src_reg = remap_list->pairs[i].src_reg;
     uint16_t dst_reg = remap_list->pairs[i].dst_reg;
     if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
@@ -41,6 +42,28 @@ static void iree_vm_bytecode_dispatch_remap_branch_registers(
   }
 }
 
+static void iree_vm_bytecode_dispatch_remap_branch_registers(
+    uint32_t bytecode_version, const iree_vm_registers_t regs,
+    const iree_vm_register_remap_list_t* IREE_RESTRICT remap_list) {
+  if (IREE_UNLIKELY(bytecode_version == iree_vm_BytecodeVersionDef_V0)) {
+    iree_vm_bytecode_dispatch_remap_branch_registers_v0(
+        regs, (const iree_vm_register_remap_list_v0_t*)remap_list);
+    return;
+  }
+  const struct pair* IREE_RESTRICT pairs = remap_list->pairs;
+  for (int i = 0; i < remap_list->i32_size; ++i) {
+    regs.i32[pairs[i].dst_reg & regs.i32_mask] =
+        regs.i32[pairs[i].src_reg & regs.i32_mask];
+  }
+  pairs += remap_list->i32_size;
+  for (int i = 0; i < remap_list->ref_size; ++i) {
+    uint16_t src_reg = pairs[i].src_reg;
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &regs.ref[src_reg & regs.ref_mask],
+                               &regs.ref[pairs[i].dst_reg & regs.ref_mask]);
+  }
+}
+
 // Discards ref registers in the list if they are marked move.
 // This can be used to eagerly release resources we don't need and reduces
 // memory consumption if used effectively prior to yields/waits.
@@ -459,28 +482,43 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
 }
 
 // Issues a populated import call and marshals the results into |dst_reg_list|.
+//
+// If the callee suspends and |can_suspend| is true the results are not
+// marshaled and |out_result| indicates the suspension: the caller must then
+// suspend itself such that the import call is reissued upon resume. When the
+// caller cannot suspend any pending wait is resolved here by blocking.
 static iree_status_t iree_vm_bytecode_issue_import_call(
     iree_vm_stack_t* stack, const iree_vm_function_call_t call,
     iree_string_view_t cconv_results,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
-    iree_vm_stack_frame_t** out_caller_frame,
+    bool can_suspend, iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
   // Call external function.
   iree_status_t call_status = call.function.module->begin_call(
       call.function.module->self, stack, &call, out_result);
+  while (iree_status_is_ok(call_status) && !can_suspend &&
+         out_result->state != IREE_VM_EXECUTION_STATE_COMPLETED) {
+    call_status = iree_vm_stack_resolve_wait(stack, iree_infinite_timeout());
+    if (iree_status_is_ok(call_status)) {
+      call_status = call.function.module->resume_call(
+          call.function.module->self, stack, &call, out_result);
+    }
+  }
   if (IREE_UNLIKELY(!iree_status_is_ok(call_status))) {
     // TODO(benvanik): set execution result to failure/capture stack.
     return iree_status_annotate(call_status,
                                 iree_make_cstring_view("while calling import"));
   }
 
-  // NOTE: we don't support yielding within imported functions right now so it's
-  // safe to assume the stack is still valid here. If the called function can
-  // yield then we'll need to requery all pointers here.
+  // The stack may have grown during the call and invalidated the pointers the
+  // caller had so we requery them here.
   *out_caller_frame = iree_vm_stack_current_frame(stack);
   *out_caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
+  if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETED) {
+    return iree_ok_status();
+  }
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
@@ -524,7 +562,7 @@ static iree_status_t iree_vm_bytecode_call_import(
     uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
     const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
-    iree_vm_stack_frame_t** out_caller_frame,
+    bool can_suspend, iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
   // Prepare |call| by looking up the import information.
@@ -552,9 +590,9 @@ static iree_status_t iree_vm_bytecode_call_import(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import->results, dst_reg_list, can_suspend,
+      out_caller_frame, out_caller_registers, out_result);
 }
 
 // Calls a variadic imported function from another module.
@@ -566,7 +604,7 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
     const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
     const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
-    iree_vm_stack_frame_t** out_caller_frame,
+    bool can_suspend, iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
   // Prepare |call| by looking up the import information.
@@ -598,9 +636,9 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import->results, dst_reg_list, can_suspend,
+      out_caller_frame, out_caller_registers, out_result);
 }
 
 //===----------------------------------------------------------------------===//
@@ -609,22 +647,39 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
 
 iree_status_t iree_vm_bytecode_dispatch(
     iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
-    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
-    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+    const iree_vm_function_call_t* call, bool is_resume,
+    iree_string_view_t cconv_arguments, iree_string_view_t cconv_results,
+    iree_vm_execution_result_t* out_result) {
   memset(out_result, 0, sizeof(*out_result));
 
   // When required emit the dispatch tables here referencing the labels we are
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
-  // The callee's return will take care of storing the output registers when it
-  // actually does return, either immediately or in the future via a resume.
   iree_vm_stack_frame_t* current_frame = NULL;
   iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
+  if (is_resume) {
+    // Continue from the frame that suspended; its pc was stored when it did.
+    // We only suspend when the entry frame is at the bottom of the stack and
+    // all frames are within this module.
+    current_frame = iree_vm_stack_current_frame(stack);
+    if (IREE_UNLIKELY(!current_frame ||
+                      current_frame->function.module != &module->interface)) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "no suspended bytecode call to resume");
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_stack_resolve_wait(stack,
+                                                    iree_immediate_timeout()));
+    regs = iree_vm_bytecode_get_register_storage(current_frame);
+  } else {
+    // Enter function (as this is the initial call).
+    // The callee's return will take care of storing the output registers when
+    // it actually does return, either immediately or in the future via a
+    // resume.
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_external_enter(
+        stack, call->function, cconv_arguments, call->arguments,
+        &current_frame, &regs));
+  }
 
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
@@ -635,12 +690,18 @@ iree_status_t iree_vm_bytecode_dispatch(
   // as we call into different functions.
   const iree_vm_bytecode_module_state_t* IREE_RESTRICT module_state =
       (iree_vm_bytecode_module_state_t*)current_frame->module_state;
+  const uint32_t bytecode_version = module->bytecode_version;
   const uint8_t* IREE_RESTRICT bytecode_data =
       module->bytecode_data.data +
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
+  const int32_t entry_frame_depth = is_resume ? 0 : current_frame->depth;
+
+  // Execution can only be suspended if the caller can resume it: frames of
+  // other modules below the entry frame would be unwound by the suspension.
+  const bool can_suspend =
+      entry_frame_depth == 0 && iree_vm_stack_is_suspendable(stack);
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -798,11 +859,18 @@ iree_status_t iree_vm_bytecode_dispatch(
             "rodata ref ordinal out of range: %d (table=%zu)", rodata_ordinal,
             module_state->rodata_ref_count);
       }
+      iree_vm_buffer_t* rodata_buffer =
+          &module_state->rodata_ref_table[rodata_ordinal];
+      if (IREE_UNLIKELY(!rodata_buffer->data.data)) {
+        // Compressed segments are decompressed on first use.
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_resolve_rodata(
+            module, (iree_vm_bytecode_module_state_t*)module_state,
+            rodata_ordinal));
+      }
       bool result_is_move;
       iree_vm_ref_t* result = VM_DecResultRegRef("value", &result_is_move);
       IREE_RETURN_IF_ERROR(iree_vm_ref_wrap_retain(
-          &module_state->rodata_ref_table[rodata_ordinal],
-          iree_vm_buffer_type_id(), result));
+          rodata_buffer, iree_vm_buffer_type_id(), result));
     });
 
     //===------------------------------------------------------------------===//
@@ -1363,7 +1431,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       const iree_vm_register_remap_list_t* remap_list =
           VM_DecBranchOperands("operands");
       pc = block_pc;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs,
+                                                       remap_list);
     });
 
     DISPATCH_OP(CORE, CondBranch, {
@@ -1376,15 +1445,18 @@ iree_status_t iree_vm_bytecode_dispatch(
           VM_DecBranchOperands("false_operands");
       if (condition) {
         pc = true_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list);
+        iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs,
+                                                         true_remap_list);
       } else {
         pc = false_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs,
+        iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs,
                                                          false_remap_list);
       }
     });
 
     DISPATCH_OP(CORE, Call, {
+      // Offset of this op used to reissue the call when resuming.
+      const iree_vm_source_offset_t op_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* src_reg_list =
           VM_DecVariadicOperands("operands");
@@ -1399,7 +1471,12 @@ iree_status_t iree_vm_bytecode_dispatch(
         // Call import (and possible yield).
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
             stack, module_state, function_ordinal, regs, src_reg_list,
-            dst_reg_list, &current_frame, &regs, out_result));
+            dst_reg_list, can_suspend, &current_frame, &regs, out_result));
+        if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETED) {
+          // Suspend such that the import is called again upon resume.
+          current_frame->pc = op_pc;
+          return iree_ok_status();
+        }
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
@@ -1416,6 +1493,7 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, CallVariadic, {
       // TODO(benvanik): dedupe with above or merge and always have the seg size
       // list be present (but empty) for non-variadic calls.
+      const iree_vm_source_offset_t op_pc = pc - 1;
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
@@ -1438,7 +1516,13 @@ iree_status_t iree_vm_bytecode_dispatch(
       // Call import (and possible yield).
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
           stack, module_state, function_ordinal, regs, segment_size_list,
-          src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+          src_reg_list, dst_reg_list, can_suspend, &current_frame, &regs,
+          out_result));
+      if (out_result->state != IREE_VM_EXECUTION_STATE_COMPLETED) {
+        // Suspend such that the import is called again upon resume.
+        current_frame->pc = op_pc;
+        return iree_ok_status();
+      }
     });
 
     DISPATCH_OP(CORE, Return, {
@@ -1480,8 +1564,12 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
-      return iree_ok_status();
+      // Yields are hints and ignored when the caller cannot resume us.
+      if (can_suspend) {
+        current_frame->pc = pc;
+        out_result->state = IREE_VM_EXECUTION_STATE_YIELDED;
+        return iree_ok_status();
+      }
     });
 
     //===------------------------------------------------------------------===//
@@ -1511,7 +1599,8 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t block_pc = VM_DecBranchTarget("dest");
       const iree_vm_register_remap_list_t* remap_list =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs,
+                                                       remap_list);
       pc = block_pc;
     });
 
@@ -1523,10 +1612,87 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t block_pc = VM_DecBranchTarget("dest");
       const iree_vm_register_remap_list_t* remap_list =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs,
+                                                       remap_list);
       pc = block_pc;
     });
 
+    //===------------------------------------------------------------------===//
+    // Fused superinstructions
+    //===------------------------------------------------------------------===//
+    // These are emitted by the compiler in place of adjacent op pairs where
+    // the intermediate value has no other uses and is never written to a
+    // register. See VMOpcodesCore.td for more information.
+
+#define DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(op_name, op_func)                 \
+  DISPATCH_OP(CORE, op_name, {                                                 \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                                  \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                                  \
+    int32_t true_block_pc = VM_DecBranchTarget("true_dest");                   \
+    const iree_vm_register_remap_list_t* true_remap_list =                     \
+        VM_DecBranchOperands("true_operands");                                 \
+    int32_t false_block_pc = VM_DecBranchTarget("false_dest");                 \
+    const iree_vm_register_remap_list_t* false_remap_list =                    \
+        VM_DecBranchOperands("false_operands");                                \
+    if (op_func(lhs, rhs)) {                                                   \
+      pc = true_block_pc;                                                      \
+      iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs, \
+                                                       true_remap_list);       \
+    } else {                                                                   \
+      pc = false_block_pc;                                                     \
+      iree_vm_bytecode_dispatch_remap_branch_registers(bytecode_version, regs, \
+                                                       false_remap_list);      \
+    }                                                                          \
+  });
+
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpEQI32CondBranch, vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpNEI32CondBranch, vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpLTI32SCondBranch, vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpLTI32UCondBranch, vm_cmp_lt_i32u);
+
+    DISPATCH_OP(CORE, BufferLoadI32AddI32, {
+      bool buffer_is_move;
+      iree_vm_ref_t* buffer_ref =
+          VM_DecOperandRegRef("source_buffer", &buffer_is_move);
+      iree_vm_buffer_t* buffer = iree_vm_buffer_deref(*buffer_ref);
+      if (IREE_UNLIKELY(!buffer)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "source_buffer is null");
+      }
+      uint32_t offset = VM_DecOperandRegI32("source_offset");
+      int32_t addend = VM_DecOperandRegI32("addend");
+      int32_t* result = VM_DecResultRegI32("result");
+      int32_t element = 0;
+      IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+          buffer, offset, &element, 1, sizeof(element)));
+      *result = vm_add_i32(element, addend);
+    });
+
+    DISPATCH_OP(CORE, ListGetI32SetI32, {
+      bool src_list_is_move;
+      iree_vm_ref_t* src_list_ref =
+          VM_DecOperandRegRef("src_list", &src_list_is_move);
+      iree_vm_list_t* src_list = iree_vm_list_deref(*src_list_ref);
+      if (IREE_UNLIKELY(!src_list)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "src_list is null");
+      }
+      uint32_t src_index = VM_DecOperandRegI32("src_index");
+      bool dst_list_is_move;
+      iree_vm_ref_t* dst_list_ref =
+          VM_DecOperandRegRef("dst_list", &dst_list_is_move);
+      iree_vm_list_t* dst_list = iree_vm_list_deref(*dst_list_ref);
+      if (IREE_UNLIKELY(!dst_list)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "dst_list is null");
+      }
+      uint32_t dst_index = VM_DecOperandRegI32("dst_index");
+      iree_vm_value_t value;
+      IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+          src_list, src_index, IREE_VM_VALUE_TYPE_I32, &value));
+      IREE_RETURN_IF_ERROR(iree_vm_list_set_value(dst_list, dst_index, &value));
+    });
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
@@ -2079,8 +2245,313 @@ iree_status_t iree_vm_bytecode_dispatch(
     }
     END_DISPATCH_PREFIX();
 
-    DISPATCH_OP(CORE, PrefixExtF64,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+    BEGIN_DISPATCH_PREFIX(PrefixExtF64, EXT_F64) {
+#if IREE_VM_EXT_F64_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF64: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, GlobalLoadF64, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double* value = VM_DecResultRegF64("value");
+        const double* global_ptr =
+            (const double*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalStoreF64, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double value = VM_DecOperandRegF64("value");
+        double* global_ptr =
+            (double*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalLoadIndirectF64, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double* value = VM_DecResultRegF64("value");
+        const double* global_ptr =
+            (const double*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalStoreIndirectF64, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double value = VM_DecOperandRegF64("value");
+        double* global_ptr =
+            (double*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, ConstF64, {
+        double value = VM_DecFloatAttr64("value");
+        double* result = VM_DecResultRegF64("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F64, ConstF64Zero, {
+        double* result = VM_DecResultRegF64("result");
+        *result = 0;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, ListGetF64, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(*list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        double* result = VM_DecResultRegF64("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F64, &value));
+        *result = value.f64;
+      });
+
+      DISPATCH_OP(EXT_F64, ListSetF64, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(*list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        double raw_value = VM_DecOperandRegF64("value");
+        iree_vm_value_t value = iree_vm_value_make_f64(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Conditional assignment
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, SelectF64, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        double true_value = VM_DecOperandRegF64("true_value");
+        double false_value = VM_DecOperandRegF64("false_value");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_select_f64(condition, true_value, false_value);
+      });
+
+      DISPATCH_OP(EXT_F64, SwitchF64, {
+        int32_t index = VM_DecOperandRegI32("index");
+        double default_value = VM_DecFloatAttr64("default_value");
+        const iree_vm_register_list_t* value_reg_list =
+            VM_DecVariadicOperands("values");
+        double* result = VM_DecResultRegF64("result");
+        if (index >= 0 && index < value_reg_list->size) {
+          *result = *((double*)&regs.i32[value_reg_list->registers[index] &
+                                         (regs.i32_mask & ~1)]);
+        } else {
+          *result = default_value;
+        }
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP_EXT_F64_BINARY_F64(AddF64, vm_add_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(SubF64, vm_sub_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(MulF64, vm_mul_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(DivF64, vm_div_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(RemF64, vm_rem_f64);
+      DISPATCH_OP_EXT_F64_TERNARY_F64(FMAF64, vm_fma_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(AbsF64, vm_abs_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(NegF64, vm_neg_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(CeilF64, vm_ceil_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(FloorF64, vm_floor_f64);
+
+      DISPATCH_OP_EXT_F64_UNARY_F64(AtanF64, vm_atan_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(Atan2F64, vm_atan2_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(CosF64, vm_cos_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(SinF64, vm_sin_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(ExpF64, vm_exp_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(Exp2F64, vm_exp2_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(ExpM1F64, vm_expm1_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(LogF64, vm_log_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(Log10F64, vm_log10_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(Log1pF64, vm_log1p_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(Log2F64, vm_log2_f64);
+      DISPATCH_OP_EXT_F64_BINARY_F64(PowF64, vm_pow_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(RsqrtF64, vm_rsqrt_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(SqrtF64, vm_sqrt_f64);
+      DISPATCH_OP_EXT_F64_UNARY_F64(TanhF64, vm_tanh_f64);
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, TruncF64F32, {
+        double operand = VM_DecOperandRegF64("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = vm_trunc_f64f32(operand);
+      });
+      DISPATCH_OP(EXT_F64, ExtF32F64, {
+        float operand = VM_DecOperandRegF32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_ext_f32f64(operand);
+      });
+
+      DISPATCH_OP(EXT_F64, CastSI32F64, {
+        int32_t operand = (int32_t)VM_DecOperandRegI32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_cast_si32f64(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastUI32F64, {
+        int32_t operand = (int32_t)VM_DecOperandRegI32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_cast_ui32f64(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastF64SI32, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = vm_cast_f64si32(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastF64UI32, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = vm_cast_f64ui32(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastSI64F64, {
+        int64_t operand = (int64_t)VM_DecOperandRegI64("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_cast_si64f64(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastUI64F64, {
+        int64_t operand = (int64_t)VM_DecOperandRegI64("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = vm_cast_ui64f64(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastF64SI64, {
+        double operand = VM_DecOperandRegF64("operand");
+        int64_t* result = VM_DecResultRegI64("result");
+        *result = vm_cast_f64si64(operand);
+      });
+      DISPATCH_OP(EXT_F64, CastF64UI64, {
+        double operand = VM_DecOperandRegF64("operand");
+        int64_t* result = VM_DecResultRegI64("result");
+        *result = vm_cast_f64ui64(operand);
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Comparison ops
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F64_CMP_F64(op_name, op_func) \
+  DISPATCH_OP(EXT_F64, op_name, {                     \
+    double lhs = VM_DecOperandRegF64("lhs");           \
+    double rhs = VM_DecOperandRegF64("rhs");           \
+    int32_t* result = VM_DecResultRegI32("result");   \
+    *result = op_func(lhs, rhs);                      \
+  });
+
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpEQF64O, vm_cmp_eq_f64o);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpEQF64U, vm_cmp_eq_f64u);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpNEF64O, vm_cmp_ne_f64o);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpNEF64U, vm_cmp_ne_f64u);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTF64O, vm_cmp_lt_f64o);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTF64U, vm_cmp_lt_f64u);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTEF64O, vm_cmp_lte_f64o);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTEF64U, vm_cmp_lte_f64u);
+      DISPATCH_OP(EXT_F64, CmpNaNF64, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = vm_cmp_nan_f64(operand);
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Buffers
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, BufferFillF64, {
+        bool buffer_is_move;
+        iree_vm_ref_t* buffer_ref =
+            VM_DecOperandRegRef("target_buffer", &buffer_is_move);
+        iree_vm_buffer_t* buffer = iree_vm_buffer_deref(*buffer_ref);
+        if (IREE_UNLIKELY(!buffer)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "buffer is null");
+        }
+        uint32_t offset = VM_DecOperandRegI32("target_offset");
+        uint32_t length = VM_DecOperandRegI32("length");
+        double value = VM_DecOperandRegF64("value");
+        IREE_RETURN_IF_ERROR(iree_vm_buffer_fill_elements(
+            buffer, offset, length / sizeof(double), sizeof(double), &value));
+      });
+
+      DISPATCH_OP(EXT_F64, BufferLoadF64, {
+        bool buffer_is_move;
+        iree_vm_ref_t* buffer_ref =
+            VM_DecOperandRegRef("source_buffer", &buffer_is_move);
+        iree_vm_buffer_t* buffer = iree_vm_buffer_deref(*buffer_ref);
+        if (IREE_UNLIKELY(!buffer)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "source_buffer is null");
+        }
+        uint32_t offset = VM_DecOperandRegI32("source_offset");
+        double* result = VM_DecResultRegF64("result");
+        IREE_RETURN_IF_ERROR(iree_vm_buffer_read_elements(
+            buffer, offset, result, 1, sizeof(*result)));
+      });
+
+      DISPATCH_OP(EXT_F64, BufferStoreF64, {
+        bool buffer_is_move;
+        iree_vm_ref_t* buffer_ref =
+            VM_DecOperandRegRef("target_buffer", &buffer_is_move);
+        iree_vm_buffer_t* buffer = iree_vm_buffer_deref(*buffer_ref);
+        if (IREE_UNLIKELY(!buffer)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "target_buffer is null");
+        }
+        uint32_t offset = VM_DecOperandRegI32("target_offset");
+        double value = VM_DecOperandRegF64("value");
+        IREE_RETURN_IF_ERROR(iree_vm_buffer_write_elements(
+            &value, buffer, offset, 1, sizeof(double)));
+      });
+
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F64_ENABLE
+    }
+    END_DISPATCH_PREFIX();
 
     // NOLINTNEXTLINE(misc-static-assert)
     DISPATCH_UNHANDLED_CORE();
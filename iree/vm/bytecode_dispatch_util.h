@@ -94,9 +94,12 @@ typedef struct {
 
 // Interleaved src-dst register sets for branch register remapping.
 // This structure is an overlay for the bytecode that is serialized in a
-// matching format.
+// matching format. The first |i32_size| pairs are i32 registers (with 64-bit
+// values split into two pairs) and the following |ref_size| pairs are ref
+// registers so that neither needs to be checked for its register type.
 typedef struct {
-  uint16_t size;
+  uint16_t i32_size;
+  uint16_t ref_size;
   struct pair {
     uint16_t src_reg;
     uint16_t dst_reg;
@@ -104,9 +107,33 @@ typedef struct {
 } iree_vm_register_remap_list_t;
 static_assert(iree_alignof(iree_vm_register_remap_list_t) == 2,
               "Expecting byte alignment (to avoid padding)");
-static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
+static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 4,
+              "Expect no padding in the struct");
+
+// Branch register remap list as encoded in iree_vm_BytecodeVersionDef_V0
+// modules: a single run of pairs with i32 and ref registers interleaved.
+typedef struct {
+  uint16_t size;
+  struct pair pairs[];
+} iree_vm_register_remap_list_v0_t;
+static_assert(offsetof(iree_vm_register_remap_list_v0_t, pairs) == 2,
               "Expect no padding in the struct");
 
+// Returns the encoded size in bytes of the branch register remap list at
+// |bytecode_ptr| in the given |bytecode_version|.
+static inline iree_host_size_t iree_vm_register_remap_list_byte_length(
+    uint32_t bytecode_version, const uint8_t* bytecode_ptr) {
+  if (IREE_UNLIKELY(bytecode_version == iree_vm_BytecodeVersionDef_V0)) {
+    const iree_vm_register_remap_list_v0_t* remap_list =
+        (const iree_vm_register_remap_list_v0_t*)bytecode_ptr;
+    return sizeof(uint16_t) + remap_list->size * sizeof(struct pair);
+  }
+  const iree_vm_register_remap_list_t* remap_list =
+      (const iree_vm_register_remap_list_t*)bytecode_ptr;
+  return 2 * sizeof(uint16_t) +
+         (remap_list->i32_size + remap_list->ref_size) * sizeof(struct pair);
+}
+
 // Maps a type ID to a type def with clamping for out of bounds values.
 static inline const iree_vm_type_def_t* iree_vm_map_type(
     iree_vm_bytecode_module_t* module, int32_t type_id) {
@@ -223,11 +250,10 @@ static const int kRegSize = sizeof(uint16_t);
   (out_str)->data = (const char*)&bytecode_data[pc + 2]; \
   pc += 2 + (out_str)->size;
 #define VM_DecBranchTarget(block_name) VM_DecConstI32(name)
-#define VM_DecBranchOperands(operands_name)                                   \
-  (const iree_vm_register_remap_list_t*)&bytecode_data[pc];                   \
-  pc +=                                                                       \
-      kRegSize + ((const iree_vm_register_list_t*)&bytecode_data[pc])->size * \
-                     2 * kRegSize;
+#define VM_DecBranchOperands(operands_name)                        \
+  (const iree_vm_register_remap_list_t*)&bytecode_data[pc];        \
+  pc += iree_vm_register_remap_list_byte_length(bytecode_version, \
+                                                &bytecode_data[pc]);
 #define VM_DecOperandRegI32(name)      \
   regs.i32[OP_I16(0) & regs.i32_mask]; \
   pc += kRegSize;
@@ -301,13 +327,17 @@ static const int kRegSize = sizeof(uint16_t);
       DECLARE_DISPATCH_CORE_OPC, DECLARE_DISPATCH_CORE_RSV)};
 
 #define DECLARE_DISPATCH_EXT_RSV(ordinal) &&_dispatch_unhandled,
+// Disabled extensions route all of their opcodes to the unhandled handler.
+#define DECLARE_DISPATCH_EXT_DISABLED_OPC(ordinal, name) &&_dispatch_unhandled,
 #if IREE_VM_EXT_I64_ENABLE
 #define DECLARE_DISPATCH_EXT_I64_OPC(ordinal, name) &&_dispatch_EXT_I64_##name,
 #define DEFINE_DISPATCH_TABLE_EXT_I64()                                       \
   static const void* kDispatchTable_EXT_I64[256] = {IREE_VM_OP_EXT_I64_TABLE( \
       DECLARE_DISPATCH_EXT_I64_OPC, DECLARE_DISPATCH_EXT_RSV)};
 #else
-#define DEFINE_DISPATCH_TABLE_EXT_I64()
+#define DEFINE_DISPATCH_TABLE_EXT_I64()                                       \
+  static const void* kDispatchTable_EXT_I64[256] = {IREE_VM_OP_EXT_I64_TABLE( \
+      DECLARE_DISPATCH_EXT_DISABLED_OPC, DECLARE_DISPATCH_EXT_RSV)};
 #endif  // IREE_VM_EXT_I64_ENABLE
 #if IREE_VM_EXT_F32_ENABLE
 #define DECLARE_DISPATCH_EXT_F32_OPC(ordinal, name) &&_dispatch_EXT_F32_##name,
@@ -315,16 +345,20 @@ static const int kRegSize = sizeof(uint16_t);
   static const void* kDispatchTable_EXT_F32[256] = {IREE_VM_OP_EXT_F32_TABLE( \
       DECLARE_DISPATCH_EXT_F32_OPC, DECLARE_DISPATCH_EXT_RSV)};
 #else
-#define DEFINE_DISPATCH_TABLE_EXT_F32()
-#endif  // IREE_VM_EXT_I64_ENABLE
+#define DEFINE_DISPATCH_TABLE_EXT_F32()                                       \
+  static const void* kDispatchTable_EXT_F32[256] = {IREE_VM_OP_EXT_F32_TABLE( \
+      DECLARE_DISPATCH_EXT_DISABLED_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#endif  // IREE_VM_EXT_F32_ENABLE
 #if IREE_VM_EXT_F64_ENABLE
 #define DECLARE_DISPATCH_EXT_F64_OPC(ordinal, name) &&_dispatch_EXT_F64_##name,
 #define DEFINE_DISPATCH_TABLE_EXT_F64()                                       \
   static const void* kDispatchTable_EXT_F64[256] = {IREE_VM_OP_EXT_F64_TABLE( \
       DECLARE_DISPATCH_EXT_F64_OPC, DECLARE_DISPATCH_EXT_RSV)};
 #else
-#define DEFINE_DISPATCH_TABLE_EXT_F64()
-#endif  // IREE_VM_EXT_I64_ENABLE
+#define DEFINE_DISPATCH_TABLE_EXT_F64()                                       \
+  static const void* kDispatchTable_EXT_F64[256] = {IREE_VM_OP_EXT_F64_TABLE( \
+      DECLARE_DISPATCH_EXT_DISABLED_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#endif  // IREE_VM_EXT_F64_ENABLE
 
 #define DEFINE_DISPATCH_TABLES()   \
   DEFINE_DISPATCH_TABLE_CORE();    \
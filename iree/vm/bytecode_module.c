@@ -6,8 +6,11 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <inttypes.h>
+
 #include "iree/base/alignment.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/lz4_block.h"
 #include "iree/base/tracing.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module_impl.h"
@@ -97,12 +100,85 @@ static iree_status_t iree_vm_bytecode_module_resolve_types(
   return status;
 }
 
+// flatcc table verifier for BytecodeModuleDef that matches the generated
+// __iree_vm_BytecodeModuleDef_table_verifier except that rodata_segments is
+// only verified as a vector of offsets; the segment tables are verified later
+// by iree_vm_bytecode_module_rodata_table_verifier. Must be kept in sync with
+// the fields in bytecode_module_def.fbs.
+static int iree_vm_bytecode_module_header_table_verifier(
+    flatcc_table_verifier_descriptor_t* td) {
+  int ret;
+  if ((ret = flatcc_verify_string_field(td, 0, 1) /* name */)) return ret;
+  if ((ret = flatcc_verify_table_vector_field(
+           td, 1, 0, __iree_vm_TypeDef_table_verifier) /* types */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_table_vector_field(
+           td, 2, 0, __iree_vm_ImportFunctionDef_table_verifier)
+       /* imported_functions */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_table_vector_field(
+           td, 3, 0, __iree_vm_ExportFunctionDef_table_verifier)
+       /* exported_functions */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_table_vector_field(
+           td, 4, 0, __iree_vm_InternalFunctionDef_table_verifier)
+       /* internal_functions */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_vector_field(
+           td, 5, 0, sizeof(flatbuffers_uoffset_t),
+           sizeof(flatbuffers_uoffset_t),
+           (size_t)UINT32_MAX / sizeof(flatbuffers_uoffset_t))
+       /* rodata_segments */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_table_vector_field(
+           td, 6, 0, __iree_vm_RwdataSegmentDef_table_verifier)
+       /* rwdata_segments */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_table_field(td, 7, 0,
+                                       __iree_vm_ModuleStateDef_table_verifier)
+       /* module_state */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_vector_field(
+           td, 8, 0, sizeof(iree_vm_FunctionDescriptor_t), 4,
+           (size_t)UINT32_MAX / sizeof(iree_vm_FunctionDescriptor_t))
+       /* function_descriptors */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_vector_field(td, 9, 0, 1, 1, (size_t)UINT32_MAX)
+       /* bytecode_data */)) {
+    return ret;
+  }
+  if ((ret = flatcc_verify_field(td, 10, 4, 4) /* bytecode_version */)) {
+    return ret;
+  }
+  return flatcc_verify_ok;
+}
+
+// flatcc table verifier for BytecodeModuleDef that only verifies the
+// rodata_segments tables skipped by
+// iree_vm_bytecode_module_header_table_verifier.
+static int iree_vm_bytecode_module_rodata_table_verifier(
+    flatcc_table_verifier_descriptor_t* td) {
+  return flatcc_verify_table_vector_field(
+      td, 5, 0, __iree_vm_RodataSegmentDef_table_verifier);
+}
+
 // Verifies the structure of the flatbuffer so that we can avoid doing so during
 // runtime. There are still some conditions we must be aware of (such as omitted
 // names on functions with internal linkage), however we shouldn't need to
 // bounds check anything within the flatbuffer after this succeeds.
+//
+// If |verify_rodata| is false the rodata segment tables are skipped and must be
+// verified with iree_vm_bytecode_module_verify_rodata before use.
 static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
-    iree_const_byte_span_t flatbuffer_data) {
+    iree_const_byte_span_t flatbuffer_data, bool verify_rodata) {
   if (!flatbuffer_data.data || flatbuffer_data.data_length < 16) {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
@@ -113,8 +189,14 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
   // Run flatcc generated verification. This ensures all pointers are in-bounds
   // and that we can safely walk the file, but not that the actual contents of
   // the flatbuffer meet our expectations.
-  int verify_ret = iree_vm_BytecodeModuleDef_verify_as_root(
-      flatbuffer_data.data, flatbuffer_data.data_length);
+  int verify_ret =
+      verify_rodata
+          ? iree_vm_BytecodeModuleDef_verify_as_root(
+                flatbuffer_data.data, flatbuffer_data.data_length)
+          : flatcc_verify_table_as_root(
+                flatbuffer_data.data, flatbuffer_data.data_length,
+                iree_vm_BytecodeModuleDef_file_identifier,
+                iree_vm_bytecode_module_header_table_verifier);
   if (verify_ret != flatcc_verify_ok) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "flatbuffer verification failed: %s",
@@ -130,6 +212,17 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
                             "module missing name field");
   }
 
+  iree_vm_BytecodeVersionDef_enum_t bytecode_version =
+      iree_vm_BytecodeModuleDef_bytecode_version(module_def);
+  if (bytecode_version != iree_vm_BytecodeVersionDef_V0 &&
+      bytecode_version != iree_vm_BytecodeVersionDef_V1) {
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "bytecode version %u is not supported by this runtime (expected <= "
+        "%u); recompile the module",
+        (uint32_t)bytecode_version, (uint32_t)iree_vm_BytecodeVersionDef_V1);
+  }
+
   iree_vm_TypeDef_vec_t types = iree_vm_BytecodeModuleDef_types(module_def);
   for (size_t i = 0; i < iree_vm_TypeDef_vec_len(types); ++i) {
     iree_vm_TypeDef_table_t type_def = iree_vm_TypeDef_vec_at(types, i);
@@ -241,10 +334,78 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
   return iree_ok_status();
 }
 
+// Verifies the rodata segments of |module| if they were not verified during
+// module creation. Safe to call concurrently; verification may run more than
+// once if raced but has no side effects.
+static iree_status_t iree_vm_bytecode_module_verify_rodata(
+    iree_vm_bytecode_module_t* module) {
+  if (IREE_LIKELY(iree_atomic_load_int32(&module->rodata_verified,
+                                         iree_memory_order_acquire))) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  int verify_ret = flatcc_verify_table_as_root(
+      module->flatbuffer_data.data, module->flatbuffer_data.data_length,
+      iree_vm_BytecodeModuleDef_file_identifier,
+      iree_vm_bytecode_module_rodata_table_verifier);
+  if (verify_ret != flatcc_verify_ok) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "flatbuffer rodata verification failed: %s",
+                            flatcc_verify_error_string(verify_ret));
+  }
+  iree_atomic_store_int32(&module->rodata_verified, 1,
+                          iree_memory_order_release);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Allocates the rodata cache of |module| if it has not yet been allocated.
+// The rodata segments must have been verified. Safe to call concurrently; only
+// one allocation is kept if raced.
+static iree_status_t iree_vm_bytecode_module_allocate_rodata_cache(
+    iree_vm_bytecode_module_t* module) {
+  if (iree_atomic_load_intptr(&module->rodata_cache,
+                              iree_memory_order_acquire)) {
+    return iree_ok_status();
+  }
+  iree_host_size_t rodata_segment_count = iree_vm_RodataSegmentDef_vec_len(
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def));
+  if (rodata_segment_count == 0) return iree_ok_status();
+
+  // Entries start as 0 as the allocation is zero initialized.
+  iree_atomic_intptr_t* rodata_cache = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      module->allocator, rodata_segment_count * sizeof(*rodata_cache),
+      (void**)&rodata_cache));
+  intptr_t existing = 0;
+  if (!iree_atomic_compare_exchange_strong_intptr(
+          &module->rodata_cache, &existing, (intptr_t)rodata_cache,
+          iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+    iree_allocator_free(module->allocator, rodata_cache);
+  }
+  return iree_ok_status();
+}
+
 static void iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // The cache is only allocated once the rodata segments have been verified
+  // and the segment count can be trusted.
+  iree_atomic_intptr_t* rodata_cache = (iree_atomic_intptr_t*)
+      iree_atomic_load_intptr(&module->rodata_cache, iree_memory_order_acquire);
+  if (rodata_cache) {
+    iree_host_size_t rodata_segment_count = iree_vm_RodataSegmentDef_vec_len(
+        iree_vm_BytecodeModuleDef_rodata_segments(module->def));
+    for (iree_host_size_t i = 0; i < rodata_segment_count; ++i) {
+      iree_allocator_free(module->allocator,
+                          (void*)iree_atomic_load_intptr(
+                              &rodata_cache[i], iree_memory_order_acquire));
+    }
+    iree_allocator_free(module->allocator, rodata_cache);
+  }
+
   iree_allocator_free(module->flatbuffer_allocator,
                       (void*)module->flatbuffer_data.data);
   module->flatbuffer_data = iree_make_const_byte_span(NULL, 0);
@@ -555,6 +716,12 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   iree_vm_BytecodeModuleDef_table_t module_def = module->def;
 
+  // Rodata segments are first accessed below; verify them now if deferred.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_verify_rodata(module));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_allocate_rodata_cache(module));
+
   // Compute the total size required (with padding) for the state structure.
   iree_host_size_t total_state_struct_size =
       iree_vm_bytecode_module_layout_state(module_def, NULL);
@@ -569,19 +736,37 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   // Perform layout to get the pointers into the storage for each nested table.
   iree_vm_bytecode_module_layout_state(module_def, state);
 
-  // Setup rodata segments to point directly at the flatbuffer memory.
+  // Setup uncompressed rodata segments to point directly at the flatbuffer
+  // memory. Compressed segments start empty and are resolved on first use.
   iree_vm_RodataSegmentDef_vec_t rodata_segments =
       iree_vm_BytecodeModuleDef_rodata_segments(module_def);
   for (int i = 0; i < state->rodata_ref_count; ++i) {
     iree_vm_RodataSegmentDef_table_t segment =
         iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
-    iree_vm_buffer_t* ref = &state->rodata_ref_table[i];
-    iree_vm_buffer_initialize(
-        IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
-        iree_make_byte_span(
+    iree_byte_span_t data = iree_make_byte_span(NULL, 0);
+    switch (iree_vm_RodataSegmentDef_compression_type_type(segment)) {
+      case iree_vm_CompressionTypeDef_NONE:
+      case iree_vm_CompressionTypeDef_UncompressedDataDef:
+        data = iree_make_byte_span(
             (uint8_t*)iree_vm_RodataSegmentDef_data(segment),
-            flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment))),
-        iree_allocator_null(), ref);
+            flatbuffers_uint8_vec_len(iree_vm_RodataSegmentDef_data(segment)));
+        break;
+      case iree_vm_CompressionTypeDef_LZ4BlockDataDef:
+        break;
+      default:
+        iree_allocator_free(allocator, state);
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(
+            IREE_STATUS_UNIMPLEMENTED,
+            "rodata segment %d uses unsupported compression type %u", i,
+            (uint32_t)iree_vm_RodataSegmentDef_compression_type_type(segment));
+    }
+    // Compressed segments are left empty and resolved on first use.
+    iree_vm_buffer_initialize(
+        IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE, data,
+        data.data ? iree_vm_buffer_module_data_allocator(&module->interface)
+                  : iree_allocator_null(),
+        &state->rodata_ref_table[i]);
   }
 
   *out_module_state = (iree_vm_module_state_t*)state;
@@ -589,6 +774,96 @@ static iree_status_t iree_vm_bytecode_module_alloc_state(
   return iree_ok_status();
 }
 
+// Decompresses the LZ4 block compressed rodata |segment| into a new allocation
+// from |allocator| with the contents aligned to
+// IREE_VM_BYTECODE_RODATA_ALIGNMENT.
+static iree_status_t iree_vm_bytecode_module_decompress_rodata(
+    iree_vm_RodataSegmentDef_table_t segment, iree_allocator_t allocator,
+    iree_host_size_t uncompressed_size, void** out_allocation) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE(z0, uncompressed_size);
+
+  void* allocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              allocator, uncompressed_size + IREE_VM_BYTECODE_RODATA_ALIGNMENT,
+              &allocation));
+
+  flatbuffers_uint8_vec_t compressed_data =
+      iree_vm_RodataSegmentDef_data(segment);
+  iree_status_t status = iree_lz4_block_decompress(
+      iree_make_const_byte_span(compressed_data,
+                                flatbuffers_uint8_vec_len(compressed_data)),
+      iree_make_byte_span(
+          (uint8_t*)iree_host_align((uintptr_t)allocation,
+                                    IREE_VM_BYTECODE_RODATA_ALIGNMENT),
+          uncompressed_size));
+  if (iree_status_is_ok(status)) {
+    *out_allocation = allocation;
+  } else {
+    iree_allocator_free(allocator, allocation);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_vm_bytecode_module_resolve_rodata(
+    iree_vm_bytecode_module_t* module,
+    iree_vm_bytecode_module_state_t* module_state, uint32_t rodata_ordinal) {
+  iree_vm_RodataSegmentDef_table_t segment = iree_vm_RodataSegmentDef_vec_at(
+      iree_vm_BytecodeModuleDef_rodata_segments(module->def), rodata_ordinal);
+  if (iree_vm_RodataSegmentDef_compression_type_type(segment) !=
+      iree_vm_CompressionTypeDef_LZ4BlockDataDef) {
+    // Uncompressed segments are resolved when the state is allocated.
+    return iree_ok_status();
+  }
+  iree_vm_LZ4BlockDataDef_table_t compression_def =
+      (iree_vm_LZ4BlockDataDef_table_t)
+          iree_vm_RodataSegmentDef_compression_type(segment);
+  uint64_t uncompressed_size =
+      iree_vm_LZ4BlockDataDef_uncompressed_size(compression_def);
+  if (uncompressed_size >
+      (uint64_t)(~(iree_host_size_t)0 - IREE_VM_BYTECODE_RODATA_ALIGNMENT)) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "rodata segment %u uncompressed size %" PRIu64
+                            " exceeds the host address space",
+                            rodata_ordinal, uncompressed_size);
+  }
+
+  // Decompress on first use by any state. If multiple states race only one
+  // allocation is kept and the others are discarded.
+  iree_atomic_intptr_t* rodata_cache = (iree_atomic_intptr_t*)
+      iree_atomic_load_intptr(&module->rodata_cache, iree_memory_order_acquire);
+  iree_atomic_intptr_t* cache_entry = &rodata_cache[rodata_ordinal];
+  intptr_t allocation =
+      iree_atomic_load_intptr(cache_entry, iree_memory_order_acquire);
+  if (!allocation) {
+    void* new_allocation = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_module_decompress_rodata(
+            segment, module->allocator, (iree_host_size_t)uncompressed_size,
+            &new_allocation),
+        "decompressing rodata segment %u", rodata_ordinal);
+    if (iree_atomic_compare_exchange_strong_intptr(
+            cache_entry, &allocation, (intptr_t)new_allocation,
+            iree_memory_order_acq_rel, iree_memory_order_acquire)) {
+      allocation = (intptr_t)new_allocation;
+    } else {
+      iree_allocator_free(module->allocator, new_allocation);
+    }
+  }
+
+  iree_vm_buffer_initialize(
+      IREE_VM_BUFFER_ACCESS_ORIGIN_MODULE,
+      iree_make_byte_span((uint8_t*)iree_host_align(
+                              allocation, IREE_VM_BYTECODE_RODATA_ALIGNMENT),
+                          (iree_host_size_t)uncompressed_size),
+      iree_vm_buffer_module_data_allocator(&module->interface),
+      &module_state->rodata_ref_table[rodata_ordinal]);
+  return iree_ok_status();
+}
+
 static void iree_vm_bytecode_module_free_state(
     void* self, iree_vm_module_state_t* module_state) {
   if (!module_state) return;
@@ -657,9 +932,10 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   return iree_ok_status();
 }
 
-static iree_status_t iree_vm_bytecode_module_begin_call(
+// Begins or resumes (if |is_resume|) the given |call|.
+static iree_status_t iree_vm_bytecode_module_dispatch_call(
     void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
-    iree_vm_execution_result_t* out_result) {
+    bool is_resume, iree_vm_execution_result_t* out_result) {
   // NOTE: any work here adds directly to the invocation time. Avoid doing too
   // much work or touching too many unlikely-to-be-cached structures (such as
   // walking the FlatBuffer, which may cause page faults).
@@ -718,23 +994,50 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
 
   // Jump into the dispatch routine to execute bytecode until the function
   // either returns (synchronous) or yields (asynchronous).
-  iree_status_t status = iree_vm_bytecode_dispatch(
-      stack, module, call, cconv_arguments, cconv_results, out_result);
+  iree_status_t status =
+      iree_vm_bytecode_dispatch(stack, module, call, is_resume, cconv_arguments,
+                                cconv_results, out_result);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_status_t iree_vm_bytecode_module_begin_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  return iree_vm_bytecode_module_dispatch_call(self, stack, call,
+                                               /*is_resume=*/false, out_result);
+}
+
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
+  return iree_vm_bytecode_module_dispatch_call(self, stack, call,
+                                               /*is_resume=*/true, out_result);
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      flatbuffer_data, IREE_VM_BYTECODE_MODULE_FLAG_NONE, flatbuffer_allocator,
+      allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_const_byte_span_t flatbuffer_data,
+    iree_vm_bytecode_module_flags_t flags,
+    iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
+    iree_vm_module_t** out_module) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
 
+  bool verify_rodata =
+      !(flags & IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION);
   IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_module_flatbuffer_verify");
   iree_status_t status =
-      iree_vm_bytecode_module_flatbuffer_verify(flatbuffer_data);
+      iree_vm_bytecode_module_flatbuffer_verify(flatbuffer_data, verify_rodata);
   if (!iree_status_is_ok(status)) {
     IREE_TRACE_ZONE_END(z1);
     IREE_TRACE_ZONE_END(z0);
@@ -773,10 +1076,14 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
       iree_vm_BytecodeModuleDef_bytecode_data(module_def);
   module->bytecode_data = iree_make_const_byte_span(
       bytecode_data, flatbuffers_uint8_vec_len(bytecode_data));
+  module->bytecode_version =
+      (uint32_t)iree_vm_BytecodeModuleDef_bytecode_version(module_def);
 
   module->flatbuffer_data = flatbuffer_data;
   module->flatbuffer_allocator = flatbuffer_allocator;
   module->def = module_def;
+  iree_atomic_store_int32(&module->rodata_verified, verify_rodata ? 1 : 0,
+                          iree_memory_order_relaxed);
 
   module->type_count = iree_vm_TypeDef_vec_len(type_defs);
   module->type_table = (iree_vm_type_def_t*)((uint8_t*)module +
@@ -799,6 +1106,7 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
@@ -25,6 +25,32 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Controls how a bytecode module FlatBuffer is loaded.
+enum iree_vm_bytecode_module_flag_bits_e {
+  IREE_VM_BYTECODE_MODULE_FLAG_NONE = 0u,
+
+  // Defers verification of rodata segments until they are first accessed when
+  // allocating module state. Only the module header, types, function tables,
+  // and function descriptors are verified during creation. Intended for large
+  // memory-mapped modules where touching every segment during creation would
+  // page in the bulk of the file before it is needed.
+  IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION = 1u << 0,
+};
+typedef uint32_t iree_vm_bytecode_module_flags_t;
+
+// Creates a VM module from an in-memory ModuleDef FlatBuffer as with
+// iree_vm_bytecode_module_create using the given |flags|.
+//
+// Rodata buffers reference |flatbuffer_data| directly and are never copied so
+// when the data is a file mapping (see iree_file_map_contents) pages holding
+// unused constants are never read. The mapping deallocator can be passed as
+// |flatbuffer_allocator| to unmap the file when the module is destroyed.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_const_byte_span_t flatbuffer_data,
+    iree_vm_bytecode_module_flags_t flags,
+    iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
+    iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -297,6 +297,47 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+static void BM_LoopSumF64Reference(benchmark::State& state) {
+  static auto work = +[](double x) {
+    benchmark::DoNotOptimize(x);
+    return x;
+  };
+  static auto loop = +[](int count) {
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(sum = work(sum + 0.5));
+    }
+    return sum;
+  };
+  while (state.KeepRunningBatch(state.range(0))) {
+    double ret = loop(static_cast<int>(state.range(0)));
+    benchmark::DoNotOptimize(ret);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_LoopSumF64Reference)->Arg(100000);
+
+static void BM_LoopSumF32Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.loop_sum_f32"),
+      {static_cast<int32_t>(state.range(0))},
+      /*result_count=*/1,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF32Bytecode)->Arg(100000);
+
+#if IREE_VM_EXT_F64_ENABLE
+static void BM_LoopSumF64Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(
+      state, iree_make_cstring_view("bytecode_module_benchmark.loop_sum_f64"),
+      {static_cast<int32_t>(state.range(0))},
+      // The f64 result occupies two i32 result slots.
+      /*result_count=*/2,
+      /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF64Bytecode)->Arg(100000);
+#endif  // IREE_VM_EXT_F64_ENABLE
+
 static void BM_BufferReduceReference(benchmark::State& state) {
   static auto work = +[](int32_t* buffer, int i, int sum) {
     int new_sum = buffer[i] + sum;
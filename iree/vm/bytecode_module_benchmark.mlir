@@ -77,6 +77,40 @@ vm.module @bytecode_module_benchmark {
     vm.return %ie : i32
   }
 
+  // Measures the cost of a simple for-loop carrying an f32 accumulator.
+  vm.export @loop_sum_f32
+  vm.func @loop_sum_f32(%count : i32) -> f32 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    %step = vm.const.f32 0.5 : f32
+    %sum0 = vm.const.f32.zero : f32
+    vm.br ^loop(%i0, %sum0 : i32, f32)
+  ^loop(%i : i32, %sum : f32):
+    %in = vm.add.i32 %i, %c1 : i32
+    %new_sum = vm.add.f32 %sum, %step : f32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %new_sum : i32, f32), ^loop_exit(%new_sum : f32)
+  ^loop_exit(%result : f32):
+    vm.return %result : f32
+  }
+
+  // Measures the cost of a simple for-loop carrying an f64 accumulator.
+  vm.export @loop_sum_f64
+  vm.func @loop_sum_f64(%count : i32) -> f64 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    %step = vm.const.f64 0.5 : f64
+    %sum0 = vm.const.f64.zero : f64
+    vm.br ^loop(%i0, %sum0 : i32, f64)
+  ^loop(%i : i32, %sum : f64):
+    %in = vm.add.i32 %i, %c1 : i32
+    %new_sum = vm.add.f64 %sum, %step : f64
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %new_sum : i32, f64), ^loop_exit(%new_sum : f64)
+  ^loop_exit(%result : f64):
+    vm.return %result : f64
+  }
+
   // Measures the cost of lots of buffer loads.
   vm.export @buffer_reduce
   vm.func @buffer_reduce(%count : i32) -> i32 {
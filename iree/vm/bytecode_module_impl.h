@@ -16,6 +16,7 @@
 #endif  // _MSC_VER
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/vm/api.h"
 
 // NOTE: include order matters:
@@ -56,6 +57,8 @@ typedef struct {
 
   // A pointer to the bytecode data embedded within the module.
   iree_const_byte_span_t bytecode_data;
+  // Encoding revision of |bytecode_data| (iree_vm_BytecodeVersionDef_*).
+  uint32_t bytecode_version;
 
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
@@ -65,6 +68,20 @@ typedef struct {
   iree_allocator_t flatbuffer_allocator;
   iree_vm_BytecodeModuleDef_table_t def;
 
+  // Nonzero once the rodata segments of |def| have been verified. Modules
+  // created with IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION start
+  // unverified and verify on first module state allocation.
+  iree_atomic_int32_t rodata_verified;
+
+  // Decompressed contents of compressed rodata segments indexed by rodata
+  // ordinal and shared by all module states. Entries are 0 until first used and
+  // then hold an allocation from |allocator| containing the contents aligned to
+  // IREE_VM_BYTECODE_RODATA_ALIGNMENT. Uncompressed segment entries stay 0.
+  // The table itself is an iree_atomic_intptr_t array from |allocator| that is
+  // allocated on first module state allocation once the rodata segment count
+  // has been verified; it is 0 until then and in modules without rodata.
+  iree_atomic_intptr_t rodata_cache;
+
   // Type table mapping module type IDs to registered VM types.
   iree_host_size_t type_count;
   iree_vm_type_def_t* type_table;
@@ -107,8 +124,8 @@ typedef struct {
 
   // TODO(benvanik): move to iree_vm_bytecode_module_t if always static.
   // Initialized references to rodata segments.
-  // Right now these don't do much, however we can perform lazy caching and
-  // on-the-fly decompression using this information.
+  // Compressed segments have no data until resolved on first use with
+  // iree_vm_bytecode_module_resolve_rodata.
   iree_host_size_t rodata_ref_count;
   iree_vm_buffer_t* rodata_ref_table;
 
@@ -120,12 +137,26 @@ typedef struct {
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
 
+// Minimum alignment of decompressed rodata segment contents.
+// Must match the guarantee in bytecode_module_def.fbs.
+#define IREE_VM_BYTECODE_RODATA_ALIGNMENT 64
+
+// Resolves the contents of the compressed rodata segment |rodata_ordinal| in
+// |module_state|, decompressing it into the module rodata cache if no state
+// has used it yet. Rodata references with NULL data must be resolved before
+// use.
+iree_status_t iree_vm_bytecode_module_resolve_rodata(
+    iree_vm_bytecode_module_t* module,
+    iree_vm_bytecode_module_state_t* module_state, uint32_t rodata_ordinal);
+
 // Begins (or resumes) execution of the current frame and continues until
 // either a yield or return. |out_result| will contain the result status for
-// continuation, if needed.
+// continuation, if needed. When |is_resume| is true execution continues from
+// the frame at the top of |stack| that previously suspended.
 iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
                                         iree_vm_bytecode_module_t* module,
                                         const iree_vm_function_call_t* call,
+                                        bool is_resume,
                                         iree_string_view_t cconv_arguments,
                                         iree_string_view_t cconv_results,
                                         iree_vm_execution_result_t* out_result);
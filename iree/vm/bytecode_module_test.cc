@@ -10,10 +10,153 @@
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstring>
+
+#include "iree/base/api.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+// Compiled module embedded here to avoid file IO:
+#include "iree/vm/test/all_bytecode_modules.h"
 
 namespace {
 
+using ::iree::StatusCode;
+using ::iree::testing::status::StatusIs;
+
 // TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
 
+// Modules created with deferred rodata verification verify and reference their
+// rodata segments when module state is allocated.
+TEST(BytecodeModuleTest, LazyRodataVerification) {
+  IREE_ASSERT_OK(iree_vm_register_builtin_types());
+  const struct iree_file_toc_t* module_file_toc =
+      all_bytecode_modules_c_create();
+  for (size_t i = 0; i < all_bytecode_modules_c_size(); ++i) {
+    const auto& module_file = module_file_toc[i];
+    iree_vm_module_t* module = nullptr;
+    IREE_ASSERT_OK(iree_vm_bytecode_module_create_with_flags(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file.data),
+            module_file.size},
+        IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION,
+        iree_allocator_null(), iree_allocator_system(), &module))
+        << module_file.name;
+    for (int j = 0; j < 2; ++j) {
+      iree_vm_module_state_t* module_state = nullptr;
+      IREE_ASSERT_OK(module->alloc_state(module->self, iree_allocator_system(),
+                                         &module_state))
+          << module_file.name;
+      module->free_state(module->self, module_state);
+    }
+    iree_vm_module_release(module);
+  }
+}
+
+// Truncated FlatBuffers fail verification regardless of flags.
+TEST(BytecodeModuleTest, TruncatedFlatBuffer) {
+  const struct iree_file_toc_t* module_file_toc =
+      all_bytecode_modules_c_create();
+  ASSERT_GT(all_bytecode_modules_c_size(), 0);
+  iree_const_byte_span_t truncated_data = {
+      reinterpret_cast<const uint8_t*>(module_file_toc[0].data),
+      module_file_toc[0].size / 2};
+  iree_vm_module_t* module = nullptr;
+  EXPECT_THAT(iree::Status(iree_vm_bytecode_module_create_with_flags(
+                  truncated_data, IREE_VM_BYTECODE_MODULE_FLAG_NONE,
+                  iree_allocator_null(), iree_allocator_system(), &module)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(iree::Status(iree_vm_bytecode_module_create_with_flags(
+                  truncated_data,
+                  IREE_VM_BYTECODE_MODULE_FLAG_LAZY_RODATA_VERIFICATION,
+                  iree_allocator_null(), iree_allocator_system(), &module)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Returns the embedded module file with the given |name|.
+const struct iree_file_toc_t* FindModuleFile(const char* name) {
+  const struct iree_file_toc_t* module_file_toc =
+      all_bytecode_modules_c_create();
+  for (size_t i = 0; i < all_bytecode_modules_c_size(); ++i) {
+    if (strcmp(module_file_toc[i].name, name) == 0) return &module_file_toc[i];
+  }
+  return nullptr;
+}
+
+// Asynchronous invocations suspend at each vm.yield and resume where they left
+// off each time they are queried.
+class BytecodeModuleInvocationTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_vm_register_builtin_types());
+    IREE_ASSERT_OK(
+        iree_vm_instance_create(iree_allocator_system(), &instance_));
+    const struct iree_file_toc_t* module_file =
+        FindModuleFile("control_flow_ops.vmfb");
+    ASSERT_NE(nullptr, module_file);
+    iree_vm_module_t* module = nullptr;
+    IREE_ASSERT_OK(iree_vm_bytecode_module_create(
+        iree_const_byte_span_t{
+            reinterpret_cast<const uint8_t*>(module_file->data),
+            module_file->size},
+        iree_allocator_null(), iree_allocator_system(), &module));
+    IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+        instance_, &module, 1, iree_allocator_system(), &context_));
+    iree_vm_module_release(module);
+    IREE_ASSERT_OK(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("control_flow_ops.test_yield"),
+        &function_));
+  }
+
+  void TearDown() override {
+    iree_vm_context_release(context_);
+    iree_vm_instance_release(instance_);
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_context_t* context_ = nullptr;
+  iree_vm_function_t function_;
+};
+
+TEST_F(BytecodeModuleInvocationTest, QueryStatusResumesYield) {
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, function_, /*policy=*/nullptr, /*inputs=*/nullptr,
+      iree_allocator_system(), &invocation));
+  // Each query resumes the function once: it yields twice and then returns.
+  EXPECT_THAT(iree::Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  EXPECT_THAT(iree::Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  EXPECT_NE(nullptr, iree_vm_invocation_output(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(BytecodeModuleInvocationTest, AwaitResumesYield) {
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, function_, /*policy=*/nullptr, /*inputs=*/nullptr,
+      iree_allocator_system(), &invocation));
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(BytecodeModuleInvocationTest, AbortYielded) {
+  iree_vm_invocation_t* invocation = nullptr;
+  IREE_ASSERT_OK(iree_vm_invocation_create(
+      context_, function_, /*policy=*/nullptr, /*inputs=*/nullptr,
+      iree_allocator_system(), &invocation));
+  EXPECT_THAT(iree::Status(iree_vm_invocation_query_status(invocation)),
+              StatusIs(StatusCode::kUnavailable));
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(iree::Status(iree_vm_invocation_await(
+                  invocation, IREE_TIME_INFINITE_FUTURE)),
+              StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+}
+
 }  // namespace
@@ -135,12 +135,12 @@ typedef enum {
   IREE_VM_OP_CORE_Print = 0x7D,
   IREE_VM_OP_CORE_CondBreak = 0x7E,
   IREE_VM_OP_CORE_Break = 0x7F,
-  IREE_VM_OP_CORE_RSV_0x80,
-  IREE_VM_OP_CORE_RSV_0x81,
-  IREE_VM_OP_CORE_RSV_0x82,
-  IREE_VM_OP_CORE_RSV_0x83,
-  IREE_VM_OP_CORE_RSV_0x84,
-  IREE_VM_OP_CORE_RSV_0x85,
+  IREE_VM_OP_CORE_CmpEQI32CondBranch = 0x80,
+  IREE_VM_OP_CORE_CmpNEI32CondBranch = 0x81,
+  IREE_VM_OP_CORE_CmpLTI32SCondBranch = 0x82,
+  IREE_VM_OP_CORE_CmpLTI32UCondBranch = 0x83,
+  IREE_VM_OP_CORE_BufferLoadI32AddI32 = 0x84,
+  IREE_VM_OP_CORE_ListGetI32SetI32 = 0x85,
   IREE_VM_OP_CORE_RSV_0x86,
   IREE_VM_OP_CORE_RSV_0x87,
   IREE_VM_OP_CORE_RSV_0x88,
@@ -394,12 +394,12 @@ typedef enum {
     OPC(0x7D, Print) \
     OPC(0x7E, CondBreak) \
     OPC(0x7F, Break) \
-    RSV(0x80) \
-    RSV(0x81) \
-    RSV(0x82) \
-    RSV(0x83) \
-    RSV(0x84) \
-    RSV(0x85) \
+    OPC(0x80, CmpEQI32CondBranch) \
+    OPC(0x81, CmpNEI32CondBranch) \
+    OPC(0x82, CmpLTI32SCondBranch) \
+    OPC(0x83, CmpLTI32UCondBranch) \
+    OPC(0x84, BufferLoadI32AddI32) \
+    OPC(0x85, ListGetI32SetI32) \
     RSV(0x86) \
     RSV(0x87) \
     RSV(0x88) \
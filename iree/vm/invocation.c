@@ -7,6 +7,7 @@
 #include "iree/vm/invocation.h"
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/tracing.h"
 
 // Marshals caller arguments from the variant list to the ABI convention.
@@ -137,6 +138,34 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
+// Releases any references remaining in the ABI |storage| of |cconv_fragment|.
+// Callees either move reference arguments out of the storage or only borrow
+// them for the duration of the call so this must be called once the call has
+// completed (or will never be issued) to drop the references taken by
+// iree_vm_invoke_marshal_inputs.
+static void iree_vm_invoke_release_fragment(iree_string_view_t cconv_fragment,
+                                            iree_byte_span_t storage) {
+  uint8_t* p = storage.data;
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    switch (cconv_fragment.data[i]) {
+      case IREE_VM_CCONV_TYPE_VOID:
+        break;
+      case IREE_VM_CCONV_TYPE_I32:
+      case IREE_VM_CCONV_TYPE_F32:
+        p += sizeof(int32_t);
+        break;
+      case IREE_VM_CCONV_TYPE_I64:
+      case IREE_VM_CCONV_TYPE_F64:
+        p += sizeof(int64_t);
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        iree_vm_ref_release((iree_vm_ref_t*)p);
+        p += sizeof(iree_vm_ref_t);
+        break;
+    }
+  }
+}
+
 // TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
@@ -160,8 +189,6 @@ static iree_status_t iree_vm_invoke_within(
       cconv_arguments, /*segment_size_list=*/NULL, &arguments.data_length));
   arguments.data = iree_alloca(arguments.data_length);
   memset(arguments.data, 0, arguments.data_length);
-  IREE_RETURN_IF_ERROR(
-      iree_vm_invoke_marshal_inputs(cconv_arguments, inputs, arguments));
 
   // Allocate the result output that will be populated by the callee.
   iree_byte_span_t results = iree_make_byte_span(NULL, 0);
@@ -170,6 +197,13 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
+  iree_status_t status =
+      iree_vm_invoke_marshal_inputs(cconv_arguments, inputs, arguments);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_invoke_release_fragment(cconv_arguments, arguments);
+    return status;
+  }
+
   // Perform execution. Note that for synchronous execution we expect this to
   // complete without yielding.
   iree_vm_function_call_t call;
@@ -178,18 +212,17 @@ static iree_status_t iree_vm_invoke_within(
   call.arguments = arguments;
   call.results = results;
   iree_vm_execution_result_t result;
-  iree_status_t status =
+  status =
       function.module->begin_call(function.module->self, stack, &call, &result);
-  if (!iree_status_is_ok(status)) {
-    iree_vm_function_call_release(&call, &signature);
-    return status;
-  }
 
   // Read back the outputs from the result buffer.
-  IREE_RETURN_IF_ERROR(
-      iree_vm_invoke_marshal_outputs(cconv_results, results, outputs));
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(cconv_results, results, outputs);
+  }
 
-  return iree_ok_status();
+  iree_vm_invoke_release_fragment(cconv_arguments, arguments);
+  iree_vm_invoke_release_fragment(cconv_results, results);
+  return status;
 }
 
 IREE_API_EXPORT iree_status_t iree_vm_invoke(
@@ -208,3 +241,231 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+
+  // Call with arguments and results stored in the trailing allocation.
+  iree_vm_function_call_t call;
+  iree_string_view_t cconv_arguments;
+  iree_string_view_t cconv_results;
+
+  // Stack holding the frames of the in-flight call or NULL once completed.
+  iree_vm_stack_t* stack;
+  // True once the call has been issued with begin_call.
+  bool started;
+  // State of the call as of the last begin_call or resume_call.
+  iree_vm_execution_result_t result;
+
+  // Outputs of the call; populated only if it completed successfully.
+  iree_vm_list_t* outputs;
+  // Final status of the invocation; only valid once |stack| is NULL.
+  iree_status_t status;
+};
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+  iree_host_size_t arguments_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_arguments, /*segment_size_list=*/NULL, &arguments_size));
+  iree_host_size_t results_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_results, /*segment_size_list=*/NULL, &results_size));
+
+  // The ABI argument and result buffers must outlive any suspension and are
+  // stored immediately following the invocation.
+  iree_host_size_t arguments_offset =
+      iree_host_align(sizeof(iree_vm_invocation_t), iree_max_align_t);
+  iree_host_size_t results_offset =
+      iree_host_align(arguments_offset + arguments_size, iree_max_align_t);
+  iree_host_size_t total_size = results_offset + results_size;
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, total_size, (void**)&invocation));
+  memset(invocation, 0, total_size);
+  iree_atomic_ref_count_init(&invocation->ref_count);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->call.function = function;
+  invocation->call.arguments = iree_make_byte_span(
+      (uint8_t*)invocation + arguments_offset, arguments_size);
+  invocation->call.results = iree_make_byte_span(
+      (uint8_t*)invocation + results_offset, results_size);
+  invocation->cconv_arguments = cconv_arguments;
+  invocation->cconv_results = cconv_results;
+
+  // NOTE: today we don't support variadic arguments through this interface.
+  iree_status_t status = iree_vm_invoke_marshal_inputs(
+      cconv_arguments, (iree_vm_list_t*)inputs, invocation->call.arguments);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_create(/*element_type=*/NULL,
+                                 /*initial_capacity=*/0, allocator,
+                                 &invocation->outputs);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_allocate(iree_vm_context_state_resolver(context),
+                                    allocator, &invocation->stack);
+  }
+  if (iree_status_is_ok(status)) {
+    iree_vm_stack_set_suspendable(invocation->stack, true);
+    *out_invocation = invocation;
+  } else {
+    iree_vm_invocation_release(invocation);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Releases the references held in the ABI argument and result buffers of the
+// call. Arguments are retained from the inputs on creation and remain owned by
+// the invocation if the call is never started, is borrowed by a native callee,
+// or is aborted while suspended.
+static void iree_vm_invocation_release_call(iree_vm_invocation_t* invocation) {
+  iree_vm_invoke_release_fragment(invocation->cconv_arguments,
+                                  invocation->call.arguments);
+  iree_vm_invoke_release_fragment(invocation->cconv_results,
+                                  invocation->call.results);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_atomic_ref_count_inc(&invocation->ref_count);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  if (invocation && iree_atomic_ref_count_dec(&invocation->ref_count) == 1) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    if (invocation->stack) iree_vm_stack_free(invocation->stack);
+    iree_vm_invocation_release_call(invocation);
+    iree_status_ignore(invocation->status);
+    iree_vm_list_release(invocation->outputs);
+    iree_vm_context_release(invocation->context);
+    iree_allocator_free(invocation->allocator, invocation);
+    IREE_TRACE_ZONE_END(z0);
+  }
+  return iree_ok_status();
+}
+
+// Completes |invocation| with |status|, reading back the outputs on success.
+static void iree_vm_invocation_complete(iree_vm_invocation_t* invocation,
+                                        iree_status_t status) {
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(invocation->cconv_results,
+                                            invocation->call.results,
+                                            invocation->outputs);
+  }
+  iree_vm_stack_free(invocation->stack);
+  invocation->stack = NULL;
+  iree_vm_invocation_release_call(invocation);
+  invocation->status = status;
+}
+
+// Advances |invocation| by beginning or resuming the call once if it is able
+// to make progress within |timeout|. Returns false if the call is waiting and
+// the wait did not resolve in time.
+static bool iree_vm_invocation_step(iree_vm_invocation_t* invocation,
+                                    iree_timeout_t timeout) {
+  if (!invocation->stack) return true;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_module_t* module = invocation->call.function.module;
+  iree_status_t status = iree_ok_status();
+  if (!invocation->started) {
+    invocation->started = true;
+    status = module->begin_call(module->self, invocation->stack,
+                                &invocation->call, &invocation->result);
+  } else {
+    if (invocation->result.state == IREE_VM_EXECUTION_STATE_WAITING) {
+      status = iree_vm_stack_resolve_wait(invocation->stack, timeout);
+      if (iree_status_is_deadline_exceeded(status)) {
+        iree_status_ignore(status);
+        IREE_TRACE_ZONE_END(z0);
+        return false;
+      }
+    }
+    if (iree_status_is_ok(status)) {
+      status = module->resume_call(module->self, invocation->stack,
+                                   &invocation->call, &invocation->result);
+    }
+  }
+  if (!iree_status_is_ok(status) ||
+      invocation->result.state == IREE_VM_EXECUTION_STATE_COMPLETED) {
+    iree_vm_invocation_complete(invocation, status);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return true;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_vm_invocation_step(invocation, iree_immediate_timeout());
+  if (invocation->stack) {
+    return iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* iree_vm_invocation_output(
+    iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (invocation->stack || !iree_status_is_ok(invocation->status)) {
+    return NULL;
+  }
+  return invocation->outputs;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_timeout_t timeout = iree_make_deadline(deadline);
+  while (invocation->stack) {
+    if (!iree_vm_invocation_step(invocation, timeout) ||
+        (invocation->stack && iree_time_now() >= deadline)) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!invocation->stack) return iree_ok_status();
+  // Tearing down the stack releases all references held by suspended frames
+  // and any pending wait.
+  iree_vm_stack_free(invocation->stack);
+  invocation->stack = NULL;
+  iree_vm_invocation_release_call(invocation);
+  invocation->status =
+      iree_make_status(IREE_STATUS_ABORTED, "invocation aborted");
+  return iree_ok_status();
+}
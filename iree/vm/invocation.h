@@ -39,7 +39,21 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Creates an asynchronous invocation of |function| in the VM.
+// Returns immediately without executing the function; execution makes progress
+// each time the invocation is queried with iree_vm_invocation_query_status or
+// awaited with iree_vm_invocation_await. Functions may suspend when they yield
+// or wait on asynchronous work (such as a HAL semaphore) and the caller thread
+// is free to drive other invocations in the meantime. Invocations are not
+// thread-safe and must only be driven from one thread at a time.
+//
+// |policy| is used to schedule the invocation relative to other pending or
+// in-flight invocations. It may be omitted to leave the behavior up to the
+// implementation.
+//
+// |inputs| is used to pass values and objects into the target function and must
+// match the signature defined by the compiled function. The input values are
+// captured during creation and list ownership remains with the caller.
 IREE_API_EXPORT iree_status_t iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
@@ -54,6 +68,9 @@ IREE_API_EXPORT iree_status_t
 iree_vm_invocation_release(iree_vm_invocation_t* invocation);
 
 // Queries the completion status of the invocation.
+// Advances the invocation if it is able to make progress without blocking:
+// a yielded invocation is resumed once and a waiting invocation is resumed if
+// its wait has resolved.
 // Returns one of the following:
 //   IREE_STATUS_OK: the invocation completed successfully.
 //   IREE_STATUS_UNAVAILABLE: the invocation has not yet completed.
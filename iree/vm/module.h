@@ -249,14 +249,25 @@ IREE_API_EXPORT void iree_vm_function_call_release(
     iree_vm_function_call_t* call,
     const iree_vm_function_signature_t* signature);
 
+// Describes the state of a call when control returns to the caller.
+enum iree_vm_execution_state_e {
+  // The call has completed and its results have been written.
+  IREE_VM_EXECUTION_STATE_COMPLETED = 0,
+  // The call yielded (such as via vm.yield) and may be resumed immediately.
+  IREE_VM_EXECUTION_STATE_YIELDED = 1,
+  // The call is suspended on the wait registered on the stack with
+  // iree_vm_stack_wait and may be resumed once it has been resolved.
+  IREE_VM_EXECUTION_STATE_WAITING = 2,
+};
+typedef uint32_t iree_vm_execution_state_t;
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Whether the call completed or needs to be resumed with resume_call.
+  // Calls may only suspend when issued on a stack that has been marked as
+  // suspendable with iree_vm_stack_set_suspendable and otherwise always
+  // complete before returning.
+  iree_vm_execution_state_t state;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -319,9 +330,12 @@ typedef struct iree_vm_module {
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
-  // Resumes execution of a previously-yielded call.
+  // Resumes execution of a previously-suspended call.
+  // |call| must be the same call passed to begin_call and the results will be
+  // written to it when the call completes. Any wait pending on the stack must
+  // have been resolved prior to resuming.
   iree_status_t(IREE_API_PTR* resume_call)(
-      void* self, iree_vm_stack_t* stack,
+      void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // TODO(benvanik): move this/refactor.
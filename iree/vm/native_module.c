@@ -296,6 +296,7 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
   const iree_vm_native_function_ptr_t* function_ptr =
       &module->descriptor->functions[call->function.ordinal];
   iree_vm_module_state_t* module_state = callee_frame->module_state;
+  out_result->state = IREE_VM_EXECUTION_STATE_COMPLETED;
   iree_status_t status = function_ptr->shim(stack, call, function_ptr->target,
                                             module, module_state, out_result);
   if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
@@ -309,18 +310,28 @@ static iree_status_t IREE_API_PTR iree_vm_native_module_begin_call(
                                   (int)function_name.size, function_name.data);
   }
 
+  // Functions that need to wait register the wait on the stack and return
+  // without producing results; the call is reissued once the wait resolves.
+  if (iree_vm_stack_pending_wait(stack)) {
+    out_result->state = IREE_VM_EXECUTION_STATE_WAITING;
+  }
+
   return iree_vm_stack_function_leave(stack);
 }
 
-static iree_status_t IREE_API_PTR
-iree_vm_native_module_resume_call(void* self, iree_vm_stack_t* stack,
-                                  iree_vm_execution_result_t* out_result) {
+static iree_status_t IREE_API_PTR iree_vm_native_module_resume_call(
+    void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
+    iree_vm_execution_result_t* out_result) {
   iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
   if (module->user_interface.resume_call) {
-    return module->user_interface.resume_call(module->self, stack, out_result);
+    return module->user_interface.resume_call(module->self, stack, call,
+                                              out_result);
+  } else if (module->user_interface.begin_call) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "native module does not support resume");
   }
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "native module does not support resume");
+  // Native functions keep no state across suspension and are reissued.
+  return iree_vm_native_module_begin_call(self, stack, call, out_result);
 }
 
 IREE_API_EXPORT iree_status_t iree_vm_native_module_create(
@@ -86,6 +86,36 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
+  // Creates an asynchronous invocation of module_b.entry with |arg0|.
+  StatusOr<iree_vm_invocation_t*> CreateInvocation(int32_t arg0) {
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(iree_vm_context_resolve_function(
+        context_, iree_make_cstring_view("module_b.entry"), &function));
+    vm::ref<iree_vm_list_t> input_list;
+    IREE_RETURN_IF_ERROR(iree_vm_list_create(
+        /*element_type=*/nullptr, 1, iree_allocator_system(), &input_list));
+    auto arg0_value = iree_vm_value_make_i32(arg0);
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_push_value(input_list.get(), &arg0_value));
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_invocation_create(
+        context_, function, /*policy=*/nullptr, input_list.get(),
+        iree_allocator_system(), &invocation));
+    return invocation;
+  }
+
+  // Returns the i32 result of a completed |invocation|.
+  static StatusOr<int32_t> InvocationResult(iree_vm_invocation_t* invocation) {
+    const iree_vm_list_t* output_list = iree_vm_invocation_output(invocation);
+    if (!output_list) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "invocation has not completed successfully");
+    }
+    iree_vm_value_t ret0_value;
+    IREE_RETURN_IF_ERROR(iree_vm_list_get_value(output_list, 0, &ret0_value));
+    return ret0_value.i32;
+  }
+
  private:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
@@ -103,5 +133,62 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+TEST_F(VMNativeModuleTest, InvocationQueryStatus) {
+  IREE_ASSERT_OK_AND_ASSIGN(iree_vm_invocation_t * invocation,
+                            CreateInvocation(2));
+  // Native functions complete the first time they are issued.
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v0, InvocationResult(invocation));
+  EXPECT_EQ(2, v0);
+  // Querying a completed invocation does not run it again.
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v1, InvocationResult(invocation));
+  EXPECT_EQ(2, v1);
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleTest, InvocationAwait) {
+  IREE_ASSERT_OK_AND_ASSIGN(iree_vm_invocation_t * invocation,
+                            CreateInvocation(3));
+  IREE_EXPECT_OK(
+      iree_vm_invocation_await(invocation, IREE_TIME_INFINITE_FUTURE));
+  IREE_ASSERT_OK_AND_ASSIGN(int32_t v0, InvocationResult(invocation));
+  EXPECT_EQ(3, v0);
+  // Aborting a completed invocation has no effect.
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_query_status(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+}
+
+TEST_F(VMNativeModuleTest, InvocationAbortBeforeStart) {
+  IREE_ASSERT_OK_AND_ASSIGN(iree_vm_invocation_t * invocation,
+                            CreateInvocation(1));
+  IREE_EXPECT_OK(iree_vm_invocation_abort(invocation));
+  EXPECT_THAT(Status(iree_vm_invocation_query_status(invocation)),
+              testing::status::StatusIs(StatusCode::kAborted));
+  EXPECT_THAT(Status(iree_vm_invocation_await(invocation,
+                                              IREE_TIME_INFINITE_FUTURE)),
+              testing::status::StatusIs(StatusCode::kAborted));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+
+  // The function never ran and did not accumulate |arg0|.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 2));
+  EXPECT_EQ(2, v0);
+}
+
+TEST_F(VMNativeModuleTest, InvocationReleaseBeforeStart) {
+  IREE_ASSERT_OK_AND_ASSIGN(iree_vm_invocation_t * invocation,
+                            CreateInvocation(1));
+  EXPECT_EQ(nullptr, iree_vm_invocation_output(invocation));
+  IREE_EXPECT_OK(iree_vm_invocation_release(invocation));
+
+  // The function never ran and did not accumulate |arg0|.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 2));
+  EXPECT_EQ(2, v0);
+}
+
 }  // namespace
 }  // namespace iree
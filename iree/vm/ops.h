@@ -28,6 +28,39 @@ static inline void vm_global_store_i32(uint8_t* base, uint32_t byte_offset,
   *global_ptr = value;
 }
 
+static inline int64_t vm_global_load_i64(uint8_t* base, uint32_t byte_offset) {
+  const int64_t* global_ptr = (const int64_t*)(base + byte_offset);
+  return *global_ptr;
+}
+
+static inline void vm_global_store_i64(uint8_t* base, uint32_t byte_offset,
+                                       int64_t value) {
+  int64_t* global_ptr = (int64_t*)(base + byte_offset);
+  *global_ptr = value;
+}
+
+static inline float vm_global_load_f32(uint8_t* base, uint32_t byte_offset) {
+  const float* global_ptr = (const float*)(base + byte_offset);
+  return *global_ptr;
+}
+
+static inline void vm_global_store_f32(uint8_t* base, uint32_t byte_offset,
+                                       float value) {
+  float* global_ptr = (float*)(base + byte_offset);
+  *global_ptr = value;
+}
+
+static inline double vm_global_load_f64(uint8_t* base, uint32_t byte_offset) {
+  const double* global_ptr = (const double*)(base + byte_offset);
+  return *global_ptr;
+}
+
+static inline void vm_global_store_f64(uint8_t* base, uint32_t byte_offset,
+                                       double value) {
+  double* global_ptr = (double*)(base + byte_offset);
+  *global_ptr = value;
+}
+
 //===------------------------------------------------------------------===//
 // Conditional assignment
 //===------------------------------------------------------------------===//
@@ -311,6 +344,118 @@ static inline int32_t vm_cmp_nz_i64(int64_t operand) {
   return (operand != 0) ? 1 : 0;
 }
 
+//===------------------------------------------------------------------===//
+// ExtF64: Conditional assignment
+//===------------------------------------------------------------------===//
+
+static inline double vm_select_f64(int32_t condition, double true_value,
+                                   double false_value) {
+  return condition ? true_value : false_value;
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Native floating-point arithmetic
+//===------------------------------------------------------------------===//
+
+static inline double vm_add_f64(double lhs, double rhs) { return lhs + rhs; }
+static inline double vm_sub_f64(double lhs, double rhs) { return lhs - rhs; }
+static inline double vm_mul_f64(double lhs, double rhs) { return lhs * rhs; }
+static inline double vm_div_f64(double lhs, double rhs) { return lhs / rhs; }
+static inline double vm_rem_f64(double lhs, double rhs) {
+  return remainder(lhs, rhs);
+}
+static inline double vm_fma_f64(double a, double b, double c) {
+#ifdef FP_FAST_FMA
+  return fma(a, b, c);
+#else
+  return a * b + c;
+#endif  // FP_FAST_FMA
+}
+static inline double vm_abs_f64(double operand) { return fabs(operand); }
+static inline double vm_neg_f64(double operand) { return -operand; }
+static inline double vm_ceil_f64(double operand) { return ceil(operand); }
+static inline double vm_floor_f64(double operand) { return floor(operand); }
+
+static inline double vm_atan_f64(double operand) { return atan(operand); }
+static inline double vm_atan2_f64(double y, double x) { return atan2(y, x); }
+static inline double vm_cos_f64(double operand) { return cos(operand); }
+static inline double vm_sin_f64(double operand) { return sin(operand); }
+static inline double vm_exp_f64(double operand) { return exp(operand); }
+static inline double vm_exp2_f64(double operand) { return exp2(operand); }
+static inline double vm_expm1_f64(double operand) { return expm1(operand); }
+static inline double vm_log_f64(double operand) { return log(operand); }
+static inline double vm_log10_f64(double operand) { return log10(operand); }
+static inline double vm_log1p_f64(double operand) { return log1p(operand); }
+static inline double vm_log2_f64(double operand) { return log2(operand); }
+static inline double vm_pow_f64(double b, double e) { return pow(b, e); }
+static inline double vm_rsqrt_f64(double operand) {
+  return 1.0 / sqrt(operand);
+}
+static inline double vm_sqrt_f64(double operand) { return sqrt(operand); }
+static inline double vm_tanh_f64(double operand) { return tanh(operand); }
+
+//===------------------------------------------------------------------===//
+// ExtF64: Casting and type conversion/emulation
+//===------------------------------------------------------------------===//
+
+static inline float vm_trunc_f64f32(double operand) { return (float)operand; }
+static inline double vm_ext_f32f64(float operand) { return (double)operand; }
+
+static inline double vm_cast_si32f64(int32_t operand) {
+  return (double)operand;
+}
+static inline double vm_cast_ui32f64(int32_t operand) {
+  return (double)(uint32_t)operand;
+}
+static inline int32_t vm_cast_f64si32(double operand) {
+  return (int32_t)round(operand);
+}
+static inline int32_t vm_cast_f64ui32(double operand) {
+  return (uint32_t)round(operand);
+}
+static inline double vm_cast_si64f64(int64_t operand) {
+  return (double)operand;
+}
+static inline double vm_cast_ui64f64(int64_t operand) {
+  return (double)(uint64_t)operand;
+}
+static inline int64_t vm_cast_f64si64(double operand) {
+  return (int64_t)round(operand);
+}
+static inline int64_t vm_cast_f64ui64(double operand) {
+  return (uint64_t)round(operand);
+}
+
+//===------------------------------------------------------------------===//
+// ExtF64: Comparison ops
+//===------------------------------------------------------------------===//
+
+static inline int32_t vm_cmp_eq_f64o(double lhs, double rhs) {
+  return (lhs == rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_eq_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || (lhs == rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f64o(double lhs, double rhs) {
+  return (lhs != rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_ne_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || (lhs != rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f64o(double lhs, double rhs) {
+  return isless(lhs, rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lt_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || isless(lhs, rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f64o(double lhs, double rhs) {
+  return islessequal(lhs, rhs) ? 1 : 0;
+}
+static inline int32_t vm_cmp_lte_f64u(double lhs, double rhs) {
+  return (isunordered(lhs, rhs) || islessequal(lhs, rhs)) ? 1 : 0;
+}
+static inline int32_t vm_cmp_nan_f64(double operand) { return isnan(operand); }
+
 //===------------------------------------------------------------------===//
 // Utility macros (Used for things that EmitC can't hadnle)
 //===------------------------------------------------------------------===//
@@ -72,4 +72,35 @@ static iree_status_t call_0ii_i_shim(iree_vm_stack_t* stack,
                    &results->ret0);
 }
 
+// Calls the resolved |import| with the given packed |arguments| and |results|
+// buffers laid out per the import calling convention. Generated code cannot
+// suspend so any wait the callee yields on is resolved here by blocking.
+static iree_status_t call_import_shim(iree_vm_stack_t* stack,
+                                      const iree_vm_function_t* import,
+                                      iree_byte_span_t arguments,
+                                      iree_byte_span_t results) {
+  if (IREE_UNLIKELY(!import->module)) {
+    return iree_make_status(IREE_STATUS_NOT_FOUND,
+                            "import %u has not been resolved",
+                            (uint32_t)import->ordinal);
+  }
+  iree_vm_function_call_t call;
+  call.function = *import;
+  call.arguments = arguments;
+  call.results = results;
+  iree_vm_execution_result_t result;
+  memset(&result, 0, sizeof(result));
+  iree_status_t status = import->module->begin_call(import->module->self,
+                                                    stack, &call, &result);
+  while (iree_status_is_ok(status) &&
+         result.state != IREE_VM_EXECUTION_STATE_COMPLETED) {
+    status = iree_vm_stack_resolve_wait(stack, iree_infinite_timeout());
+    if (iree_status_is_ok(status)) {
+      status = import->module->resume_call(import->module->self, stack, &call,
+                                           &result);
+    }
+  }
+  return status;
+}
+
 #endif  // IREE_VM_SHIMS_EMITC_H_
@@ -181,6 +181,12 @@ struct iree_vm_stack {
   // Allocator used for dynamic stack allocations. May be the null allocator
   // if growth is prohibited.
   iree_allocator_t allocator;
+
+  // True if functions executing on the stack may suspend.
+  bool suspendable;
+
+  // Wait that must be resolved before a suspended call can resume.
+  iree_vm_wait_t pending_wait;
 };
 
 //===----------------------------------------------------------------------===//
@@ -228,6 +234,9 @@ IREE_API_EXPORT void iree_vm_stack_deinitialize(iree_vm_stack_t* stack) {
     iree_status_ignore(iree_vm_stack_function_leave(stack));
   }
 
+  stack->pending_wait.fn = NULL;
+  iree_vm_ref_release(&stack->pending_wait.target);
+
   if (stack->owns_frame_storage) {
     iree_allocator_free(stack->allocator, stack->frame_storage);
   }
@@ -288,6 +297,54 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_query_module_state(
                                                   module, out_module_state);
 }
 
+IREE_API_EXPORT void iree_vm_stack_set_suspendable(iree_vm_stack_t* stack,
+                                                   bool suspendable) {
+  stack->suspendable = suspendable;
+}
+
+IREE_API_EXPORT bool iree_vm_stack_is_suspendable(iree_vm_stack_t* stack) {
+  return stack->suspendable;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_stack_wait(iree_vm_stack_t* stack,
+                                                 iree_vm_wait_fn_t fn,
+                                                 iree_vm_ref_t* target,
+                                                 uint64_t value) {
+  IREE_ASSERT_ARGUMENT(fn);
+  IREE_ASSERT_ARGUMENT(target);
+  if (IREE_UNLIKELY(!stack->suspendable)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "stack is not suspendable");
+  } else if (IREE_UNLIKELY(stack->pending_wait.fn)) {
+    return iree_make_status(IREE_STATUS_ALREADY_EXISTS,
+                            "stack already has a pending wait");
+  }
+  stack->pending_wait.fn = fn;
+  iree_vm_ref_retain(target, &stack->pending_wait.target);
+  stack->pending_wait.value = value;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT const iree_vm_wait_t* iree_vm_stack_pending_wait(
+    iree_vm_stack_t* stack) {
+  return stack->pending_wait.fn ? &stack->pending_wait : NULL;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_stack_resolve_wait(iree_vm_stack_t* stack, iree_timeout_t timeout) {
+  if (!stack->pending_wait.fn) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status =
+      stack->pending_wait.fn(&stack->pending_wait.target,
+                             stack->pending_wait.value, timeout);
+  if (iree_status_is_ok(status)) {
+    stack->pending_wait.fn = NULL;
+    iree_vm_ref_release(&stack->pending_wait.target);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Attempts to grow the stack store to hold at least |minimum_capacity|.
 // Pointers to existing stack frames will be invalidated and any pointers
 // embedded in the stack frame data structures will be updated.
@@ -204,6 +204,62 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter(
 IREE_API_EXPORT iree_status_t
 iree_vm_stack_function_leave(iree_vm_stack_t* stack);
 
+//===----------------------------------------------------------------------===//
+// Suspension
+//===----------------------------------------------------------------------===//
+// Stacks marked as suspendable allow the functions executing on them to return
+// control to the caller before they have completed, such as when yielding or
+// when waiting on an asynchronous operation. The frames of the suspended
+// functions remain on the stack and execution continues when the caller
+// resumes the call. Stacks default to non-suspendable so that existing
+// synchronous callers always observe completed calls.
+
+// Callback used to resolve a wait registered with iree_vm_stack_wait.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED if the wait did not complete before
+// |timeout| elapsed.
+typedef iree_status_t(IREE_API_PTR* iree_vm_wait_fn_t)(iree_vm_ref_t* target,
+                                                     uint64_t value,
+                                                     iree_timeout_t timeout);
+
+// A wait pending on a suspended stack.
+typedef struct iree_vm_wait {
+  // Resolves the wait; NULL if no wait is pending.
+  iree_vm_wait_fn_t fn;
+  // Object being waited on (such as a semaphore), retained by the stack.
+  iree_vm_ref_t target;
+  // Implementation-defined payload (such as a semaphore value).
+  uint64_t value;
+} iree_vm_wait_t;
+
+// Sets whether functions executing on |stack| may suspend.
+IREE_API_EXPORT void iree_vm_stack_set_suspendable(iree_vm_stack_t* stack,
+                                                   bool suspendable);
+
+// Returns true if functions executing on |stack| may suspend.
+IREE_API_EXPORT bool iree_vm_stack_is_suspendable(iree_vm_stack_t* stack);
+
+// Registers a wait on |target| that must be resolved before the current call
+// is resumed. |target| is retained until the wait is resolved or the stack is
+// deinitialized. Native functions registering a wait must return without
+// side-effects as they will be reissued with the same arguments upon resume.
+//
+// Fails with IREE_STATUS_FAILED_PRECONDITION if the stack is not suspendable
+// and IREE_STATUS_ALREADY_EXISTS if a wait is already pending.
+IREE_API_EXPORT iree_status_t iree_vm_stack_wait(iree_vm_stack_t* stack,
+                                                 iree_vm_wait_fn_t fn,
+                                                 iree_vm_ref_t* target,
+                                                 uint64_t value);
+
+// Returns the wait pending on |stack| or NULL if there is none.
+IREE_API_EXPORT const iree_vm_wait_t* iree_vm_stack_pending_wait(
+    iree_vm_stack_t* stack);
+
+// Resolves the wait pending on |stack|, if any, waiting up to |timeout|.
+// Returns IREE_STATUS_DEADLINE_EXCEEDED and keeps the wait pending if it did
+// not complete in time.
+IREE_API_EXPORT iree_status_t
+iree_vm_stack_resolve_wait(iree_vm_stack_t* stack, iree_timeout_t timeout);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
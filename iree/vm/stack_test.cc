@@ -202,4 +202,51 @@ TEST(VMStackTest, ModuleStateQueryFailure) {
   iree_vm_stack_deinitialize(stack);
 }
 
+// Tests that waits can only be registered on suspendable stacks and that they
+// remain pending until resolved.
+TEST(VMStackTest, SuspendableWait) {
+  iree_vm_state_resolver_t state_resolver = {nullptr, SentinelStateResolver};
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, state_resolver,
+                                  iree_allocator_system());
+
+  static bool ready = false;
+  iree_vm_wait_fn_t wait_fn = +[](iree_vm_ref_t* target, uint64_t value,
+                                  iree_timeout_t timeout) -> iree_status_t {
+    EXPECT_EQ(123u, value);
+    return ready ? iree_ok_status()
+                 : iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  };
+  iree_vm_ref_t target = {0};
+
+  // Stacks are not suspendable by default.
+  EXPECT_FALSE(iree_vm_stack_is_suspendable(stack));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_FAILED_PRECONDITION,
+      ::iree::Status(iree_vm_stack_wait(stack, wait_fn, &target, 123)));
+  EXPECT_EQ(nullptr, iree_vm_stack_pending_wait(stack));
+
+  iree_vm_stack_set_suspendable(stack, true);
+  EXPECT_TRUE(iree_vm_stack_is_suspendable(stack));
+  IREE_EXPECT_OK(iree_vm_stack_wait(stack, wait_fn, &target, 123));
+  ASSERT_NE(nullptr, iree_vm_stack_pending_wait(stack));
+  EXPECT_EQ(123u, iree_vm_stack_pending_wait(stack)->value);
+
+  // Only one wait may be pending at a time.
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_ALREADY_EXISTS,
+      ::iree::Status(iree_vm_stack_wait(stack, wait_fn, &target, 123)));
+
+  // Unresolved waits remain pending.
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DEADLINE_EXCEEDED,
+                        ::iree::Status(iree_vm_stack_resolve_wait(
+                            stack, iree_immediate_timeout())));
+  EXPECT_NE(nullptr, iree_vm_stack_pending_wait(stack));
+
+  ready = true;
+  IREE_EXPECT_OK(iree_vm_stack_resolve_wait(stack, iree_immediate_timeout()));
+  EXPECT_EQ(nullptr, iree_vm_stack_pending_wait(stack));
+
+  iree_vm_stack_deinitialize(stack);
+}
+
 }  // namespace
@@ -0,0 +1,38 @@
+vm.module @assignment_ops_f64 {
+
+  //===--------------------------------------------------------------------===//
+  // ExtF64: Conditional assignment
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_select_f64
+  vm.func @test_select_f64() {
+    %c0 = vm.const.i32 0 : i32
+    %c0dno = iree.do_not_optimize(%c0) : i32
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %c2 = vm.const.f64 0.0 : f64
+    %c3 = vm.const.f64 1.0 : f64
+    %v1 = vm.select.f64 %c0dno, %c2, %c3 : f64
+    vm.check.eq %v1, %c3, "0 ? 0 : 1 = 1" : f64
+    %v2 = vm.select.f64 %c1dno, %c2, %c3 : f64
+    vm.check.eq %v2, %c2, "1 ? 0 : 1 = 0" : f64
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // ExtF64: Branch operands
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_br_swap_f64
+  vm.func @test_br_swap_f64() {
+    %c1 = vm.const.f64 1.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 -2.5 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    vm.br ^bb1(%c2dno, %c1dno : f64, f64)
+  ^bb1(%lhs : f64, %rhs : f64):
+    vm.check.eq %lhs, %c2, "lhs = -2.5" : f64
+    vm.check.eq %rhs, %c1, "rhs = 1.5" : f64
+    vm.return
+  }
+}
@@ -493,6 +493,24 @@ vm.module @buffer_ops {
     vm.return
   }
 
+  // A load whose only use is an add; the sum wraps around.
+  vm.export @test_load_i32_add
+  vm.func @test_load_i32_add() {
+    %c4 = vm.const.i32 4 : i32
+    %c8 = vm.const.i32 8 : i32
+    %c2 = vm.const.i32 2 : i32
+    %rodata = vm.const.ref.rodata @test_load_i32_data : !vm.buffer
+    %v0 = vm.buffer.load.i32 %rodata[%c4] : !vm.buffer -> i32
+    %s0 = vm.add.i32 %c2, %v0 : i32
+    %e0 = vm.const.i32 3 : i32
+    vm.check.eq %s0, %e0, "2+1" : i32
+    %v1 = vm.buffer.load.i32 %rodata[%c8] : !vm.buffer -> i32
+    %s1 = vm.add.i32 %v1, %c2 : i32
+    %e1 = vm.const.i32 0x80000001 : i32
+    vm.check.eq %s1, %e1, "0x7FFFFFFF+2" : i32
+    vm.return
+  }
+
   vm.rodata @test_load_i32_unaligned_data dense<[0x00112233, 0x44556677, 0x8899AABB, 0xCCDDEEFF]> : tensor<4xui32>
 
   // Unaligned loads are not supported and offsets will be rounded down.
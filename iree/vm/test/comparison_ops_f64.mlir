@@ -0,0 +1,97 @@
+vm.module @comparison_ops_f64 {
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lt.f64
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_0_f64
+  vm.func @test_cmp_lt_0_f64() {
+    %lhs = vm.const.f64 4.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 -4.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "4.0 < -4.0" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_1_f64
+  vm.func @test_cmp_lt_1_f64() {
+    %lhs = vm.const.f64 -4.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 4.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "-4.0 < 4.0" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.*.f64 pseudo-ops
+  //===--------------------------------------------------------------------===//
+  // NOTE: all of these are turned in to some variants of vm.cmp.lt by the
+  // compiler and are here as a way to test the runtime behavior of the
+  // pseudo-op expansions.
+
+  vm.export @test_cmp_lte_f64
+  vm.func @test_cmp_lte_f64() {
+    %true = vm.const.i32 1 : i32
+    %false = vm.const.i32 0 : i32
+
+    %cn2 = vm.const.f64 -2.0 : f64
+    %cn2_dno = iree.do_not_optimize(%cn2) : f64
+    %c2 = vm.const.f64 2.0 : f64
+    %c2_dno = iree.do_not_optimize(%c2) : f64
+
+    %cmp_0 = vm.cmp.lte.f64.o %cn2_dno, %c2_dno : f64
+    vm.check.eq %cmp_0, %true, "-2 <= 2" : i32
+    %cmp_1 = vm.cmp.lte.f64.o %c2_dno, %cn2_dno : f64
+    vm.check.eq %cmp_1, %false, "2 <= -2" : i32
+    %cmp_2 = vm.cmp.lte.f64.o %c2_dno, %c2_dno : f64
+    vm.check.eq %cmp_2, %true, "2 <= 2" : i32
+
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f64
+  vm.func @test_cmp_gt_f64() {
+    %true = vm.const.i32 1 : i32
+    %false = vm.const.i32 0 : i32
+
+    %cn2 = vm.const.f64 -2.0 : f64
+    %cn2_dno = iree.do_not_optimize(%cn2) : f64
+    %c2 = vm.const.f64 2.0 : f64
+    %c2_dno = iree.do_not_optimize(%c2) : f64
+
+    %cmp_0 = vm.cmp.gt.f64.o %cn2_dno, %c2_dno : f64
+    vm.check.eq %cmp_0, %false, "-2 > 2" : i32
+    %cmp_1 = vm.cmp.gt.f64.o %c2_dno, %cn2_dno : f64
+    vm.check.eq %cmp_1, %true, "2 > -2" : i32
+    %cmp_2 = vm.cmp.gt.f64.o %c2_dno, %c2_dno : f64
+    vm.check.eq %cmp_2, %false, "2 > 2" : i32
+
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f64
+  vm.func @test_cmp_gte_f64() {
+    %true = vm.const.i32 1 : i32
+    %false = vm.const.i32 0 : i32
+
+    %cn2 = vm.const.f64 -2.0 : f64
+    %cn2_dno = iree.do_not_optimize(%cn2) : f64
+    %c2 = vm.const.f64 2.0 : f64
+    %c2_dno = iree.do_not_optimize(%c2) : f64
+
+    %cmp_0 = vm.cmp.gte.f64.o %cn2_dno, %c2_dno : f64
+    vm.check.eq %cmp_0, %false, "-2 >= 2" : i32
+    %cmp_1 = vm.cmp.gte.f64.o %c2_dno, %cn2_dno : f64
+    vm.check.eq %cmp_1, %true, "2 >= -2" : i32
+    %cmp_2 = vm.cmp.gte.f64.o %c2_dno, %c2_dno : f64
+    vm.check.eq %cmp_2, %true, "2 >= 2" : i32
+
+    vm.return
+  }
+}
@@ -41,4 +41,23 @@ vm.module @control_flow_ops {
     vm.return
   }
 
+  //===--------------------------------------------------------------------===//
+  // vm.yield
+  //===--------------------------------------------------------------------===//
+
+  // Yields are no-ops when invoked synchronously; asynchronous invocations
+  // suspend at each yield (see bytecode_module_test.cc).
+  vm.export @test_yield
+  vm.func @test_yield() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    vm.yield
+    %c2 = vm.add.i32 %c1dno, %c1dno : i32
+    vm.yield
+    %c2dno = iree.do_not_optimize(%c2) : i32
+    %c2_0 = vm.const.i32 2 : i32
+    vm.check.eq %c2dno, %c2_0, "error!" : i32
+    vm.return
+  }
+
 }
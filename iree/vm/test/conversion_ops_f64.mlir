@@ -0,0 +1,37 @@
+vm.module @conversion_ops_f64 {
+
+  //===----------------------------------------------------------------------===//
+  // Casting and type conversion/emulation
+  //===----------------------------------------------------------------------===//
+
+  vm.export @test_trunc_f64_f32
+  vm.func @test_trunc_f64_f32() {
+    %c1 = vm.const.f64 1.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.trunc.f64.f32 %c1dno : f64 -> f32
+    %c2 = vm.const.f32 1.5 : f32
+    vm.check.eq %v, %c2, "truncate f64 to f32" : f32
+    vm.return
+  }
+
+  vm.export @test_trunc_f64_f32_rounding
+  vm.func @test_trunc_f64_f32_rounding() {
+    %c1 = vm.const.f64 1.0000000001 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.trunc.f64.f32 %c1dno : f64 -> f32
+    %c2 = vm.const.f32 1.0 : f32
+    vm.check.eq %v, %c2, "truncate f64 to f32 rounds to nearest" : f32
+    vm.return
+  }
+
+  vm.export @test_ext_f32_f64
+  vm.func @test_ext_f32_f64() {
+    %c1 = vm.const.f32 -2.25 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.ext.f32.f64 %c1dno : f32 -> f64
+    %c2 = vm.const.f64 -2.25 : f64
+    vm.check.eq %v, %c2, "extend f32 to f64" : f64
+    vm.return
+  }
+
+}
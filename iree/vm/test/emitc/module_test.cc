@@ -12,16 +12,25 @@
 #include "iree/vm/api.h"
 #include "iree/vm/test/emitc/arithmetic_ops.h"
 #include "iree/vm/test/emitc/arithmetic_ops_f32.h"
+#include "iree/vm/test/emitc/arithmetic_ops_f64.h"
 #include "iree/vm/test/emitc/arithmetic_ops_i64.h"
 #include "iree/vm/test/emitc/assignment_ops.h"
+#include "iree/vm/test/emitc/assignment_ops_f32.h"
+#include "iree/vm/test/emitc/assignment_ops_f64.h"
 #include "iree/vm/test/emitc/assignment_ops_i64.h"
 #include "iree/vm/test/emitc/comparison_ops.h"
 #include "iree/vm/test/emitc/comparison_ops_f32.h"
+#include "iree/vm/test/emitc/comparison_ops_f64.h"
 #include "iree/vm/test/emitc/comparison_ops_i64.h"
 #include "iree/vm/test/emitc/control_flow_ops.h"
 #include "iree/vm/test/emitc/conversion_ops.h"
+#include "iree/vm/test/emitc/conversion_ops_f32.h"
+#include "iree/vm/test/emitc/conversion_ops_f64.h"
 #include "iree/vm/test/emitc/conversion_ops_i64.h"
 #include "iree/vm/test/emitc/global_ops.h"
+#include "iree/vm/test/emitc/global_ops_f32.h"
+#include "iree/vm/test/emitc/global_ops_f64.h"
+#include "iree/vm/test/emitc/global_ops_i64.h"
 #include "iree/vm/test/emitc/list_ops.h"
 #include "iree/vm/test/emitc/shift_ops.h"
 #include "iree/vm/test/emitc/shift_ops_i64.h"
@@ -54,16 +63,25 @@ std::vector<TestParams> GetModuleTestParams() {
   std::vector<ModuleDescription> modules = {
       {arithmetic_ops_descriptor_, arithmetic_ops_create},
       {arithmetic_ops_f32_descriptor_, arithmetic_ops_f32_create},
+      {arithmetic_ops_f64_descriptor_, arithmetic_ops_f64_create},
       {arithmetic_ops_i64_descriptor_, arithmetic_ops_i64_create},
       {assignment_ops_descriptor_, assignment_ops_create},
+      {assignment_ops_f32_descriptor_, assignment_ops_f32_create},
+      {assignment_ops_f64_descriptor_, assignment_ops_f64_create},
       {assignment_ops_i64_descriptor_, assignment_ops_i64_create},
       {comparison_ops_descriptor_, comparison_ops_create},
       {comparison_ops_f32_descriptor_, comparison_ops_f32_create},
+      {comparison_ops_f64_descriptor_, comparison_ops_f64_create},
       {comparison_ops_i64_descriptor_, comparison_ops_i64_create},
       {control_flow_ops_descriptor_, control_flow_ops_create},
       {conversion_ops_descriptor_, conversion_ops_create},
+      {conversion_ops_f32_descriptor_, conversion_ops_f32_create},
+      {conversion_ops_f64_descriptor_, conversion_ops_f64_create},
       {conversion_ops_i64_descriptor_, conversion_ops_i64_create},
       {global_ops_descriptor_, global_ops_create},
+      {global_ops_f32_descriptor_, global_ops_f32_create},
+      {global_ops_f64_descriptor_, global_ops_f64_create},
+      {global_ops_i64_descriptor_, global_ops_i64_create},
       {list_ops_descriptor_, list_ops_create},
       {shift_ops_descriptor_, shift_ops_create},
       {shift_ops_i64_descriptor_, shift_ops_i64_create}};
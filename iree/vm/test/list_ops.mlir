@@ -52,6 +52,25 @@ vm.module @list_ops {
     vm.return
   }
 
+  // An element copied between lists with an adjacent get and set.
+  vm.export @test_i32_copy
+  vm.func @test_i32_copy() {
+    %c1 = vm.const.i32 1 : i32
+    %c2 = vm.const.i32 2 : i32
+    %c3 = vm.const.i32 3 : i32
+    %c42 = vm.const.i32 42 : i32
+    %src = vm.list.alloc %c3 : (i32) -> !vm.list<i32>
+    vm.list.resize %src, %c3 : (!vm.list<i32>, i32)
+    vm.list.set.i32 %src, %c2, %c42 : (!vm.list<i32>, i32, i32)
+    %dst = vm.list.alloc %c2 : (i32) -> !vm.list<i32>
+    vm.list.resize %dst, %c2 : (!vm.list<i32>, i32)
+    %e = vm.list.get.i32 %src, %c2 : (!vm.list<i32>, i32) -> i32
+    vm.list.set.i32 %dst, %c1, %e : (!vm.list<i32>, i32, i32)
+    %v = vm.list.get.i32 %dst, %c1 : (!vm.list<i32>, i32) -> i32
+    vm.check.eq %v, %c42, "list<i32>.set(1, src.get(2)).get(1)=42" : i32
+    vm.return
+  }
+
   //===--------------------------------------------------------------------===//
   // vm.list.* with I64 types
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,62 @@
+// Compiled with LZ4 rodata compression; large rodata segments are
+// decompressed on first use.
+vm.module @rodata_compression_ops {
+
+  vm.rodata @rodata_splat_a dense<7> : tensor<1024xi32>
+  vm.rodata @rodata_splat_b dense<7> : tensor<1024xi32>
+  vm.rodata @rodata_small dense<[1, 2, 3]> : tensor<3xi32>
+
+  vm.export @test_compressed_length
+  vm.func @test_compressed_length() {
+    %rodata = vm.const.ref.rodata @rodata_splat_a : !vm.buffer
+    %rodata_dno = iree.do_not_optimize(%rodata) : !vm.buffer
+    %length = vm.buffer.length %rodata_dno : !vm.buffer -> i32
+    %c4096 = vm.const.i32 4096 : i32
+    vm.check.eq %length, %c4096, "length == 4096" : i32
+    vm.return
+  }
+
+  vm.export @test_compressed_contents
+  vm.func @test_compressed_contents() {
+    %c0 = vm.const.i32 0 : i32
+    %c2048 = vm.const.i32 2048 : i32
+    %c4092 = vm.const.i32 4092 : i32
+    %c7 = vm.const.i32 7 : i32
+    %rodata = vm.const.ref.rodata @rodata_splat_a : !vm.buffer
+    %rodata_dno = iree.do_not_optimize(%rodata) : !vm.buffer
+    %v0 = vm.buffer.load.i32 %rodata_dno[%c0] : !vm.buffer -> i32
+    vm.check.eq %v0, %c7, "first element" : i32
+    %v1 = vm.buffer.load.i32 %rodata_dno[%c2048] : !vm.buffer -> i32
+    vm.check.eq %v1, %c7, "middle element" : i32
+    %v2 = vm.buffer.load.i32 %rodata_dno[%c4092] : !vm.buffer -> i32
+    vm.check.eq %v2, %c7, "last element" : i32
+    vm.return
+  }
+
+  // Compressed and uncompressed segments can be used together and repeated
+  // references resolve to the same contents.
+  vm.export @test_compare_segments
+  vm.func @test_compare_segments() {
+    %c0 = vm.const.i32 0 : i32
+    %c4096 = vm.const.i32 4096 : i32
+    %rodata_a = vm.const.ref.rodata @rodata_splat_a : !vm.buffer
+    %rodata_a_dno = iree.do_not_optimize(%rodata_a) : !vm.buffer
+    %rodata_b = vm.const.ref.rodata @rodata_splat_b : !vm.buffer
+    %rodata_b_dno = iree.do_not_optimize(%rodata_b) : !vm.buffer
+    %cmp0 = vm.buffer.compare %rodata_a_dno, %c0, %rodata_b_dno, %c0, %c4096 : !vm.buffer, !vm.buffer
+    vm.check.nz %cmp0, "a == b" : i32
+    %rodata_a2 = vm.const.ref.rodata @rodata_splat_a : !vm.buffer
+    %rodata_a2_dno = iree.do_not_optimize(%rodata_a2) : !vm.buffer
+    %cmp1 = vm.buffer.compare %rodata_a_dno, %c0, %rodata_a2_dno, %c0, %c4096 : !vm.buffer, !vm.buffer
+    vm.check.nz %cmp1, "a == a" : i32
+
+    %c4 = vm.const.i32 4 : i32
+    %c2 = vm.const.i32 2 : i32
+    %rodata_small = vm.const.ref.rodata @rodata_small : !vm.buffer
+    %rodata_small_dno = iree.do_not_optimize(%rodata_small) : !vm.buffer
+    %v = vm.buffer.load.i32 %rodata_small_dno[%c4] : !vm.buffer -> i32
+    vm.check.eq %v, %c2, "small[1] == 2" : i32
+    vm.return
+  }
+
+}